@@ -29,6 +29,7 @@ from qgis.PyQt.QtCore import QVariant
 from qgis.core import (QgsApplication,
                        QgsSettings,
                        QgsGeometry,
+                       QgsGeometryValidator,
                        QgsFeature,
                        QgsField,
                        QgsFeatureRequest,
@@ -61,6 +62,9 @@ class CheckValidity(QgisAlgorithm):
     ERROR_COUNT = 'ERROR_COUNT'
     IGNORE_RING_SELF_INTERSECTION = 'IGNORE_RING_SELF_INTERSECTION'
 
+    # number of features validated together, using multiple threads
+    BATCH_SIZE = 1000
+
     def icon(self):
         return QgsApplication.getThemeIcon("/algorithms/mAlgorithmCheckGeometry.svg")
 
@@ -149,33 +153,72 @@ class CheckValidity(QgisAlgorithm):
 
         features = source.getFeatures(QgsFeatureRequest(), QgsProcessingFeatureSource.FlagSkipGeometryValidityChecks)
         total = 100.0 / source.featureCount() if source.featureCount() else 0
-        for current, inFeat in enumerate(features):
+        current = 0
+
+        # features are validated in batches, using multiple threads
+        batch = []
+        for inFeat in features:
+            if feedback.isCanceled():
+                break
+
+            batch.append(inFeat)
+            if len(batch) < self.BATCH_SIZE:
+                continue
+
+            current, valid_count, invalid_count, error_count = self.checkBatch(batch, method, flags, feedback, current, total,
+                                                                               valid_output_sink, invalid_output_sink, error_output_sink,
+                                                                               valid_count, invalid_count, error_count)
+            batch = []
+
+        if batch and not feedback.isCanceled():
+            current, valid_count, invalid_count, error_count = self.checkBatch(batch, method, flags, feedback, current, total,
+                                                                               valid_output_sink, invalid_output_sink, error_output_sink,
+                                                                               valid_count, invalid_count, error_count)
+
+        results = {
+            self.VALID_COUNT: valid_count,
+            self.INVALID_COUNT: invalid_count,
+            self.ERROR_COUNT: error_count
+        }
+        if valid_output_sink:
+            results[self.VALID_OUTPUT] = valid_output_dest_id
+        if invalid_output_sink:
+            results[self.INVALID_OUTPUT] = invalid_output_dest_id
+        if error_output_sink:
+            results[self.ERROR_OUTPUT] = error_output_dest_id
+        return results
+
+    def checkBatch(self, batch, method, flags, feedback, current, total,
+                   valid_output_sink, invalid_output_sink, error_output_sink,
+                   valid_count, invalid_count, error_count):
+        geometries = [f.geometry() if not f.geometry().isNull() and not f.geometry().isEmpty() else QgsGeometry() for f in batch]
+        batch_errors = QgsGeometryValidator.validateGeometries(geometries, method, flags, feedback)
+
+        for inFeat, errors in zip(batch, batch_errors):
             if feedback.isCanceled():
                 break
             geom = inFeat.geometry()
             attrs = inFeat.attributes()
 
             valid = True
-            if not geom.isNull() and not geom.isEmpty():
-                errors = list(geom.validateGeometry(method, flags))
-                if errors:
-                    valid = False
-                    reasons = []
-                    for error in errors:
-                        errFeat = QgsFeature()
-                        error_geom = QgsGeometry.fromPointXY(error.where())
-                        errFeat.setGeometry(error_geom)
-                        errFeat.setAttributes([error.what()])
-                        if error_output_sink:
-                            error_output_sink.addFeature(errFeat, QgsFeatureSink.FastInsert)
-                        error_count += 1
-
-                        reasons.append(error.what())
-
-                    reason = "\n".join(reasons)
-                    if len(reason) > 255:
-                        reason = reason[:252] + '…'
-                    attrs.append(reason)
+            if errors:
+                valid = False
+                reasons = []
+                for error in errors:
+                    errFeat = QgsFeature()
+                    error_geom = QgsGeometry.fromPointXY(error.where())
+                    errFeat.setGeometry(error_geom)
+                    errFeat.setAttributes([error.what()])
+                    if error_output_sink:
+                        error_output_sink.addFeature(errFeat, QgsFeatureSink.FastInsert)
+                    error_count += 1
+
+                    reasons.append(error.what())
+
+                reason = "\n".join(reasons)
+                if len(reason) > 255:
+                    reason = reason[:252] + '…'
+                attrs.append(reason)
 
             outFeat = QgsFeature()
             outFeat.setGeometry(geom)
@@ -192,16 +235,6 @@ class CheckValidity(QgisAlgorithm):
                 invalid_count += 1
 
             feedback.setProgress(int(current * total))
+            current += 1
 
-        results = {
-            self.VALID_COUNT: valid_count,
-            self.INVALID_COUNT: invalid_count,
-            self.ERROR_COUNT: error_count
-        }
-        if valid_output_sink:
-            results[self.VALID_OUTPUT] = valid_output_dest_id
-        if invalid_output_sink:
-            results[self.INVALID_OUTPUT] = invalid_output_dest_id
-        if error_output_sink:
-            results[self.ERROR_OUTPUT] = error_output_dest_id
-        return results
+        return current, valid_count, invalid_count, error_count
@@ -56,6 +56,7 @@ class Heatmap(QgisAlgorithm):
     KERNEL = 'KERNEL'
     DECAY = 'DECAY'
     OUTPUT_VALUE = 'OUTPUT_VALUE'
+    METHOD = 'METHOD'
     OUTPUT = 'OUTPUT'
 
     def icon(self):
@@ -89,6 +90,10 @@ class Heatmap(QgisAlgorithm):
         self.OUTPUT_VALUES = OrderedDict([(self.tr('Raw'), QgsKernelDensityEstimation.OutputRaw),
                                           (self.tr('Scaled'), QgsKernelDensityEstimation.OutputScaled)])
 
+        self.METHODS = OrderedDict([(self.tr('Point by point'), QgsKernelDensityEstimation.PointByPoint),
+                                    (self.tr('Tiled (parallel)'), QgsKernelDensityEstimation.Tiled),
+                                    (self.tr('Streamed (parallel, fixed memory)'), QgsKernelDensityEstimation.Streamed)])
+
         self.addParameter(QgsProcessingParameterFeatureSource(self.INPUT,
                                                               self.tr('Point layer'),
                                                               [QgsProcessing.TypeVectorPoint]))
@@ -167,6 +172,15 @@ class Heatmap(QgisAlgorithm):
         output_scaling.setFlags(output_scaling.flags() | QgsProcessingParameterDefinition.FlagAdvanced)
         self.addParameter(output_scaling)
 
+        keys = list(self.METHODS.keys())
+        method_param = QgsProcessingParameterEnum(self.METHOD,
+                                                  self.tr('Calculation method'),
+                                                  keys,
+                                                  allowMultiple=False,
+                                                  defaultValue=0)
+        method_param.setFlags(method_param.flags() | QgsProcessingParameterDefinition.FlagAdvanced)
+        self.addParameter(method_param)
+
         self.addParameter(QgsProcessingParameterRasterDestination(self.OUTPUT, self.tr('Heatmap')))
 
     def processAlgorithm(self, parameters, context, feedback):
@@ -179,6 +193,7 @@ class Heatmap(QgisAlgorithm):
         pixel_size = self.parameterAsDouble(parameters, self.PIXEL_SIZE, context)
         decay = self.parameterAsDouble(parameters, self.DECAY, context)
         output_values = self.parameterAsEnum(parameters, self.OUTPUT_VALUE, context)
+        method = list(self.METHODS.values())[self.parameterAsEnum(parameters, self.METHOD, context)]
         outputFile = self.parameterAsOutputLayer(parameters, self.OUTPUT, context)
         output_format = QgsRasterFileWriter.driverForExtension(os.path.splitext(outputFile)[1])
         weight_field = self.parameterAsString(parameters, self.WEIGHT_FIELD, context)
@@ -204,6 +219,14 @@ class Heatmap(QgisAlgorithm):
         kde_params.outputValues = output_values
 
         kde = QgsKernelDensityEstimation(kde_params, outputFile, output_format)
+        kde.setMethod(method)
+
+        if method == QgsKernelDensityEstimation.Streamed:
+            # the streamed method fetches the features for each strip of the output itself
+            if kde.run(feedback) != QgsKernelDensityEstimation.Success:
+                raise QgsProcessingException(
+                    self.tr('Could not save destination layer'))
+            return {self.OUTPUT: outputFile}
 
         if kde.prepare() != QgsKernelDensityEstimation.Success:
             raise QgsProcessingException(
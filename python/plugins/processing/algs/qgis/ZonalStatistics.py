@@ -34,6 +34,7 @@ from qgis.core import (QgsProcessing,
                        QgsProcessingParameterString,
                        QgsProcessingParameterBand,
                        QgsProcessingParameterEnum,
+                       QgsProcessingParameterDefinition,
                        QgsProcessingOutputVectorLayer)
 
 from processing.algs.qgis.QgisAlgorithm import QgisAlgorithm
@@ -48,6 +49,7 @@ class ZonalStatistics(QgisAlgorithm):
     INPUT_VECTOR = 'INPUT_VECTOR'
     COLUMN_PREFIX = 'COLUMN_PREFIX'
     STATISTICS = 'STATS'
+    METHOD = 'METHOD'
 
     def icon(self):
         return QIcon(os.path.join(pluginPath, 'images', 'zonalstats.png'))
@@ -66,6 +68,7 @@ class ZonalStatistics(QgisAlgorithm):
         self.bandNumber = None
         self.columnPrefix = None
         self.selectedStats = None
+        self.method = None
         self.vectorLayer = None
         self.raster_interface = None
         self.raster_crs = None
@@ -103,6 +106,14 @@ class ZonalStatistics(QgisAlgorithm):
                                                      self.tr('Statistics to calculate'),
                                                      keys,
                                                      allowMultiple=True, defaultValue=[0, 1, 2]))
+        method_param = QgsProcessingParameterEnum(self.METHOD,
+                                                  self.tr('Cell assignment method'),
+                                                  [self.tr('Separately for each zone'),
+                                                   self.tr('Rasterize all zones at once (faster for many zones, overlapping zones not supported)')],
+                                                  defaultValue=0,
+                                                  optional=True)
+        method_param.setFlags(method_param.flags() | QgsProcessingParameterDefinition.FlagAdvanced)
+        self.addParameter(method_param)
         self.addOutput(QgsProcessingOutputVectorLayer(self.INPUT_VECTOR,
                                                       self.tr('Zonal statistics'),
                                                       QgsProcessing.TypeVectorPolygon))
@@ -123,6 +134,9 @@ class ZonalStatistics(QgisAlgorithm):
         for i in st:
             self.selectedStats |= self.STATS[keys[i]]
 
+        methods = [QgsZonalStatistics.PerFeature, QgsZonalStatistics.Rasterized]
+        self.method = methods[self.parameterAsEnum(parameters, self.METHOD, context)]
+
         self.vectorLayer = self.parameterAsVectorLayer(parameters, self.INPUT_VECTOR, context)
         rasterLayer = self.parameterAsRasterLayer(parameters, self.INPUT_RASTER, context)
         self.raster_interface = rasterLayer.dataProvider().clone()
@@ -140,5 +154,6 @@ class ZonalStatistics(QgisAlgorithm):
                                 self.columnPrefix,
                                 self.bandNumber,
                                 QgsZonalStatistics.Statistics(self.selectedStats))
+        zs.setMethod(self.method)
         zs.calculateStatistics(feedback)
         return {self.INPUT_VECTOR: self.vectorLayer}
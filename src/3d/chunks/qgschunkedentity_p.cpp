@@ -54,6 +54,9 @@ static float screenSpaceError( float epsilon, float distance, float screenSize,
   return phi;
 }
 
+//! Factor applied to the screen space error of chunks requested by prefetch(), so that they are loaded after chunks of the current view
+static const float PREFETCH_PRIORITY_FACTOR = 0.5f;
+
 static float screenSpaceError( QgsChunkNode *node, const QgsChunkedEntity::SceneState &state )
 {
   float dist = node->bbox().distanceFromPoint( state.cameraPos );
@@ -73,6 +76,7 @@ QgsChunkedEntity::QgsChunkedEntity( const QgsAABB &rootBbox, float rootError, fl
   mRootNode = new QgsChunkNode( 0, 0, 0, rootBbox, rootError );
   mChunkLoaderQueue = new QgsChunkList;
   mReplacementQueue = new QgsChunkList;
+  mClock.start();
 }
 
 
@@ -121,6 +125,7 @@ void QgsChunkedEntity::update( const SceneState &state )
   t.start();
 
   int oldJobsCount = pendingJobsCount();
+  const qint64 updateTime = mClock.elapsed();
 
   QSet<QgsChunkNode *> activeBefore = QSet<QgsChunkNode *>::fromList( mActiveNodes );
   mActiveNodes.clear();
@@ -166,6 +171,9 @@ void QgsChunkedEntity::update( const SceneState &state )
     mBboxesEntity->setBoxes( bboxes );
   }
 
+  // chunks which were requested neither by this update nor by a recent prefetch are not needed anymore
+  cancelUnneededJobs( updateTime );
+
   // start a job from queue if there is anything waiting
   startJobs();
 
@@ -223,6 +231,33 @@ int QgsChunkedEntity::pendingJobsCount() const
   return mChunkLoaderQueue->count() + mActiveJobs.count();
 }
 
+void QgsChunkedEntity::prefetch( const SceneState &state, int lifetime )
+{
+  int oldJobsCount = pendingJobsCount();
+
+  prefetch( mRootNode, state, mClock.elapsed() + lifetime );
+
+  startJobs();
+
+  if ( pendingJobsCount() != oldJobsCount )
+    emit pendingJobsCountChanged();
+}
+
+void QgsChunkedEntity::setMaximumConcurrentJobs( int count )
+{
+  mMaxConcurrentJobs = std::max( 1, count );
+  startJobs();
+}
+
+QgsChunkedEntity::LoadingStatistics QgsChunkedEntity::loadingStatistics() const
+{
+  LoadingStatistics statistics = mStatistics;
+  statistics.queuedJobs = mChunkLoaderQueue->count();
+  statistics.activeJobs = mActiveJobs.count();
+  statistics.loadedChunks = mReplacementQueue->count();
+  return statistics;
+}
+
 
 void QgsChunkedEntity::update( QgsChunkNode *node, const SceneState &state )
 {
@@ -236,7 +271,7 @@ void QgsChunkedEntity::update( QgsChunkNode *node, const SceneState &state )
 
   // make sure all nodes leading to children are always loaded
   // so that zooming out does not create issues
-  requestResidency( node );
+  requestResidency( node, state );
 
   if ( !node->entity() )
   {
@@ -270,14 +305,70 @@ void QgsChunkedEntity::update( QgsChunkNode *node, const SceneState &state )
     {
       QgsChunkNode *const *children = node->children();
       for ( int i = 0; i < 4; ++i )
-        requestResidency( children[i] );
+        requestResidency( children[i], state );
     }
   }
 }
 
+void QgsChunkedEntity::prefetch( QgsChunkNode *node, const SceneState &state, qint64 requestedUntil )
+{
+  if ( Qgs3DUtils::isCullable( node->bbox(), state.viewProjectionMatrix ) )
+    return;
+
+  if ( !node->hasData() )
+    return;  // neither this node nor its descendants have anything to show
 
-void QgsChunkedEntity::requestResidency( QgsChunkNode *node )
+  node->ensureAllChildrenExist();
+
+  requestResidency( node, state, PREFETCH_PRIORITY_FACTOR, requestedUntil );
+
+  if ( screenSpaceError( node, state ) > mTau && node->level() < mMaxLevel )
+  {
+    QgsChunkNode *const *children = node->children();
+    for ( int i = 0; i < 4; ++i )
+      prefetch( children[i], state, requestedUntil );
+  }
+}
+
+void QgsChunkedEntity::cancelUnneededJobs( qint64 time )
 {
+  QgsChunkListEntry *entry = mChunkLoaderQueue->first();
+  while ( entry )
+  {
+    QgsChunkListEntry *next = entry->next;
+    QgsChunkNode *node = entry->chunk;
+    if ( node->state() == QgsChunkNode::QueuedForLoad && node->requestedUntil() < time )
+    {
+      mChunkLoaderQueue->takeEntry( entry );
+      node->cancelQueuedForLoad();  // also deletes the entry
+      ++mStatistics.canceledLoads;
+    }
+    entry = next;
+  }
+
+  const QList<QgsChunkQueueJob *> activeJobs = mActiveJobs;
+  for ( QgsChunkQueueJob *job : activeJobs )
+  {
+    if ( qobject_cast<QgsChunkLoader *>( job ) && job->chunk()->requestedUntil() < time )
+    {
+      cancelActiveJob( job );
+      ++mStatistics.canceledLoads;
+    }
+  }
+}
+
+
+void QgsChunkedEntity::requestResidency( QgsChunkNode *node, const SceneState &state, float priorityFactor, qint64 requestedUntil )
+{
+  const qint64 now = mClock.elapsed();
+  requestedUntil = std::max( requestedUntil, now );
+
+  // requests of the current view replace priorities of expired requests, otherwise the highest priority wins
+  const float error = screenSpaceError( node, state ) * priorityFactor;
+  if ( node->requestedUntil() < now || error > node->loadScreenError() )
+    node->setLoadPriority( error, node->bbox().distanceFromPoint( state.cameraPos ) );
+  node->setRequestedUntil( std::max( node->requestedUntil(), requestedUntil ) );
+
   if ( node->state() == QgsChunkNode::Loaded || node->state() == QgsChunkNode::QueuedForUpdate || node->state() == QgsChunkNode::Updating )
   {
     Q_ASSERT( node->replacementQueueEntry() );
@@ -287,14 +378,9 @@ void QgsChunkedEntity::requestResidency( QgsChunkNode *node )
   }
   else if ( node->state() == QgsChunkNode::QueuedForLoad )
   {
-    // move to the front of loading queue
+    // nothing to do - jobs are started in order of their priority
     Q_ASSERT( node->loaderQueueEntry() );
     Q_ASSERT( !node->loader() );
-    if ( node->loaderQueueEntry()->prev || node->loaderQueueEntry()->next )
-    {
-      mChunkLoaderQueue->takeEntry( node->loaderQueueEntry() );
-      mChunkLoaderQueue->insertFirst( node->loaderQueueEntry() );
-    }
   }
   else if ( node->state() == QgsChunkNode::Loading )
   {
@@ -308,7 +394,10 @@ void QgsChunkedEntity::requestResidency( QgsChunkNode *node )
     // add to the loading queue
     QgsChunkListEntry *entry = new QgsChunkListEntry( node );
     node->setQueuedForLoad( entry );
-    mChunkLoaderQueue->insertFirst( entry );
+    mChunkLoaderQueue->insertLast( entry );
+
+    if ( priorityFactor < 1 )
+      ++mStatistics.prefetchRequests;
   }
   else
     Q_ASSERT( false && "impossible!" );
@@ -343,6 +432,8 @@ void QgsChunkedEntity::onActiveJobFinished()
       node->setLoaded( entity );
 
       mReplacementQueue->insertFirst( node->replacementQueueEntry() );
+
+      emit newEntityCreated( entity );
     }
     else
     {
@@ -352,6 +443,9 @@ void QgsChunkedEntity::onActiveJobFinished()
 
     // now we need an update!
     mNeedsUpdate = true;
+
+    ++mStatistics.finishedLoads;
+    mStatistics.totalLoadTime += mClock.elapsed() - mJobStartTimes.value( job );
   }
   else
   {
@@ -362,6 +456,7 @@ void QgsChunkedEntity::onActiveJobFinished()
 
   // cleanup the job that has just finished
   mActiveJobs.removeOne( job );
+  mJobStartTimes.remove( job );
   job->deleteLater();
 
   // start another job - if any
@@ -373,18 +468,26 @@ void QgsChunkedEntity::onActiveJobFinished()
 
 void QgsChunkedEntity::startJobs()
 {
-  while ( mActiveJobs.count() < 4 )
+  while ( mActiveJobs.count() < mMaxConcurrentJobs )
   {
     if ( mChunkLoaderQueue->isEmpty() )
       return;
 
-    QgsChunkListEntry *entry = mChunkLoaderQueue->takeFirst();
-    Q_ASSERT( entry );
+    // pick the queued chunk with the highest priority
+    QgsChunkListEntry *entry = mChunkLoaderQueue->first();
+    for ( QgsChunkListEntry *e = entry->next; e; e = e->next )
+    {
+      if ( e->chunk->hasHigherLoadPriority( entry->chunk ) )
+        entry = e;
+    }
+
+    mChunkLoaderQueue->takeEntry( entry );
     QgsChunkNode *node = entry->chunk;
     delete entry;
 
     QgsChunkQueueJob *job = startJob( node );
     mActiveJobs.append( job );
+    mJobStartTimes.insert( job, mClock.elapsed() );
   }
 }
 
@@ -439,6 +542,7 @@ void QgsChunkedEntity::cancelActiveJob( QgsChunkQueueJob *job )
 
   job->cancel();
   mActiveJobs.removeOne( job );
+  mJobStartTimes.remove( job );
   job->deleteLater();
 }
 
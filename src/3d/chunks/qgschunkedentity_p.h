@@ -27,6 +27,8 @@
 // version without notice, or even be removed.
 //
 
+#include "qgis_3d.h"
+
 #include <Qt3DCore/QEntity>
 
 class QgsAABB;
@@ -41,6 +43,8 @@ class QgsChunkQueueJobFactory;
 #include <QMatrix4x4>
 
 #include <QTime>
+#include <QElapsedTimer>
+#include <QHash>
 
 /**
  * \ingroup 3d
@@ -48,7 +52,7 @@ class QgsChunkQueueJobFactory;
  * based on data error and unloading of data when data are not necessary anymore
  * \since QGIS 3.0
  */
-class QgsChunkedEntity : public Qt3DCore::QEntity
+class _3D_EXPORT QgsChunkedEntity : public Qt3DCore::QEntity
 {
     Q_OBJECT
   public:
@@ -85,6 +89,48 @@ class QgsChunkedEntity : public Qt3DCore::QEntity
     //! Returns number of jobs pending for this entity until it is fully loaded/updated in the current view
     int pendingJobsCount() const;
 
+    /**
+     * Requests loading of the chunks needed to render the scene in the given \a state, e.g. for a camera
+     * position which is going to be reached soon. The active nodes are not changed. The screen space error
+     * of prefetched chunks is scaled down when ordering the jobs, so that they are loaded after chunks of
+     * a similar error in the current view. The requests are kept for \a lifetime milliseconds.
+     * \since QGIS 3.12
+     */
+    void prefetch( const SceneState &state, int lifetime = 2000 );
+
+    /**
+     * Sets the maximum number of jobs which are running at the same time
+     * \since QGIS 3.12
+     */
+    void setMaximumConcurrentJobs( int count );
+
+    /**
+     * Returns the maximum number of jobs which are running at the same time
+     * \since QGIS 3.12
+     */
+    int maximumConcurrentJobs() const { return mMaxConcurrentJobs; }
+
+    /**
+     * Statistics about loading of chunks
+     * \since QGIS 3.12
+     */
+    struct LoadingStatistics
+    {
+      int queuedJobs = 0;       //!< Number of jobs waiting to be started
+      int activeJobs = 0;       //!< Number of jobs running at the moment
+      int loadedChunks = 0;     //!< Number of chunks with loaded data
+      int finishedLoads = 0;    //!< Total number of chunk loads which have finished
+      int canceledLoads = 0;    //!< Total number of chunk loads which were canceled as the chunks were no longer needed
+      int prefetchRequests = 0; //!< Total number of chunk loads requested by prefetch()
+      qint64 totalLoadTime = 0; //!< Total time (in milliseconds) between the start and the end of the finished loads
+    };
+
+    /**
+     * Returns statistics about loading of chunks of the entity
+     * \since QGIS 3.12
+     */
+    LoadingStatistics loadingStatistics() const;
+
   protected:
     //! Cancels the background job that is currently in progress
     void cancelActiveJob( QgsChunkQueueJob *job );
@@ -96,7 +142,13 @@ class QgsChunkedEntity : public Qt3DCore::QEntity
     void update( QgsChunkNode *node, const SceneState &state );
 
     //! make sure that the chunk will be loaded soon (if not loaded yet) and not unloaded anytime soon (if loaded already)
-    void requestResidency( QgsChunkNode *node );
+    void requestResidency( QgsChunkNode *node, const SceneState &state, float priorityFactor = 1, qint64 requestedUntil = -1 );
+
+    //! recursively requests the chunks needed for the given scene state, without changing active nodes
+    void prefetch( QgsChunkNode *node, const SceneState &state, qint64 requestedUntil );
+
+    //! cancels queued and running loads of chunks which have not been requested since \a time
+    void cancelUnneededJobs( qint64 time );
 
     void startJobs();
     QgsChunkQueueJob *startJob( QgsChunkNode *node );
@@ -108,6 +160,12 @@ class QgsChunkedEntity : public Qt3DCore::QEntity
     //! Emitted when the number of pending jobs changes (some jobs have finished or some jobs have been just created)
     void pendingJobsCountChanged();
 
+    /**
+     * Emitted when a new 3D entity for a chunk has been created
+     * \since QGIS 3.12
+     */
+    void newEntityCreated( Qt3DCore::QEntity *entity );
+
   protected:
     //! root node of the quadtree hierarchy
     QgsChunkNode *mRootNode = nullptr;
@@ -140,6 +198,14 @@ class QgsChunkedEntity : public Qt3DCore::QEntity
 
     //! jobs that are currently being processed (asynchronously in worker threads)
     QList<QgsChunkQueueJob *> mActiveJobs;
+    //! maximum number of jobs being processed at the same time
+    int mMaxConcurrentJobs = 4;
+    //! clock used to track requests of chunks
+    QElapsedTimer mClock;
+    //! start times of the active jobs
+    QHash<QgsChunkQueueJob *, qint64> mJobStartTimes;
+    //! loading statistics (counts of queued / active / loaded chunks are filled on request)
+    LoadingStatistics mStatistics;
 };
 
 /// @endcond
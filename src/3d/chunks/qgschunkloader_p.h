@@ -34,7 +34,7 @@
  * Base class for jobs that load chunks
  * \since QGIS 3.0
  */
-class QgsChunkLoader : public QgsChunkQueueJob
+class _3D_EXPORT QgsChunkLoader : public QgsChunkQueueJob
 {
     Q_OBJECT
   public:
@@ -27,6 +27,7 @@
 // version without notice, or even be removed.
 //
 
+#include "qgis_3d.h"
 #include "qgsaabb.h"
 
 #include <QTime>
@@ -69,7 +70,7 @@ struct QgsChunkNodeId
  *
  * \since QGIS 3.0
  */
-class QgsChunkNode
+class _3D_EXPORT QgsChunkNode
 {
   public:
     //! constructs a skeleton chunk
@@ -192,6 +193,43 @@ class QgsChunkNode
     //! Returns whether the node has any data to be displayed. If not, it will be kept as a skeleton node and will not get loaded anymore
     bool hasData() const { return mHasData; }
 
+    /**
+     * Sets the priority of the node's pending load or update job. The \a screenError is the projected
+     * screen space error of the node and \a distance its distance from the camera. Jobs of nodes with
+     * larger screen error are started first, ties are resolved in favor of nodes closer to the camera.
+     * \since QGIS 3.12
+     */
+    void setLoadPriority( float screenError, float distance ) { mLoadScreenError = screenError; mLoadDistance = distance; }
+
+    /**
+     * Returns the screen space error used to prioritize the node's pending job
+     * \since QGIS 3.12
+     */
+    float loadScreenError() const { return mLoadScreenError; }
+
+    /**
+     * Returns TRUE if the node's pending job should be started before the job of the \a other node.
+     * \since QGIS 3.12
+     */
+    bool hasHigherLoadPriority( const QgsChunkNode *other ) const
+    {
+      return mLoadScreenError > other->mLoadScreenError || ( mLoadScreenError == other->mLoadScreenError && mLoadDistance < other->mLoadDistance );
+    }
+
+    /**
+     * Sets the \a time (in milliseconds of the chunked entity's clock) until which the node
+     * has been requested to be resident.
+     * \since QGIS 3.12
+     */
+    void setRequestedUntil( qint64 time ) { mRequestedUntil = time; }
+
+    /**
+     * Returns the time (in milliseconds of the chunked entity's clock) until which the node
+     * has been requested to be resident.
+     * \since QGIS 3.12
+     */
+    qint64 requestedUntil() const { return mRequestedUntil; }
+
   private:
     QgsAABB mBbox;      //!< Bounding box in world coordinates
     float mError;    //!< Error of the node in world coordinates
@@ -214,6 +252,10 @@ class QgsChunkNode
 
     QTime mEntityCreatedTime;
     bool mHasData = true;   //!< Whether there are (will be) any data in this node (or any descentants) and so whether it makes sense to load this node
+
+    float mLoadScreenError = 0;  //!< Screen space error of the node when it was last requested
+    float mLoadDistance = 0;     //!< Distance of the node from the camera when it was last requested
+    qint64 mRequestedUntil = -1;  //!< Time until which the node is requested to be resident
 };
 
 /// @endcond
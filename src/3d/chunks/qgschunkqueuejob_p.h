@@ -36,6 +36,8 @@ namespace Qt3DCore
 
 #include <QObject>
 
+#include "qgis_3d.h"
+
 /**
  * \ingroup 3d
  * Base class for chunk queue jobs. Job implementations start their work when they are created
@@ -49,7 +51,7 @@ namespace Qt3DCore
  *
  * \since QGIS 3.0
  */
-class QgsChunkQueueJob : public QObject
+class _3D_EXPORT QgsChunkQueueJob : public QObject
 {
     Q_OBJECT
   public:
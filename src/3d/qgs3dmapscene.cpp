@@ -39,6 +39,7 @@
 #include "qgs3dutils.h"
 #include "qgsabstract3drenderer.h"
 #include "qgscameracontroller.h"
+#include "qgscamerapose.h"
 #include "qgschunkedentity_p.h"
 #include "qgschunknode_p.h"
 #include "qgseventtracing.h"
@@ -47,6 +48,8 @@
 #include "qgsrulebased3drenderer.h"
 #include "qgsterrainentity_p.h"
 #include "qgsterraingenerator.h"
+#include "qgsdemterraingenerator.h"
+#include "qgsdemterraintileloader_p.h"
 #include "qgstessellatedpolygongeometry.h"
 #include "qgsvectorlayer.h"
 #include "qgsvectorlayer3drenderer.h"
@@ -102,6 +105,7 @@ Qgs3DMapScene::Qgs3DMapScene( const Qgs3DMapSettings &map, QgsAbstract3DEngine *
   connect( &map, &Qgs3DMapSettings::pointLightsChanged, this, &Qgs3DMapScene::updateLights );
   connect( &map, &Qgs3DMapSettings::fieldOfViewChanged, this, &Qgs3DMapScene::updateCameraLens );
   connect( &map, &Qgs3DMapSettings::renderersChanged, this, &Qgs3DMapScene::onRenderersChanged );
+  connect( &map, &Qgs3DMapSettings::triangulationAlgorithmChanged, this, &Qgs3DMapScene::onTriangulationAlgorithmChanged );
 
   // create entities of renderers
 
@@ -261,6 +265,30 @@ void Qgs3DMapScene::updateScene()
   updateSceneState();
 }
 
+void Qgs3DMapScene::prefetch( const QgsCameraPose &pose )
+{
+  // a detached camera with the same lens as the scene's camera, placed at the requested pose
+  Qt3DRender::QCamera *camera = mCameraController->camera();
+  Qt3DRender::QCamera poseCamera;
+  poseCamera.lens()->setProjectionMatrix( camera->projectionMatrix() );
+  QgsCameraPose( pose ).updateCamera( &poseCamera );
+
+  QgsChunkedEntity::SceneState state;
+  state.cameraFov = camera->fieldOfView();
+  state.cameraPos = poseCamera.position();
+  QRect rect = mCameraController->viewport();
+  state.screenSizePx = std::max( rect.width(), rect.height() );
+  state.viewProjectionMatrix = poseCamera.projectionMatrix() * poseCamera.viewMatrix();
+
+  for ( QgsChunkedEntity *entity : qgis::as_const( mChunkEntities ) )
+  {
+    if ( entity->isEnabled() )
+      entity->prefetch( state );
+  }
+
+  updateSceneState();
+}
+
 bool Qgs3DMapScene::updateCameraNearFarPlanes()
 {
   // Update near and far plane from the terrain.
@@ -379,6 +407,13 @@ void Qgs3DMapScene::createTerrainDeferred()
   double tile0width = mMap.terrainGenerator()->extent().width();
   int maxZoomLevel = Qgs3DUtils::maxZoomLevel( tile0width, mMap.mapTileResolution(), mMap.maxTerrainGroundError() );
 
+  if ( mMap.terrainGenerator()->type() == QgsTerrainGenerator::Dem )
+  {
+    QgsDemTerrainGenerator *demGenerator = static_cast<QgsDemTerrainGenerator *>( mMap.terrainGenerator() );
+    if ( demGenerator->heightMapCacheMode() == QgsDemTerrainGenerator::PregeneratedCache && demGenerator->heightMapGenerator() )
+      demGenerator->heightMapGenerator()->pregenerateCache( maxZoomLevel );
+  }
+
   mTerrain = new QgsTerrainEntity( maxZoomLevel, mMap );
   //mTerrain->setEnabled(false);
   mTerrain->setParent( this );
@@ -527,6 +562,20 @@ void Qgs3DMapScene::onLayerRenderer3DChanged()
   addLayerEntity( layer );
 }
 
+void Qgs3DMapScene::onTriangulationAlgorithmChanged()
+{
+  // polygons of all vector layers need to be tessellated again
+  const QList<QgsMapLayer *> layers = mLayerEntities.keys();
+  for ( QgsMapLayer *layer : layers )
+  {
+    if ( layer->type() != QgsMapLayerType::VectorLayer )
+      continue;
+
+    removeLayerEntity( layer );
+    addLayerEntity( layer );
+  }
+}
+
 void Qgs3DMapScene::onLayersChanged()
 {
   QSet<QgsMapLayer *> layersBefore = QSet<QgsMapLayer *>::fromList( mLayerEntities.keys() );
@@ -557,6 +606,7 @@ void Qgs3DMapScene::onLayersChanged()
 
 void Qgs3DMapScene::addLayerEntity( QgsMapLayer *layer )
 {
+  bool needsSceneUpdate = false;
   QgsAbstract3DRenderer *renderer = layer->renderer3D();
   if ( renderer )
   {
@@ -584,6 +634,18 @@ void Qgs3DMapScene::addLayerEntity( QgsMapLayer *layer )
       newEntity->setParent( this );
       mLayerEntities.insert( layer, newEntity );
 
+      if ( QgsChunkedEntity *chunkedNewEntity = qobject_cast<QgsChunkedEntity *>( newEntity ) )
+      {
+        mChunkEntities.append( chunkedNewEntity );
+        needsSceneUpdate = true;
+
+        // entities of chunks are only created once their data get loaded
+        connect( chunkedNewEntity, &QgsChunkedEntity::newEntityCreated, this, [this]( Qt3DCore::QEntity * entity )
+        {
+          finalizeNewEntity( entity );
+        } );
+      }
+
       if ( !mPickHandlers.isEmpty() )
       {
         Qt3DRender::QObjectPicker *picker = new Qt3DRender::QObjectPicker( newEntity );
@@ -602,11 +664,20 @@ void Qgs3DMapScene::addLayerEntity( QgsMapLayer *layer )
     QgsVectorLayer *vlayer = qobject_cast<QgsVectorLayer *>( layer );
     connect( vlayer, &QgsVectorLayer::selectionChanged, this, &Qgs3DMapScene::onLayerRenderer3DChanged );
   }
+
+  if ( needsSceneUpdate )
+    onCameraChanged();   // needed for chunked entities
 }
 
 void Qgs3DMapScene::removeLayerEntity( QgsMapLayer *layer )
 {
   Qt3DCore::QEntity *entity = mLayerEntities.take( layer );
+
+  if ( QgsChunkedEntity *chunkedEntity = qobject_cast<QgsChunkedEntity *>( entity ) )
+  {
+    mChunkEntities.removeOne( chunkedEntity );
+  }
+
   if ( entity )
     entity->deleteLater();
 
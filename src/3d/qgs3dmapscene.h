@@ -41,6 +41,7 @@ class QgsAbstract3DEngine;
 class QgsAbstract3DRenderer;
 class QgsMapLayer;
 class QgsCameraController;
+class QgsCameraPose;
 class Qgs3DMapScenePickHandler;
 class Qgs3DMapSettings;
 class QgsTerrainEntity;
@@ -90,6 +91,14 @@ class _3D_EXPORT Qgs3DMapScene : public Qt3DCore::QEntity
      */
     float worldSpaceError( float epsilon, float distance );
 
+    /**
+     * Requests loading of the data needed to render the scene from the given camera \a pose,
+     * e.g. the pose of an animation that is going to be reached soon. The data are loaded in
+     * background with lower priority than the data of the current view.
+     * \since QGIS 3.12
+     */
+    void prefetch( const QgsCameraPose &pose );
+
   signals:
     //! Emitted when the current terrain entity is replaced by a new one
     void terrainEntityChanged();
@@ -110,6 +119,7 @@ class _3D_EXPORT Qgs3DMapScene : public Qt3DCore::QEntity
     void updateLights();
     void updateCameraLens();
     void onRenderersChanged();
+    void onTriangulationAlgorithmChanged();
   private:
     void addLayerEntity( QgsMapLayer *layer );
     void removeLayerEntity( QgsMapLayer *layer );
@@ -54,6 +54,7 @@ Qgs3DMapSettings::Qgs3DMapSettings( const Qgs3DMapSettings &other )
   , mTransformContext( other.mTransformContext )
   , mPathResolver( other.mPathResolver )
   , mMapThemes( other.mMapThemes )
+  , mTriangulationAlgorithm( other.mTriangulationAlgorithm )
 {
   Q_FOREACH ( QgsAbstract3DRenderer *renderer, other.mRenderers )
   {
@@ -190,6 +191,9 @@ void Qgs3DMapSettings::readXml( const QDomElement &elem, const QgsReadWriteConte
   mShowTerrainBoundingBoxes = elemDebug.attribute( QStringLiteral( "bounding-boxes" ), QStringLiteral( "0" ) ).toInt();
   mShowTerrainTileInfo = elemDebug.attribute( QStringLiteral( "terrain-tile-info" ), QStringLiteral( "0" ) ).toInt();
   mShowCameraViewCenter = elemDebug.attribute( QStringLiteral( "camera-view-center" ), QStringLiteral( "0" ) ).toInt();
+
+  QDomElement elemTessellation = elem.firstChildElement( QStringLiteral( "tessellation" ) );
+  mTriangulationAlgorithm = elemTessellation.attribute( QStringLiteral( "algorithm" ) ) == QLatin1String( "earcut" ) ? QgsTessellator::Earcut : QgsTessellator::ConstrainedDelaunay;
 }
 
 QDomElement Qgs3DMapSettings::writeXml( QDomDocument &doc, const QgsReadWriteContext &context ) const
@@ -272,6 +276,10 @@ QDomElement Qgs3DMapSettings::writeXml( QDomDocument &doc, const QgsReadWriteCon
   elemDebug.setAttribute( QStringLiteral( "camera-view-center" ), mShowCameraViewCenter ? 1 : 0 );
   elem.appendChild( elemDebug );
 
+  QDomElement elemTessellation = doc.createElement( QStringLiteral( "tessellation" ) );
+  elemTessellation.setAttribute( QStringLiteral( "algorithm" ), mTriangulationAlgorithm == QgsTessellator::Earcut ? QStringLiteral( "earcut" ) : QStringLiteral( "delaunay" ) );
+  elem.appendChild( elemTessellation );
+
   return elem;
 }
 
@@ -516,6 +524,15 @@ void Qgs3DMapSettings::setPointLights( const QList<QgsPointLightSettings> &point
   emit pointLightsChanged();
 }
 
+void Qgs3DMapSettings::setTriangulationAlgorithm( QgsTessellator::TriangulationAlgorithm algorithm )
+{
+  if ( mTriangulationAlgorithm == algorithm )
+    return;
+
+  mTriangulationAlgorithm = algorithm;
+  emit triangulationAlgorithmChanged();
+}
+
 void Qgs3DMapSettings::setFieldOfView( const float fieldOfView )
 {
   if ( mFieldOfView == fieldOfView )
@@ -27,6 +27,7 @@
 #include "qgsphongmaterialsettings.h"
 #include "qgspointlightsettings.h"
 #include "qgsterraingenerator.h"
+#include "qgstessellator.h"
 #include "qgsvector3d.h"
 
 class QgsMapLayer;
@@ -355,6 +356,21 @@ class _3D_EXPORT Qgs3DMapSettings : public QObject
      */
     double outputDpi() const { return mDpi; }
 
+    /**
+     * Returns the algorithm used to triangulate polygons of vector layers (e.g. extruded polygons and buffered lines)
+     * \see setTriangulationAlgorithm()
+     * \since QGIS 3.12
+     */
+    QgsTessellator::TriangulationAlgorithm triangulationAlgorithm() const { return mTriangulationAlgorithm; }
+
+    /**
+     * Sets the \a algorithm used to triangulate polygons of vector layers (e.g. extruded polygons and buffered lines).
+     * Ear clipping is significantly faster for layers with many or complex polygons.
+     * \see triangulationAlgorithm()
+     * \since QGIS 3.12
+     */
+    void setTriangulationAlgorithm( QgsTessellator::TriangulationAlgorithm algorithm );
+
   signals:
     //! Emitted when the background color has changed
     void backgroundColorChanged();
@@ -416,6 +432,12 @@ class _3D_EXPORT Qgs3DMapSettings : public QObject
      */
     void fieldOfViewChanged();
 
+    /**
+     * Emitted when the algorithm used to triangulate polygons changes
+     * \since QGIS 3.12
+     */
+    void triangulationAlgorithmChanged();
+
   private:
     //! Offset in map CRS coordinates at which our 3D world has origin (0,0,0)
     QgsVector3D mOrigin;
@@ -446,6 +468,7 @@ class _3D_EXPORT Qgs3DMapSettings : public QObject
     QgsPathResolver mPathResolver;
     QgsMapThemeCollection *mMapThemes = nullptr;   //!< Pointer to map themes (e.g. from the current project) to resolve map theme content from the name
     double mDpi = 96;  //!< Dot per inch value for the screen / painter
+    QgsTessellator::TriangulationAlgorithm mTriangulationAlgorithm = QgsTessellator::ConstrainedDelaunay;  //!< Triangulation of polygons of vector layers
 };
 
 
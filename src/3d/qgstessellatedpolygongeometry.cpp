@@ -63,16 +63,27 @@ void QgsTessellatedPolygonGeometry::setPolygons( const QList<QgsPolygon *> &poly
   mTriangleIndexFids.reserve( polygons.count() );
 
   QgsTessellator tessellator( origin.x(), origin.y(), mWithNormals, mInvertNormals, mAddBackFaces );
+  tessellator.setTriangulationAlgorithm( mTriangulationAlgorithm );
+
+  QVector<const QgsPolygon *> polygonsToTessellate;
+  polygonsToTessellate.reserve( polygons.count() );
+  for ( const QgsPolygon *polygon : polygons )
+    polygonsToTessellate << polygon;
+
+  QVector<float> extrusionHeights;
+  extrusionHeights.reserve( polygons.count() );
+  for ( int i = 0; i < polygons.count(); ++i )
+    extrusionHeights << ( extrusionHeightPerPolygon.isEmpty() ? extrusionHeight : extrusionHeightPerPolygon.at( i ) );
+
+  // polygons get tessellated in parallel, output vertices are in the order of input polygons
+  QVector<int> startingVertexIndices;
+  tessellator.addPolygons( polygonsToTessellate, extrusionHeights, &startingVertexIndices );
+
   for ( int i = 0; i < polygons.count(); ++i )
   {
-    Q_ASSERT( tessellator.dataVerticesCount() % 3 == 0 );
-    uint startingTriangleIndex = static_cast<uint>( tessellator.dataVerticesCount() / 3 );
-    mTriangleIndexStartingIndices.append( startingTriangleIndex );
+    Q_ASSERT( startingVertexIndices.at( i ) % 3 == 0 );
+    mTriangleIndexStartingIndices.append( static_cast<uint>( startingVertexIndices.at( i ) / 3 ) );
     mTriangleIndexFids.append( featureIds[i] );
-
-    QgsPolygon *polygon = polygons.at( i );
-    float extr = extrusionHeightPerPolygon.isEmpty() ? extrusionHeight : extrusionHeightPerPolygon.at( i );
-    tessellator.addPolygon( *polygon, extr );
   }
 
   qDeleteAll( polygons );
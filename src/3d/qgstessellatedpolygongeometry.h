@@ -18,6 +18,7 @@
 
 #include "qgsfeatureid.h"
 #include "qgspolygon.h"
+#include "qgstessellator.h"
 
 #include <Qt3DRender/QGeometry>
 
@@ -59,6 +60,19 @@ class QgsTessellatedPolygonGeometry : public Qt3DRender::QGeometry
      */
     void setAddBackFaces( bool add ) { mAddBackFaces = add; }
 
+    /**
+     * Returns the algorithm used to triangulate polygons
+     * \since QGIS 3.12
+     */
+    QgsTessellator::TriangulationAlgorithm triangulationAlgorithm() const { return mTriangulationAlgorithm; }
+
+    /**
+     * Sets the algorithm used to triangulate polygons. Ear clipping is considerably faster than the default
+     * constrained Delaunay triangulation and copes better with degenerate input, at the expense of less regular triangles.
+     * \since QGIS 3.12
+     */
+    void setTriangulationAlgorithm( QgsTessellator::TriangulationAlgorithm algorithm ) { mTriangulationAlgorithm = algorithm; }
+
     //! Initializes vertex buffer from given polygons. Takes ownership of passed polygon geometries
     void setPolygons( const QList<QgsPolygon *> &polygons, const QList<QgsFeatureId> &featureIds, const QgsPointXY &origin, float extrusionHeight, const QList<float> &extrusionHeightPerPolygon = QList<float>() );
 
@@ -77,6 +91,7 @@ class QgsTessellatedPolygonGeometry : public Qt3DRender::QGeometry
     bool mWithNormals = true;
     bool mInvertNormals = false;
     bool mAddBackFaces = false;
+    QgsTessellator::TriangulationAlgorithm mTriangulationAlgorithm = QgsTessellator::ConstrainedDelaunay;
 };
 
 #endif // QGSTESSELLATEDPOLYGONGEOMETRY_H
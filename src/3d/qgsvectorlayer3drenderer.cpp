@@ -21,6 +21,7 @@
 #include "qgsline3dsymbol_p.h"
 #include "qgspoint3dsymbol_p.h"
 #include "qgspolygon3dsymbol_p.h"
+#include "qgsvectorlayerchunkloader_p.h"
 
 #include "qgsvectorlayer.h"
 #include "qgsxmlutils.h"
@@ -81,6 +82,10 @@ Qt3DCore::QEntity *QgsVectorLayer3DRenderer::createEntity( const Qgs3DMapSetting
   if ( !mSymbol || !vl )
     return nullptr;
 
+  // polygons and lines are loaded by tiles in background threads, so that large layers do not block the scene
+  if ( QgsVectorLayerChunkedEntity::isSupported( mSymbol.get() ) )
+    return new QgsVectorLayerChunkedEntity( vl, mSymbol->clone(), map );
+
   if ( mSymbol->type() == QLatin1String( "polygon" ) )
     return Qgs3DSymbolImpl::entityForPolygon3DSymbol( map, vl, *static_cast<QgsPolygon3DSymbol *>( mSymbol.get() ) );
   else if ( mSymbol->type() == QLatin1String( "point" ) )
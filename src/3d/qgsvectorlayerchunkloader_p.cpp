@@ -0,0 +1,305 @@
+/***************************************************************************
+  qgsvectorlayerchunkloader_p.cpp
+  --------------------------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by the QGIS project
+  Email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsvectorlayerchunkloader_p.h"
+
+#include "qgs3dmapsettings.h"
+#include "qgs3dutils.h"
+#include "qgschunknode_p.h"
+#include "qgseventtracing.h"
+#include "qgsexception.h"
+#include "qgsline3dsymbol.h"
+#include "qgsline3dsymbol_p.h"
+#include "qgslogger.h"
+#include "qgspolygon3dsymbol.h"
+#include "qgspolygon3dsymbol_p.h"
+#include "qgsterraingenerator.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectorlayerfeatureiterator.h"
+
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
+
+///@cond PRIVATE
+
+//! Approximate number of features in a tile of the leaf level
+static const double FEATURES_PER_LEAF_TILE = 4000;
+
+//! Maximum depth of the quadtree of tiles
+static const int MAX_LEAF_LEVEL = 8;
+
+
+QgsVectorLayerChunkLoader::QgsVectorLayerChunkLoader( const QgsVectorLayerChunkLoaderFactory *factory, QgsChunkNode *node )
+  : QgsChunkLoader( node )
+  , mFactory( factory )
+  , mContext( factory->mMap )
+  , mSource( new QgsVectorLayerFeatureSource( factory->mLayer ) )
+{
+  QgsVectorLayer *layer = mFactory->mLayer;
+  const Qgs3DMapSettings &map = mFactory->mMap;
+
+  mHandler.reset( mFactory->createHandler() );
+
+  QgsExpressionContext exprContext( Qgs3DUtils::globalProjectLayerExpressionContext( layer ) );
+  exprContext.setFields( layer->fields() );
+  mContext.setExpressionContext( exprContext );
+
+  QSet<QString> attributeNames;
+  if ( !mHandler || !mHandler->prepare( mContext, attributeNames ) )
+  {
+    QgsDebugMsg( QStringLiteral( "Failed to prepare 3D feature handler!" ) );
+    mHandler.reset();
+    // there is nothing to load - report back once the control returns to the event loop
+    QTimer::singleShot( 0, this, &QgsChunkQueueJob::finished );
+    return;
+  }
+
+  const int tileX = node->tileX();
+  const int tileY = node->tileY();
+  const int level = node->tileZ();
+  const QgsRectangle rootExtent = mFactory->mExtent;
+  const QgsRectangle extent = mFactory->tileExtent( tileX, tileY, level );
+  const int tilesPerSide = 1 << level;
+
+  // tiles above the leaf level only contain the features which are larger than their error
+  const double minimumFeatureSize = level < mFactory->mLeafLevel ? node->error() : 0;
+
+  // build the feature request
+  QgsFeatureRequest req;
+  req.setDestinationCrs( map.crs(), map.transformContext() );
+  req.setSubsetOfAttributes( attributeNames, layer->fields() );
+  req.setFilterRect( extent );
+
+  //
+  // this will be run in a background thread
+  //
+  QFuture<void> future = QtConcurrent::run( [req, rootExtent, tileX, tileY, tilesPerSide, minimumFeatureSize, this]
+  {
+    QgsEventTracing::ScopedEvent e( QStringLiteral( "3D" ), QStringLiteral( "VL chunk load" ) );
+
+    const double tileWidth = rootExtent.width() / tilesPerSide;
+    const double tileHeight = rootExtent.height() / tilesPerSide;
+
+    QgsFeature f;
+    QgsFeatureIterator fi = mSource->getFeatures( req );
+    while ( fi.nextFeature( f ) )
+    {
+      if ( mCanceled )
+        break;
+
+      if ( !f.hasGeometry() )
+        continue;
+
+      // a feature may intersect several tiles - only handle it in the tile which contains the center of its bounding box
+      const QgsRectangle bbox = f.geometry().boundingBox();
+      const QgsPointXY center = bbox.center();
+      const int col = qBound( 0, static_cast< int >( std::floor( ( center.x() - rootExtent.xMinimum() ) / tileWidth ) ), tilesPerSide - 1 );
+      const int row = qBound( 0, static_cast< int >( std::floor( ( center.y() - rootExtent.yMinimum() ) / tileHeight ) ), tilesPerSide - 1 );
+      if ( col != tileX || row != tileY )
+        continue;
+
+      ++mFeatureCount;
+      if ( std::max( bbox.width(), bbox.height() ) < minimumFeatureSize )
+        continue;
+
+      ++mHandledFeatureCount;
+      mContext.expressionContext().setFeature( f );
+      mHandler->processFeature( f, mContext );
+    }
+  } );
+
+  // emit finished() as soon as the handler is populated with features
+  mFutureWatcher = new QFutureWatcher<void>( this );
+  mFutureWatcher->setFuture( future );
+  connect( mFutureWatcher, &QFutureWatcher<void>::finished, this, &QgsChunkQueueJob::finished );
+}
+
+QgsVectorLayerChunkLoader::~QgsVectorLayerChunkLoader()
+{
+  if ( mFutureWatcher && !mFutureWatcher->isFinished() )
+  {
+    disconnect( mFutureWatcher, &QFutureWatcher<void>::finished, this, &QgsChunkQueueJob::finished );
+    mCanceled = true;
+    mFutureWatcher->waitForFinished();
+  }
+}
+
+void QgsVectorLayerChunkLoader::cancel()
+{
+  mCanceled = true;
+  if ( mFutureWatcher )
+  {
+    disconnect( mFutureWatcher, &QFutureWatcher<void>::finished, this, &QgsChunkQueueJob::finished );
+    mFutureWatcher->waitForFinished();
+  }
+}
+
+Qt3DCore::QEntity *QgsVectorLayerChunkLoader::createEntity( Qt3DCore::QEntity *parent )
+{
+  // no features in this tile or any of its descendants: the node will not be loaded again
+  if ( !mHandler || mFeatureCount == 0 )
+    return nullptr;
+
+  // returning NULLPTR for a tile above the leaf level would also stop loading of its children,
+  // so an empty entity is used when all its features were left for the more detailed levels
+  Qt3DCore::QEntity *entity = new Qt3DCore::QEntity( parent );
+  if ( mHandledFeatureCount > 0 )
+    mHandler->finalize( entity, mContext );
+  return entity;
+}
+
+
+///////////////
+
+
+QgsVectorLayerChunkLoaderFactory::QgsVectorLayerChunkLoaderFactory( const Qgs3DMapSettings &map, QgsVectorLayer *vl, QgsAbstract3DSymbol *symbol, const QgsRectangle &extent, int leafLevel )
+  : mMap( map )
+  , mLayer( vl )
+  , mSymbol( symbol )
+  , mExtent( extent )
+  , mLeafLevel( leafLevel )
+{
+}
+
+QgsVectorLayerChunkLoaderFactory::~QgsVectorLayerChunkLoaderFactory() = default;
+
+QgsChunkLoader *QgsVectorLayerChunkLoaderFactory::createChunkLoader( QgsChunkNode *node ) const
+{
+  return new QgsVectorLayerChunkLoader( this, node );
+}
+
+QgsFeature3DHandler *QgsVectorLayerChunkLoaderFactory::createHandler() const
+{
+  if ( mSymbol->type() == QLatin1String( "polygon" ) )
+    return Qgs3DSymbolImpl::handlerForPolygon3DSymbol( mLayer, *static_cast<QgsPolygon3DSymbol *>( mSymbol.get() ) );
+  else if ( mSymbol->type() == QLatin1String( "line" ) )
+    return Qgs3DSymbolImpl::handlerForLine3DSymbol( mLayer, *static_cast<QgsLine3DSymbol *>( mSymbol.get() ) );
+  else
+    return nullptr;
+}
+
+QgsRectangle QgsVectorLayerChunkLoaderFactory::tileExtent( int tileX, int tileY, int tileZ ) const
+{
+  const int tilesPerSide = 1 << tileZ;
+  const double tileWidth = mExtent.width() / tilesPerSide;
+  const double tileHeight = mExtent.height() / tilesPerSide;
+  return QgsRectangle( mExtent.xMinimum() + tileX * tileWidth, mExtent.yMinimum() + tileY * tileHeight,
+                       mExtent.xMinimum() + ( tileX + 1 ) * tileWidth, mExtent.yMinimum() + ( tileY + 1 ) * tileHeight );
+}
+
+
+///////////////
+
+
+//! Returns extent of the layer in map coordinates
+static QgsRectangle layerExtent( QgsVectorLayer *vl, const Qgs3DMapSettings &map )
+{
+  QgsRectangle extent = vl->extent();
+  if ( vl->crs() != map.crs() )
+  {
+    QgsCoordinateTransform layerToMapTransform( vl->crs(), map.crs(), map.transformContext() );
+    try
+    {
+      extent = layerToMapTransform.transformBoundingBox( extent );
+    }
+    catch ( QgsCsException & )
+    {
+      QgsDebugMsg( QStringLiteral( "Could not transform layer extent to the map CRS" ) );
+      extent = QgsRectangle();
+    }
+  }
+  if ( extent.isEmpty() )
+  {
+    // make sure that even a layer with a single point has got a tile with non-zero size
+    extent = QgsRectangle( extent.xMinimum() - 1, extent.yMinimum() - 1, extent.xMaximum() + 1, extent.yMaximum() + 1 );
+  }
+  return extent;
+}
+
+//! Returns the range of heights of the features relative to the terrain, without data defined overrides
+static void symbolHeightRange( const QgsAbstract3DSymbol *symbol, float &zMin, float &zMax )
+{
+  float height = 0, extrusion = 0;
+  if ( symbol->type() == QLatin1String( "polygon" ) )
+  {
+    height = static_cast<const QgsPolygon3DSymbol *>( symbol )->height();
+    extrusion = static_cast<const QgsPolygon3DSymbol *>( symbol )->extrusionHeight();
+  }
+  else if ( symbol->type() == QLatin1String( "line" ) )
+  {
+    height = static_cast<const QgsLine3DSymbol *>( symbol )->height();
+    extrusion = static_cast<const QgsLine3DSymbol *>( symbol )->extrusionHeight();
+  }
+  zMin = std::min( height, height + extrusion );
+  zMax = std::max( height, height + extrusion );
+}
+
+static QgsAABB rootBbox( const QgsRectangle &extent, const QgsAbstract3DSymbol *symbol, const Qgs3DMapSettings &map )
+{
+  float terrainMin = 0, terrainMax = 0;
+  if ( map.terrainGenerator() )
+  {
+    QgsAABB terrainBbox = map.terrainGenerator()->rootChunkBbox( map );
+    terrainMin = terrainBbox.yMin;
+    terrainMax = terrainBbox.yMax;
+  }
+
+  float zMin, zMax;
+  symbolHeightRange( symbol, zMin, zMax );
+
+  return QgsAABB( extent.xMinimum() - map.origin().x(), terrainMin + zMin, -extent.yMaximum() + map.origin().y(),
+                  extent.xMaximum() - map.origin().x(), terrainMax + zMax, -extent.yMinimum() + map.origin().y() );
+}
+
+int QgsVectorLayerChunkedEntity::leafLevel( const QgsVectorLayer *vl )
+{
+  const long featureCount = vl->featureCount();
+  if ( featureCount <= 0 )
+    return 0;  // empty layer or unknown count - a single tile
+
+  const double level = std::ceil( std::log( featureCount / FEATURES_PER_LEAF_TILE ) / std::log( 4. ) );
+  return qBound( 0, static_cast< int >( level ), MAX_LEAF_LEVEL );
+}
+
+QgsVectorLayerChunkedEntity::QgsVectorLayerChunkedEntity( QgsVectorLayer *vl, QgsAbstract3DSymbol *symbol, const Qgs3DMapSettings &map )
+  : QgsVectorLayerChunkedEntity( vl, symbol, map, layerExtent( vl, map ), leafLevel( vl ) )
+{
+}
+
+QgsVectorLayerChunkedEntity::QgsVectorLayerChunkedEntity( QgsVectorLayer *vl, QgsAbstract3DSymbol *symbol, const Qgs3DMapSettings &map, const QgsRectangle &extent, int leafLevel )
+  : QgsChunkedEntity( rootBbox( extent, symbol, map ),
+                      // the root tile omits features smaller than 1/16 of the extent
+                      std::max( extent.width(), extent.height() ) / 16,
+                      map.maxTerrainScreenError(),
+                      leafLevel,
+                      new QgsVectorLayerChunkLoaderFactory( map, vl, symbol, extent, leafLevel ) )
+{
+  setShowBoundingBoxes( map.showTerrainBoundingBoxes() );
+}
+
+QgsVectorLayerChunkedEntity::~QgsVectorLayerChunkedEntity()
+{
+  // cancel / wait for jobs
+  cancelActiveJobs();
+
+  delete mChunkLoaderFactory;
+}
+
+bool QgsVectorLayerChunkedEntity::isSupported( const QgsAbstract3DSymbol *symbol )
+{
+  return symbol && ( symbol->type() == QLatin1String( "polygon" ) || symbol->type() == QLatin1String( "line" ) );
+}
+
+/// @endcond
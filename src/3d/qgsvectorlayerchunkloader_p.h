@@ -0,0 +1,151 @@
+/***************************************************************************
+  qgsvectorlayerchunkloader_p.h
+  --------------------------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by the QGIS project
+  Email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSVECTORLAYERCHUNKLOADER_P_H
+#define QGSVECTORLAYERCHUNKLOADER_P_H
+
+///@cond PRIVATE
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QGIS API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+
+#include "qgis_3d.h"
+#include "qgschunkedentity_p.h"
+#include "qgschunkloader_p.h"
+#include "qgsfeature3dhandler_p.h"
+#include "qgsrectangle.h"
+
+#include <memory>
+#include <atomic>
+
+#include <QFutureWatcher>
+
+class Qgs3DMapSettings;
+class QgsAbstract3DSymbol;
+class QgsVectorLayer;
+class QgsVectorLayerFeatureSource;
+
+class QgsVectorLayerChunkLoaderFactory;
+
+
+/**
+ * \ingroup 3d
+ * This loader class is responsible for async loading of data for a single tile of vector layer chunk entity.
+ *
+ * Features are fetched with a filter rectangle of the tile and passed to the symbol's 3D handler in a worker
+ * thread. Each feature is handled only by the tile which contains the center of its bounding box. Tiles above
+ * the leaf level only include features larger than the geometric error of the tile, so that coarse tiles
+ * omit the features which would not be visible from the distance at which they are rendered.
+ *
+ * \since QGIS 3.12
+ */
+class QgsVectorLayerChunkLoader : public QgsChunkLoader
+{
+    Q_OBJECT
+  public:
+    //! Constructs the loader
+    QgsVectorLayerChunkLoader( const QgsVectorLayerChunkLoaderFactory *factory, QgsChunkNode *node );
+    ~QgsVectorLayerChunkLoader() override;
+
+    void cancel() override;
+    Qt3DCore::QEntity *createEntity( Qt3DCore::QEntity *parent ) override;
+
+  private:
+    const QgsVectorLayerChunkLoaderFactory *mFactory = nullptr;
+    std::unique_ptr<QgsFeature3DHandler> mHandler;
+    Qgs3DRenderContext mContext;
+    std::unique_ptr<QgsVectorLayerFeatureSource> mSource;
+    //! Number of features within the tile, including those omitted at this level of detail
+    int mFeatureCount = 0;
+    //! Number of features passed to the handler
+    int mHandledFeatureCount = 0;
+    std::atomic<bool> mCanceled{ false };
+    QFutureWatcher<void> *mFutureWatcher = nullptr;
+};
+
+
+/**
+ * \ingroup 3d
+ * Factory for vector layer chunk loaders
+ * \since QGIS 3.12
+ */
+class QgsVectorLayerChunkLoaderFactory : public QgsChunkLoaderFactory
+{
+  public:
+    //! Constructs the factory. Takes ownership of the \a symbol
+    QgsVectorLayerChunkLoaderFactory( const Qgs3DMapSettings &map, QgsVectorLayer *vl, QgsAbstract3DSymbol *symbol, const QgsRectangle &extent, int leafLevel );
+    ~QgsVectorLayerChunkLoaderFactory() override;
+
+    QgsChunkLoader *createChunkLoader( QgsChunkNode *node ) const override;
+
+    //! Returns a new 3D handler for the factory's symbol, or NULLPTR if the symbol is not supported
+    QgsFeature3DHandler *createHandler() const;
+
+    //! Returns the extent of the given tile in map coordinates
+    QgsRectangle tileExtent( int tileX, int tileY, int tileZ ) const;
+
+    const Qgs3DMapSettings &mMap;
+    QgsVectorLayer *mLayer = nullptr;
+    std::unique_ptr<QgsAbstract3DSymbol> mSymbol;
+    //! Extent of the root tile in map coordinates
+    QgsRectangle mExtent;
+    //! Level of the tiles which contain all features
+    int mLeafLevel = 0;
+};
+
+
+/**
+ * \ingroup 3d
+ * 3D entity used for rendering of vector layers using a single 3D symbol.
+ *
+ * The layer is split into a quadtree of tiles which are loaded in background threads when needed,
+ * based on the screen space error of the tiles, and unloaded when they are no longer used.
+ *
+ * \since QGIS 3.12
+ */
+class _3D_EXPORT QgsVectorLayerChunkedEntity : public QgsChunkedEntity
+{
+    Q_OBJECT
+  public:
+    //! Constructs the entity. Takes ownership of the \a symbol
+    explicit QgsVectorLayerChunkedEntity( QgsVectorLayer *vl, QgsAbstract3DSymbol *symbol, const Qgs3DMapSettings &map );
+    ~QgsVectorLayerChunkedEntity() override;
+
+    /**
+     * Returns TRUE if features of the \a symbol can be loaded by tiles. Point symbols
+     * are rendered by a single instanced or billboard entity and are not tiled.
+     */
+    static bool isSupported( const QgsAbstract3DSymbol *symbol );
+
+    /**
+     * Returns the level of the tiles which contain all features of the layer \a vl, chosen
+     * so that each leaf tile has roughly 4000 features. Layers which are empty or have an
+     * unknown feature count use a single tile.
+     */
+    static int leafLevel( const QgsVectorLayer *vl );
+
+  private:
+    QgsVectorLayerChunkedEntity( QgsVectorLayer *vl, QgsAbstract3DSymbol *symbol, const Qgs3DMapSettings &map, const QgsRectangle &extent, int leafLevel );
+};
+
+/// @endcond
+
+#endif // QGSVECTORLAYERCHUNKLOADER_P_H
@@ -163,6 +163,7 @@ void QgsBufferedLine3DSymbolHandler::makeEntity( Qt3DCore::QEntity *parent, cons
 
   QgsPointXY origin( context.map().origin().x(), context.map().origin().y() );
   QgsTessellatedPolygonGeometry *geometry = new QgsTessellatedPolygonGeometry;
+  geometry->setTriangulationAlgorithm( context.map().triangulationAlgorithm() );
   geometry->setPolygons( out.polygons, out.fids, origin, mSymbol.extrusionHeight() );
 
   Qt3DRender::QGeometryRenderer *renderer = new Qt3DRender::QGeometryRenderer;
@@ -38,9 +38,16 @@
 #include <Qt3DExtras/QExtrudedTextGeometry>
 #endif
 
+#include <QCache>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
 #include <QUrl>
 #include <QVector3D>
 
+#include <algorithm>
+
 #include "qgspoint3dsymbol.h"
 #include "qgs3dmapsettings.h"
 
@@ -57,6 +64,31 @@
 /// @cond PRIVATE
 
 
+//! Returns per-instance attribute with positions of the instances
+static Qt3DRender::QAttribute *instancePositionAttribute( const QVector<QVector3D> &positions )
+{
+  int count = positions.count();
+  int byteCount = positions.count() * sizeof( QVector3D );
+  QByteArray ba;
+  ba.resize( byteCount );
+  memcpy( ba.data(), positions.constData(), byteCount );
+
+  Qt3DRender::QBuffer *instanceBuffer = new Qt3DRender::QBuffer( Qt3DRender::QBuffer::VertexBuffer );
+  instanceBuffer->setData( ba );
+
+  Qt3DRender::QAttribute *instanceDataAttribute = new Qt3DRender::QAttribute;
+  instanceDataAttribute->setName( QStringLiteral( "pos" ) );
+  instanceDataAttribute->setAttributeType( Qt3DRender::QAttribute::VertexAttribute );
+  instanceDataAttribute->setVertexBaseType( Qt3DRender::QAttribute::Float );
+  instanceDataAttribute->setVertexSize( 3 );
+  instanceDataAttribute->setDivisor( 1 );
+  instanceDataAttribute->setBuffer( instanceBuffer );
+  instanceDataAttribute->setCount( count );
+  instanceDataAttribute->setByteStride( 3 * sizeof( float ) );
+  return instanceDataAttribute;
+}
+
+
 //* INSTANCED RENDERING *//
 
 
@@ -70,9 +102,14 @@ class QgsInstancedPoint3DSymbolHandler : public QgsFeature3DHandler
     void processFeature( QgsFeature &feature, const Qgs3DRenderContext &context ) override;
     void finalize( Qt3DCore::QEntity *parent, const Qgs3DRenderContext &context ) override;
 
+    //! Returns material for instanced rendering of the symbol (also used for instanced 3D models)
+    static Qt3DRender::QMaterial *material( const QgsPoint3DSymbol &symbol );
+
+    //! Updates the instanced material with selection colors
+    static void setSelectionColors( Qt3DRender::QMaterial *material, const Qgs3DMapSettings &map );
+
   private:
 
-    static Qt3DRender::QMaterial *material( const QgsPoint3DSymbol &symbol );
     static Qt3DRender::QGeometryRenderer *renderer( const QgsPoint3DSymbol &symbol, const QVector<QVector3D> &positions );
     static Qt3DRender::QGeometry *symbolGeometry( QgsPoint3DSymbol::Shape shape, const QVariantMap &shapeProperties );
 
@@ -126,13 +163,7 @@ void QgsInstancedPoint3DSymbolHandler::makeEntity( Qt3DCore::QEntity *parent, co
   if ( selected )
   {
     // update the material with selection colors
-    for ( Qt3DRender::QParameter *param : mat->effect()->parameters() )
-    {
-      if ( param->name() == QLatin1String( "kd" ) ) // diffuse
-        param->setValue( context.map().selectionColor() );
-      else if ( param->name() == QLatin1String( "ka" ) ) // ambient
-        param->setValue( context.map().selectionColor().darker() );
-    }
+    setSelectionColors( mat, context.map() );
   }
 
   // build the entity
@@ -144,6 +175,17 @@ void QgsInstancedPoint3DSymbolHandler::makeEntity( Qt3DCore::QEntity *parent, co
 
 
 
+void QgsInstancedPoint3DSymbolHandler::setSelectionColors( Qt3DRender::QMaterial *material, const Qgs3DMapSettings &map )
+{
+  for ( Qt3DRender::QParameter *param : material->effect()->parameters() )
+  {
+    if ( param->name() == QLatin1String( "kd" ) ) // diffuse
+      param->setValue( map.selectionColor() );
+    else if ( param->name() == QLatin1String( "ka" ) ) // ambient
+      param->setValue( map.selectionColor().darker() );
+  }
+}
+
 Qt3DRender::QMaterial *QgsInstancedPoint3DSymbolHandler::material( const QgsPoint3DSymbol &symbol )
 {
   Qt3DRender::QFilterKey *filterKey = new Qt3DRender::QFilterKey;
@@ -215,24 +257,7 @@ Qt3DRender::QMaterial *QgsInstancedPoint3DSymbolHandler::material( const QgsPoin
 
 Qt3DRender::QGeometryRenderer *QgsInstancedPoint3DSymbolHandler::renderer( const QgsPoint3DSymbol &symbol, const QVector<QVector3D> &positions )
 {
-  int count = positions.count();
-  int byteCount = positions.count() * sizeof( QVector3D );
-  QByteArray ba;
-  ba.resize( byteCount );
-  memcpy( ba.data(), positions.constData(), byteCount );
-
-  Qt3DRender::QBuffer *instanceBuffer = new Qt3DRender::QBuffer( Qt3DRender::QBuffer::VertexBuffer );
-  instanceBuffer->setData( ba );
-
-  Qt3DRender::QAttribute *instanceDataAttribute = new Qt3DRender::QAttribute;
-  instanceDataAttribute->setName( QStringLiteral( "pos" ) );
-  instanceDataAttribute->setAttributeType( Qt3DRender::QAttribute::VertexAttribute );
-  instanceDataAttribute->setVertexBaseType( Qt3DRender::QAttribute::Float );
-  instanceDataAttribute->setVertexSize( 3 );
-  instanceDataAttribute->setDivisor( 1 );
-  instanceDataAttribute->setBuffer( instanceBuffer );
-  instanceDataAttribute->setCount( count );
-  instanceDataAttribute->setByteStride( 3 * sizeof( float ) );
+  Qt3DRender::QAttribute *instanceDataAttribute = instancePositionAttribute( positions );
 
   Qt3DRender::QGeometry *geometry = symbolGeometry( symbol.shape(), symbol.shapeProperties() );
   geometry->addAttribute( instanceDataAttribute );
@@ -240,7 +265,7 @@ Qt3DRender::QGeometryRenderer *QgsInstancedPoint3DSymbolHandler::renderer( const
 
   Qt3DRender::QGeometryRenderer *renderer = new Qt3DRender::QGeometryRenderer;
   renderer->setGeometry( geometry );
-  renderer->setInstanceCount( count );
+  renderer->setInstanceCount( positions.count() );
 
   return renderer;
 }
@@ -333,6 +358,122 @@ Qt3DRender::QGeometry *QgsInstancedPoint3DSymbolHandler::symbolGeometry( QgsPoin
 //* 3D MODEL RENDERING *//
 
 
+QByteArray Qgs3DSymbolImpl::readObjModel( const QString &path )
+{
+  QFile file( path );
+  if ( !file.open( QIODevice::ReadOnly | QIODevice::Text ) )
+    return QByteArray();
+
+  QVector<QVector3D> positions;
+  QVector<QVector3D> normals;
+  QVector<float> data;
+
+  while ( !file.atEnd() )
+  {
+    const QList<QByteArray> tokens = file.readLine().simplified().split( ' ' );
+    const QByteArray &type = tokens.at( 0 );
+    if ( type == "v" || type == "vn" )
+    {
+      if ( tokens.size() < 4 )
+        return QByteArray();
+
+      bool okX = false, okY = false, okZ = false;
+      const QVector3D vector( tokens.at( 1 ).toFloat( &okX ), tokens.at( 2 ).toFloat( &okY ), tokens.at( 3 ).toFloat( &okZ ) );
+      if ( !okX || !okY || !okZ )
+        return QByteArray();
+
+      if ( type == "v" )
+        positions.append( vector );
+      else
+        normals.append( vector );
+    }
+    else if ( type == "f" )
+    {
+      if ( tokens.size() < 4 )
+        return QByteArray();
+
+      // indexes of position and normal of the face vertices (normal is -1 if not set)
+      QVector<QPair<int, int>> face;
+      for ( int i = 1; i < tokens.size(); ++i )
+      {
+        const QList<QByteArray> indexes = tokens.at( i ).split( '/' );
+        bool ok = false;
+        int position = indexes.at( 0 ).toInt( &ok );
+        if ( !ok )
+          return QByteArray();
+        // indexes are 1-based, negative indexes are relative to the end
+        position = position < 0 ? positions.size() + position : position - 1;
+
+        int normal = -1;
+        if ( indexes.size() >= 3 && !indexes.at( 2 ).isEmpty() )
+        {
+          normal = indexes.at( 2 ).toInt( &ok );
+          if ( !ok )
+            return QByteArray();
+          normal = normal < 0 ? normals.size() + normal : normal - 1;
+          if ( normal < 0 )
+            return QByteArray();
+        }
+
+        if ( position < 0 || position >= positions.size() || normal >= normals.size() )
+          return QByteArray();
+        face.append( qMakePair( position, normal ) );
+      }
+
+      // faces are convex polygons, so they can be split to a triangle fan
+      for ( int i = 1; i + 1 < face.size(); ++i )
+      {
+        const QPair<int, int> corners[3] = { face.at( 0 ), face.at( i ), face.at( i + 1 ) };
+        const QVector3D faceNormal = QVector3D::normal( positions.at( corners[0].first ), positions.at( corners[1].first ), positions.at( corners[2].first ) );
+        for ( const QPair<int, int> &corner : corners )
+        {
+          const QVector3D &p = positions.at( corner.first );
+          const QVector3D n = corner.second >= 0 ? normals.at( corner.second ) : faceNormal;
+          data << p.x() << p.y() << p.z() << n.x() << n.y() << n.z();
+        }
+      }
+    }
+  }
+
+  return QByteArray( reinterpret_cast<const char *>( data.constData() ), data.size() * static_cast<int>( sizeof( float ) ) );
+}
+
+/**
+ * Returns triangles of the model for instanced rendering (see Qgs3DSymbolImpl::readObjModel()), or an empty array
+ * if the model is not supported. Only Wavefront OBJ models are supported, other formats are only loaded by Qt3D.
+ * The same model is typically used by all tiles of a layer, so recently used models are kept in memory
+ * (up to 64 MB of vertex data).
+ */
+static QByteArray modelVertexData( const QString &path )
+{
+  struct CachedModel
+  {
+    QDateTime lastModified;
+    QByteArray data;
+  };
+
+  static QMutex sMutex;
+  static QCache<QString, CachedModel> sModels( 64 * 1024 * 1024 );
+
+  if ( !path.endsWith( QLatin1String( ".obj" ), Qt::CaseInsensitive ) )
+    return QByteArray();
+
+  const QDateTime lastModified = QFileInfo( path ).lastModified();
+
+  QMutexLocker locker( &sMutex );
+  if ( const CachedModel *model = sModels.object( path ) )
+  {
+    if ( model->lastModified == lastModified )
+      return model->data;
+  }
+
+  const QByteArray data = Qgs3DSymbolImpl::readObjModel( path );
+  // the cost is the size of the data (models too large for the cache are not kept)
+  sModels.insert( path, new CachedModel{ lastModified, data }, std::max( 1, data.size() ) );
+  return data;
+}
+
+
 class QgsModelPoint3DSymbolHandler : public QgsFeature3DHandler
 {
   public:
@@ -347,6 +488,8 @@ class QgsModelPoint3DSymbolHandler : public QgsFeature3DHandler
 
     static void addSceneEntities( const Qgs3DMapSettings &map, const QVector<QVector3D> &positions, const QgsPoint3DSymbol &symbol, Qt3DCore::QEntity *parent );
     static void addMeshEntities( const Qgs3DMapSettings &map, const QVector<QVector3D> &positions, const QgsPoint3DSymbol &symbol, Qt3DCore::QEntity *parent, bool are_selected );
+    //! Adds a single entity rendering instances of the model at all positions, with triangles of the model in \a vertexData
+    static void addInstancedEntity( const Qgs3DMapSettings &map, const QVector<QVector3D> &positions, const QByteArray &vertexData, const QgsPoint3DSymbol &symbol, Qt3DCore::QEntity *parent, bool are_selected );
     static Qt3DCore::QTransform *transform( QVector3D position, const QgsPoint3DSymbol &symbol );
 
     //! temporary data we will pass to the tessellator
@@ -392,20 +535,22 @@ void QgsModelPoint3DSymbolHandler::finalize( Qt3DCore::QEntity *parent, const Qg
 
 void QgsModelPoint3DSymbolHandler::makeEntity( Qt3DCore::QEntity *parent, const Qgs3DRenderContext &context, PointData &out, bool selected )
 {
-  if ( selected )
+  if ( out.positions.isEmpty() )
+    return;
+
+  if ( selected || mSymbol.shapeProperties()[QStringLiteral( "overwriteMaterial" )].toBool() )
   {
-    addMeshEntities( context.map(), out.positions, mSymbol, parent, true );
+    // with the material of the symbol, the model can be drawn at all positions at once
+    const QByteArray vertexData = modelVertexData( mSymbol.shapeProperties()[QStringLiteral( "model" )].toString() );
+    if ( !vertexData.isEmpty() )
+      addInstancedEntity( context.map(), out.positions, vertexData, mSymbol, parent, selected );
+    else
+      addMeshEntities( context.map(), out.positions, mSymbol, parent, selected );
   }
   else
   {
-    if ( mSymbol.shapeProperties()[QStringLiteral( "overwriteMaterial" )].toBool() )
-    {
-      addMeshEntities( context.map(), out.positions, mSymbol, parent, false );
-    }
-    else
-    {
-      addSceneEntities( context.map(), out.positions, mSymbol, parent );
-    }
+    // materials of the model are only supported by the scene loader
+    addSceneEntities( context.map(), out.positions, mSymbol, parent );
   }
 }
 
@@ -440,16 +585,17 @@ void QgsModelPoint3DSymbolHandler::addMeshEntities( const Qgs3DMapSettings &map,
     mat->setAmbient( map.selectionColor().darker() );
   }
 
+  // the mesh is shared by all entities, so that the model is only loaded once
+  QUrl url = QUrl::fromLocalFile( symbol.shapeProperties()[QStringLiteral( "model" )].toString() );
+  Qt3DRender::QMesh *mesh = new Qt3DRender::QMesh;
+  mesh->setSource( url );
+
   // get nodes
   for ( const QVector3D &position : positions )
   {
     // build the entity
     Qt3DCore::QEntity *entity = new Qt3DCore::QEntity;
 
-    QUrl url = QUrl::fromLocalFile( symbol.shapeProperties()[QStringLiteral( "model" )].toString() );
-    Qt3DRender::QMesh *mesh = new Qt3DRender::QMesh;
-    mesh->setSource( url );
-
     entity->addComponent( mesh );
     entity->addComponent( mat );
     entity->addComponent( transform( position, symbol ) );
@@ -457,6 +603,61 @@ void QgsModelPoint3DSymbolHandler::addMeshEntities( const Qgs3DMapSettings &map,
   }
 }
 
+void QgsModelPoint3DSymbolHandler::addInstancedEntity( const Qgs3DMapSettings &map, const QVector<QVector3D> &positions, const QByteArray &vertexData, const QgsPoint3DSymbol &symbol, Qt3DCore::QEntity *parent, bool are_selected )
+{
+  // the instanced material applies the transform of the symbol to the model
+  Qt3DRender::QMaterial *mat = QgsInstancedPoint3DSymbolHandler::material( symbol );
+  if ( are_selected )
+    QgsInstancedPoint3DSymbolHandler::setSelectionColors( mat, map );
+
+  const uint stride = 6 * sizeof( float );
+  const uint vertexCount = static_cast<uint>( vertexData.size() ) / stride;
+
+  Qt3DRender::QGeometry *geometry = new Qt3DRender::QGeometry;
+
+  Qt3DRender::QBuffer *vertexBuffer = new Qt3DRender::QBuffer( Qt3DRender::QBuffer::VertexBuffer, geometry );
+  vertexBuffer->setData( vertexData );
+
+  Qt3DRender::QAttribute *positionAttribute = new Qt3DRender::QAttribute( geometry );
+  positionAttribute->setName( Qt3DRender::QAttribute::defaultPositionAttributeName() );
+  positionAttribute->setAttributeType( Qt3DRender::QAttribute::VertexAttribute );
+  positionAttribute->setVertexBaseType( Qt3DRender::QAttribute::Float );
+  positionAttribute->setVertexSize( 3 );
+  positionAttribute->setBuffer( vertexBuffer );
+  positionAttribute->setByteStride( stride );
+  positionAttribute->setByteOffset( 0 );
+  positionAttribute->setCount( vertexCount );
+
+  Qt3DRender::QAttribute *normalAttribute = new Qt3DRender::QAttribute( geometry );
+  normalAttribute->setName( Qt3DRender::QAttribute::defaultNormalAttributeName() );
+  normalAttribute->setAttributeType( Qt3DRender::QAttribute::VertexAttribute );
+  normalAttribute->setVertexBaseType( Qt3DRender::QAttribute::Float );
+  normalAttribute->setVertexSize( 3 );
+  normalAttribute->setBuffer( vertexBuffer );
+  normalAttribute->setByteStride( stride );
+  normalAttribute->setByteOffset( 3 * sizeof( float ) );
+  normalAttribute->setCount( vertexCount );
+
+  Qt3DRender::QAttribute *instanceDataAttribute = instancePositionAttribute( positions );
+
+  geometry->addAttribute( positionAttribute );
+  geometry->addAttribute( normalAttribute );
+  geometry->addAttribute( instanceDataAttribute );
+  geometry->setBoundingVolumePositionAttribute( instanceDataAttribute );
+
+  Qt3DRender::QGeometryRenderer *renderer = new Qt3DRender::QGeometryRenderer;
+  renderer->setPrimitiveType( Qt3DRender::QGeometryRenderer::Triangles );
+  renderer->setGeometry( geometry );
+  renderer->setVertexCount( static_cast<int>( vertexCount ) );
+  renderer->setInstanceCount( positions.count() );
+
+  // build the entity
+  Qt3DCore::QEntity *entity = new Qt3DCore::QEntity;
+  entity->addComponent( renderer );
+  entity->addComponent( mat );
+  entity->setParent( parent );
+}
+
 Qt3DCore::QTransform *QgsModelPoint3DSymbolHandler::transform( QVector3D position, const QgsPoint3DSymbol &symbol )
 {
   Qt3DCore::QTransform *tr = new Qt3DCore::QTransform;
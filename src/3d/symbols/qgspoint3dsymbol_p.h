@@ -28,8 +28,11 @@
 //
 
 
+#include "qgis_3d.h"
 #include "qgsfeature3dhandler_p.h"
 
+#include <QByteArray>
+
 class QgsPoint3DSymbol;
 
 namespace Qgs3DSymbolImpl
@@ -39,6 +42,14 @@ namespace Qgs3DSymbolImpl
 
   //! convenience function to create a complete entity from QgsPolygon3DSymbol (will run getFeatures() on the layer)
   Qt3DCore::QEntity *entityForPoint3DSymbol( const Qgs3DMapSettings &map, QgsVectorLayer *layer, const QgsPoint3DSymbol &symbol );
+
+  /**
+   * Reads triangles of a Wavefront OBJ model for instanced rendering. Returns interleaved vertex positions and normals
+   * (6 floats for each vertex of the triangles) or an empty array if the file could not be read or is malformed.
+   * Polygon faces are split to triangles and faces without normals get the normal of the face.
+   * \since QGIS 3.12
+   */
+  _3D_EXPORT QByteArray readObjModel( const QString &path );
 }
 
 /// @endcond
@@ -221,6 +221,7 @@ void QgsPolygon3DSymbolHandler::makeEntity( Qt3DCore::QEntity *parent, const Qgs
   QgsTessellatedPolygonGeometry *geometry = new QgsTessellatedPolygonGeometry;
   geometry->setInvertNormals( mSymbol.invertNormals() );
   geometry->setAddBackFaces( mSymbol.addBackFaces() );
+  geometry->setTriangulationAlgorithm( context.map().triangulationAlgorithm() );
   geometry->setPolygons( out.polygons, out.fids, origin, mSymbol.extrusionHeight(), out.extrusionHeightPerPolygon );
 
   Qt3DRender::QGeometryRenderer *renderer = new Qt3DRender::QGeometryRenderer;
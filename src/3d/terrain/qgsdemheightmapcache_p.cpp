@@ -0,0 +1,183 @@
+/***************************************************************************
+  qgsdemheightmapcache_p.cpp
+  --------------------------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by the QGIS project
+  Email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsdemheightmapcache_p.h"
+
+#include "qgsapplication.h"
+#include "qgschunknode_p.h"
+#include "qgsrasterdataprovider.h"
+#include "qgstilingscheme.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <vector>
+
+///@cond PRIVATE
+
+//! Version of the tile file format - to be increased whenever the format or content of tiles changes
+static const quint32 HEIGHT_MAP_CACHE_VERSION = 1;
+
+//! Header of a cached tile, followed by the array of float values
+struct QgsDemHeightMapCacheHeader
+{
+  char magic[4];
+  quint32 version;
+  quint32 resolution;
+  quint32 dataSize;
+};
+
+static const char HEIGHT_MAP_CACHE_MAGIC[4] = { 'Q', 'D', 'H', 'M' };
+
+
+QgsDemHeightMapCache::QgsDemHeightMapCache( const QString &rootDirectory, QgsRasterDataProvider *provider, const QgsTilingScheme &tilingScheme, int resolution )
+  : mResolution( resolution )
+{
+  QCryptographicHash hash( QCryptographicHash::Sha1 );
+  hash.addData( QByteArray::number( HEIGHT_MAP_CACHE_VERSION ) );
+  hash.addData( provider->name().toUtf8() );
+  hash.addData( provider->dataSourceUri().toUtf8() );
+  // make sure that the cache gets invalidated when a local file gets modified
+  QFileInfo fi( provider->dataSourceUri() );
+  if ( fi.isFile() )
+  {
+    hash.addData( QByteArray::number( fi.size() ) );
+    hash.addData( fi.lastModified().toString( Qt::ISODate ).toUtf8() );
+  }
+  hash.addData( tilingScheme.crs().toWkt().toUtf8() );
+  hash.addData( tilingScheme.tileToExtent( 0, 0, 0 ).toString( 17 ).toUtf8() );
+  hash.addData( QByteArray::number( resolution ) );
+
+  mDirectory = QDir( rootDirectory ).filePath( QString::fromLatin1( hash.result().toHex() ) );
+  QDir().mkpath( mDirectory );
+}
+
+QString QgsDemHeightMapCache::defaultRootDirectory()
+{
+  return QgsApplication::qgisSettingsDirPath() + QStringLiteral( "cache/3d/heightmaps" );
+}
+
+int QgsDemHeightMapCache::sweep( const QString &rootDirectory, qint64 maximumSize )
+{
+  std::vector< QFileInfo > tiles;
+  qint64 totalSize = 0;
+  QDirIterator it( rootDirectory, QStringList() << QStringLiteral( "*.hm" ), QDir::Files, QDirIterator::Subdirectories );
+  while ( it.hasNext() )
+  {
+    it.next();
+    tiles.emplace_back( it.fileInfo() );
+    totalSize += tiles.back().size();
+  }
+  if ( totalSize <= maximumSize )
+    return 0;
+
+  // least recently used tiles first
+  std::sort( tiles.begin(), tiles.end(), []( const QFileInfo & a, const QFileInfo & b )
+  {
+    return a.lastModified() < b.lastModified();
+  } );
+
+  int removed = 0;
+  for ( const QFileInfo &tile : tiles )
+  {
+    if ( totalSize <= maximumSize )
+      break;
+
+    if ( QFile::remove( tile.filePath() ) )
+    {
+      totalSize -= tile.size();
+      ++removed;
+    }
+  }
+  return removed;
+}
+
+bool QgsDemHeightMapCache::hasTile( const QgsChunkNodeId &tileId ) const
+{
+  return QFile::exists( tilePath( tileId ) );
+}
+
+bool QgsDemHeightMapCache::readTile( const QgsChunkNodeId &tileId, QByteArray &heightMap ) const
+{
+  QFile file( tilePath( tileId ) );
+  if ( !file.open( QIODevice::ReadOnly ) )
+    return false;
+
+  const qint64 dataSize = static_cast<qint64>( mResolution ) * mResolution * sizeof( float );
+  const qint64 fileSize = sizeof( QgsDemHeightMapCacheHeader ) + dataSize;
+  if ( file.size() != fileSize )
+    return false;
+
+  QgsDemHeightMapCacheHeader header;
+  if ( file.read( reinterpret_cast<char *>( &header ), sizeof( header ) ) != sizeof( header ) )
+    return false;
+
+  const bool valid = memcmp( header.magic, HEIGHT_MAP_CACHE_MAGIC, sizeof( HEIGHT_MAP_CACHE_MAGIC ) ) == 0 &&
+                     header.version == HEIGHT_MAP_CACHE_VERSION &&
+                     header.resolution == static_cast<quint32>( mResolution ) &&
+                     header.dataSize == static_cast<quint32>( dataSize );
+  if ( !valid )
+    return false;
+
+  // tiles are small, so reading them at once is cheaper than mapping them into memory
+  QByteArray data( static_cast<int>( dataSize ), Qt::Uninitialized );
+  if ( file.read( data.data(), dataSize ) != dataSize )
+    return false;
+
+  heightMap = data;
+  file.close();
+
+  // mark the tile as recently used for sweep()
+#if QT_VERSION >= QT_VERSION_CHECK( 5, 10, 0 )
+  if ( file.open( QIODevice::ReadWrite ) )
+    file.setFileTime( QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime );
+#endif
+  return true;
+}
+
+bool QgsDemHeightMapCache::writeTile( const QgsChunkNodeId &tileId, const QByteArray &heightMap ) const
+{
+  const qint64 dataSize = static_cast<qint64>( mResolution ) * mResolution * sizeof( float );
+  if ( heightMap.size() != dataSize )
+    return false;
+
+  QgsDemHeightMapCacheHeader header;
+  memcpy( header.magic, HEIGHT_MAP_CACHE_MAGIC, sizeof( HEIGHT_MAP_CACHE_MAGIC ) );
+  header.version = HEIGHT_MAP_CACHE_VERSION;
+  header.resolution = static_cast<quint32>( mResolution );
+  header.dataSize = static_cast<quint32>( dataSize );
+
+  // the file only appears in the cache once it is fully written
+  QSaveFile file( tilePath( tileId ) );
+  if ( !file.open( QIODevice::WriteOnly ) )
+    return false;
+
+  file.write( reinterpret_cast<const char *>( &header ), sizeof( header ) );
+  file.write( heightMap );
+  return file.commit();
+}
+
+QString QgsDemHeightMapCache::tilePath( const QgsChunkNodeId &tileId ) const
+{
+  return QStringLiteral( "%1/%2-%3-%4.hm" ).arg( mDirectory ).arg( tileId.z ).arg( tileId.x ).arg( tileId.y );
+}
+
+/// @endcond
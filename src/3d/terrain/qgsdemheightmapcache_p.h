@@ -0,0 +1,96 @@
+/***************************************************************************
+  qgsdemheightmapcache_p.h
+  --------------------------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by the QGIS project
+  Email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSDEMHEIGHTMAPCACHE_P_H
+#define QGSDEMHEIGHTMAPCACHE_P_H
+
+///@cond PRIVATE
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QGIS API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+
+#include "qgis_3d.h"
+
+#include <QString>
+#include <QByteArray>
+
+class QgsRasterDataProvider;
+class QgsTilingScheme;
+struct QgsChunkNodeId;
+
+/**
+ * \ingroup 3d
+ * On-disk cache of height maps generated from a DEM raster for terrain tiles.
+ *
+ * Each cache lives in its own sub-directory of the cache root directory, named by a hash
+ * of everything that affects content of the height maps: the DEM data source (including size
+ * and modification time for local files), the tiling scheme (CRS and extent of the root tile)
+ * and the resolution of tiles. A change of any of these therefore starts a fresh cache.
+ *
+ * Every tile is stored in a separate file with a small header followed by the raw array
+ * of float values. Tiles are written atomically, so the cache may be used from multiple worker
+ * threads at the same time. The modification time of a tile file is updated whenever the tile
+ * is read (with Qt 5.10 or later), so that sweep() removes the least recently used tiles first.
+ *
+ * \since QGIS 3.12
+ */
+class _3D_EXPORT QgsDemHeightMapCache
+{
+  public:
+
+    /**
+     * Constructs cache for height maps of the given \a provider within the \a tilingScheme, each with
+     * \a resolution height values on each side. The cache is stored in a sub-directory of \a rootDirectory.
+     */
+    QgsDemHeightMapCache( const QString &rootDirectory, QgsRasterDataProvider *provider, const QgsTilingScheme &tilingScheme, int resolution );
+
+    //! Returns the default root directory for height map caches (within the user's profile)
+    static QString defaultRootDirectory();
+
+    /**
+     * Removes the least recently used tiles of all caches within \a rootDirectory until the total
+     * size of the tile files does not exceed \a maximumSize (in bytes).
+     * Returns the number of removed tiles.
+     */
+    static int sweep( const QString &rootDirectory, qint64 maximumSize );
+
+    //! Returns directory with files of this cache
+    QString directory() const { return mDirectory; }
+
+    //! Returns whether a height map of the tile is stored in the cache
+    bool hasTile( const QgsChunkNodeId &tileId ) const;
+
+    //! Reads height map of the tile to \a heightMap. Returns FALSE if the tile is not cached or the file is not valid
+    bool readTile( const QgsChunkNodeId &tileId, QByteArray &heightMap ) const;
+
+    //! Stores height map of the tile in the cache. Returns FALSE if the height map could not be written
+    bool writeTile( const QgsChunkNodeId &tileId, const QByteArray &heightMap ) const;
+
+  private:
+    QString tilePath( const QgsChunkNodeId &tileId ) const;
+
+    QString mDirectory;
+    int mResolution;
+};
+
+/// @endcond
+
+#endif // QGSDEMHEIGHTMAPCACHE_P_H
@@ -42,6 +42,13 @@ void QgsDemTerrainGenerator::setCrs( const QgsCoordinateReferenceSystem &crs, co
   updateGenerator();
 }
 
+void QgsDemTerrainGenerator::setHeightMapCacheMode( HeightMapCacheMode mode )
+{
+  mHeightMapCacheMode = mode;
+  if ( mHeightMapGenerator )
+    mHeightMapGenerator->setCacheEnabled( mode != NoCache );
+}
+
 QgsTerrainGenerator *QgsDemTerrainGenerator::clone() const
 {
   QgsDemTerrainGenerator *cloned = new QgsDemTerrainGenerator;
@@ -49,6 +56,7 @@ QgsTerrainGenerator *QgsDemTerrainGenerator::clone() const
   cloned->mLayer = mLayer;
   cloned->mResolution = mResolution;
   cloned->mSkirtHeight = mSkirtHeight;
+  cloned->mHeightMapCacheMode = mHeightMapCacheMode;
   cloned->updateGenerator();
   return cloned;
 }
@@ -77,6 +85,7 @@ void QgsDemTerrainGenerator::writeXml( QDomElement &elem ) const
   elem.setAttribute( QStringLiteral( "layer" ), mLayer.layerId );
   elem.setAttribute( QStringLiteral( "resolution" ), mResolution );
   elem.setAttribute( QStringLiteral( "skirt-height" ), mSkirtHeight );
+  elem.setAttribute( QStringLiteral( "heightmap-cache" ), static_cast<int>( mHeightMapCacheMode ) );
 
   // crs is not read/written - it should be the same as destination crs of the map
 }
@@ -86,6 +95,7 @@ void QgsDemTerrainGenerator::readXml( const QDomElement &elem )
   mLayer = QgsMapLayerRef( elem.attribute( QStringLiteral( "layer" ) ) );
   mResolution = elem.attribute( QStringLiteral( "resolution" ) ).toInt();
   mSkirtHeight = elem.attribute( QStringLiteral( "skirt-height" ) ).toFloat();
+  mHeightMapCacheMode = static_cast<HeightMapCacheMode>( elem.attribute( QStringLiteral( "heightmap-cache" ), QString::number( NoCache ) ).toInt() );
 
   // crs is not read/written - it should be the same as destination crs of the map
 }
@@ -113,6 +123,7 @@ void QgsDemTerrainGenerator::updateGenerator()
     mTerrainTilingScheme = QgsTilingScheme( te, mCrs );
     delete mHeightMapGenerator;
     mHeightMapGenerator = new QgsDemHeightMapGenerator( dem, mTerrainTilingScheme, mResolution, mTransformContext );
+    mHeightMapGenerator->setCacheEnabled( mHeightMapCacheMode != NoCache );
   }
   else
   {
@@ -36,6 +36,18 @@ class QgsDemHeightMapGenerator;
 class _3D_EXPORT QgsDemTerrainGenerator : public QgsTerrainGenerator
 {
   public:
+
+    /**
+     * Modes of caching of height maps generated from the elevation model
+     * \since QGIS 3.12
+     */
+    enum HeightMapCacheMode
+    {
+      NoCache,           //!< Height maps are read from the layer whenever terrain tiles get loaded
+      OnDemandCache,     //!< Height maps are stored in an on-disk cache when tiles get loaded for the first time
+      PregeneratedCache, //!< As OnDemandCache, and height maps of all tiles are generated in background when the terrain is created
+    };
+
     //! Constructor for QgsDemTerrainGenerator
     QgsDemTerrainGenerator() = default;
     ~QgsDemTerrainGenerator() override;
@@ -58,6 +70,19 @@ class _3D_EXPORT QgsDemTerrainGenerator : public QgsTerrainGenerator
     //! Returns skirt height (in world units). Skirts at the edges of terrain tiles help hide cracks between adjacent tiles.
     float skirtHeight() const { return mSkirtHeight; }
 
+    /**
+     * Sets how height maps generated from the elevation model are cached on disk.
+     * Caching is disabled by default.
+     * \since QGIS 3.12
+     */
+    void setHeightMapCacheMode( HeightMapCacheMode mode );
+
+    /**
+     * Returns how height maps generated from the elevation model are cached on disk
+     * \since QGIS 3.12
+     */
+    HeightMapCacheMode heightMapCacheMode() const { return mHeightMapCacheMode; }
+
     //! Returns height map generator object - takes care of extraction of elevations from the layer)
     QgsDemHeightMapGenerator *heightMapGenerator() { return mHeightMapGenerator; }
 
@@ -86,6 +111,8 @@ class _3D_EXPORT QgsDemTerrainGenerator : public QgsTerrainGenerator
     int mResolution = 16;
     //! height of the "skirts" at the edges of tiles to hide cracks between adjacent cracks
     float mSkirtHeight = 10.f;
+    //! how height maps are cached on disk
+    HeightMapCacheMode mHeightMapCacheMode = NoCache;
 };
 
 
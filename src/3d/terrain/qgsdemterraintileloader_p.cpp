@@ -148,6 +148,10 @@ void QgsDemTerrainTileLoader::onHeightMapReady( int jobId, const QByteArray &hei
 #include <QtConcurrent/QtConcurrentRun>
 #include <QFutureWatcher>
 #include "qgsterraindownloader.h"
+#include "qgsdemheightmapcache_p.h"
+#include "qgscoordinatetransform.h"
+#include "qgsexception.h"
+#include "qgssettings.h"
 
 QgsDemHeightMapGenerator::QgsDemHeightMapGenerator( QgsRasterLayer *dtm, const QgsTilingScheme &tilingScheme, int resolution, const QgsCoordinateTransformContext &transformContext )
   : mDtm( dtm )
@@ -161,9 +165,26 @@ QgsDemHeightMapGenerator::QgsDemHeightMapGenerator( QgsRasterLayer *dtm, const Q
 
 QgsDemHeightMapGenerator::~QgsDemHeightMapGenerator()
 {
+  if ( mPregenerationCanceled )
+  {
+    *mPregenerationCanceled = true;
+    mPregeneration.waitForFinished();
+  }
+
   delete mClonedProvider;
 }
 
+static QgsRectangle _tileDataExtent( const QgsTilingScheme &tilingScheme, int res, int x, int y, int z )
+{
+  // extend the rect by half-pixel on each side? to get the values in "corners"
+  QgsRectangle extent = tilingScheme.tileToExtent( x, y, z );
+  float mapUnitsPerPixel = extent.width() / res;
+  extent.grow( mapUnitsPerPixel / 2 );
+  // but make sure not to go beyond the full extent (returns invalid values)
+  QgsRectangle fullExtent = tilingScheme.tileToExtent( 0, 0, 0 );
+  return extent.intersect( fullExtent );
+}
+
 
 static QByteArray _readDtmData( QgsRasterDataProvider *provider, const QgsRectangle &extent, int res, const QgsCoordinateReferenceSystem &destCrs )
 {
@@ -205,6 +226,18 @@ static QByteArray _readDtmData( QgsRasterDataProvider *provider, const QgsRectan
 }
 
 
+static QByteArray _readCachedDtmData( const std::shared_ptr<QgsDemHeightMapCache> &cache, const QgsChunkNodeId &tileId, QgsRasterDataProvider *provider, const QgsRectangle &extent, int res, const QgsCoordinateReferenceSystem &destCrs )
+{
+  QByteArray data;
+  if ( cache->readTile( tileId, data ) )
+    return data;
+
+  data = _readDtmData( provider, extent, res, destCrs );
+  if ( !data.isEmpty() )
+    cache->writeTile( tileId, data );
+  return data;
+}
+
 static QByteArray _readOnlineDtm( QgsTerrainDownloader *downloader, const QgsRectangle &extent, int res, const QgsCoordinateReferenceSystem &destCrs )
 {
   return downloader->getHeightMap( extent, res, destCrs );
@@ -216,13 +249,7 @@ int QgsDemHeightMapGenerator::render( int x, int y, int z )
 
   QgsEventTracing::addEvent( QgsEventTracing::AsyncBegin, QStringLiteral( "3D" ), QStringLiteral( "DEM" ), tileId.text() );
 
-  // extend the rect by half-pixel on each side? to get the values in "corners"
-  QgsRectangle extent = mTilingScheme.tileToExtent( x, y, z );
-  float mapUnitsPerPixel = extent.width() / mResolution;
-  extent.grow( mapUnitsPerPixel / 2 );
-  // but make sure not to go beyond the full extent (returns invalid values)
-  QgsRectangle fullExtent = mTilingScheme.tileToExtent( 0, 0, 0 );
-  extent = extent.intersect( fullExtent );
+  QgsRectangle extent = _tileDataExtent( mTilingScheme, mResolution, x, y, z );
 
   JobData jd;
   jd.jobId = ++mLastJobId;
@@ -230,7 +257,18 @@ int QgsDemHeightMapGenerator::render( int x, int y, int z )
   jd.extent = extent;
   jd.timer.start();
   // make a clone of the data provider so it is safe to use in worker thread
-  if ( mDtm )
+  if ( mDtm && mCache )
+  {
+    std::shared_ptr<QgsDemHeightMapCache> cache = mCache;
+    QgsRasterDataProvider *provider = mClonedProvider;
+    const int res = mResolution;
+    const QgsCoordinateReferenceSystem crs = mTilingScheme.crs();
+    jd.future = QtConcurrent::run( [cache, tileId, provider, extent, res, crs]
+    {
+      return _readCachedDtmData( cache, tileId, provider, extent, res, crs );
+    } );
+  }
+  else if ( mDtm )
     jd.future = QtConcurrent::run( _readDtmData, mClonedProvider, extent, mResolution, mTilingScheme.crs() );
   else
     jd.future = QtConcurrent::run( _readOnlineDtm, mDownloader.get(), extent, mResolution, mTilingScheme.crs() );
@@ -246,13 +284,7 @@ int QgsDemHeightMapGenerator::render( int x, int y, int z )
 
 QByteArray QgsDemHeightMapGenerator::renderSynchronously( int x, int y, int z )
 {
-  // extend the rect by half-pixel on each side? to get the values in "corners"
-  QgsRectangle extent = mTilingScheme.tileToExtent( x, y, z );
-  float mapUnitsPerPixel = extent.width() / mResolution;
-  extent.grow( mapUnitsPerPixel / 2 );
-  // but make sure not to go beyond the full extent (returns invalid values)
-  QgsRectangle fullExtent = mTilingScheme.tileToExtent( 0, 0, 0 );
-  extent = extent.intersect( fullExtent );
+  QgsRectangle extent = _tileDataExtent( mTilingScheme, mResolution, x, y, z );
 
   std::unique_ptr< QgsRasterBlock > block( mDtm->dataProvider()->block( 1, extent, mResolution, mResolution ) );
 
@@ -292,6 +324,93 @@ float QgsDemHeightMapGenerator::heightAt( double x, double y )
   return data[cellX + cellY * res];
 }
 
+void QgsDemHeightMapGenerator::setCacheEnabled( bool enabled, const QString &rootDirectory )
+{
+  if ( mPregenerationCanceled )
+  {
+    *mPregenerationCanceled = true;
+    mPregenerationCanceled.reset();
+  }
+
+  if ( enabled && mDtm )
+  {
+    mCacheRootDirectory = rootDirectory.isEmpty() ? QgsDemHeightMapCache::defaultRootDirectory() : rootDirectory;
+    mCacheMaximumSize = QgsSettings().value( QStringLiteral( "3D/heightMapCacheMaximumSize" ), 512 ).toLongLong() * 1024 * 1024;
+    mCache = std::make_shared<QgsDemHeightMapCache>( mCacheRootDirectory, mClonedProvider, mTilingScheme, mResolution );
+
+    // keep the total size of the caches bounded, without delaying the loading of tiles
+    const QString cacheRootDirectory = mCacheRootDirectory;
+    const qint64 cacheMaximumSize = mCacheMaximumSize;
+    QtConcurrent::run( [cacheRootDirectory, cacheMaximumSize]
+    {
+      QgsDemHeightMapCache::sweep( cacheRootDirectory, cacheMaximumSize );
+    } );
+  }
+  else
+    mCache.reset();
+}
+
+void QgsDemHeightMapGenerator::pregenerateCache( int maxLevel )
+{
+  if ( !mCache || mPregeneration.isRunning() )
+    return;
+
+  // use a separate provider so that the generation does not interfere with jobs of visible tiles
+  std::shared_ptr<QgsRasterDataProvider> provider( static_cast<QgsRasterDataProvider *>( mDtm->dataProvider()->clone() ) );
+
+  // tiles of the tiling scheme outside of the raster's extent have no data
+  QgsRectangle dataExtent = provider->extent();
+  if ( provider->crs() != mTilingScheme.crs() )
+  {
+    try
+    {
+      QgsCoordinateTransform transform( provider->crs(), mTilingScheme.crs(), provider->transformContext() );
+      dataExtent = transform.transformBoundingBox( dataExtent );
+    }
+    catch ( QgsCsException & )
+    {
+      dataExtent = mTilingScheme.tileToExtent( 0, 0, 0 );
+    }
+  }
+
+  std::shared_ptr<QgsDemHeightMapCache> cache = mCache;
+  std::shared_ptr<std::atomic<bool>> canceled = std::make_shared<std::atomic<bool>>( false );
+  mPregenerationCanceled = canceled;
+  const QgsTilingScheme tilingScheme = mTilingScheme;
+  const int res = mResolution;
+  const QString cacheRootDirectory = mCacheRootDirectory;
+  const qint64 cacheMaximumSize = mCacheMaximumSize;
+
+  mPregeneration = QtConcurrent::run( [cache, canceled, provider, tilingScheme, dataExtent, res, maxLevel, cacheRootDirectory, cacheMaximumSize]
+  {
+    QgsEventTracing::ScopedEvent e( QStringLiteral( "3D" ), QStringLiteral( "DEM cache pre-generation" ) );
+
+    // coarse levels first - these are needed first when a scene gets opened
+    for ( int z = 0; z <= maxLevel; ++z )
+    {
+      const int tilesPerSide = 1 << z;
+      for ( int y = 0; y < tilesPerSide; ++y )
+      {
+        for ( int x = 0; x < tilesPerSide; ++x )
+        {
+          if ( *canceled )
+            return;
+
+          const QgsChunkNodeId tileId( x, y, z );
+          if ( !tilingScheme.tileToExtent( x, y, z ).intersects( dataExtent ) || cache->hasTile( tileId ) )
+            continue;
+
+          const QByteArray data = _readDtmData( provider.get(), _tileDataExtent( tilingScheme, res, x, y, z ), res, tilingScheme.crs() );
+          if ( !data.isEmpty() )
+            cache->writeTile( tileId, data );
+        }
+      }
+    }
+
+    QgsDemHeightMapCache::sweep( cacheRootDirectory, cacheMaximumSize );
+  } );
+}
+
 void QgsDemHeightMapGenerator::onFutureFinished()
 {
   QFutureWatcher<QByteArray> *fw = static_cast<QFutureWatcher<QByteArray>*>( sender() );
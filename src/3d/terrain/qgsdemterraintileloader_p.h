@@ -31,6 +31,9 @@
 #include <QFutureWatcher>
 #include <QElapsedTimer>
 
+#include <atomic>
+#include <memory>
+
 #include "qgschunknode_p.h"
 #include "qgsrectangle.h"
 #include "qgsterraintileloader_p.h"
@@ -67,6 +70,7 @@ class QgsDemTerrainTileLoader : public QgsTerrainTileLoader
 
 
 class QgsTerrainDownloader;
+class QgsDemHeightMapCache;
 
 /**
  * \ingroup 3d
@@ -97,6 +101,30 @@ class QgsDemHeightMapGenerator : public QObject
     //! returns height at given position (in terrain's CRS)
     float heightAt( double x, double y );
 
+    /**
+     * Sets whether generated height maps are stored in an on-disk cache (and read from it when available).
+     * Height maps are cached in a sub-directory of \a rootDirectory, by default in the user's profile.
+     * Only height maps generated from a raster layer are cached. The least recently used tiles of all caches
+     * in \a rootDirectory are removed when their total size exceeds the "3D/heightMapCacheMaximumSize"
+     * setting (in megabytes, 512 by default).
+     * \since QGIS 3.12
+     */
+    void setCacheEnabled( bool enabled, const QString &rootDirectory = QString() );
+
+    /**
+     * Returns whether generated height maps are stored in an on-disk cache
+     * \since QGIS 3.12
+     */
+    bool isCacheEnabled() const { return static_cast<bool>( mCache ); }
+
+    /**
+     * Starts generation of height maps of all tiles up to \a maxLevel which intersect the DEM in a background
+     * thread, storing them in the on-disk cache. Tiles which are already cached are skipped, coarser levels
+     * are generated first. Does nothing if the cache is not enabled or the generation is already running.
+     * \since QGIS 3.12
+     */
+    void pregenerateCache( int maxLevel );
+
   signals:
     //! emitted when a previously requested heightmap is ready
     void heightMapReady( int jobId, const QByteArray &heightMap );
@@ -119,6 +147,17 @@ class QgsDemHeightMapGenerator : public QObject
 
     std::unique_ptr<QgsTerrainDownloader> mDownloader;
 
+    //! on-disk cache of height maps (shared with worker threads)
+    std::shared_ptr<QgsDemHeightMapCache> mCache;
+    //! directory with all height map caches
+    QString mCacheRootDirectory;
+    //! maximum total size of the height map caches (in bytes)
+    qint64 mCacheMaximumSize = 0;
+
+    //! background generation of cached height maps
+    QFuture<void> mPregeneration;
+    std::shared_ptr<std::atomic<bool>> mPregenerationCanceled;
+
     struct JobData
     {
       int jobId;
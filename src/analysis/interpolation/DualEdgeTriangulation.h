@@ -66,6 +66,13 @@ class ANALYSIS_EXPORT DualEdgeTriangulation: public Triangulation
     bool getTriangle( double x, double y, QgsPoint &p1 SIP_OUT, int &n1 SIP_OUT, QgsPoint &p2 SIP_OUT, int &n2 SIP_OUT, QgsPoint &p3 SIP_OUT, int &n3 SIP_OUT ) SIP_PYNAME( getTriangleVertices ) override;
     bool getTriangle( double x, double y, QgsPoint &p1 SIP_OUT, QgsPoint &p2 SIP_OUT, QgsPoint &p3 SIP_OUT ) override;
     QList<int> getSurroundingTriangles( int pointno ) override;
+
+    /**
+     * Returns the numbers of the points of all the triangles in the triangulation, with three
+     * consecutive numbers for each triangle. Triangles with the virtual point are not included.
+     * \since QGIS 3.12
+     */
+    QVector<int> getTriangles() const;
     //! Returns the largest x-coordinate value of the bounding box
     double getXMax() const override { return xMax; }
     //! Returns the smallest x-coordinate value of the bounding box
@@ -118,8 +125,8 @@ class ANALYSIS_EXPORT DualEdgeTriangulation: public Triangulation
     QVector<QgsPoint *> mPointVector;
     //! Default value for the number of storable HalfEdges at the beginning
     static const unsigned int DEFAULT_STORAGE_FOR_HALF_EDGES = 300006;
-    //! Stores pointers to the HalfEdges
-    QVector<HalfEdge *> mHalfEdge;
+    //! Stores the HalfEdges, which refer to each other by their index
+    QVector<HalfEdge> mHalfEdge;
     //! Association to an interpolator object
     TriangleInterpolator *mTriangleInterpolator = nullptr;
     //! Member to store the behavior in case of crossing forced segments
@@ -216,14 +223,14 @@ inline QgsPoint *DualEdgeTriangulation::getPoint( int i ) const
 inline bool DualEdgeTriangulation::halfEdgeBBoxTest( int edge, double xlowleft, double ylowleft, double xupright, double yupright ) const
 {
   return (
-           ( getPoint( mHalfEdge[edge]->getPoint() )->x() >= xlowleft &&
-             getPoint( mHalfEdge[edge]->getPoint() )->x() <= xupright &&
-             getPoint( mHalfEdge[edge]->getPoint() )->y() >= ylowleft &&
-             getPoint( mHalfEdge[edge]->getPoint() )->y() <= yupright ) ||
-           ( getPoint( mHalfEdge[mHalfEdge[edge]->getDual()]->getPoint() )->x() >= xlowleft &&
-             getPoint( mHalfEdge[mHalfEdge[edge]->getDual()]->getPoint() )->x() <= xupright &&
-             getPoint( mHalfEdge[mHalfEdge[edge]->getDual()]->getPoint() )->y() >= ylowleft &&
-             getPoint( mHalfEdge[mHalfEdge[edge]->getDual()]->getPoint() )->y() <= yupright )
+           ( getPoint( mHalfEdge[edge].getPoint() )->x() >= xlowleft &&
+             getPoint( mHalfEdge[edge].getPoint() )->x() <= xupright &&
+             getPoint( mHalfEdge[edge].getPoint() )->y() >= ylowleft &&
+             getPoint( mHalfEdge[edge].getPoint() )->y() <= yupright ) ||
+           ( getPoint( mHalfEdge[mHalfEdge[edge].getDual()].getPoint() )->x() >= xlowleft &&
+             getPoint( mHalfEdge[mHalfEdge[edge].getDual()].getPoint() )->x() <= xupright &&
+             getPoint( mHalfEdge[mHalfEdge[edge].getDual()].getPoint() )->y() >= ylowleft &&
+             getPoint( mHalfEdge[mHalfEdge[edge].getDual()].getPoint() )->y() <= yupright )
          );
 }
 
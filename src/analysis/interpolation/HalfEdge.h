@@ -18,6 +18,7 @@
 #define HALFEDGE_H
 
 #include "qgis_analysis.h"
+#include <QtGlobal>
 
 #define SIP_NO_FILE
 
@@ -126,4 +127,6 @@ inline void HalfEdge::setForced( bool f )
 
 #endif
 
+Q_DECLARE_TYPEINFO( HalfEdge, Q_MOVABLE_TYPE );
+
 #endif
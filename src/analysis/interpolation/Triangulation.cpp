@@ -14,6 +14,10 @@
  ***************************************************************************/
 #include "Triangulation.h"
 #include "qgsfields.h"
+#include "qgsfeedback.h"
+
+#include <algorithm>
+#include <vector>
 
 QgsFields Triangulation::triangulationFields()
 {
@@ -21,3 +25,96 @@ QgsFields Triangulation::triangulationFields()
   fields.append( QgsField( QStringLiteral( "type" ), QVariant::String, QStringLiteral( "String" ) ) );
   return fields;
 }
+
+//! Returns the position of cell \a x, \a y of a 65536 x 65536 grid along a Hilbert curve
+static quint64 hilbertIndex( quint32 x, quint32 y )
+{
+  const quint32 n = 1 << 16;
+  quint64 index = 0;
+  for ( quint32 s = n / 2; s > 0; s /= 2 )
+  {
+    const quint32 rx = ( x & s ) > 0 ? 1 : 0;
+    const quint32 ry = ( y & s ) > 0 ? 1 : 0;
+    index += static_cast< quint64 >( s ) * s * ( ( 3 * rx ) ^ ry );
+
+    // rotate the quadrant
+    if ( ry == 0 )
+    {
+      if ( rx == 1 )
+      {
+        x = n - 1 - x;
+        y = n - 1 - y;
+      }
+      std::swap( x, y );
+    }
+  }
+  return index;
+}
+
+int Triangulation::addPoints( const QVector<QgsPoint> &points, QgsFeedback *feedback )
+{
+  if ( points.isEmpty() )
+    return 0;
+
+  double xMin = points.at( 0 ).x();
+  double xMax = xMin;
+  double yMin = points.at( 0 ).y();
+  double yMax = yMin;
+  for ( const QgsPoint &point : points )
+  {
+    xMin = std::min( xMin, point.x() );
+    xMax = std::max( xMax, point.x() );
+    yMin = std::min( yMin, point.y() );
+    yMax = std::max( yMax, point.y() );
+  }
+  const double scaleX = xMax > xMin ? 65535 / ( xMax - xMin ) : 0;
+  const double scaleY = yMax > yMin ? 65535 / ( yMax - yMin ) : 0;
+
+  // pairs of curve position and point index
+  std::vector< std::pair< quint64, int > > order;
+  order.reserve( static_cast< std::size_t >( points.size() ) );
+  for ( int i = 0; i < points.size(); ++i )
+  {
+    const QgsPoint &point = points.at( i );
+    order.emplace_back( hilbertIndex( static_cast< quint32 >( ( point.x() - xMin ) * scaleX ),
+                                      static_cast< quint32 >( ( point.y() - yMin ) * scaleY ) ), i );
+  }
+  std::sort( order.begin(), order.end() );
+
+  // the first three points of a triangulation must not be collinear (close points on the curve
+  // often are), so move suitable points to the front
+  const QgsPoint &first = points.at( order[0].second );
+  for ( std::size_t i = 1; i < order.size(); ++i )
+  {
+    const QgsPoint &point = points.at( order[i].second );
+    if ( point.x() != first.x() || point.y() != first.y() )
+    {
+      std::swap( order[1], order[i] );
+      break;
+    }
+  }
+  if ( order.size() > 2 )
+  {
+    const QgsPoint &second = points.at( order[1].second );
+    for ( std::size_t i = 2; i < order.size(); ++i )
+    {
+      const QgsPoint &point = points.at( order[i].second );
+      if ( ( second.x() - first.x() ) * ( point.y() - first.y() ) - ( second.y() - first.y() ) * ( point.x() - first.x() ) != 0 )
+      {
+        std::swap( order[2], order[i] );
+        break;
+      }
+    }
+  }
+
+  int failures = 0;
+  for ( std::size_t i = 0; i < order.size(); ++i )
+  {
+    if ( feedback && i % 1000 == 0 && feedback->isCanceled() )
+      break;
+
+    if ( addPoint( points.at( order[i].second ) ) == -100 )
+      ++failures;
+  }
+  return failures;
+}
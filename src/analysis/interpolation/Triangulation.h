@@ -60,6 +60,20 @@ class ANALYSIS_EXPORT Triangulation
      */
     virtual int addPoint( const QgsPoint &point ) = 0;
 
+    /**
+     * Adds a list of \a points to the triangulation, and returns the number of points which
+     * could not be inserted.
+     *
+     * The points are inserted along a space filling curve, so that consecutive points are close
+     * to each other and the triangle containing each new point is found after a few steps.
+     * This is much faster than adding large numbers of points in arbitrary order.
+     *
+     * An optional \a feedback object can be set for cancellation support.
+     *
+     * \since QGIS 3.12
+     */
+    virtual int addPoints( const QVector< QgsPoint > &points, QgsFeedback *feedback = nullptr );
+
     /**
      * Calculates the normal at a point on the surface and assigns it to 'result'.
      * \returns TRUE in case of success and FALSE in case of failure
@@ -21,6 +21,11 @@
 #include "qgsfeedback.h"
 #include <QFile>
 #include <QFileInfo>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 QgsGridFileWriter::QgsGridFileWriter( QgsInterpolator *i, const QString &outputPath, const QgsRectangle &extent, int nCols, int nRows )
   : mInterpolator( i )
@@ -51,36 +56,124 @@ int QgsGridFileWriter::writeFile( QgsFeedback *feedback )
   outStream.setRealNumberPrecision( 8 );
   writeHeader( outStream );
 
-  double currentYValue = mInterpolationExtent.yMaximum() - mCellSizeY / 2.0; //calculate value in the center of the cell
-  double currentXValue;
-  double interpolatedValue;
+  //calculate values in the center of the cells
+  QVector< double > xValues( mNumColumns );
+  double currentXValue = mInterpolationExtent.xMinimum() + mCellSizeX / 2.0;
+  for ( double &xValue : xValues )
+  {
+    xValue = currentXValue;
+    currentXValue += mCellSizeX;
+  }
+  double currentYValue = mInterpolationExtent.yMaximum() - mCellSizeY / 2.0;
 
-  for ( int i = 0; i < mNumRows; ++i )
+  // interpolators which support it compute blocks of rows at once, and thread safe interpolators
+  // compute batches of rows in parallel. The rows are then written in order.
+  // The first interpolation also lets the interpolator cache its base data.
+  QVector< double > blockValues;
+  const bool useBlocks = mNumColumns > 0 && mNumRows > 0
+                         && mInterpolator->interpolateBlock( xValues, QVector< double >() << currentYValue, blockValues, feedback );
+  const bool parallel = !useBlocks && mInterpolator->isThreadSafe() && mNumColumns > 0 && mNumRows > 0;
+  int batchSize = 1;
+  if ( useBlocks )
   {
-    currentXValue = mInterpolationExtent.xMinimum() + mCellSizeX / 2.0; //calculate value in the center of the cell
-    for ( int j = 0; j < mNumColumns; ++j )
+    batchSize = std::max( 1, ( 1 << 20 ) / mNumColumns );
+  }
+  else if ( parallel )
+  {
+    double interpolatedValue;
+    mInterpolator->interpolatePoint( xValues.front(), currentYValue, interpolatedValue, feedback );
+    batchSize = 4 * std::max( 1, QThread::idealThreadCount() );
+  }
+  if ( feedback && feedback->isCanceled() )
+  {
+    outputFile.remove();
+    return 3;
+  }
+
+  struct GridRow
+  {
+    double y = 0;
+    std::vector< double > values;
+    std::vector< bool > valid;
+  };
+
+  auto interpolateRow = [this, &xValues, feedback]( GridRow & row )
+  {
+    if ( feedback && feedback->isCanceled() )
+      return;
+
+    row.values.resize( xValues.size() );
+    row.valid.resize( xValues.size() );
+    for ( int j = 0; j < xValues.size(); ++j )
     {
-      if ( mInterpolator->interpolatePoint( currentXValue, currentYValue, interpolatedValue, feedback ) == 0 )
-      {
-        outStream << interpolatedValue << ' ';
-      }
-      else
+      row.valid[j] = mInterpolator->interpolatePoint( xValues.at( j ), row.y, row.values[j], feedback ) == 0;
+    }
+  };
+
+  std::vector< GridRow > batch;
+  for ( int firstRow = 0; firstRow < mNumRows; firstRow += batchSize )
+  {
+    batch.resize( static_cast< std::size_t >( std::min( batchSize, mNumRows - firstRow ) ) );
+    for ( GridRow &row : batch )
+    {
+      row.y = currentYValue;
+      currentYValue -= mCellSizeY;
+    }
+
+    if ( useBlocks )
+    {
+      QVector< double > yValues;
+      yValues.reserve( static_cast< int >( batch.size() ) );
+      for ( const GridRow &row : batch )
+        yValues << row.y;
+
+      mInterpolator->interpolateBlock( xValues, yValues, blockValues, feedback );
+      const double *blockData = blockValues.constData();
+      for ( GridRow &row : batch )
       {
-        outStream << "-9999 ";
+        row.values.assign( blockData, blockData + mNumColumns );
+        row.valid.resize( row.values.size() );
+        for ( std::size_t j = 0; j < row.values.size(); ++j )
+          row.valid[j] = !std::isnan( row.values[j] );
+        blockData += mNumColumns;
       }
-      currentXValue += mCellSizeX;
     }
-    outStream << endl;
-    currentYValue -= mCellSizeY;
+    else if ( parallel )
+    {
+      QtConcurrent::blockingMap( batch, interpolateRow );
+    }
+    else
+    {
+      for ( GridRow &row : batch )
+        interpolateRow( row );
+    }
 
-    if ( feedback )
+    for ( std::size_t i = 0; i < batch.size(); ++i )
     {
-      if ( feedback->isCanceled() )
+      if ( feedback && feedback->isCanceled() )
       {
         outputFile.remove();
         return 3;
       }
-      feedback->setProgress( 100.0 * i / static_cast< double >( mNumRows ) );
+
+      const GridRow &row = batch[i];
+      for ( std::size_t j = 0; j < row.values.size(); ++j )
+      {
+        if ( row.valid[j] )
+        {
+          outStream << row.values[j] << ' ';
+        }
+        else
+        {
+          outStream << "-9999 ";
+        }
+      }
+      outStream << endl;
+
+      if ( feedback )
+      {
+        feedback->setProgress( 100.0 * ( firstRow + i ) / static_cast< double >( mNumRows ) );
+      }
     }
   }
 
@@ -48,6 +48,10 @@ class ANALYSIS_EXPORT QgsGridFileWriter
      *
      * An optional \a feedback object can be set for progress reports and cancellation support
      *
+     * Interpolators which support it compute blocks of rows at once (see QgsInterpolator::interpolateBlock()).
+     * Otherwise, if the interpolator is thread safe (see QgsInterpolator::isThreadSafe()), batches of
+     * rows are interpolated in parallel.
+     *
      * \returns 0 in case of success
     */
     int writeFile( QgsFeedback *feedback = nullptr );
@@ -17,18 +17,120 @@
 
 #include "qgsidwinterpolator.h"
 #include "qgis.h"
+#include "qgsrectangle.h"
+#include "qgsspatialindexkdbushdata.h"
+#include "kdbush.hpp"
+#include <algorithm>
 #include <cmath>
-#include <limits>
+#include <vector>
+
+///@cond PRIVATE
+
+/**
+ * KD-tree of the cached interpolation base data. The id of the indexed items is the
+ * position of the vertex in the cached data.
+ */
+class QgsIDWInterpolatorIndex : public kdbush::KDBush< std::pair<double, double>, QgsSpatialIndexKDBushData, std::size_t >
+{
+  public:
+
+    explicit QgsIDWInterpolatorIndex( const QVector<QgsInterpolatorVertexData> &data )
+    {
+      mExtent.setMinimal();
+      points.reserve( data.size() );
+      for ( int i = 0; i < data.size(); ++i )
+      {
+        const QgsInterpolatorVertexData &vertex = data.at( i );
+        points.emplace_back( QgsSpatialIndexKDBushData( i, vertex.x, vertex.y ) );
+        mExtent.combineExtentWith( vertex.x, vertex.y );
+      }
+      if ( !points.empty() )
+        sortKD( 0, points.size() - 1, 0 );
+    }
+
+    std::size_t size() const { return points.size(); }
+
+    /**
+     * Returns a search radius which is expected to contain about \a count points,
+     * assuming the points are evenly distributed over their extent.
+     */
+    double estimatedRadius( std::size_t count ) const
+    {
+      const double area = mExtent.width() * mExtent.height();
+      if ( area > 0 )
+        return std::sqrt( count * area / ( M_PI * points.size() ) );
+
+      // collinear or duplicate points
+      const double length = std::max( mExtent.width(), mExtent.height() );
+      return length > 0 ? length * count / points.size() : 1;
+    }
+
+    //! Returns a search radius around \a x, \a y which contains all indexed points
+    double maximumRadius( double x, double y ) const
+    {
+      const double dx = std::max( std::fabs( x - mExtent.xMinimum() ), std::fabs( x - mExtent.xMaximum() ) );
+      const double dy = std::max( std::fabs( y - mExtent.yMinimum() ), std::fabs( y - mExtent.yMaximum() ) );
+      return std::sqrt( dx * dx + dy * dy );
+    }
+
+  private:
+
+    QgsRectangle mExtent;
+};
+
+///@endcond
 
 QgsIDWInterpolator::QgsIDWInterpolator( const QList<LayerData> &layerData )
   : QgsInterpolator( layerData )
 {}
 
+QgsIDWInterpolator::~QgsIDWInterpolator() = default;
+
+bool QgsIDWInterpolator::isThreadSafe() const
+{
+  return true;
+}
+
+void QgsIDWInterpolator::setSearchRadius( double radius )
+{
+  mSearchRadius = std::max( 0.0, radius );
+}
+
+void QgsIDWInterpolator::setMaximumPoints( int points )
+{
+  mMaximumPoints = std::max( 0, points );
+}
+
+bool QgsIDWInterpolator::prepare( QgsFeedback *feedback )
+{
+  if ( !mIsPrepared )
+  {
+    // the data is only cached once, also if the sources are empty, so that no cache
+    // is written while other threads are interpolating
+    if ( !mDataIsCached && cacheBaseData( feedback ) == Canceled )
+      return false;
+    mIsPrepared = true;
+  }
+
+  if ( ( mSearchRadius > 0 || mMaximumPoints > 0 ) && !mIndex )
+  {
+    mIndex.reset( new QgsIDWInterpolatorIndex( mCachedBaseData ) );
+  }
+  return true;
+}
+
 int QgsIDWInterpolator::interpolatePoint( double x, double y, double &result, QgsFeedback *feedback )
 {
-  if ( !mDataIsCached )
+  const bool useIndex = mSearchRadius > 0 || mMaximumPoints > 0;
+  if ( !mIsPrepared || ( useIndex && !mIndex ) )
   {
-    cacheBaseData( feedback );
+    if ( !prepare( feedback ) )
+      return 1;
+  }
+
+  if ( useIndex )
+  {
+    return interpolateIndexed( x, y, result );
   }
 
   double sumCounter = 0;
@@ -55,3 +157,80 @@ int QgsIDWInterpolator::interpolatePoint( double x, double y, double &result, Qg
   result = sumCounter / sumDenominator;
   return 0;
 }
+
+int QgsIDWInterpolator::interpolateIndexed( double x, double y, double &result ) const
+{
+  if ( mIndex->size() == 0 )
+    return 1;
+
+  // squared distance and position in the cached data of the neighbor points
+  std::vector< std::pair< double, int > > neighbors;
+  auto addNeighbor = [&neighbors, x, y]( const QgsSpatialIndexKDBushData & point )
+  {
+    const double dx = point.coords.first - x;
+    const double dy = point.coords.second - y;
+    neighbors.emplace_back( dx * dx + dy * dy, static_cast< int >( point.id ) );
+  };
+
+  if ( mMaximumPoints == 0 )
+  {
+    mIndex->within( x, y, mSearchRadius, addNeighbor );
+  }
+  else
+  {
+    // the index has no nearest neighbor query, so search within a growing radius
+    // until enough points are found
+    const std::size_t count = std::min( mIndex->size(), static_cast< std::size_t >( mMaximumPoints ) );
+    const double maximumRadius = mIndex->maximumRadius( x, y );
+    double radius = mIndex->estimatedRadius( count );
+    while ( true )
+    {
+      bool lastSearch = false;
+      if ( mSearchRadius > 0 && radius >= mSearchRadius )
+      {
+        radius = mSearchRadius;
+        lastSearch = true;
+      }
+      if ( radius >= maximumRadius )
+        lastSearch = true;
+
+      neighbors.clear();
+      mIndex->within( x, y, radius, addNeighbor );
+      if ( neighbors.size() >= count || lastSearch )
+        break;
+
+      radius *= 2;
+    }
+
+    if ( neighbors.size() > count )
+    {
+      std::nth_element( neighbors.begin(), neighbors.begin() + count, neighbors.end() );
+      neighbors.resize( count );
+    }
+  }
+
+  double sumCounter = 0;
+  double sumDenominator = 0;
+
+  for ( const std::pair< double, int > &neighbor : neighbors )
+  {
+    const QgsInterpolatorVertexData &vertex = mCachedBaseData.at( neighbor.second );
+    double distance = std::sqrt( neighbor.first );
+    if ( qgsDoubleNear( distance, 0.0 ) )
+    {
+      result = vertex.z;
+      return 0;
+    }
+    double currentWeight = 1 / ( std::pow( distance, mDistanceCoefficient ) );
+    sumCounter += ( currentWeight * vertex.z );
+    sumDenominator += currentWeight;
+  }
+
+  if ( sumDenominator == 0.0 )
+  {
+    return 1;
+  }
+
+  result = sumCounter / sumDenominator;
+  return 0;
+}
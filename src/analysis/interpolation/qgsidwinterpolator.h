@@ -21,10 +21,19 @@
 #include "qgsinterpolator.h"
 #include "qgis_analysis.h"
 
+#include <memory>
+
+class QgsIDWInterpolatorIndex;
+
 /**
  * \ingroup analysis
  * \class QgsIDWInterpolator
  * Inverse distance weight interpolator.
+ *
+ * By default every data point contributes to each interpolated value. Setting a
+ * searchRadius() or a maximumPoints() count restricts the contributing points to the
+ * neighborhood of the interpolated location, which is found using a spatial index
+ * and makes interpolation of large data sets feasible.
  */
 class ANALYSIS_EXPORT QgsIDWInterpolator: public QgsInterpolator
 {
@@ -35,8 +44,12 @@ class ANALYSIS_EXPORT QgsIDWInterpolator: public QgsInterpolator
      */
     QgsIDWInterpolator( const QList<QgsInterpolator::LayerData> &layerData );
 
+    ~QgsIDWInterpolator() override;
+
     int interpolatePoint( double x, double y, double &result SIP_OUT, QgsFeedback *feedback = nullptr ) override;
 
+    bool isThreadSafe() const override;
+
     /**
      * Sets the distance \a coefficient, the parameter that sets how the values are
      * weighted with distance. Smaller values mean sharper peaks at the data points.
@@ -60,11 +73,71 @@ class ANALYSIS_EXPORT QgsIDWInterpolator: public QgsInterpolator
     */
     double distanceCoefficient() const { return mDistanceCoefficient; }
 
+    /**
+     * Sets the search \a radius (in map units). Only points within this distance
+     * of the interpolated location are used, and locations without any point within the
+     * radius are not interpolated.
+     *
+     * A radius of 0 (the default) means that the search is not limited by distance.
+     *
+     * \see searchRadius()
+     * \since QGIS 3.12
+     */
+    void setSearchRadius( double radius );
+
+    /**
+     * Returns the search radius (in map units), or 0 if the search is not limited by distance.
+     *
+     * \see setSearchRadius()
+     * \since QGIS 3.12
+     */
+    double searchRadius() const { return mSearchRadius; }
+
+    /**
+     * Sets the maximum number of nearest \a points used to interpolate each location.
+     *
+     * A value of 0 (the default) means that all points (within the searchRadius(), if set)
+     * are used.
+     *
+     * \see maximumPoints()
+     * \since QGIS 3.12
+     */
+    void setMaximumPoints( int points );
+
+    /**
+     * Returns the maximum number of nearest points used to interpolate each location,
+     * or 0 if the number of points is not limited.
+     *
+     * \see setMaximumPoints()
+     * \since QGIS 3.12
+     */
+    int maximumPoints() const { return mMaximumPoints; }
+
   private:
 
     QgsIDWInterpolator() = delete;
 
+#ifdef SIP_RUN
+    QgsIDWInterpolator( const QgsIDWInterpolator &other );
+#endif
+
+    /**
+     * Caches the base data and builds the spatial index if required, so that
+     * interpolatePoint() can afterwards be called concurrently.
+     * Returns FALSE if caching was canceled.
+     */
+    bool prepare( QgsFeedback *feedback );
+
+    //! Interpolates using only the points found in the spatial index
+    int interpolateIndexed( double x, double y, double &result ) const;
+
     double mDistanceCoefficient = 2.0;
+    double mSearchRadius = 0;
+    int mMaximumPoints = 0;
+    bool mIsPrepared = false;
+
+    //! Spatial index of the cached base data, built on demand
+    std::unique_ptr< QgsIDWInterpolatorIndex > mIndex;
 };
 
 #endif
@@ -28,6 +28,11 @@ QgsInterpolator::QgsInterpolator( const QList<LayerData> &layerData )
 
 }
 
+bool QgsInterpolator::interpolateBlock( const QVector<double> &, const QVector<double> &, QVector<double> &, QgsFeedback * )
+{
+  return false;
+}
+
 QgsInterpolator::Result QgsInterpolator::cacheBaseData( QgsFeedback *feedback )
 {
   if ( mLayerData.empty() )
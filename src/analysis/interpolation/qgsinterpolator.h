@@ -125,6 +125,32 @@ class ANALYSIS_EXPORT QgsInterpolator
      */
     virtual int interpolatePoint( double x, double y, double &result SIP_OUT, QgsFeedback *feedback = nullptr ) = 0;
 
+    /**
+     * Interpolates the values at the intersections of the columns at \a xValues and the rows at \a yValues,
+     * typically the centers of the cells of a block of a grid. The \a xValues must be in ascending order.
+     *
+     * On success, \a values contains the interpolated values row by row, with NaN for the cells which could
+     * not be interpolated. Interpolators which can compute many values at once more efficiently than by
+     * repeated calls to interpolatePoint() implement this method.
+     *
+     * An optional \a feedback object can be set for cancellation support.
+     *
+     * The default implementation returns FALSE, meaning that interpolatePoint() has to be used for each cell instead.
+     *
+     * \since QGIS 3.12
+     */
+    virtual bool interpolateBlock( const QVector< double > &xValues, const QVector< double > &yValues, QVector< double > &values SIP_OUT, QgsFeedback *feedback = nullptr );
+
+    /**
+     * Returns TRUE if interpolatePoint() may be called concurrently from several threads
+     * once a first call to interpolatePoint() has returned.
+     *
+     * The default implementation returns FALSE.
+     *
+     * \since QGIS 3.12
+     */
+    virtual bool isThreadSafe() const { return false; }
+
     //! \note not available in Python bindings
     QList<LayerData> layerData() const { return mLayerData; } SIP_SKIP
 
@@ -27,11 +27,19 @@
 #include "qgsvectorlayer.h"
 #include "qgswkbptr.h"
 #include "qgsfeedback.h"
+#include "qgsmessagelog.h"
 #include "qgscurve.h"
 #include "qgsmulticurve.h"
 #include "qgscurvepolygon.h"
 #include "qgsmultisurface.h"
 
+#include <QThread>
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
 QgsTinInterpolator::QgsTinInterpolator( const QList<LayerData> &inputData, TinInterpolation interpolation, QgsFeedback *feedback )
   : QgsInterpolator( inputData )
   , mIsInitialized( false )
@@ -67,6 +75,206 @@ int QgsTinInterpolator::interpolatePoint( double x, double y, double &result, Qg
   return 0;
 }
 
+bool QgsTinInterpolator::interpolateBlock( const QVector<double> &xValues, const QVector<double> &yValues, QVector<double> &values, QgsFeedback *feedback )
+{
+  // Clough-Tocher patches depend on the neighborhood of each triangle in the triangulation,
+  // so they are evaluated cell by cell
+  if ( mInterpolation != Linear )
+  {
+    return false;
+  }
+
+  if ( !mIsInitialized )
+  {
+    initialize();
+  }
+
+  const DualEdgeTriangulation *triangulation = dynamic_cast< const DualEdgeTriangulation * >( mTriangulation );
+  if ( !triangulation )
+  {
+    return false;
+  }
+
+  const int nCols = xValues.size();
+  const int nRows = yValues.size();
+  values.fill( std::numeric_limits<double>::quiet_NaN(), nCols * nRows );
+  if ( nCols == 0 || nRows == 0 )
+  {
+    return true;
+  }
+
+  if ( mBandOffsets.isEmpty() )
+  {
+    prepareBlockInterpolation( triangulation );
+  }
+  if ( mTriangles.isEmpty() )
+  {
+    return true;
+  }
+
+  // each task fills a range of rows, from the triangles of the bands overlapping these rows
+  struct RowRange
+  {
+    int firstRow;
+    int lastRow;
+  };
+  const int threadCount = std::max( 1, QThread::idealThreadCount() );
+  const int rowsPerTask = std::max( 1, nRows / ( 4 * threadCount ) );
+  std::vector< RowRange > tasks;
+  for ( int row = 0; row < nRows; row += rowsPerTask )
+  {
+    tasks.push_back( { row, std::min( nRows, row + rowsPerTask ) - 1 } );
+  }
+
+  const int bandCount = mBandOffsets.size() - 1;
+  double *data = values.data();
+  auto bandOf = [this, bandCount]( double y )
+  {
+    if ( mBandHeight <= 0 )
+      return 0;
+    return std::min( bandCount - 1, std::max( 0, static_cast< int >( ( y - mBandYMin ) / mBandHeight ) ) );
+  };
+
+  auto fillRows = [&]( const RowRange & task )
+  {
+    if ( feedback && feedback->isCanceled() )
+      return;
+
+    double rangeYMin = yValues.at( task.firstRow );
+    double rangeYMax = rangeYMin;
+    for ( int row = task.firstRow + 1; row <= task.lastRow; ++row )
+    {
+      rangeYMin = std::min( rangeYMin, yValues.at( row ) );
+      rangeYMax = std::max( rangeYMax, yValues.at( row ) );
+    }
+    const int firstBand = bandOf( rangeYMin );
+    const int lastBand = bandOf( rangeYMax );
+
+    for ( int band = firstBand; band <= lastBand; ++band )
+    {
+      for ( int i = mBandOffsets.at( band ); i < mBandOffsets.at( band + 1 ); ++i )
+      {
+        const int triangle = mBandTriangles.at( i );
+        const QgsPoint *p1 = triangulation->getPoint( mTriangles.at( 3 * triangle ) );
+        const QgsPoint *p2 = triangulation->getPoint( mTriangles.at( 3 * triangle + 1 ) );
+        const QgsPoint *p3 = triangulation->getPoint( mTriangles.at( 3 * triangle + 2 ) );
+
+        const double triangleYMin = std::min( { p1->y(), p2->y(), p3->y() } );
+        const double triangleYMax = std::max( { p1->y(), p2->y(), p3->y() } );
+        // triangles spanning several bands are only handled once
+        if ( band > firstBand && bandOf( triangleYMin ) < band )
+          continue;
+        if ( triangleYMax < rangeYMin || triangleYMin > rangeYMax )
+          continue;
+
+        // plane through the triangle, as calculated by LinTriangleInterpolator
+        const double denominatorA = ( p1->x() - p2->x() ) * ( p2->y() - p3->y() ) - ( p2->x() - p3->x() ) * ( p1->y() - p2->y() );
+        const double denominatorB = ( p1->y() - p2->y() ) * ( p2->x() - p3->x() ) - ( p2->y() - p3->y() ) * ( p1->x() - p2->x() );
+        if ( denominatorA == 0 || denominatorB == 0 )
+          continue;
+        const double a = ( p1->z() * ( p2->y() - p3->y() ) + p2->z() * ( p3->y() - p1->y() ) + p3->z() * ( p1->y() - p2->y() ) ) / denominatorA;
+        const double b = ( p1->z() * ( p2->x() - p3->x() ) + p2->z() * ( p3->x() - p1->x() ) + p3->z() * ( p1->x() - p2->x() ) ) / denominatorB;
+        const double c = p1->z() - a * p1->x() - b * p1->y();
+
+        const QgsPoint *edges[3][2] = { { p1, p2 }, { p2, p3 }, { p3, p1 } };
+        for ( int row = task.firstRow; row <= task.lastRow; ++row )
+        {
+          const double y = yValues.at( row );
+          if ( y < triangleYMin || y > triangleYMax )
+            continue;
+
+          // horizontal extent of the triangle at this row
+          double xMin = std::numeric_limits<double>::max();
+          double xMax = -std::numeric_limits<double>::max();
+          for ( const auto &edge : edges )
+          {
+            const QgsPoint *a = edge[0];
+            const QgsPoint *b = edge[1];
+            if ( ( y < a->y() && y < b->y() ) || ( y > a->y() && y > b->y() ) )
+              continue;
+
+            if ( a->y() == b->y() )
+            {
+              xMin = std::min( { xMin, a->x(), b->x() } );
+              xMax = std::max( { xMax, a->x(), b->x() } );
+            }
+            else
+            {
+              const double x = a->x() + ( y - a->y() ) * ( b->x() - a->x() ) / ( b->y() - a->y() );
+              xMin = std::min( xMin, x );
+              xMax = std::max( xMax, x );
+            }
+          }
+
+          double *rowData = data + static_cast< std::size_t >( row ) * nCols;
+          for ( auto it = std::lower_bound( xValues.constBegin(), xValues.constEnd(), xMin ); it != xValues.constEnd() && *it <= xMax; ++it )
+          {
+            rowData[ it - xValues.constBegin() ] = a * *it + b * y + c;
+          }
+        }
+      }
+    }
+  };
+
+  QtConcurrent::blockingMap( tasks, fillRows );
+  return true;
+}
+
+void QgsTinInterpolator::prepareBlockInterpolation( const DualEdgeTriangulation *triangulation )
+{
+  mTriangles = triangulation->getTriangles();
+  const int triangleCount = mTriangles.size() / 3;
+
+  // about one triangle per band and column of bands
+  const int bandCount = std::max( 1, static_cast< int >( std::sqrt( static_cast< double >( triangleCount ) ) ) );
+  mBandYMin = triangulation->getYMin();
+  mBandHeight = ( triangulation->getYMax() - triangulation->getYMin() ) / bandCount;
+
+  auto bandRange = [this, triangulation, bandCount]( int triangle, int &firstBand, int &lastBand )
+  {
+    double yMin = std::numeric_limits<double>::max();
+    double yMax = -std::numeric_limits<double>::max();
+    for ( int i = 0; i < 3; ++i )
+    {
+      const double y = triangulation->getPoint( mTriangles.at( 3 * triangle + i ) )->y();
+      yMin = std::min( yMin, y );
+      yMax = std::max( yMax, y );
+    }
+    if ( mBandHeight <= 0 )
+    {
+      firstBand = 0;
+      lastBand = 0;
+      return;
+    }
+    firstBand = std::min( bandCount - 1, std::max( 0, static_cast< int >( ( yMin - mBandYMin ) / mBandHeight ) ) );
+    lastBand = std::min( bandCount - 1, std::max( 0, static_cast< int >( ( yMax - mBandYMin ) / mBandHeight ) ) );
+  };
+
+  // count the triangles of each band, then fill the bands
+  mBandOffsets.fill( 0, bandCount + 1 );
+  int firstBand = 0;
+  int lastBand = 0;
+  for ( int triangle = 0; triangle < triangleCount; ++triangle )
+  {
+    bandRange( triangle, firstBand, lastBand );
+    for ( int band = firstBand; band <= lastBand; ++band )
+      mBandOffsets[band + 1]++;
+  }
+  for ( int band = 0; band < bandCount; ++band )
+  {
+    mBandOffsets[band + 1] += mBandOffsets[band];
+  }
+
+  mBandTriangles.resize( mBandOffsets.at( bandCount ) );
+  QVector< int > position = mBandOffsets;
+  for ( int triangle = 0; triangle < triangleCount; ++triangle )
+  {
+    bandRange( triangle, firstBand, lastBand );
+    for ( int band = firstBand; band <= lastBand; ++band )
+      mBandTriangles[position[band]++] = triangle;
+  }
+}
+
 QgsFields QgsTinInterpolator::triangulationFields()
 {
   return Triangulation::triangulationFields();
@@ -143,6 +351,28 @@ void QgsTinInterpolator::initialize()
     }
   }
 
+  // the points are inserted at once, in an order which makes the triangulation much faster to build,
+  // and the lines afterwards, so that they are not split by the points
+  if ( !mFeedback || !mFeedback->isCanceled() )
+  {
+    const int failures = mTriangulation->addPoints( mPointsToInsert, mFeedback );
+    if ( failures > 0 )
+    {
+      QgsMessageLog::logMessage( QObject::tr( "%n point(s) could not be inserted into the triangulation because of numerical problems", nullptr, failures ),
+                                 QObject::tr( "Interpolation" ), Qgis::Warning );
+    }
+  }
+  mPointsToInsert.clear();
+  mPointsToInsert.squeeze();
+
+  for ( const QPair< QVector< QgsPoint >, SourceType > &line : qgis::as_const( mLinesToInsert ) )
+  {
+    if ( mFeedback && mFeedback->isCanceled() )
+      break;
+    mTriangulation->addLine( line.first, line.second );
+  }
+  mLinesToInsert.clear();
+
   if ( mInterpolation == CloughTocher )
   {
     CloughTocherInterpolator *ctInterpolator = new CloughTocherInterpolator();
@@ -214,8 +444,7 @@ int QgsTinInterpolator::insertData( const QgsFeature &f, QgsInterpolator::ValueS
   {
     case SourcePoints:
     {
-      if ( addPointsFromGeometry( g, source, attributeValue ) != 0 )
-        return -1;
+      addPointsFromGeometry( g, source, attributeValue );
       break;
     }
 
@@ -226,8 +455,7 @@ int QgsTinInterpolator::insertData( const QgsFeature &f, QgsInterpolator::ValueS
       {
         case QgsWkbTypes::PointGeometry:
         {
-          if ( addPointsFromGeometry( g, source, attributeValue ) != 0 )
-            return -1;
+          addPointsFromGeometry( g, source, attributeValue );
           break;
         }
 
@@ -309,7 +537,7 @@ int QgsTinInterpolator::insertData( const QgsFeature &f, QgsInterpolator::ValueS
 
               linePoints.append( QgsPoint( p.x(), p.y(), z ) );
             }
-            mTriangulation->addLine( linePoints, type );
+            mLinesToInsert.append( qMakePair( linePoints, type ) );
           }
           break;
         }
@@ -325,7 +553,7 @@ int QgsTinInterpolator::insertData( const QgsFeature &f, QgsInterpolator::ValueS
 }
 
 
-int QgsTinInterpolator::addPointsFromGeometry( const QgsGeometry &g, ValueSource source, double attributeValue )
+void QgsTinInterpolator::addPointsFromGeometry( const QgsGeometry &g, ValueSource source, double attributeValue )
 {
   // loop through all vertices and add to triangulation
   for ( auto point = g.vertices_begin(); point != g.vertices_end(); ++point )
@@ -346,10 +574,6 @@ int QgsTinInterpolator::addPointsFromGeometry( const QgsGeometry &g, ValueSource
         z = p.m();
         break;
     }
-    if ( mTriangulation->addPoint( QgsPoint( p.x(), p.y(), z ) ) == -100 )
-    {
-      return -1;
-    }
+    mPointsToInsert.append( QgsPoint( p.x(), p.y(), z ) );
   }
-  return 0;
 }
@@ -20,10 +20,13 @@
 
 #include "qgsinterpolator.h"
 #include <QString>
+#include <QPair>
+#include <QVector>
 #include "qgis_analysis.h"
 
 class QgsFeatureSink;
 class Triangulation;
+class DualEdgeTriangulation;
 class TriangleInterpolator;
 class QgsFeature;
 class QgsFeedback;
@@ -55,6 +58,14 @@ class ANALYSIS_EXPORT QgsTinInterpolator: public QgsInterpolator
 
     int interpolatePoint( double x, double y, double &result SIP_OUT, QgsFeedback *feedback ) override;
 
+    /**
+     * Interpolates a block of cells triangle by triangle, in parallel. This is only supported
+     * for Linear interpolation.
+     *
+     * \since QGIS 3.12
+     */
+    bool interpolateBlock( const QVector< double > &xValues, const QVector< double > &yValues, QVector< double > &values SIP_OUT, QgsFeedback *feedback = nullptr ) override;
+
     /**
      * Returns the fields output by features when saving the triangulation.
      * These fields should be used when creating
@@ -86,20 +97,38 @@ class ANALYSIS_EXPORT QgsTinInterpolator: public QgsInterpolator
     //! Type of interpolation
     TinInterpolation mInterpolation;
 
+    //! Points and lines collected by insertData(), which are added to the triangulation once all features were read
+    QVector< QgsPoint > mPointsToInsert;
+    QList< QPair< QVector< QgsPoint >, SourceType > > mLinesToInsert;
+
+    //! Point numbers of the triangles, three for each triangle, used by interpolateBlock()
+    QVector< int > mTriangles;
+    //! Offsets into mBandTriangles of the triangles overlapping each horizontal band of the triangulation extent
+    QVector< int > mBandOffsets;
+    //! Numbers of the triangles overlapping each band
+    QVector< int > mBandTriangles;
+    double mBandYMin = 0;
+    double mBandHeight = 0;
+
     //! Create dual edge triangulation
     void initialize();
 
+    //! Builds the list of triangles and their horizontal bands used by interpolateBlock()
+    void prepareBlockInterpolation( const DualEdgeTriangulation *triangulation );
+
     /**
-     * Inserts the vertices of a feature into the triangulation
+     * Collects the vertices of a feature for insertion into the triangulation
      * \param f the feature
      * \param source source for feature values to interpolate
      * \param attr interpolation attribute index (if zCoord is FALSE)
      * \param type point/structure line, break line
-     * \returns 0 in case of success, -1 if the feature could not be inserted because of numerical problems
+     * \returns 0 in case of success. Points are only collected here and inserted into the triangulation
+     * by initialize(), which logs a warning for points which could not be inserted because of numerical problems
     */
     int insertData( const QgsFeature &f, QgsInterpolator::ValueSource source, int attr, SourceType type );
 
-    int addPointsFromGeometry( const QgsGeometry &g, ValueSource source, double attributeValue );
+    //! Collects the vertices of \a g in the list of points inserted at once by initialize()
+    void addPointsFromGeometry( const QgsGeometry &g, ValueSource source, double attributeValue );
 };
 
 #endif
@@ -104,8 +104,107 @@ QStringList QgsMeshCalcNode::usedDatasetGroupNames() const
   return res;
 }
 
+QStringList QgsMeshCalcNode::nonAggregatedDatasetGroupNames() const
+{
+  QStringList res;
+
+  if ( isAggregate() )
+  {
+    return res;
+  }
+
+  if ( mType == tDatasetGroupRef )
+  {
+    res.append( mDatasetGroupName );
+  }
+
+  if ( mLeft )
+  {
+    res += mLeft->nonAggregatedDatasetGroupNames();
+  }
+
+  if ( mRight )
+  {
+    res += mRight->nonAggregatedDatasetGroupNames();
+  }
+
+  if ( mCondition )
+  {
+    res += mCondition->nonAggregatedDatasetGroupNames();
+  }
+
+  return res;
+}
+
+QgsMeshCalcNode::Operator QgsMeshCalcNode::operatorType() const
+{
+  return mOperator;
+}
+
+const QgsMeshCalcNode *QgsMeshCalcNode::left() const
+{
+  return mLeft.get();
+}
+
+bool QgsMeshCalcNode::isAggregate() const
+{
+  if ( mType != tOperator )
+    return false;
+
+  switch ( mOperator )
+  {
+    case opSUM_AGGR:
+    case opMAX_AGGR:
+    case opMIN_AGGR:
+    case opAVG_AGGR:
+      return true;
+    default:
+      return false;
+  }
+}
+
+QList<const QgsMeshCalcNode *> QgsMeshCalcNode::aggregateNodes() const
+{
+  QList<const QgsMeshCalcNode *> res;
+
+  if ( mLeft )
+  {
+    res += mLeft->aggregateNodes();
+  }
+
+  if ( mRight )
+  {
+    res += mRight->aggregateNodes();
+  }
+
+  if ( mCondition )
+  {
+    res += mCondition->aggregateNodes();
+  }
+
+  if ( isAggregate() )
+  {
+    res.append( this );
+  }
+
+  return res;
+}
+
 bool QgsMeshCalcNode::calculate( const  QgsMeshCalcUtils &dsu, QgsMeshMemoryDatasetGroup &result ) const
 {
+  if ( isAggregate() )
+  {
+    // the aggregation may have been calculated already, e.g. from datasets read one by one
+    const std::shared_ptr<const QgsMeshMemoryDatasetGroup> aggregated = dsu.aggregatedGroup( this );
+    if ( aggregated )
+    {
+      result.clearDatasets();
+      for ( int i = 0; i < aggregated->datasetCount(); ++i )
+        result.addDataset( dsu.copy( aggregated->constDataset( i ) ) );
+      return true;
+    }
+  }
+
   if ( mType == tDatasetGroupRef )
   {
     dsu.copy( result, mDatasetGroupName );
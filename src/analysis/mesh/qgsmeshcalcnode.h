@@ -139,6 +139,37 @@ class ANALYSIS_EXPORT QgsMeshCalcNode
     //! Returns all dataset group names used in formula
     QStringList usedDatasetGroupNames() const;
 
+    /**
+     * Returns dataset group names used in formula outside of arguments of aggregate operators
+     * \since QGIS 3.12
+     */
+    QStringList nonAggregatedDatasetGroupNames() const;
+
+    /**
+     * Returns operator of the node
+     * \since QGIS 3.12
+     */
+    Operator operatorType() const;
+
+    /**
+     * Returns left node (the argument of unary operators)
+     * \since QGIS 3.12
+     */
+    const QgsMeshCalcNode *left() const;
+
+    /**
+     * Returns whether the node is an aggregate operator (e.g. sum_aggr)
+     * \since QGIS 3.12
+     */
+    bool isAggregate() const;
+
+    /**
+     * Returns all aggregate operator nodes of the formula. Nested aggregate operators
+     * are always listed before the aggregate operators which contain them.
+     * \since QGIS 3.12
+     */
+    QList<const QgsMeshCalcNode *> aggregateNodes() const;
+
     /**
      * Parses string to calculation node. Caller takes responsibility to delete the node
      * \param str string with formula definition
@@ -16,6 +16,9 @@
  ***************************************************************************/
 
 #include <QFileInfo>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <functional>
 #include <limits>
 #include <memory>
 
@@ -66,7 +69,7 @@ QgsMeshCalculator::Result QgsMeshCalculator::expression_valid( const QString &fo
 
   double startTime = -std::numeric_limits<double>::max();
   double endTime = std::numeric_limits<double>::max();
-  QgsMeshCalcUtils dsu( layer, calcNode->usedDatasetGroupNames(), startTime, endTime );
+  QgsMeshCalcUtils dsu( layer, calcNode->usedDatasetGroupNames(), startTime, endTime, false );
   if ( !dsu.isValid() )
   {
     return InvalidDatasets;
@@ -75,10 +78,61 @@ QgsMeshCalculator::Result QgsMeshCalculator::expression_valid( const QString &fo
   return Success;
 }
 
-QgsMeshCalculator::Result QgsMeshCalculator::processCalculation( QgsFeedback *feedback )
+/**
+ * Evaluates time steps of the calculation in parallel and passes the results to \a consume in the order of time steps
+ */
+static QgsMeshCalculator::Result evaluateTimesteps( const QgsMeshCalcUtils &dsu, int timeCount,
+    const std::function<bool( const QgsMeshCalcUtils &, QgsMeshMemoryDatasetGroup & )> &evaluate,
+    const std::function<void( int, const QgsMeshMemoryDatasetGroup & )> &consume,
+    QgsFeedback *feedback, double progressStart, double progressEnd )
 {
-  Q_UNUSED( feedback )
+  struct TimestepResult
+  {
+    int timeIndex;
+    std::unique_ptr<QgsMeshMemoryDatasetGroup> group;
+    bool ok;
+  };
+
+  // time steps are evaluated in batches, so that only a few of them are kept in memory at once
+  const int batchSize = std::max( 1, QThread::idealThreadCount() );
+  for ( int batchStart = 0; batchStart < timeCount; batchStart += batchSize )
+  {
+    if ( feedback && feedback->isCanceled() )
+    {
+      return QgsMeshCalculator::Canceled;
+    }
+
+    std::vector<TimestepResult> batch;
+    for ( int timeIndex = batchStart; timeIndex < std::min( timeCount, batchStart + batchSize ); ++timeIndex )
+      batch.push_back( TimestepResult{ timeIndex, nullptr, false } );
 
+    QtConcurrent::blockingMap( batch, [&dsu, &evaluate]( TimestepResult & result )
+    {
+      const std::unique_ptr<QgsMeshCalcUtils> step = dsu.timestep( result.timeIndex );
+      result.group = qgis::make_unique<QgsMeshMemoryDatasetGroup>( QStringLiteral( "output" ) );
+      result.ok = evaluate( *step, *result.group );
+    } );
+
+    // results are passed on in the order of time steps
+    for ( const TimestepResult &result : batch )
+    {
+      if ( !result.ok )
+      {
+        return QgsMeshCalculator::EvaluateError;
+      }
+      consume( result.timeIndex, *result.group );
+    }
+
+    if ( feedback )
+    {
+      feedback->setProgress( progressStart + ( progressEnd - progressStart ) * std::min( timeCount, batchStart + batchSize ) / timeCount );
+    }
+  }
+  return QgsMeshCalculator::Success;
+}
+
+QgsMeshCalculator::Result QgsMeshCalculator::processCalculation( QgsFeedback *feedback )
+{
   // check input
   if ( mOutputFile.isEmpty() )
   {
@@ -101,42 +155,103 @@ QgsMeshCalculator::Result QgsMeshCalculator::processCalculation( QgsFeedback *fe
     return ParserError;
   }
 
-  QgsMeshCalcUtils dsu( mMeshLayer, calcNode->usedDatasetGroupNames(), mStartTime, mEndTime );
+  // only groups without time steps are read to memory here, time steps of other groups
+  // are read one by one when evaluating them
+  QgsMeshCalcUtils dsu( mMeshLayer, calcNode->usedDatasetGroupNames(), mStartTime, mEndTime, false );
   if ( !dsu.isValid() )
   {
     return InvalidDatasets;
   }
 
-  //open output dataset
-  std::unique_ptr<QgsMeshMemoryDatasetGroup> outputGroup = qgis::make_unique<QgsMeshMemoryDatasetGroup> ( mOutputFile );
+  // the filter is shared by all time steps, creating it also prepares the mesh
+  // before it is used from the worker threads
+  const std::shared_ptr<const QgsMeshMemoryDatasetGroup> filter = mUseMask ? dsu.maskFilter( mOutputMask )
+      : dsu.spatialFilter( mOutputExtent );
 
-  // calculate
-  bool ok = calcNode->calculate( dsu, *outputGroup );
-  if ( !ok )
-  {
-    return EvaluateError;
-  }
+  const QList<const QgsMeshCalcNode *> aggregateNodes = calcNode->aggregateNodes();
+  const bool timeVarying = dsu.isTimeVarying( calcNode->nonAggregatedDatasetGroupNames() );
+  const int timeCount = dsu.timestepCount();
+  const int evaluatedTimeCount = timeVarying ? timeCount : 1;
 
-  if ( feedback && feedback->isCanceled() )
-  {
-    return Canceled;
-  }
-  if ( feedback )
+  // share of the progress for each evaluation pass over the time steps (aggregates + the formula)
+  const double passProgress = 80.0 / ( aggregateNodes.size() + 1 );
+  double progress = 0;
+
+  // aggregate operators need all time steps of their argument, so they are evaluated before the formula
+  for ( const QgsMeshCalcNode *node : aggregateNodes )
   {
-    feedback->setProgress( 60.0 );
+    QgsMeshCalcAggregator::Aggregate aggregate = QgsMeshCalcAggregator::Sum;
+    switch ( node->operatorType() )
+    {
+      case QgsMeshCalcNode::opMAX_AGGR:
+        aggregate = QgsMeshCalcAggregator::Maximum;
+        break;
+      case QgsMeshCalcNode::opMIN_AGGR:
+        aggregate = QgsMeshCalcAggregator::Minimum;
+        break;
+      case QgsMeshCalcNode::opAVG_AGGR:
+        aggregate = QgsMeshCalcAggregator::Average;
+        break;
+      default:
+        break;
+    }
+
+    const int valueCount = dsu.outputType() == QgsMeshDatasetGroupMetadata::DataOnVertices ?
+                           mMeshLayer->dataProvider()->vertexCount() : mMeshLayer->dataProvider()->faceCount();
+    QgsMeshCalcAggregator aggregator( aggregate, valueCount );
+    const bool argumentTimeVarying = dsu.isTimeVarying( node->left()->nonAggregatedDatasetGroupNames() );
+
+    const Result res = evaluateTimesteps( dsu, argumentTimeVarying ? timeCount : 1,
+                                          [node]( const QgsMeshCalcUtils & step, QgsMeshMemoryDatasetGroup & group )
+    {
+      return node->left()->calculate( step, group );
+    },
+    [&aggregator]( int, const QgsMeshMemoryDatasetGroup & group )
+    {
+      for ( int i = 0; i < group.datasetCount(); ++i )
+        aggregator.addDataset( *group.constDataset( i ) );
+    }, feedback, progress, progress + passProgress );
+
+    if ( res != Success )
+      return res;
+
+    dsu.setAggregatedGroup( node, dsu.aggregatedGroup( aggregator.result() ) );
+    progress += passProgress;
   }
 
-  // Finalize dataset
-  if ( mUseMask )
+  // evaluate the formula and collect the output time step by time step
+  QVector<QgsMeshDataBlock> datasetValues;
+  QVector<QgsMeshDataBlock> datasetActive;
+  QVector<double> times;
+  datasetValues.reserve( evaluatedTimeCount );
+  times.reserve( evaluatedTimeCount );
+
+  const QVector<double> stepTimes = dsu.times();
+  const Result res = evaluateTimesteps( dsu, evaluatedTimeCount,
+                                        [&calcNode, &filter]( const QgsMeshCalcUtils & step, QgsMeshMemoryDatasetGroup & group )
   {
-    dsu.filter( *outputGroup, mOutputMask );
-  }
-  else
+    if ( !calcNode->calculate( step, group ) )
+      return false;
+    step.filter( group, *filter );
+    return true;
+  },
+  [&]( int timeIndex, const QgsMeshMemoryDatasetGroup & group )
   {
-    dsu.filter( *outputGroup, mOutputExtent );
-  }
-  outputGroup->isScalar = true;
-  outputGroup->name = QFileInfo( mOutputFile ).baseName();
+    for ( int i = 0; i < group.datasetCount(); ++i )
+    {
+      const std::shared_ptr<const QgsMeshMemoryDataset> dataset = group.constDataset( i );
+
+      times.push_back( timeVarying ? stepTimes.at( timeIndex ) : dataset->time );
+      datasetValues.push_back( dataset->datasetValues( true, 0, dataset->values.size() ) );
+      if ( !dataset->active.isEmpty() )
+      {
+        datasetActive.push_back( dataset->areFacesActive( 0, dataset->active.size() ) );
+      }
+    }
+  }, feedback, progress, 80.0 );
+
+  if ( res != Success )
+    return res;
 
   // before storing the file, find out if the process is not already canceled
   if ( feedback && feedback->isCanceled() )
@@ -149,35 +264,10 @@ QgsMeshCalculator::Result QgsMeshCalculator::processCalculation( QgsFeedback *fe
   }
 
   // store to file
-  QVector<QgsMeshDataBlock> datasetValues;
-  QVector<QgsMeshDataBlock> datasetActive;
-  QVector<double> times;
-
-  const auto datasize = outputGroup->datasets.size();
-  datasetValues.reserve( datasize );
-  times.reserve( datasize );
-
-  for ( int i = 0; i < datasize; ++i )
-  {
-    const std::shared_ptr<QgsMeshMemoryDataset> dataset = outputGroup->datasets.at( i );
-
-    times.push_back( dataset->time );
-    datasetValues.push_back(
-      dataset->datasetValues( outputGroup->isScalar,
-                              0,
-                              dataset->values.size() )
-    );
-    if ( !dataset->active.isEmpty() )
-    {
-      datasetActive.push_back(
-        dataset->areFacesActive(
-          0,
-          dataset->active.size() )
-      );
-    }
-  }
+  QgsMeshMemoryDatasetGroup outputGroup( QFileInfo( mOutputFile ).baseName() );
+  outputGroup.isScalar = true;
 
-  const QgsMeshDatasetGroupMetadata meta = outputGroup->groupMetadata();
+  const QgsMeshDatasetGroupMetadata meta = outputGroup.groupMetadata();
   bool err = mMeshLayer->dataProvider()->persistDatasetGroup(
                mOutputFile,
                meta,
@@ -41,6 +41,10 @@ struct QgsMeshMemoryDataset;
  * Result can be filtered by extent or a vector layer mask
  * spatially and by selection of times.
  *
+ * Time steps are read from the data provider and evaluated one by one
+ * (several of them in parallel), so the memory needed for the input
+ * datasets does not grow with the number of time steps.
+ *
  * Note: only dataset groups defined on vertices are
  * implemented and supported
  *
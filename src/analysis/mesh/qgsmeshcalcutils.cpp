@@ -17,6 +17,7 @@
 ///@cond PRIVATE
 
 #include <QFileInfo>
+#include <QMutexLocker>
 
 #include "qgsmeshcalcnode.h"
 #include "qgsmeshcalcutils.h"
@@ -28,7 +29,7 @@ const double D_TRUE = 1.0;
 const double D_FALSE = 0.0;
 const double D_NODATA = std::numeric_limits<double>::quiet_NaN();
 
-std::shared_ptr<QgsMeshMemoryDatasetGroup> QgsMeshCalcUtils::create( const QString &datasetGroupName ) const
+std::shared_ptr<QgsMeshMemoryDatasetGroup> QgsMeshCalcUtils::create( const QString &datasetGroupName, bool loadDatasets ) const
 {
   const auto dp = mMeshLayer->dataProvider();
   std::shared_ptr<QgsMeshMemoryDatasetGroup> grp;
@@ -45,29 +46,17 @@ std::shared_ptr<QgsMeshMemoryDatasetGroup> QgsMeshCalcUtils::create( const QStri
       grp->minimum = meta.minimum();
       grp->name = meta.name();
 
-      int count = ( meta.dataType() == QgsMeshDatasetGroupMetadata::DataOnFaces ) ? dp->faceCount() : dp->vertexCount();
+      // values of time varying groups may be read later, time step by time step
+      const bool readValues = loadDatasets || dp->datasetCount( group_i ) == 1;
       for ( int dataset_i = 0; dataset_i < dp->datasetCount( group_i ); ++dataset_i )
       {
         const QgsMeshDatasetIndex index( group_i, dataset_i );
         const auto dsMeta = dp->datasetMetadata( index );
-        std::shared_ptr<QgsMeshMemoryDataset> ds = create( grp->type );
+        std::shared_ptr<QgsMeshMemoryDataset> ds = readValues ? read( index, grp->type ) : std::make_shared<QgsMeshMemoryDataset>();
         ds->maximum = dsMeta.maximum();
         ds->minimum = dsMeta.minimum();
         ds->time = dsMeta.time();
         ds->valid = dsMeta.isValid();
-
-        const QgsMeshDataBlock block = dp->datasetValues( index, 0, count );
-        Q_ASSERT( block.count() == count );
-        for ( int value_i = 0; value_i < count; ++value_i )
-          ds->values[value_i] = block.value( value_i );
-
-        if ( grp->type == QgsMeshDatasetGroupMetadata::DataOnVertices )
-        {
-          const QgsMeshDataBlock active = dp->areFacesActive( index, 0, dp->faceCount() );
-          Q_ASSERT( active.count() == dp->faceCount() );
-          for ( int value_i = 0; value_i < dp->faceCount(); ++value_i )
-            ds->active[value_i] = active.active( value_i );
-        }
         grp->addDataset( ds );
       }
 
@@ -77,6 +66,27 @@ std::shared_ptr<QgsMeshMemoryDatasetGroup> QgsMeshCalcUtils::create( const QStri
   return grp;
 }
 
+std::shared_ptr<QgsMeshMemoryDataset> QgsMeshCalcUtils::read( const QgsMeshDatasetIndex &index, QgsMeshDatasetGroupMetadata::DataType type ) const
+{
+  const auto dp = mMeshLayer->dataProvider();
+  std::shared_ptr<QgsMeshMemoryDataset> ds = create( type );
+
+  const int count = ( type == QgsMeshDatasetGroupMetadata::DataOnFaces ) ? dp->faceCount() : dp->vertexCount();
+  const QgsMeshDataBlock block = dp->datasetValues( index, 0, count );
+  Q_ASSERT( block.count() == count );
+  for ( int value_i = 0; value_i < count; ++value_i )
+    ds->values[value_i] = block.value( value_i );
+
+  if ( type == QgsMeshDatasetGroupMetadata::DataOnVertices )
+  {
+    const QgsMeshDataBlock active = dp->areFacesActive( index, 0, dp->faceCount() );
+    Q_ASSERT( active.count() == dp->faceCount() );
+    for ( int value_i = 0; value_i < dp->faceCount(); ++value_i )
+      ds->active[value_i] = active.active( value_i );
+  }
+  return ds;
+}
+
 std::shared_ptr<QgsMeshMemoryDataset> QgsMeshCalcUtils::create( const QgsMeshMemoryDatasetGroup &grp ) const
 {
   return create( grp.type );
@@ -100,10 +110,18 @@ std::shared_ptr<QgsMeshMemoryDataset> QgsMeshCalcUtils::create( const QgsMeshDat
   return ds;
 }
 
+QgsMeshCalcUtils::QgsMeshCalcUtils( QgsMeshLayer *layer )
+  : mMeshLayer( layer )
+  , mIsValid( false )
+  , mOutputType( QgsMeshDatasetGroupMetadata::DataType::DataOnVertices )
+{
+}
+
 QgsMeshCalcUtils:: QgsMeshCalcUtils( QgsMeshLayer *layer,
                                      const QStringList &usedGroupNames,
                                      double startTime,
-                                     double endTime )
+                                     double endTime,
+                                     bool loadDatasets )
   : mMeshLayer( layer )
   , mIsValid( false )
   , mOutputType( QgsMeshDatasetGroupMetadata::DataType::DataOnVertices )
@@ -112,13 +130,21 @@ QgsMeshCalcUtils:: QgsMeshCalcUtils( QgsMeshLayer *layer,
   // And basically fetch all data from any mesh provider to memory
   for ( const QString &groupName : usedGroupNames )
   {
-    std::shared_ptr<QgsMeshMemoryDatasetGroup> ds = create( groupName );
+    std::shared_ptr<QgsMeshMemoryDatasetGroup> ds = create( groupName, loadDatasets );
     if ( !ds )
       return;
 
     mDatasetGroupMap.insert( groupName, ds );
   }
 
+  const QgsMeshDataProvider *dp = mMeshLayer->dataProvider();
+  for ( int group_i = 0; group_i < dp->datasetGroupCount(); ++group_i )
+  {
+    const QString name = dp->datasetGroupMetadata( group_i ).name();
+    if ( mDatasetGroupMap.contains( name ) && !mGroupIndexes.contains( name ) )
+      mGroupIndexes.insert( name, group_i );
+  }
+
   // Now populate used times and check that all datasets do have some times
   // OR just one time (== one output)
   bool timesPopulated = false;
@@ -156,6 +182,7 @@ QgsMeshCalcUtils:: QgsMeshCalcUtils( QgsMeshLayer *layer,
         else
         {
           mTimes.append( o->time );
+          mTimeDatasetIndexes.append( datasetIndex );
         }
       }
 
@@ -167,18 +194,21 @@ QgsMeshCalcUtils:: QgsMeshCalcUtils( QgsMeshLayer *layer,
   if ( mTimes.isEmpty() )
   {
     mTimes.push_back( 0.0 );
+    mTimeDatasetIndexes.push_back( 0 );
   }
   else
   {
     // filter out times we do not need to speed up calculations
-    for ( QVector<double>::iterator it = mTimes.begin(); it != mTimes.end(); )
+    for ( int i = mTimes.size() - 1; i >= 0; --i )
     {
-      if ( qgsDoubleNear( *it, startTime ) ||
-           qgsDoubleNear( *it, endTime ) ||
-           ( ( *it >= startTime ) && ( *it <= endTime ) ) )
-        ++it;
-      else
-        it = mTimes.erase( it );
+      const double time = mTimes.at( i );
+      if ( !( qgsDoubleNear( time, startTime ) ||
+              qgsDoubleNear( time, endTime ) ||
+              ( ( time >= startTime ) && ( time <= endTime ) ) ) )
+      {
+        mTimes.remove( i );
+        mTimeDatasetIndexes.remove( i );
+      }
     }
   }
 
@@ -208,6 +238,118 @@ std::shared_ptr<const QgsMeshMemoryDatasetGroup> QgsMeshCalcUtils::group( const
   return mDatasetGroupMap[datasetName];
 }
 
+QgsMeshDatasetGroupMetadata::DataType QgsMeshCalcUtils::outputType() const
+{
+  return mOutputType;
+}
+
+int QgsMeshCalcUtils::timestepCount() const
+{
+  return mTimes.size();
+}
+
+QVector<double> QgsMeshCalcUtils::times() const
+{
+  return mTimes;
+}
+
+bool QgsMeshCalcUtils::isTimeVarying( const QStringList &groupNames ) const
+{
+  for ( const QString &groupName : groupNames )
+  {
+    const std::shared_ptr<const QgsMeshMemoryDatasetGroup> grp = mDatasetGroupMap.value( groupName );
+    if ( grp && grp->datasetCount() > 1 )
+      return true;
+  }
+  return false;
+}
+
+std::unique_ptr<QgsMeshCalcUtils> QgsMeshCalcUtils::timestep( int timeIndex ) const
+{
+  Q_ASSERT( isValid() );
+  Q_ASSERT( timeIndex >= 0 && timeIndex < mTimes.size() );
+
+  std::unique_ptr<QgsMeshCalcUtils> utils( new QgsMeshCalcUtils( mMeshLayer ) );
+  utils->mIsValid = mIsValid;
+  utils->mOutputType = mOutputType;
+  utils->mTimes = { mTimes.at( timeIndex ) };
+  utils->mTimeDatasetIndexes = { mTimeDatasetIndexes.at( timeIndex ) };
+  utils->mGroupIndexes = mGroupIndexes;
+  utils->mAggregatedGroups = mAggregatedGroups;
+
+  for ( auto it = mDatasetGroupMap.constBegin(); it != mDatasetGroupMap.constEnd(); ++it )
+  {
+    const std::shared_ptr<QgsMeshMemoryDatasetGroup> &grp = it.value();
+    if ( grp->datasetCount() == 1 )
+    {
+      // groups are only read by the operators, so the group without time steps can be shared
+      utils->mDatasetGroupMap.insert( it.key(), grp );
+      continue;
+    }
+
+    std::shared_ptr<QgsMeshMemoryDatasetGroup> stepGroup = std::make_shared<QgsMeshMemoryDatasetGroup>( grp->name );
+    stepGroup->isScalar = grp->isScalar;
+    stepGroup->type = grp->type;
+    stepGroup->minimum = grp->minimum;
+    stepGroup->maximum = grp->maximum;
+
+    const int datasetIndex = mTimeDatasetIndexes.at( timeIndex );
+    const std::shared_ptr<QgsMeshMemoryDataset> dataset = grp->datasets.at( datasetIndex );
+    if ( !dataset->values.isEmpty() )
+    {
+      stepGroup->addDataset( dataset );
+    }
+    else
+    {
+      std::shared_ptr<QgsMeshMemoryDataset> stepDataset;
+      {
+        // data providers are not thread safe
+        QMutexLocker locker( &mProviderMutex );
+        stepDataset = read( QgsMeshDatasetIndex( mGroupIndexes.value( it.key() ), datasetIndex ), grp->type );
+      }
+      stepDataset->time = dataset->time;
+      stepDataset->valid = dataset->valid;
+      stepDataset->minimum = dataset->minimum;
+      stepDataset->maximum = dataset->maximum;
+      stepGroup->addDataset( stepDataset );
+    }
+    utils->mDatasetGroupMap.insert( it.key(), stepGroup );
+  }
+
+  return utils;
+}
+
+void QgsMeshCalcUtils::setAggregatedGroup( const QgsMeshCalcNode *node, std::shared_ptr<const QgsMeshMemoryDatasetGroup> group )
+{
+  mAggregatedGroups.insert( node, group );
+}
+
+std::shared_ptr<const QgsMeshMemoryDatasetGroup> QgsMeshCalcUtils::aggregatedGroup( const QgsMeshCalcNode *node ) const
+{
+  return mAggregatedGroups.value( node );
+}
+
+std::shared_ptr<QgsMeshMemoryDatasetGroup> QgsMeshCalcUtils::aggregatedGroup( const QVector<double> &values ) const
+{
+  Q_ASSERT( isValid() );
+
+  std::shared_ptr<QgsMeshMemoryDatasetGroup> grp = std::make_shared<QgsMeshMemoryDatasetGroup>( QStringLiteral( "aggregated" ) );
+  grp->type = mOutputType;
+
+  std::shared_ptr<QgsMeshMemoryDataset> output = create( mOutputType );
+  output->time = mTimes[0];
+  Q_ASSERT( output->values.size() == values.size() );
+  for ( int n = 0; n < values.size(); ++n )
+    output->values[n] = values.at( n );
+
+  // lets do activation purely on NODATA values as we did aggregation here
+  if ( mOutputType == QgsMeshDatasetGroupMetadata::DataOnVertices )
+    activate( output );
+
+  grp->addDataset( output );
+  return grp;
+}
+
 void QgsMeshCalcUtils::populateSpatialFilter( QgsMeshMemoryDatasetGroup &filter, const QgsRectangle &extent ) const
 {
   filter.clearDatasets();
@@ -1080,18 +1222,33 @@ void QgsMeshCalcUtils::maximum( QgsMeshMemoryDatasetGroup &group1, const QgsMesh
 
 void QgsMeshCalcUtils::filter( QgsMeshMemoryDatasetGroup &group1, const QgsRectangle &extent ) const
 {
-  QgsMeshMemoryDatasetGroup filter( "filter" );
-  populateSpatialFilter( filter, extent );
-  return func2( group1, filter, std::bind( & QgsMeshCalcUtils::ffilter, this, std::placeholders::_1, std::placeholders::_2 ) );
+  return filter( group1, *spatialFilter( extent ) );
 }
 
 void QgsMeshCalcUtils::filter( QgsMeshMemoryDatasetGroup &group1, const QgsGeometry &mask ) const
 {
-  QgsMeshMemoryDatasetGroup filter( "filter" );
-  populateMaskFilter( filter, mask );
+  return filter( group1, *maskFilter( mask ) );
+}
+
+void QgsMeshCalcUtils::filter( QgsMeshMemoryDatasetGroup &group1, const QgsMeshMemoryDatasetGroup &filter ) const
+{
   return func2( group1, filter, std::bind( & QgsMeshCalcUtils::ffilter, this, std::placeholders::_1, std::placeholders::_2 ) );
 }
 
+std::shared_ptr<QgsMeshMemoryDatasetGroup> QgsMeshCalcUtils::spatialFilter( const QgsRectangle &extent ) const
+{
+  std::shared_ptr<QgsMeshMemoryDatasetGroup> filter = std::make_shared<QgsMeshMemoryDatasetGroup>( QStringLiteral( "filter" ) );
+  populateSpatialFilter( *filter, extent );
+  return filter;
+}
+
+std::shared_ptr<QgsMeshMemoryDatasetGroup> QgsMeshCalcUtils::maskFilter( const QgsGeometry &mask ) const
+{
+  std::shared_ptr<QgsMeshMemoryDatasetGroup> filter = std::make_shared<QgsMeshMemoryDatasetGroup>( QStringLiteral( "filter" ) );
+  populateMaskFilter( *filter, mask );
+  return filter;
+}
+
 void QgsMeshCalcUtils::sumAggregated( QgsMeshMemoryDatasetGroup &group1 ) const
 {
   return funcAggr( group1, std::bind( & QgsMeshCalcUtils::fsumAggregated, this, std::placeholders::_1 ) );
@@ -1112,4 +1269,63 @@ void QgsMeshCalcUtils::averageAggregated( QgsMeshMemoryDatasetGroup &group1 ) co
   return funcAggr( group1, std::bind( & QgsMeshCalcUtils::faverageAggregated, this, std::placeholders::_1 ) );
 }
 
+
+QgsMeshCalcAggregator::QgsMeshCalcAggregator( Aggregate aggregate, int valueCount )
+  : mAggregate( aggregate )
+  , mValues( valueCount, 0.0 )
+  , mCounts( valueCount, 0 )
+{
+}
+
+void QgsMeshCalcAggregator::addDataset( const QgsMeshMemoryDataset &dataset )
+{
+  Q_ASSERT( dataset.values.size() == mValues.size() );
+
+  for ( int n = 0; n < mValues.size(); ++n )
+  {
+    const double val = dataset.values.at( n ).scalar();
+    if ( std::isnan( val ) )
+      continue;
+
+    double &aggregated = mValues[n];
+    if ( mCounts[n] == 0 )
+    {
+      aggregated = val;
+    }
+    else
+    {
+      switch ( mAggregate )
+      {
+        case Sum:
+        case Average:
+          aggregated += val;
+          break;
+        case Minimum:
+          aggregated = std::min( aggregated, val );
+          break;
+        case Maximum:
+          aggregated = std::max( aggregated, val );
+          break;
+      }
+    }
+    ++mCounts[n];
+  }
+}
+
+QVector<double> QgsMeshCalcAggregator::result() const
+{
+  QVector<double> res( mValues.size(), D_NODATA );
+  for ( int n = 0; n < mValues.size(); ++n )
+  {
+    if ( mCounts.at( n ) == 0 )
+      continue;
+
+    if ( mAggregate == Average )
+      res[n] = mValues.at( n ) / mCounts.at( n );
+    else
+      res[n] = mValues.at( n );
+  }
+  return res;
+}
+
 ///@endcond
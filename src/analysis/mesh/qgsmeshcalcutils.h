@@ -24,11 +24,13 @@
 
 #include <QStringList>
 #include <QMap>
+#include <QMutex>
 #include <QVector>
 
 #include <algorithm>
 #include <functional>
 #include <math.h>
+#include <memory>
 #include <numeric>
 
 #include "qgsrectangle.h"
@@ -38,6 +40,7 @@
 
 struct QgsMeshMemoryDatasetGroup;
 struct QgsMeshMemoryDataset;
+class QgsMeshCalcNode;
 
 /**
  * \ingroup analysis
@@ -58,11 +61,15 @@ class ANALYSIS_EXPORT QgsMeshCalcUtils
      * \param usedGroupNames dataset group's names that are used in the expression
      * \param startTime start time
      * \param endTime end time
+     * \param loadDatasets whether values of all datasets of the used groups are read to memory. If FALSE,
+     * only groups with a single dataset are read and datasets of other groups are read time step by time step
+     * with timestep(). Since QGIS 3.12
      */
     QgsMeshCalcUtils( QgsMeshLayer *layer,
                       const QStringList &usedGroupNames,
                       double startTime,
-                      double endTime );
+                      double endTime,
+                      bool loadDatasets = true );
 
     //! Returns whether the input parameters are consistent and valid for given mesh layer
     bool isValid() const;
@@ -73,6 +80,61 @@ class ANALYSIS_EXPORT QgsMeshCalcUtils
     //! Returns dataset group based on name
     std::shared_ptr<const QgsMeshMemoryDatasetGroup> group( const QString &groupName ) const;
 
+    /**
+     * Returns type of the output of the calculation (values on vertices or on faces)
+     * \since QGIS 3.12
+     */
+    QgsMeshDatasetGroupMetadata::DataType outputType() const;
+
+    /**
+     * Returns number of time steps of the calculation
+     * \since QGIS 3.12
+     */
+    int timestepCount() const;
+
+    /**
+     * Returns times of the time steps of the calculation
+     * \since QGIS 3.12
+     */
+    QVector<double> times() const;
+
+    /**
+     * Returns whether any of the dataset groups with \a groupNames has more datasets (time steps)
+     * \since QGIS 3.12
+     */
+    bool isTimeVarying( const QStringList &groupNames ) const;
+
+    /**
+     * Returns utils for calculation of a single time step with index \a timeIndex. All dataset groups
+     * of the returned utils have a single dataset, read from the data provider if it is not in memory.
+     *
+     * May be called from multiple threads at the same time, reading from the data provider is serialized.
+     * Mesh of the layer must be already prepared (e.g. by creating a spatial filter) before calling this
+     * from other than the main thread.
+     *
+     * \since QGIS 3.12
+     */
+    std::unique_ptr<QgsMeshCalcUtils> timestep( int timeIndex ) const;
+
+    /**
+     * Sets precalculated result of the aggregate operator \a node. The node is then evaluated to a copy
+     * of \a group instead of aggregating its argument.
+     * \since QGIS 3.12
+     */
+    void setAggregatedGroup( const QgsMeshCalcNode *node, std::shared_ptr<const QgsMeshMemoryDatasetGroup> group );
+
+    /**
+     * Returns precalculated result of the aggregate operator \a node, or NULLPTR if it is not set
+     * \since QGIS 3.12
+     */
+    std::shared_ptr<const QgsMeshMemoryDatasetGroup> aggregatedGroup( const QgsMeshCalcNode *node ) const;
+
+    /**
+     * Creates a single dataset group with aggregated \a values, as created by aggregate operators
+     * \since QGIS 3.12
+     */
+    std::shared_ptr<QgsMeshMemoryDatasetGroup> aggregatedGroup( const QVector<double> &values ) const;
+
     //! Creates a single dataset with all values set to 1
     void ones( QgsMeshMemoryDatasetGroup &group1 ) const;
 
@@ -109,6 +171,24 @@ class ANALYSIS_EXPORT QgsMeshCalcUtils
     //! Creates a spatial filter from geometry
     void filter( QgsMeshMemoryDatasetGroup &group1, const QgsGeometry &mask ) const;
 
+    /**
+     * Applies the spatial \a filter created by spatialFilter() or maskFilter()
+     * \since QGIS 3.12
+     */
+    void filter( QgsMeshMemoryDatasetGroup &group1, const QgsMeshMemoryDatasetGroup &filter ) const;
+
+    /**
+     * Returns a spatial filter group from extent, to be applied with filter() to multiple groups
+     * \since QGIS 3.12
+     */
+    std::shared_ptr<QgsMeshMemoryDatasetGroup> spatialFilter( const QgsRectangle &extent ) const;
+
+    /**
+     * Returns a spatial filter group from geometry, to be applied with filter() to multiple groups
+     * \since QGIS 3.12
+     */
+    std::shared_ptr<QgsMeshMemoryDatasetGroup> maskFilter( const QgsGeometry &mask ) const;
+
     //! Operator NOT
     void logicalNot( QgsMeshMemoryDatasetGroup &group1 ) const;
 
@@ -176,6 +256,9 @@ class ANALYSIS_EXPORT QgsMeshCalcUtils
     void maximum( QgsMeshMemoryDatasetGroup &group1, const QgsMeshMemoryDatasetGroup &group2 ) const;
 
   private:
+    //! Constructs utils for a single time step
+    explicit QgsMeshCalcUtils( QgsMeshLayer *layer );
+
     double ffilter( double val1, double filter ) const;
     double fadd( double val1, double val2 ) const;
     double fsubtract( double val1, double val2 ) const;
@@ -203,9 +286,12 @@ class ANALYSIS_EXPORT QgsMeshCalcUtils
     /**
      * Find dataset group in provider with the name and copy all values to
      * memory dataset group. Returns NULLPTR if no such dataset group
-     * exists
+     * exists. If \a loadDatasets is FALSE, values are only read for groups with a single dataset.
      */
-    std::shared_ptr<QgsMeshMemoryDatasetGroup> create( const QString &datasetGroupName ) const;
+    std::shared_ptr<QgsMeshMemoryDatasetGroup> create( const QString &datasetGroupName, bool loadDatasets = true ) const;
+
+    //! Reads values and active flags of the dataset with \a index from the data provider
+    std::shared_ptr<QgsMeshMemoryDataset> read( const QgsMeshDatasetIndex &index, QgsMeshDatasetGroupMetadata::DataType type ) const;
 
     /**
      *  Creates dataset based on group. Initializes values and active based on group type.
@@ -273,7 +359,47 @@ class ANALYSIS_EXPORT QgsMeshCalcUtils
     QgsMeshDatasetGroupMetadata::DataType mOutputType; //!< Mesh can work only with one output types, so you cannot mix
     //!< E.g. one dataset with element outputs and one with node outputs
     QVector<double> mTimes;
+    QVector<int> mTimeDatasetIndexes; //!< Indexes of datasets of time varying groups for each of mTimes
     QMap < QString, std::shared_ptr<QgsMeshMemoryDatasetGroup> > mDatasetGroupMap; //!< Groups that are referenced in the expression
+    QMap < QString, int > mGroupIndexes; //!< Indexes of the referenced groups in the data provider
+    QMap < const QgsMeshCalcNode *, std::shared_ptr<const QgsMeshMemoryDatasetGroup> > mAggregatedGroups; //!< Precalculated results of aggregate operators
+    mutable QMutex mProviderMutex; //!< Serializes reading of time steps from the data provider
+};
+
+/**
+ * \ingroup analysis
+ * \class QgsMeshCalcAggregator
+ * Aggregates values of datasets added one by one, so that the datasets do not need to be kept
+ * in memory together. Like aggregate operators of QgsMeshCalcUtils, NODATA values are skipped
+ * and values are NODATA if they are NODATA in all datasets.
+ *
+ * \since QGIS 3.12
+ */
+class ANALYSIS_EXPORT QgsMeshCalcAggregator
+{
+  public:
+    //! Type of aggregation
+    enum Aggregate
+    {
+      Sum, //!< Sum of values
+      Minimum, //!< Minimum value
+      Maximum, //!< Maximum value
+      Average, //!< Average value
+    };
+
+    //! Constructs aggregator of datasets with \a valueCount values
+    QgsMeshCalcAggregator( Aggregate aggregate, int valueCount );
+
+    //! Adds values of the dataset to the aggregation
+    void addDataset( const QgsMeshMemoryDataset &dataset );
+
+    //! Returns aggregated values
+    QVector<double> result() const;
+
+  private:
+    Aggregate mAggregate;
+    QVector<double> mValues;
+    QVector<int> mCounts;
 };
 
 ///@endcond
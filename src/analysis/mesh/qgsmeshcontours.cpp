@@ -28,11 +28,398 @@
 #include "qgsmeshlayerutils.h"
 #include "qgsmeshdataprovider.h"
 #include "qgsfeedback.h"
+#include "qgsmultipolygon.h"
 
+#include <algorithm>
+#include <functional>
 #include <limits>
 
 #include <QSet>
 #include <QPair>
+#include <QHash>
+#include <QtConcurrentMap>
+
+///@cond PRIVATE
+
+/**
+ * Identifies a point of contours, either a vertex of the mesh or the intersection of a mesh edge (with
+ * vertices ordered by index) with a level. Both triangles sharing an edge get the same key for the
+ * intersection with the edge, so that the parts of contours from the triangles can be joined.
+ */
+struct QgsMeshContourPointKey
+{
+  int vertex1;
+  int vertex2;
+  int level; //!< Index of the level, -1 for vertices
+
+  bool operator==( const QgsMeshContourPointKey &other ) const
+  {
+    return vertex1 == other.vertex1 && vertex2 == other.vertex2 && level == other.level;
+  }
+};
+
+uint qHash( const QgsMeshContourPointKey &key, uint seed )
+{
+  return qHash( key.vertex1, seed ) ^ qHash( key.vertex2, seed + 1 ) ^ qHash( key.level, seed + 2 );
+}
+
+//! Segment of contour line or directed edge of a part of a contour band
+struct QgsMeshContourSegment
+{
+  QgsMeshContourPointKey from;
+  QgsMeshContourPointKey to;
+};
+
+//! Segments for each of the levels (or bands)
+typedef std::vector<std::vector<QgsMeshContourSegment>> QgsMeshContourSegments;
+
+static QgsMeshContourPointKey vertexKey( int vertex )
+{
+  return QgsMeshContourPointKey{ vertex, vertex, -1 };
+}
+
+//! Returns key of the intersection of the edge with the level, the edge must cross the level
+static QgsMeshContourPointKey crossingKey( int vertex1, double value1, int vertex2, double value2, int level, double levelValue )
+{
+  // the level goes exactly through a vertex, the point needs to be joined with all triangles around the vertex
+  if ( value1 == levelValue )
+    return vertexKey( vertex1 );
+  if ( value2 == levelValue )
+    return vertexKey( vertex2 );
+
+  if ( vertex1 < vertex2 )
+    return QgsMeshContourPointKey{ vertex1, vertex2, level };
+  else
+    return QgsMeshContourPointKey{ vertex2, vertex1, level };
+}
+
+//! Returns the point for the key
+static QgsPoint contourPoint( const QgsMeshContourPointKey &key, const QVector<QgsMeshVertex> &vertices, const QVector<double> &values, const QVector<double> &levels )
+{
+  if ( key.level < 0 )
+    return vertices.at( key.vertex1 );
+
+  const double value1 = values.at( key.vertex1 );
+  const double value2 = values.at( key.vertex2 );
+  const double fraction = ( levels.at( key.level ) - value1 ) / ( value2 - value1 );
+  return QgsGeometryUtils::interpolatePointOnLine( vertices.at( key.vertex1 ), vertices.at( key.vertex2 ), fraction );
+}
+
+/**
+ * Calls \a func for all active triangles with valid values, from multiple threads. The function gets indexes of
+ * vertices of the triangle in counter-clockwise order, their values and segments of the chunk of triangles
+ * to add its segments to. Returns segments of all chunks.
+ */
+template<typename Func>
+static std::vector<QgsMeshContourSegments> sweepTriangles( const QgsTriangularMesh &mesh,
+    const QgsMeshDataBlock &activeFlags,
+    const QVector<double> &values,
+    int levelCount,
+    QgsFeedback *feedback,
+    Func func )
+{
+  const QVector<QgsMeshFace> &triangles = mesh.triangles();
+  const QVector<int> &trianglesToNativeFaces = mesh.trianglesToNativeFaces();
+  const QVector<QgsMeshVertex> &vertices = mesh.vertices();
+
+  struct Chunk
+  {
+    int first;
+    int last;
+    QgsMeshContourSegments segments;
+  };
+
+  const int CHUNK_SIZE = 16384;
+  std::vector<Chunk> chunks;
+  for ( int first = 0; first < triangles.size(); first += CHUNK_SIZE )
+    chunks.push_back( Chunk{ first, std::min( first + CHUNK_SIZE, triangles.size() ), QgsMeshContourSegments( static_cast<size_t>( levelCount ) ) } );
+
+  QtConcurrent::blockingMap( chunks, [&]( Chunk & chunk )
+  {
+    if ( feedback && feedback->isCanceled() )
+      return;
+
+    for ( int i = chunk.first; i < chunk.last; ++i )
+    {
+      if ( !activeFlags.active( trianglesToNativeFaces.at( i ) ) )
+        continue;
+
+      const QgsMeshFace &triangle = triangles.at( i );
+      int indices[3] = { triangle.at( 0 ), triangle.at( 1 ), triangle.at( 2 ) };
+      double triangleValues[3] = { values.at( indices[0] ), values.at( indices[1] ), values.at( indices[2] ) };
+
+      // any value is NaN
+      if ( std::isnan( triangleValues[0] ) || std::isnan( triangleValues[1] ) || std::isnan( triangleValues[2] ) )
+        continue;
+
+      // edges of parts of bands need to be consistently oriented to cancel out between triangles
+      const QgsMeshVertex &v0 = vertices.at( indices[0] );
+      const QgsMeshVertex &v1 = vertices.at( indices[1] );
+      const QgsMeshVertex &v2 = vertices.at( indices[2] );
+      if ( ( v1.x() - v0.x() ) * ( v2.y() - v0.y() ) - ( v1.y() - v0.y() ) * ( v2.x() - v0.x() ) < 0 )
+      {
+        std::swap( indices[1], indices[2] );
+        std::swap( triangleValues[1], triangleValues[2] );
+      }
+
+      func( indices, triangleValues, chunk.segments );
+    }
+  } );
+
+  std::vector<QgsMeshContourSegments> result;
+  result.reserve( chunks.size() );
+  for ( Chunk &chunk : chunks )
+    result.push_back( std::move( chunk.segments ) );
+  return result;
+}
+
+//! Joins segments of contour lines of a single level to line strings
+static QgsGeometry assembleLines( const std::vector<QgsMeshContourSegment> &segments, const std::function<QgsPoint( const QgsMeshContourPointKey & )> &point )
+{
+  QHash<QgsMeshContourPointKey, QVector<int>> segmentsAtPoint;
+  QSet<QPair<QgsMeshContourPointKey, QgsMeshContourPointKey>> uniqueSegments;
+  std::vector<QgsMeshContourSegment> lineSegments;
+  lineSegments.reserve( segments.size() );
+  for ( const QgsMeshContourSegment &segment : segments )
+  {
+    // the segment along a mesh edge lying exactly on the level may be found by both triangles sharing the edge
+    if ( uniqueSegments.contains( qMakePair( segment.to, segment.from ) ) || uniqueSegments.contains( qMakePair( segment.from, segment.to ) ) )
+      continue;
+    uniqueSegments.insert( qMakePair( segment.from, segment.to ) );
+
+    const int index = static_cast<int>( lineSegments.size() );
+    lineSegments.push_back( segment );
+    segmentsAtPoint[segment.from].append( index );
+    segmentsAtPoint[segment.to].append( index );
+  }
+
+  std::vector<bool> used( lineSegments.size(), false );
+
+  // finds unused segment at the point and returns its other point
+  auto nextPoint = [&]( const QgsMeshContourPointKey & key, QgsMeshContourPointKey & next ) -> bool
+  {
+    const auto it = segmentsAtPoint.constFind( key );
+    if ( it == segmentsAtPoint.constEnd() )
+      return false;
+
+    for ( const int index : it.value() )
+    {
+      if ( used[index] )
+        continue;
+
+      used[index] = true;
+      const QgsMeshContourSegment &segment = lineSegments[index];
+      next = segment.from == key ? segment.to : segment.from;
+      return true;
+    }
+    return false;
+  };
+
+  std::unique_ptr<QgsMultiLineString> multiLineString = qgis::make_unique<QgsMultiLineString>();
+  for ( size_t i = 0; i < lineSegments.size(); ++i )
+  {
+    if ( used[i] )
+      continue;
+    used[i] = true;
+
+    QVector<QgsMeshContourPointKey> forward = { lineSegments[i].from, lineSegments[i].to };
+    QgsMeshContourPointKey next;
+    while ( nextPoint( forward.last(), next ) )
+      forward.append( next );
+
+    QVector<QgsMeshContourPointKey> backward = { lineSegments[i].from };
+    while ( nextPoint( backward.last(), next ) )
+      backward.append( next );
+
+    QVector<QgsPoint> points;
+    points.reserve( backward.size() + forward.size() - 1 );
+    for ( int j = backward.size() - 1; j > 0; --j )
+      points.append( point( backward.at( j ) ) );
+    for ( const QgsMeshContourPointKey &key : qgis::as_const( forward ) )
+      points.append( point( key ) );
+
+    multiLineString->addGeometry( new QgsLineString( points ) );
+  }
+
+  if ( multiLineString->isEmpty() )
+    return QgsGeometry();
+  return QgsGeometry( std::move( multiLineString ) );
+}
+
+//! Returns whether the point is inside the ring
+static bool pointInRing( const QVector<QgsPoint> &ring, double x, double y )
+{
+  bool inside = false;
+  for ( int i = 0, j = ring.size() - 1; i < ring.size(); j = i++ )
+  {
+    const QgsPoint &pi = ring.at( i );
+    const QgsPoint &pj = ring.at( j );
+    if ( ( ( pi.y() > y ) != ( pj.y() > y ) ) &&
+         ( x < ( pj.x() - pi.x() ) * ( y - pi.y() ) / ( pj.y() - pi.y() ) + pi.x() ) )
+      inside = !inside;
+  }
+  return inside;
+}
+
+//! Joins oriented edges of parts of a single band to polygons
+static QgsGeometry assemblePolygons( const std::vector<QgsMeshContourSegment> &edges, const std::function<QgsPoint( const QgsMeshContourPointKey & )> &point )
+{
+  // edges shared by parts of the band in neighbouring triangles have opposite directions and cancel out,
+  // the remaining edges form the rings of the band
+  QSet<QPair<QgsMeshContourPointKey, QgsMeshContourPointKey>> boundary;
+  for ( const QgsMeshContourSegment &edge : edges )
+  {
+    if ( !boundary.remove( qMakePair( edge.to, edge.from ) ) )
+      boundary.insert( qMakePair( edge.from, edge.to ) );
+  }
+
+  QMultiHash<QgsMeshContourPointKey, QgsMeshContourPointKey> outgoing;
+  outgoing.reserve( boundary.size() );
+  for ( const auto &edge : qgis::as_const( boundary ) )
+    outgoing.insert( edge.first, edge.second );
+
+  struct Ring
+  {
+    QVector<QgsPoint> points;
+    double area;
+    QgsRectangle extent;
+  };
+  std::vector<Ring> exteriorRings;
+  std::vector<Ring> interiorRings;
+
+  while ( !outgoing.isEmpty() )
+  {
+    auto it = outgoing.begin();
+    const QgsMeshContourPointKey start = it.key();
+    QgsMeshContourPointKey current = it.value();
+    outgoing.erase( it );
+
+    QVector<QgsMeshContourPointKey> keys = { start };
+    bool closed = false;
+    while ( true )
+    {
+      if ( current == start )
+      {
+        closed = true;
+        break;
+      }
+      keys.append( current );
+
+      const auto next = outgoing.find( current );
+      if ( next == outgoing.end() )
+        break;
+      current = next.value();
+      outgoing.erase( next );
+    }
+
+    if ( !closed || keys.size() < 3 )
+      continue;
+
+    Ring ring;
+    ring.points.reserve( keys.size() + 1 );
+    for ( const QgsMeshContourPointKey &key : qgis::as_const( keys ) )
+      ring.points.append( point( key ) );
+    ring.points.append( ring.points.first() );
+
+    ring.area = 0;
+    ring.extent.setMinimal();
+    for ( int i = 0; i < ring.points.size() - 1; ++i )
+    {
+      const QgsPoint &p1 = ring.points.at( i );
+      const QgsPoint &p2 = ring.points.at( i + 1 );
+      ring.area += p1.x() * p2.y() - p2.x() * p1.y();
+      ring.extent.combineExtentWith( p1.x(), p1.y() );
+    }
+    ring.area /= 2;
+
+    // triangles are oriented counter-clockwise, so exterior rings are too and interior rings are clockwise
+    if ( ring.area > 0 )
+      exteriorRings.push_back( std::move( ring ) );
+    else if ( ring.area < 0 )
+      interiorRings.push_back( std::move( ring ) );
+  }
+
+  if ( exteriorRings.empty() )
+    return QgsGeometry();
+
+  std::vector<std::unique_ptr<QgsPolygon>> polygons;
+  polygons.reserve( exteriorRings.size() );
+  for ( const Ring &ring : exteriorRings )
+  {
+    std::unique_ptr<QgsPolygon> polygon = qgis::make_unique<QgsPolygon>();
+    polygon->setExteriorRing( new QgsLineString( ring.points ) );
+    polygons.push_back( std::move( polygon ) );
+  }
+
+  // each interior ring belongs to the smallest exterior ring containing it
+  for ( const Ring &ring : interiorRings )
+  {
+    const QgsPoint &p = ring.points.first();
+    int polygonIndex = -1;
+    for ( size_t i = 0; i < exteriorRings.size(); ++i )
+    {
+      const Ring &exteriorRing = exteriorRings[i];
+      if ( polygonIndex >= 0 && exteriorRing.area >= exteriorRings[polygonIndex].area )
+        continue;
+      if ( !exteriorRing.extent.contains( ring.extent ) || !pointInRing( exteriorRing.points, p.x(), p.y() ) )
+        continue;
+      polygonIndex = static_cast<int>( i );
+    }
+
+    if ( polygonIndex >= 0 )
+      polygons[polygonIndex]->addInteriorRing( new QgsLineString( ring.points ) );
+  }
+
+  std::unique_ptr<QgsMultiPolygon> multiPolygon = qgis::make_unique<QgsMultiPolygon>();
+  for ( std::unique_ptr<QgsPolygon> &polygon : polygons )
+    multiPolygon->addGeometry( polygon.release() );
+  return QgsGeometry( std::move( multiPolygon ) );
+}
+
+/**
+ * Assembles geometries of all levels (or bands) from \a segments of the chunks in parallel,
+ * using \a assemble function.
+ */
+static QVector<QgsGeometry> assembleLevels( const std::vector<QgsMeshContourSegments> &segments,
+    int levelCount,
+    QgsFeedback *feedback,
+    const std::function<QgsGeometry( const std::vector<QgsMeshContourSegment> & )> &assemble )
+{
+  struct Level
+  {
+    int index;
+    QgsGeometry geometry;
+  };
+
+  std::vector<Level> levels;
+  levels.reserve( static_cast<size_t>( levelCount ) );
+  for ( int i = 0; i < levelCount; ++i )
+    levels.push_back( Level{ i, QgsGeometry() } );
+
+  QtConcurrent::blockingMap( levels, [&]( Level & level )
+  {
+    if ( feedback && feedback->isCanceled() )
+      return;
+
+    std::vector<QgsMeshContourSegment> levelSegments;
+    size_t count = 0;
+    for ( const QgsMeshContourSegments &chunkSegments : segments )
+      count += chunkSegments[level.index].size();
+    levelSegments.reserve( count );
+    for ( const QgsMeshContourSegments &chunkSegments : segments )
+      levelSegments.insert( levelSegments.end(), chunkSegments[level.index].begin(), chunkSegments[level.index].end() );
+
+    level.geometry = assemble( levelSegments );
+  } );
+
+  QVector<QgsGeometry> result;
+  result.reserve( levelCount );
+  for ( Level &level : levels )
+    result.append( level.geometry );
+  return result;
+}
+
+///@endcond
 
 QgsMeshContours::QgsMeshContours( QgsMeshLayer *layer )
   : mMeshLayer( layer )
@@ -388,3 +775,199 @@ void QgsMeshContours::populateCache( const QgsMeshDatasetIndex &index, QgsMeshRe
     }
   }
 }
+
+QVector<QgsGeometry> QgsMeshContours::exportLines( const QgsMeshDatasetIndex &index,
+    const QVector<double> &values,
+    QgsMeshRendererScalarSettings::DataInterpolationMethod method,
+    QgsFeedback *feedback )
+{
+  QVector<QgsGeometry> result( values.size() );
+
+  // Check if the layer/mesh is valid
+  if ( !mTriangularMesh || values.isEmpty() )
+    return result;
+
+  // STEP 1: Get Data
+  populateCache( index, method );
+
+  QVector<double> levels = values;
+  std::sort( levels.begin(), levels.end() );
+
+  // STEP 2: Find segments of contour lines of all levels in a single pass over the triangles
+  const std::vector<QgsMeshContourSegments> segments = sweepTriangles( *mTriangularMesh, mScalarActiveFaceFlagValues, mDatasetValues, levels.size(), feedback,
+      [&levels]( const int *indices, const double *triangleValues, QgsMeshContourSegments & levelSegments )
+  {
+    const double minValue = std::min( { triangleValues[0], triangleValues[1], triangleValues[2] } );
+    const double maxValue = std::max( { triangleValues[0], triangleValues[1], triangleValues[2] } );
+
+    // levels within the range of values, including levels equal to the minimum or maximum value
+    const int first = static_cast<int>( std::lower_bound( levels.constBegin(), levels.constEnd(), minValue ) - levels.constBegin() );
+    const int last = static_cast<int>( std::upper_bound( levels.constBegin(), levels.constEnd(), maxValue ) - levels.constBegin() );
+    for ( int level = first; level < last; ++level )
+    {
+      const double levelValue = levels.at( level );
+
+      // the whole triangle lies on the level, its edges are added by the neighbouring triangles
+      if ( minValue == maxValue )
+        continue;
+
+      // an edge with both vertices on the level is the contour line in the triangle, the triangle on the other side
+      // of the edge adds the same segment, which is skipped when the line is assembled
+      int edgeOnLevel = -1;
+      for ( int i = 0; i < 3; ++i )
+      {
+        if ( triangleValues[i] == levelValue && triangleValues[( i + 1 ) % 3] == levelValue )
+          edgeOnLevel = i;
+      }
+      if ( edgeOnLevel >= 0 )
+      {
+        levelSegments[level].push_back( QgsMeshContourSegment{ vertexKey( indices[edgeOnLevel] ), vertexKey( indices[( edgeOnLevel + 1 ) % 3] ) } );
+        continue;
+      }
+
+      QgsMeshContourPointKey points[2];
+      int pointCount = 0;
+      for ( int i = 0; i < 3 && pointCount < 2; ++i )
+      {
+        const int j = ( i + 1 ) % 3;
+        if ( ( triangleValues[i] >= levelValue ) != ( triangleValues[j] >= levelValue ) )
+          points[pointCount++] = crossingKey( indices[i], triangleValues[i], indices[j], triangleValues[j], level, levelValue );
+      }
+
+      // both points may be the same vertex when the level only touches the triangle
+      if ( pointCount == 2 && !( points[0] == points[1] ) )
+        levelSegments[level].push_back( QgsMeshContourSegment{ points[0], points[1] } );
+    }
+  } );
+
+  if ( feedback )
+  {
+    if ( feedback->isCanceled() )
+      return result;
+    feedback->setProgress( 50 );
+  }
+
+  // STEP 3: Join the segments to lines, for all levels in parallel
+  const QVector<QgsMeshVertex> &vertices = mTriangularMesh->vertices();
+  const QVector<QgsGeometry> lines = assembleLevels( segments, levels.size(), feedback,
+                                     [&]( const std::vector<QgsMeshContourSegment> &levelSegments )
+  {
+    return assembleLines( levelSegments, [&]( const QgsMeshContourPointKey & key )
+    {
+      return contourPoint( key, vertices, mDatasetValues, levels );
+    } );
+  } );
+
+  if ( feedback && feedback->isCanceled() )
+    return result;
+
+  // results in the order of the requested values
+  for ( int i = 0; i < values.size(); ++i )
+  {
+    const int level = static_cast<int>( std::lower_bound( levels.constBegin(), levels.constEnd(), values.at( i ) ) - levels.constBegin() );
+    result[i] = lines.at( level );
+  }
+
+  if ( feedback )
+    feedback->setProgress( 100 );
+
+  return result;
+}
+
+QVector<QgsGeometry> QgsMeshContours::exportPolygons( const QgsMeshDatasetIndex &index,
+    const QVector<double> &levels,
+    QgsMeshRendererScalarSettings::DataInterpolationMethod method,
+    QgsFeedback *feedback )
+{
+  const int bandCount = std::max( 0, levels.size() - 1 );
+  QVector<QgsGeometry> result( bandCount );
+
+  // Check if the layer/mesh is valid
+  if ( !mTriangularMesh || bandCount == 0 )
+    return result;
+
+  // STEP 1: Get Data
+  populateCache( index, method );
+
+  QVector<double> sortedLevels = levels;
+  std::sort( sortedLevels.begin(), sortedLevels.end() );
+
+  // STEP 2: Find parts of all bands in triangles in a single pass over the triangles
+  const std::vector<QgsMeshContourSegments> segments = sweepTriangles( *mTriangularMesh, mScalarActiveFaceFlagValues, mDatasetValues, bandCount, feedback,
+      [&sortedLevels, bandCount]( const int *indices, const double *triangleValues, QgsMeshContourSegments & bandEdges )
+  {
+    const double minValue = std::min( { triangleValues[0], triangleValues[1], triangleValues[2] } );
+    const double maxValue = std::max( { triangleValues[0], triangleValues[1], triangleValues[2] } );
+
+    // bands with values in the triangle
+    const int first = std::max( 0, static_cast<int>( std::upper_bound( sortedLevels.constBegin(), sortedLevels.constEnd(), minValue ) - sortedLevels.constBegin() ) - 1 );
+    const int last = std::min( bandCount, static_cast<int>( std::upper_bound( sortedLevels.constBegin(), sortedLevels.constEnd(), maxValue ) - sortedLevels.constBegin() ) );
+    for ( int band = first; band < last; ++band )
+    {
+      const double lowValue = sortedLevels.at( band );
+      const double highValue = sortedLevels.at( band + 1 );
+
+      // part of the band in the triangle is a convex polygon with at most 2 points on each edge
+      // in addition to the vertices of the triangle
+      QgsMeshContourPointKey ring[9];
+      int ringSize = 0;
+      auto addPoint = [&]( const QgsMeshContourPointKey & key )
+      {
+        if ( ringSize == 0 || !( ring[ringSize - 1] == key ) )
+          ring[ringSize++] = key;
+      };
+
+      for ( int i = 0; i < 3; ++i )
+      {
+        const int j = ( i + 1 ) % 3;
+        if ( triangleValues[i] >= lowValue && triangleValues[i] < highValue )
+          addPoint( vertexKey( indices[i] ) );
+
+        const bool crossesLow = ( triangleValues[i] >= lowValue ) != ( triangleValues[j] >= lowValue );
+        const bool crossesHigh = ( triangleValues[i] >= highValue ) != ( triangleValues[j] >= highValue );
+        const bool ascending = triangleValues[i] < triangleValues[j];
+        if ( crossesLow && ascending )
+          addPoint( crossingKey( indices[i], triangleValues[i], indices[j], triangleValues[j], band, lowValue ) );
+        if ( crossesHigh )
+          addPoint( crossingKey( indices[i], triangleValues[i], indices[j], triangleValues[j], band + 1, highValue ) );
+        if ( crossesLow && !ascending )
+          addPoint( crossingKey( indices[i], triangleValues[i], indices[j], triangleValues[j], band, lowValue ) );
+      }
+
+      if ( ringSize > 1 && ring[ringSize - 1] == ring[0] )
+        --ringSize;
+      if ( ringSize < 3 )
+        continue;
+
+      for ( int k = 0; k < ringSize; ++k )
+        bandEdges[band].push_back( QgsMeshContourSegment{ ring[k], ring[( k + 1 ) % ringSize] } );
+    }
+  } );
+
+  if ( feedback )
+  {
+    if ( feedback->isCanceled() )
+      return result;
+    feedback->setProgress( 50 );
+  }
+
+  // STEP 3: Join the parts of bands to polygons, for all bands in parallel
+  const QVector<QgsMeshVertex> &vertices = mTriangularMesh->vertices();
+  result = assembleLevels( segments, bandCount, feedback,
+                           [&]( const std::vector<QgsMeshContourSegment> &bandEdges )
+  {
+    return assemblePolygons( bandEdges, [&]( const QgsMeshContourPointKey & key )
+    {
+      return contourPoint( key, vertices, mDatasetValues, sortedLevels );
+    } );
+  } );
+
+  if ( feedback )
+  {
+    if ( feedback->isCanceled() )
+      return QVector<QgsGeometry>( bandCount );
+    feedback->setProgress( 100 );
+  }
+
+  return result;
+}
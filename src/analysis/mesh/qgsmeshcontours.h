@@ -87,6 +87,49 @@ class ANALYSIS_EXPORT QgsMeshContours
                                 QgsMeshRendererScalarSettings::DataInterpolationMethod method,
                                 QgsFeedback *feedback = nullptr );
 
+    /**
+     * Exports contour lines for multiple values of particular dataset.
+     *
+     * All contour lines are found in a single pass over the triangles of the mesh and their segments
+     * are joined by the mesh edges they cross, without any further geometry operations.
+     * Contour lines of the individual values are assembled in parallel.
+     *
+     * \param index dataset index
+     * \param values values of the contour lines
+     * \param method for datasets defined on faces, the method will be used to convert data to vertices
+     * \param feedback optional feedback object for progress and cancellation support
+     * \returns MultiLineString geometries containing contour lines, one for each of the \a values. Geometry
+     * is null if there is no contour line for the value
+     *
+     * \since QGIS 3.12
+     */
+    QVector<QgsGeometry> exportLines( const QgsMeshDatasetIndex &index,
+                                      const QVector<double> &values,
+                                      QgsMeshRendererScalarSettings::DataInterpolationMethod method,
+                                      QgsFeedback *feedback = nullptr );
+
+    /**
+     * Exports multi polygons representing the areas with values between consecutive \a levels (filled contours)
+     * for particular dataset.
+     *
+     * All bands are found in a single pass over the triangles of the mesh. Parts of the bands in
+     * the individual triangles are joined by the mesh edges they share, so the polygons are assembled
+     * without union of the geometries. Polygons of the individual bands are assembled in parallel.
+     *
+     * \param index dataset index
+     * \param levels values of the band boundaries, sorted in ascending order
+     * \param method for datasets defined on faces, the method will be used to convert data to vertices
+     * \param feedback optional feedback object for progress and cancellation support
+     * \returns MultiPolygon geometries of the bands, the first one for values between the first two levels etc.
+     * Geometry is null if there are no values in the band
+     *
+     * \since QGIS 3.12
+     */
+    QVector<QgsGeometry> exportPolygons( const QgsMeshDatasetIndex &index,
+                                         const QVector<double> &levels,
+                                         QgsMeshRendererScalarSettings::DataInterpolationMethod method,
+                                         QgsFeedback *feedback = nullptr );
+
   private:
     void populateCache(
       const QgsMeshDatasetIndex &index,
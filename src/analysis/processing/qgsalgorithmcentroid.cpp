@@ -45,6 +45,17 @@ QString QgsCentroidAlgorithm::groupId() const
   return QStringLiteral( "vectorgeometry" );
 }
 
+QgsProcessingAlgorithm::Flags QgsCentroidAlgorithm::flags() const
+{
+  return QgsProcessingFeatureBasedAlgorithm::flags() | QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+}
+
+bool QgsCentroidAlgorithm::supportsParallelFeatureProcessing( const QVariantMap &parameters ) const
+{
+  // evaluating data defined parameters is not safe from multiple threads
+  return !QgsProcessingParameters::isDynamic( parameters, QStringLiteral( "ALL_PARTS" ) );
+}
+
 QString QgsCentroidAlgorithm::outputName() const
 {
   return QObject::tr( "Centroids" );
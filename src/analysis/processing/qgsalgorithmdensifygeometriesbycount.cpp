@@ -45,6 +45,17 @@ QString QgsDensifyGeometriesByCountAlgorithm::groupId() const
   return QStringLiteral( "vectorgeometry" );
 }
 
+QgsProcessingAlgorithm::Flags QgsDensifyGeometriesByCountAlgorithm::flags() const
+{
+  return QgsProcessingFeatureBasedAlgorithm::flags() | QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+}
+
+bool QgsDensifyGeometriesByCountAlgorithm::supportsParallelFeatureProcessing( const QVariantMap &parameters ) const
+{
+  // evaluating data defined parameters is not safe from multiple threads
+  return !QgsProcessingParameters::isDynamic( parameters, QStringLiteral( "VERTICES" ) );
+}
+
 QString QgsDensifyGeometriesByCountAlgorithm::shortHelpString() const
 {
   return QObject::tr( "This algorithm takes a polygon or line layer "
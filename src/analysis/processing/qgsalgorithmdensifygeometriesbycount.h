@@ -31,6 +31,7 @@ class QgsDensifyGeometriesByCountAlgorithm : public QgsProcessingFeatureBasedAlg
   public:
 
     QgsDensifyGeometriesByCountAlgorithm() = default;
+    Flags flags() const override;
     QString name() const override;
     QString displayName() const override;
     QStringList tags() const override;
@@ -45,6 +46,7 @@ class QgsDensifyGeometriesByCountAlgorithm : public QgsProcessingFeatureBasedAlg
     void initParameters( const QVariantMap &configuration = QVariantMap() ) override;
     QString outputName() const override;
     bool prepareAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
+    bool supportsParallelFeatureProcessing( const QVariantMap &parameters ) const override;
     QgsFeatureList processFeature( const QgsFeature &feature,  QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
 
   private:
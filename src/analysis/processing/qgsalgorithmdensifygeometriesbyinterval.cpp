@@ -45,6 +45,17 @@ QString QgsDensifyGeometriesByIntervalAlgorithm::groupId() const
   return QStringLiteral( "vectorgeometry" );
 }
 
+QgsProcessingAlgorithm::Flags QgsDensifyGeometriesByIntervalAlgorithm::flags() const
+{
+  return QgsProcessingFeatureBasedAlgorithm::flags() | QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+}
+
+bool QgsDensifyGeometriesByIntervalAlgorithm::supportsParallelFeatureProcessing( const QVariantMap &parameters ) const
+{
+  // evaluating data defined parameters is not safe from multiple threads
+  return !QgsProcessingParameters::isDynamic( parameters, QStringLiteral( "INTERVAL" ) );
+}
+
 QString QgsDensifyGeometriesByIntervalAlgorithm::shortHelpString() const
 {
   return QObject::tr( "Geometries are densified by adding additional vertices on "
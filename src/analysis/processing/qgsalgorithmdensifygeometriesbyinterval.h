@@ -31,6 +31,7 @@ class QgsDensifyGeometriesByIntervalAlgorithm : public QgsProcessingFeatureBased
   public:
 
     QgsDensifyGeometriesByIntervalAlgorithm() = default;
+    Flags flags() const override;
     QString name() const override;
     QString displayName() const override;
     QStringList tags() const override;
@@ -44,6 +45,7 @@ class QgsDensifyGeometriesByIntervalAlgorithm : public QgsProcessingFeatureBased
   protected:
     void initParameters( const QVariantMap &configuration = QVariantMap() ) override;
     QString outputName() const override;
+    bool supportsParallelFeatureProcessing( const QVariantMap &parameters ) const override;
     QgsFeatureList processFeature( const QgsFeature &feature,  QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
     bool prepareAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
 
@@ -122,7 +122,15 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
 
       if ( f.hasGeometry() && !f.geometry().isNull() )
       {
-        geometryHash[ indexAttributes ].append( f.geometry() );
+        QVector< QgsGeometry > &geometries = geometryHash[ indexAttributes ];
+        geometries.append( f.geometry() );
+        if ( maxQueueLength > 0 && geometries.length() > maxQueueLength )
+        {
+          // queue too long, combine it
+          QgsGeometry tempOutputGeometry = collector( geometries );
+          geometries.clear();
+          geometries << tempOutputGeometry;
+        }
       }
     }
 
@@ -216,7 +224,8 @@ QVariantMap QgsDissolveAlgorithm::processAlgorithm( const QVariantMap &parameter
 {
   return processCollection( parameters, context, feedback, [ & ]( const QVector< QgsGeometry > &parts )->QgsGeometry
   {
-    QgsGeometry result( QgsGeometry::unaryUnion( parts ) );
+    // large inputs are partitioned spatially and united using multiple threads
+    QgsGeometry result( QgsGeometry::parallelUnaryUnion( parts ) );
     if ( QgsWkbTypes::geometryType( result.wkbType() ) == QgsWkbTypes::LineGeometry )
       result = result.mergeLines();
     // Geos may fail in some cases, let's try a slower but safer approach
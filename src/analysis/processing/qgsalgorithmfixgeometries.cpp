@@ -45,6 +45,11 @@ QString QgsFixGeometriesAlgorithm::groupId() const
   return QStringLiteral( "vectorgeometry" );
 }
 
+QgsProcessingAlgorithm::Flags QgsFixGeometriesAlgorithm::flags() const
+{
+  return QgsProcessingFeatureBasedAlgorithm::flags() | QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+}
+
 QgsProcessingFeatureSource::Flag QgsFixGeometriesAlgorithm::sourceFlags() const
 {
   return QgsProcessingFeatureSource::FlagSkipGeometryValidityChecks;
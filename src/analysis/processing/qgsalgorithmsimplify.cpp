@@ -44,6 +44,17 @@ QString QgsSimplifyAlgorithm::groupId() const
   return QStringLiteral( "vectorgeometry" );
 }
 
+QgsProcessingAlgorithm::Flags QgsSimplifyAlgorithm::flags() const
+{
+  return QgsProcessingFeatureBasedAlgorithm::flags() | QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+}
+
+bool QgsSimplifyAlgorithm::supportsParallelFeatureProcessing( const QVariantMap &parameters ) const
+{
+  // evaluating data defined parameters is not safe from multiple threads
+  return !QgsProcessingParameters::isDynamic( parameters, QStringLiteral( "TOLERANCE" ) );
+}
+
 QString QgsSimplifyAlgorithm::outputName() const
 {
   return QObject::tr( "Simplified" );
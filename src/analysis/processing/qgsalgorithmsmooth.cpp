@@ -44,6 +44,19 @@ QString QgsSmoothAlgorithm::groupId() const
   return QStringLiteral( "vectorgeometry" );
 }
 
+QgsProcessingAlgorithm::Flags QgsSmoothAlgorithm::flags() const
+{
+  return QgsProcessingFeatureBasedAlgorithm::flags() | QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+}
+
+bool QgsSmoothAlgorithm::supportsParallelFeatureProcessing( const QVariantMap &parameters ) const
+{
+  // evaluating data defined parameters is not safe from multiple threads
+  return !QgsProcessingParameters::isDynamic( parameters, QStringLiteral( "ITERATIONS" ) )
+         && !QgsProcessingParameters::isDynamic( parameters, QStringLiteral( "OFFSET" ) )
+         && !QgsProcessingParameters::isDynamic( parameters, QStringLiteral( "MAX_ANGLE" ) );
+}
+
 QString QgsSmoothAlgorithm::outputName() const
 {
   return QObject::tr( "Smoothed" );
@@ -34,6 +34,7 @@ class QgsSmoothAlgorithm : public QgsProcessingFeatureBasedAlgorithm
   public:
 
     QgsSmoothAlgorithm() = default;
+    Flags flags() const override;
     QString name() const override;
     QString displayName() const override;
     QStringList tags() const override;
@@ -48,6 +49,7 @@ class QgsSmoothAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QString outputName() const override;
     QgsProcessing::SourceType outputLayerType() const override;
     bool prepareAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
+    bool supportsParallelFeatureProcessing( const QVariantMap &parameters ) const override;
     QgsFeatureList processFeature( const QgsFeature &feature,  QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
     QgsProcessingFeatureSource::Flag sourceFlags() const override;
 
@@ -65,6 +65,11 @@ QString QgsTransformAlgorithm::groupId() const
   return QStringLiteral( "vectorgeneral" );
 }
 
+QgsProcessingAlgorithm::Flags QgsTransformAlgorithm::flags() const
+{
+  return QgsProcessingFeatureBasedAlgorithm::flags() | QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+}
+
 QString QgsTransformAlgorithm::shortHelpString() const
 {
   return QObject::tr( "This algorithm reprojects a vector layer. It creates a new layer with the same features "
@@ -82,17 +87,14 @@ bool QgsTransformAlgorithm::prepareAlgorithm( const QVariantMap &parameters, Qgs
   prepareSource( parameters, context );
   mDestCrs = parameterAsCrs( parameters, QStringLiteral( "TARGET_CRS" ), context );
   mTransformContext = context.project() ? context.project()->transformContext() : QgsCoordinateTransformContext();
+  // created up front, processFeature() may be called from multiple threads and only reads the transform
+  mTransform = QgsCoordinateTransform( sourceCrs(), mDestCrs, mTransformContext );
   return true;
 }
 
 QgsFeatureList QgsTransformAlgorithm::processFeature( const QgsFeature &f, QgsProcessingContext &, QgsProcessingFeedback *feedback )
 {
   QgsFeature feature = f;
-  if ( !mCreatedTransform )
-  {
-    mCreatedTransform = true;
-    mTransform = QgsCoordinateTransform( sourceCrs(), mDestCrs, mTransformContext );
-  }
 
   if ( feature.hasGeometry() )
   {
@@ -34,6 +34,7 @@ class QgsTransformAlgorithm : public QgsProcessingFeatureBasedAlgorithm
   public:
 
     QgsTransformAlgorithm() = default;
+    Flags flags() const override;
     QString name() const override;
     QString displayName() const override;
     QStringList tags() const override;
@@ -54,7 +55,6 @@ class QgsTransformAlgorithm : public QgsProcessingFeatureBasedAlgorithm
 
   private:
 
-    bool mCreatedTransform = false;
     QgsCoordinateReferenceSystem mDestCrs;
     QgsCoordinateTransform mTransform;
     QgsCoordinateTransformContext mTransformContext;
@@ -18,6 +18,10 @@
 #include "qgsgeometryengine.h"
 #include "qgsprocessingalgorithm.h"
 
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
 ///@cond PRIVATE
 
 bool QgsOverlayUtils::sanitizeIntersectionResult( QgsGeometry &geom, QgsWkbTypes::GeometryType geometryType )
@@ -74,6 +78,126 @@ static bool sanitizeDifferenceResult( QgsGeometry &geom )
 }
 
 
+//! Input feature together with overlay candidates and results of the overlay operation
+struct OverlayItem
+{
+  QgsFeature feature;
+  //! IDs of overlay features with intersecting bounding box, sorted to get deterministic output
+  QList<QgsFeatureId> candidates;
+  QgsFeatureList results;
+  QString error;
+};
+
+/**
+ * Runs an overlay operation in parallel. Features are read from \a fitA in batches, overlay features
+ * needed by a batch are fetched from \a sourceB in a single request and then \a overlay is called
+ * for each feature of the batch from worker threads. Every worker creates its own geometry engines,
+ * the data shared between the workers (features of the batch and overlay features) are only read.
+ * Results are written to the sink in the order of input features, so the output does not depend
+ * on the number of threads. If the global thread pool is limited to a single thread, the batch
+ * is processed sequentially on the calling thread.
+ */
+template <typename OverlayFunction>
+static void runParallelOverlay( QgsFeatureIterator &fitA, const QgsSpatialIndex &indexB, const QgsFeatureSource &sourceB, const QgsFeatureRequest &requestB,
+                                QgsFeatureSink &sink, QgsProcessingFeedback *feedback, int &count, int totalCount, OverlayFunction overlay )
+{
+  if ( totalCount == 0 )
+    totalCount = 1;  // avoid division by zero
+
+  // large enough batches to keep all threads busy, small enough to avoid holding too many overlay features in memory
+  const int batchSize = std::max( 1, QThread::idealThreadCount() ) * 64;
+
+  QVector< OverlayItem > batch;
+  batch.reserve( batchSize );
+
+  QgsFeature featA;
+  bool finished = false;
+  while ( !finished )
+  {
+    batch.clear();
+    QgsFeatureIds batchCandidates;
+    while ( batch.size() < batchSize )
+    {
+      if ( feedback->isCanceled() || !fitA.nextFeature( featA ) )
+      {
+        finished = true;
+        break;
+      }
+
+      OverlayItem item;
+      item.feature = featA;
+      if ( featA.hasGeometry() )
+      {
+        item.candidates = indexB.intersects( featA.geometry().boundingBox() );
+        std::sort( item.candidates.begin(), item.candidates.end() );
+        for ( QgsFeatureId id : qgis::as_const( item.candidates ) )
+          batchCandidates.insert( id );
+      }
+      batch << item;
+    }
+
+    if ( batch.isEmpty() || feedback->isCanceled() )
+      break;
+
+    QHash< QgsFeatureId, QgsFeature > featuresB;
+    if ( !batchCandidates.isEmpty() )
+    {
+      QgsFeatureRequest request( requestB );
+      request.setFilterFids( batchCandidates );
+      QgsFeature featB;
+      QgsFeatureIterator fitB = sourceB.getFeatures( request );
+      while ( fitB.nextFeature( featB ) )
+      {
+        if ( feedback->isCanceled() )
+          break;
+
+        // calculate the cached bounding box here, the workers must not modify shared geometries
+        if ( featB.hasGeometry() )
+          featB.geometry().constGet()->boundingBox();
+        featuresB.insert( featB.id(), featB );
+      }
+    }
+
+    const QHash< QgsFeatureId, QgsFeature > &constFeaturesB = featuresB;
+    auto processItem = [&constFeaturesB, &overlay, feedback]( OverlayItem & item )
+    {
+      if ( feedback->isCanceled() )
+        return;
+
+      try
+      {
+        overlay( item, constFeaturesB );
+      }
+      catch ( QgsProcessingException &e )
+      {
+        item.error = e.what();
+      }
+    };
+
+    // respect the thread limit set by the user, with a single thread everything runs on the calling thread
+    if ( QThreadPool::globalInstance()->maxThreadCount() > 1 )
+      QtConcurrent::blockingMap( batch, processItem );
+    else
+      std::for_each( batch.begin(), batch.end(), processItem );
+
+    for ( const OverlayItem &item : qgis::as_const( batch ) )
+    {
+      if ( feedback->isCanceled() )
+        return;
+
+      if ( !item.error.isEmpty() )
+        throw QgsProcessingException( item.error );
+
+      for ( QgsFeature outFeat : item.results )
+        sink.addFeature( outFeat, QgsFeatureSink::FastInsert );
+
+      ++count;
+      feedback->setProgress( count / ( double ) totalCount * 100. );
+    }
+  }
+}
+
+
 void QgsOverlayUtils::difference( const QgsFeatureSource &sourceA, const QgsFeatureSource &sourceB, QgsFeatureSink &sink, QgsProcessingContext &context, QgsProcessingFeedback *feedback, int &count, int totalCount, QgsOverlayUtils::DifferenceOutput outputAttrs )
 {
   QgsFeatureRequest requestB;
@@ -84,102 +208,87 @@ void QgsOverlayUtils::difference( const QgsFeatureSource &sourceA, const QgsFeat
 
   int fieldsCountA = sourceA.fields().count();
   int fieldsCountB = sourceB.fields().count();
-  QgsAttributes attrs;
-  attrs.resize( outputAttrs == OutputA ? fieldsCountA : ( fieldsCountA + fieldsCountB ) );
+  QgsAttributes emptyAttrs;
+  emptyAttrs.resize( outputAttrs == OutputA ? fieldsCountA : ( fieldsCountA + fieldsCountB ) );
 
-  if ( totalCount == 0 )
-    totalCount = 1;  // avoid division by zero
-
-  QgsFeature featA;
   QgsFeatureRequest requestA;
   requestA.setInvalidGeometryCheck( context.invalidGeometryCheck() );
   if ( outputAttrs == OutputBA )
     requestA.setDestinationCrs( sourceB.sourceCrs(), context.transformContext() );
   QgsFeatureIterator fitA = sourceA.getFeatures( requestA );
-  while ( fitA.nextFeature( featA ) )
-  {
-    if ( feedback->isCanceled() )
-      break;
 
-    if ( featA.hasGeometry() )
+  auto overlay = [ = ]( OverlayItem & item, const QHash< QgsFeatureId, QgsFeature > &featuresB )
+  {
+    if ( !item.feature.hasGeometry() )
     {
-      QgsGeometry geom( featA.geometry() );
-      QgsFeatureIds intersects = indexB.intersects( geom.boundingBox() ).toSet();
+      // TODO: should we write out features that do not have geometry?
+      item.results << item.feature;
+      return;
+    }
 
-      QgsFeatureRequest request;
-      request.setFilterFids( intersects );
-      request.setNoAttributes();
-      if ( outputAttrs != OutputBA )
-        request.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
+    QgsGeometry geom( item.feature.geometry() );
 
-      std::unique_ptr< QgsGeometryEngine > engine;
-      if ( !intersects.isEmpty() )
+    std::unique_ptr< QgsGeometryEngine > engine;
+    QVector<QgsGeometry> geometriesB;
+    for ( QgsFeatureId id : item.candidates )
+    {
+      auto featB = featuresB.constFind( id );
+      if ( featB == featuresB.constEnd() )
+        continue;
+
+      if ( !engine )
       {
         // use prepared geometries for faster intersection tests
         engine.reset( QgsGeometry::createGeometryEngine( geom.constGet() ) );
         engine->prepareGeometry();
       }
 
-      QVector<QgsGeometry> geometriesB;
-      QgsFeature featB;
-      QgsFeatureIterator fitB = sourceB.getFeatures( request );
-      while ( fitB.nextFeature( featB ) )
-      {
-        if ( feedback->isCanceled() )
-          break;
-
-        if ( engine->intersects( featB.geometry().constGet() ) )
-          geometriesB << featB.geometry();
-      }
+      if ( engine->intersects( featB->geometry().constGet() ) )
+        geometriesB << featB->geometry();
+    }
 
-      if ( !geometriesB.isEmpty() )
+    if ( !geometriesB.isEmpty() )
+    {
+      QgsGeometry geomB = QgsGeometry::unaryUnion( geometriesB );
+      if ( !geomB.lastError().isEmpty() )
       {
-        QgsGeometry geomB = QgsGeometry::unaryUnion( geometriesB );
-        if ( !geomB.lastError().isEmpty() )
-        {
-          // This may happen if input geometries from a layer do not line up well (for example polygons
-          // that are nearly touching each other, but there is a very tiny overlap or gap at one of the edges).
-          // It is possible to get rid of this issue in two steps:
-          // 1. snap geometries with a small tolerance (e.g. 1cm) using QgsGeometrySnapperSingleSource
-          // 2. fix geometries (removes polygons collapsed to lines etc.) using MakeValid
-          throw QgsProcessingException( QStringLiteral( "%1\n\n%2" ).arg( QObject::tr( "GEOS geoprocessing error: unary union failed." ), geomB.lastError() ) );
-        }
-        geom = geom.difference( geomB );
+        // This may happen if input geometries from a layer do not line up well (for example polygons
+        // that are nearly touching each other, but there is a very tiny overlap or gap at one of the edges).
+        // It is possible to get rid of this issue in two steps:
+        // 1. snap geometries with a small tolerance (e.g. 1cm) using QgsGeometrySnapperSingleSource
+        // 2. fix geometries (removes polygons collapsed to lines etc.) using MakeValid
+        throw QgsProcessingException( QStringLiteral( "%1\n\n%2" ).arg( QObject::tr( "GEOS geoprocessing error: unary union failed." ), geomB.lastError() ) );
       }
+      geom = geom.difference( geomB );
+    }
 
-      if ( !sanitizeDifferenceResult( geom ) )
-        continue;
-
-      const QgsAttributes attrsA( featA.attributes() );
-      switch ( outputAttrs )
-      {
-        case OutputA:
-          attrs = attrsA;
-          break;
-        case OutputAB:
-          for ( int i = 0; i < fieldsCountA; ++i )
-            attrs[i] = attrsA[i];
-          break;
-        case OutputBA:
-          for ( int i = 0; i < fieldsCountA; ++i )
-            attrs[i + fieldsCountB] = attrsA[i];
-          break;
-      }
+    if ( !sanitizeDifferenceResult( geom ) )
+      return;
 
-      QgsFeature outFeat;
-      outFeat.setGeometry( geom );
-      outFeat.setAttributes( attrs );
-      sink.addFeature( outFeat, QgsFeatureSink::FastInsert );
-    }
-    else
+    QgsAttributes attrs = emptyAttrs;
+    const QgsAttributes attrsA( item.feature.attributes() );
+    switch ( outputAttrs )
     {
-      // TODO: should we write out features that do not have geometry?
-      sink.addFeature( featA, QgsFeatureSink::FastInsert );
+      case OutputA:
+        attrs = attrsA;
+        break;
+      case OutputAB:
+        for ( int i = 0; i < fieldsCountA; ++i )
+          attrs[i] = attrsA[i];
+        break;
+      case OutputBA:
+        for ( int i = 0; i < fieldsCountA; ++i )
+          attrs[i + fieldsCountB] = attrsA[i];
+        break;
     }
 
-    ++count;
-    feedback->setProgress( count / ( double ) totalCount * 100. );
-  }
+    QgsFeature outFeat;
+    outFeat.setGeometry( geom );
+    outFeat.setAttributes( attrs );
+    item.results << outFeat;
+  };
+
+  runParallelOverlay( fitA, indexB, sourceB, requestB, sink, feedback, count, totalCount, overlay );
 }
 
 
@@ -192,51 +301,41 @@ void QgsOverlayUtils::intersection( const QgsFeatureSource &sourceA, const QgsFe
   request.setNoAttributes();
   request.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
 
-  QgsFeature outFeat;
   QgsSpatialIndex indexB( sourceB.getFeatures( request ), feedback );
 
-  if ( totalCount == 0 )
-    totalCount = 1;  // avoid division by zero
+  QgsFeatureRequest requestB;
+  requestB.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
+  requestB.setSubsetOfAttributes( fieldIndicesB );
 
-  QgsFeature featA;
   QgsFeatureIterator fitA = sourceA.getFeatures( QgsFeatureRequest().setSubsetOfAttributes( fieldIndicesA ) );
-  while ( fitA.nextFeature( featA ) )
-  {
-    if ( feedback->isCanceled() )
-      break;
 
-    if ( !featA.hasGeometry() )
-      continue;
-
-    QgsGeometry geom( featA.geometry() );
-    QgsFeatureIds intersects = indexB.intersects( geom.boundingBox() ).toSet();
+  auto overlay = [ = ]( OverlayItem & item, const QHash< QgsFeatureId, QgsFeature > &featuresB )
+  {
+    if ( !item.feature.hasGeometry() )
+      return;
 
-    QgsFeatureRequest request;
-    request.setFilterFids( intersects );
-    request.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
-    request.setSubsetOfAttributes( fieldIndicesB );
-
-    std::unique_ptr< QgsGeometryEngine > engine;
-    if ( !intersects.isEmpty() )
-    {
-      // use prepared geometries for faster intersection tests
-      engine.reset( QgsGeometry::createGeometryEngine( geom.constGet() ) );
-      engine->prepareGeometry();
-    }
+    QgsGeometry geom( item.feature.geometry() );
 
     QgsAttributes outAttributes( attrCount );
-    const QgsAttributes attrsA( featA.attributes() );
+    const QgsAttributes attrsA( item.feature.attributes() );
     for ( int i = 0; i < fieldIndicesA.count(); ++i )
       outAttributes[i] = attrsA[fieldIndicesA[i]];
 
-    QgsFeature featB;
-    QgsFeatureIterator fitB = sourceB.getFeatures( request );
-    while ( fitB.nextFeature( featB ) )
+    std::unique_ptr< QgsGeometryEngine > engine;
+    for ( QgsFeatureId id : item.candidates )
     {
-      if ( feedback->isCanceled() )
-        break;
+      auto featB = featuresB.constFind( id );
+      if ( featB == featuresB.constEnd() )
+        continue;
 
-      QgsGeometry tmpGeom( featB.geometry() );
+      if ( !engine )
+      {
+        // use prepared geometries for faster intersection tests
+        engine.reset( QgsGeometry::createGeometryEngine( geom.constGet() ) );
+        engine->prepareGeometry();
+      }
+
+      QgsGeometry tmpGeom( featB->geometry() );
       if ( !engine->intersects( tmpGeom.constGet() ) )
         continue;
 
@@ -244,18 +343,18 @@ void QgsOverlayUtils::intersection( const QgsFeatureSource &sourceA, const QgsFe
       if ( !sanitizeIntersectionResult( intGeom, geometryType ) )
         continue;
 
-      const QgsAttributes attrsB( featB.attributes() );
+      const QgsAttributes attrsB( featB->attributes() );
       for ( int i = 0; i < fieldIndicesB.count(); ++i )
         outAttributes[fieldIndicesA.count() + i] = attrsB[fieldIndicesB[i]];
 
+      QgsFeature outFeat;
       outFeat.setGeometry( intGeom );
       outFeat.setAttributes( outAttributes );
-      sink.addFeature( outFeat, QgsFeatureSink::FastInsert );
+      item.results << outFeat;
     }
+  };
 
-    ++count;
-    feedback->setProgress( count / ( double ) totalCount * 100. );
-  }
+  runParallelOverlay( fitA, indexB, sourceB, requestB, sink, feedback, count, totalCount, overlay );
 }
 
 void QgsOverlayUtils::resolveOverlaps( const QgsFeatureSource &source, QgsFeatureSink &sink, QgsProcessingFeedback *feedback )
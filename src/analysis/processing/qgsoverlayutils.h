@@ -41,8 +41,16 @@ namespace QgsOverlayUtils
     OutputBA,  //!< Write attributes of both layers, inverted (first attributes of B, then attributes of A)
   };
 
+  /**
+   * Writes parts of features from \a sourceA which do not overlap with features from \a sourceB.
+   * Features are processed in parallel, the output order does not depend on the number of threads.
+   */
   void difference( const QgsFeatureSource &sourceA, const QgsFeatureSource &sourceB, QgsFeatureSink &sink, QgsProcessingContext &context, QgsProcessingFeedback *feedback, int &count, int totalCount, DifferenceOutput outputAttrs );
 
+  /**
+   * Writes intersections of features from \a sourceA with features from \a sourceB.
+   * Features are processed in parallel, the output order does not depend on the number of threads.
+   */
   void intersection( const QgsFeatureSource &sourceA, const QgsFeatureSource &sourceB, QgsFeatureSink &sink, QgsProcessingContext &context, QgsProcessingFeedback *feedback, int &count, int totalCount, const QList<int> &fieldIndicesA, const QList<int> &fieldIndicesB );
 
   //! Makes sure that what came out from intersection of two geometries is good to be used in the output
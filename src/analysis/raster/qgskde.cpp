@@ -14,15 +14,67 @@
  ***************************************************************************/
 
 #include <QByteArray>
+#include <QThread>
+#include <QtConcurrentMap>
 
 #include "qgskde.h"
 #include "qgsfeaturesource.h"
 #include "qgsfeatureiterator.h"
+#include "qgsfeedback.h"
 #include "qgsgeometry.h"
 #include "qgsrasterfilewriter.h"
 
 #define NO_DATA -9999
 
+///@cond PRIVATE
+
+//! Size of the square output tiles used by the Tiled and Streamed methods, in pixels
+constexpr int KDE_TILE_SIZE = 128;
+
+//! Approximate maximum number of output pixels held in memory at once by the Tiled and Streamed methods
+constexpr int KDE_STRIP_PIXELS = 1 << 24;
+
+struct QgsKernelDensityPoint
+{
+  double x;
+  double y;
+  double radius;
+  double weight;
+  int buffer;
+};
+
+/**
+ * Points binned into the output tiles they affect, for a range of tile rows.
+ */
+class QgsKernelDensityTiles
+{
+  public:
+
+    QgsKernelDensityTiles( int firstTileRow, int tileRows, int tileCols )
+      : firstTileRow( firstTileRow )
+      , tileRows( tileRows )
+      , tileCols( tileCols )
+      , bins( static_cast< std::size_t >( tileRows ) * tileCols )
+    {}
+
+    std::vector< QgsKernelDensityPoint > &bin( int tileRow, int tileCol )
+    {
+      return bins[ static_cast< std::size_t >( tileRow - firstTileRow ) * tileCols + tileCol ];
+    }
+
+    const std::vector< QgsKernelDensityPoint > &bin( int tileRow, int tileCol ) const
+    {
+      return bins[ static_cast< std::size_t >( tileRow - firstTileRow ) * tileCols + tileCol ];
+    }
+
+    int firstTileRow = 0;
+    int tileRows = 0;
+    int tileCols = 0;
+    std::vector< std::vector< QgsKernelDensityPoint > > bins;
+};
+
+///@endcond
+
 QgsKernelDensityEstimation::QgsKernelDensityEstimation( const QgsKernelDensityEstimation::Parameters &parameters, const QString &outputFile, const QString &outputFormat )
   : mSource( parameters.source )
   , mOutputFile( outputFile )
@@ -42,7 +94,9 @@ QgsKernelDensityEstimation::QgsKernelDensityEstimation( const QgsKernelDensityEs
     mWeightField = mSource->fields().lookupField( parameters.weightField );
 }
 
-QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::run()
+QgsKernelDensityEstimation::~QgsKernelDensityEstimation() = default;
+
+QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::run( QgsFeedback *feedback )
 {
   Result result = prepare();
   if ( result != Success )
@@ -56,12 +110,65 @@ QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::run()
   if ( mWeightField >= 0 )
     requiredAttributes << mWeightField;
 
+  if ( mMethod == Streamed )
+  {
+    const int tileRows = ( mRows + KDE_TILE_SIZE - 1 ) / KDE_TILE_SIZE;
+    const int tileCols = ( mCols + KDE_TILE_SIZE - 1 ) / KDE_TILE_SIZE;
+    const int stripTileRows = stripTileRowCount();
+    const double radius = maximumRadius();
+
+    for ( int firstTileRow = 0; firstTileRow < tileRows; firstTileRow += stripTileRows )
+    {
+      if ( feedback && feedback->isCanceled() )
+        break;
+
+      if ( feedback )
+        feedback->setProgress( 100.0 * firstTileRow / tileRows );
+
+      const int stripRows = std::min( stripTileRows, tileRows - firstTileRow );
+      mTiles.reset( new QgsKernelDensityTiles( firstTileRow, stripRows, tileCols ) );
+
+      // only fetch the points whose kernels can reach pixels within this strip. Kernel blocks are aligned
+      // to the pixel grid like for the PointByPoint method, and may extend up to two pixels past the radius
+      const double stripYMax = mBounds.yMaximum() - static_cast< double >( firstTileRow ) * KDE_TILE_SIZE * mPixelSize;
+      const double stripYMin = mBounds.yMaximum() - static_cast< double >( firstTileRow + stripRows ) * KDE_TILE_SIZE * mPixelSize;
+      const QgsRectangle stripExtent( mBounds.xMinimum(), stripYMin - radius - 2 * mPixelSize,
+                                      mBounds.xMaximum(), stripYMax + radius + 2 * mPixelSize );
+
+      QgsFeatureIterator fit = mSource->getFeatures( QgsFeatureRequest().setFilterRect( stripExtent ).setSubsetOfAttributes( requiredAttributes ) );
+      QgsFeature f;
+      while ( fit.nextFeature( f ) )
+      {
+        if ( feedback && feedback->isCanceled() )
+          break;
+
+        addFeature( f );
+      }
+
+      result = writeTiles();
+      if ( result != Success )
+        break;
+    }
+
+    mTiles.reset();
+    Result finaliseResult = finalise();
+    return result != Success ? result : finaliseResult;
+  }
+
   QgsFeatureIterator fit = mSource->getFeatures( QgsFeatureRequest().setSubsetOfAttributes( requiredAttributes ) );
 
+  const long featureCount = mSource->featureCount();
+  long current = 0;
   QgsFeature f;
   while ( fit.nextFeature( f ) )
   {
+    if ( feedback && feedback->isCanceled() )
+      break;
+
     addFeature( f );
+
+    if ( feedback && featureCount > 0 )
+      feedback->setProgress( 100.0 * ++current / featureCount );
   }
 
   return finalise();
@@ -78,6 +185,8 @@ QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::prepare()
 
   int rows = std::max( std::ceil( mBounds.height() / mPixelSize ) + 1, 1.0 );
   int cols = std::max( std::ceil( mBounds.width() / mPixelSize ) + 1, 1.0 );
+  mRows = rows;
+  mCols = cols;
 
   // create empty raster and fill it with nodata values
   QgsRasterFileWriter writer( mOutputFile );
@@ -94,12 +203,21 @@ QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::prepare()
     return FileCreationError;
   }
 
-  QgsRasterBlock block( Qgis::Float32, cols, 1 );
-  block.setNoDataValue( NO_DATA );
-  block.setIsNoData();
-  for ( int i = 0; i < rows ; i++ )
+  mTiles.reset();
+  if ( mMethod != PointByPoint )
+  {
+    // every pixel is written once when the tiles are calculated, so there's no need to prefill the raster
+    mTiles.reset( new QgsKernelDensityTiles( 0, ( rows + KDE_TILE_SIZE - 1 ) / KDE_TILE_SIZE, ( cols + KDE_TILE_SIZE - 1 ) / KDE_TILE_SIZE ) );
+  }
+  else
   {
-    mProvider->writeBlock( &block, 1, 0, i );
+    QgsRasterBlock block( Qgis::Float32, cols, 1 );
+    block.setNoDataValue( NO_DATA );
+    block.setIsNoData();
+    for ( int i = 0; i < rows ; i++ )
+    {
+      mProvider->writeBlock( &block, 1, 0, i );
+    }
   }
 
   mBufferSize = -1;
@@ -161,6 +279,12 @@ QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::addFeature( const
       continue;
     }
 
+    if ( mTiles )
+    {
+      addPointToTiles( *pointIt, radius, weight, buffer );
+      continue;
+    }
+
     // calculate the pixel position
     unsigned int xPosition = ( ( ( *pointIt ).x() - mBounds.xMinimum() ) / mPixelSize ) - buffer;
     unsigned int yPosition = ( ( ( *pointIt ).y() - mBounds.yMinimum() ) / mPixelSize ) - buffer;
@@ -212,10 +336,158 @@ QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::addFeature( const
 
 QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::finalise()
 {
+  Result result = Success;
+  if ( mTiles )
+  {
+    result = writeTiles();
+    mTiles.reset();
+  }
+
   mProvider->setEditable( false );
   mProvider = nullptr;
 
-  return Success;
+  return result;
+}
+
+void QgsKernelDensityEstimation::pixelFootprint( double x, double y, int buffer, int &colMin, int &colMax, int &rowMin, int &rowMax, int &centerRowMin ) const
+{
+  colMin = static_cast< int >( ( x - mBounds.xMinimum() ) / mPixelSize - buffer );
+  colMax = colMin + 2 * buffer;
+  rowMin = static_cast< int >( ( mBounds.yMaximum() - y ) / mPixelSize - buffer );
+  rowMax = rowMin + 2 * buffer;
+  // the PointByPoint method measures the distances of the rows of its block from the bottom of the raster
+  centerRowMin = static_cast< int >( ( y - mBounds.yMinimum() ) / mPixelSize - buffer );
+}
+
+void QgsKernelDensityEstimation::addPointToTiles( const QgsPointXY &point, double radius, double weight, int buffer )
+{
+  int colMin, colMax, rowMin, rowMax, centerRowMin;
+  pixelFootprint( point.x(), point.y(), buffer, colMin, colMax, rowMin, rowMax, centerRowMin );
+  colMin = std::max( colMin, 0 );
+  colMax = std::min( colMax, mCols - 1 );
+  rowMin = std::max( rowMin, 0 );
+  rowMax = std::min( rowMax, mRows - 1 );
+  if ( colMin > colMax || rowMin > rowMax )
+    return;
+
+  // when streaming, only the tiles of the current strip are held
+  const int tileRowMin = std::max( rowMin / KDE_TILE_SIZE, mTiles->firstTileRow );
+  const int tileRowMax = std::min( rowMax / KDE_TILE_SIZE, mTiles->firstTileRow + mTiles->tileRows - 1 );
+  const QgsKernelDensityPoint kdePoint{ point.x(), point.y(), radius, weight, buffer };
+  for ( int tileRow = tileRowMin; tileRow <= tileRowMax; ++tileRow )
+  {
+    for ( int tileCol = colMin / KDE_TILE_SIZE; tileCol <= colMax / KDE_TILE_SIZE; ++tileCol )
+    {
+      mTiles->bin( tileRow, tileCol ).push_back( kdePoint );
+    }
+  }
+}
+
+int QgsKernelDensityEstimation::stripTileRowCount() const
+{
+  return std::max( 1, KDE_STRIP_PIXELS / ( KDE_TILE_SIZE * std::max( mCols, 1 ) ) );
+}
+
+QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::writeTiles()
+{
+  struct TileTask
+  {
+    int tileRow;
+    int tileCol;
+  };
+
+  const int stripTileRows = stripTileRowCount();
+  const int lastTileRow = mTiles->firstTileRow + mTiles->tileRows - 1;
+  Result result = Success;
+
+  for ( int firstTileRow = mTiles->firstTileRow; firstTileRow <= lastTileRow; firstTileRow += stripTileRows )
+  {
+    const int stripLastTileRow = std::min( firstTileRow + stripTileRows - 1, lastTileRow );
+    const int firstRow = firstTileRow * KDE_TILE_SIZE;
+    const int rowCount = std::min( ( stripLastTileRow + 1 ) * KDE_TILE_SIZE, mRows ) - firstRow;
+    if ( rowCount <= 0 )
+      break;
+
+    QByteArray stripData( static_cast< int >( sizeof( float ) ) * mCols * rowCount, Qt::Uninitialized );
+    float *strip = reinterpret_cast< float * >( stripData.data() );
+
+    std::vector< TileTask > tasks;
+    tasks.reserve( static_cast< std::size_t >( stripLastTileRow - firstTileRow + 1 ) * mTiles->tileCols );
+    for ( int tileRow = firstTileRow; tileRow <= stripLastTileRow; ++tileRow )
+    {
+      for ( int tileCol = 0; tileCol < mTiles->tileCols; ++tileCol )
+      {
+        tasks.push_back( TileTask{ tileRow, tileCol } );
+      }
+    }
+
+    // each task gathers the kernels of the points binned into its tile, and owns the pixels of
+    // that tile within the strip buffer, so tiles can be calculated concurrently without locking
+    auto calculateTile = [this, strip, firstRow]( const TileTask & task )
+    {
+      const int tileRowMin = task.tileRow * KDE_TILE_SIZE;
+      const int tileRowMax = std::min( tileRowMin + KDE_TILE_SIZE, mRows ) - 1;
+      const int tileColMin = task.tileCol * KDE_TILE_SIZE;
+      const int tileColMax = std::min( tileColMin + KDE_TILE_SIZE, mCols ) - 1;
+
+      for ( int row = tileRowMin; row <= tileRowMax; ++row )
+      {
+        float *line = strip + static_cast< std::size_t >( row - firstRow ) * mCols;
+        std::fill( line + tileColMin, line + tileColMax + 1, static_cast< float >( NO_DATA ) );
+      }
+
+      for ( const QgsKernelDensityPoint &point : mTiles->bin( task.tileRow, task.tileCol ) )
+      {
+        int colMin, colMax, rowMin, rowMax, centerRowMin;
+        pixelFootprint( point.x, point.y, point.buffer, colMin, colMax, rowMin, rowMax, centerRowMin );
+        const int firstKernelRow = rowMin;
+        colMin = std::max( colMin, tileColMin );
+        colMax = std::min( colMax, tileColMax );
+        rowMin = std::max( rowMin, tileRowMin );
+        rowMax = std::min( rowMax, tileRowMax );
+
+        for ( int row = rowMin; row <= rowMax; ++row )
+        {
+          // same pixel centers as the PointByPoint method, so that all methods give the same surface
+          const double dy = mBounds.yMinimum() + ( centerRowMin + ( row - firstKernelRow ) + 0.5 ) * mPixelSize - point.y;
+          float *line = strip + static_cast< std::size_t >( row - firstRow ) * mCols;
+          for ( int col = colMin; col <= colMax; ++col )
+          {
+            const double dx = mBounds.xMinimum() + ( col + 0.5 ) * mPixelSize - point.x;
+            const double distance = std::sqrt( dx * dx + dy * dy );
+
+            // is pixel outside search bandwidth of feature?
+            if ( distance > point.radius )
+              continue;
+
+            if ( line[ col ] == NO_DATA )
+              line[ col ] = 0;
+            line[ col ] += point.weight * calculateKernelValue( distance, point.radius, mShape, mOutputValues );
+          }
+        }
+      }
+    };
+    QtConcurrent::blockingMap( tasks, calculateTile );
+
+    // the binned points are no longer needed once their tiles are calculated
+    for ( int tileRow = firstTileRow; tileRow <= stripLastTileRow; ++tileRow )
+    {
+      for ( int tileCol = 0; tileCol < mTiles->tileCols; ++tileCol )
+      {
+        std::vector< QgsKernelDensityPoint >().swap( mTiles->bin( tileRow, tileCol ) );
+      }
+    }
+
+    QgsRasterBlock block( Qgis::Float32, mCols, rowCount );
+    block.setNoDataValue( NO_DATA );
+    block.setData( stripData );
+    if ( !mProvider->writeBlock( &block, 1, 0, firstRow ) )
+    {
+      result = RasterIoError;
+    }
+  }
+
+  return result;
 }
 
 int QgsKernelDensityEstimation::radiusSizeInPixels( double radius ) const
@@ -367,20 +639,24 @@ QgsRectangle QgsKernelDensityEstimation::calculateBounds() const
 
   QgsRectangle bbox = mSource->sourceExtent();
 
-  double radius = 0;
+  double radius = maximumRadius();
+  // expand the bounds by the maximum search radius
+  bbox.setXMinimum( bbox.xMinimum() - radius );
+  bbox.setYMinimum( bbox.yMinimum() - radius );
+  bbox.setXMaximum( bbox.xMaximum() + radius );
+  bbox.setYMaximum( bbox.yMaximum() + radius );
+  return bbox;
+}
+
+double QgsKernelDensityEstimation::maximumRadius() const
+{
   if ( mRadiusField >= 0 )
   {
     // if radius is using a field, find the max value
-    radius = mSource->maximumValue( mRadiusField ).toDouble();
+    return mSource->maximumValue( mRadiusField ).toDouble();
   }
   else
   {
-    radius = mRadius;
+    return mRadius;
   }
-  // expand the bounds by the maximum search radius
-  bbox.setXMinimum( bbox.xMinimum() - radius );
-  bbox.setYMinimum( bbox.yMinimum() - radius );
-  bbox.setXMaximum( bbox.xMaximum() + radius );
-  bbox.setYMaximum( bbox.yMaximum() + radius );
-  return bbox;
 }
@@ -18,6 +18,7 @@
 
 #include "qgsogrutils.h"
 #include <QString>
+#include <memory>
 
 #include "qgis_analysis.h"
 #include "qgsrectangle.h"
@@ -25,6 +26,8 @@
 
 class QgsFeatureSource;
 class QgsFeature;
+class QgsFeedback;
+class QgsKernelDensityTiles;
 
 
 /**
@@ -64,6 +67,17 @@ class ANALYSIS_EXPORT QgsKernelDensityEstimation
       RasterIoError, //!< Error writing to raster
     };
 
+    /**
+     * Method used to calculate the output surface.
+     * \since QGIS 3.12
+     */
+    enum Method
+    {
+      PointByPoint = 0, //!< The kernel of each point is read from and written back to the output raster as the point is added
+      Tiled, //!< Points are binned into output tiles, which are calculated in parallel in memory and written once each
+      Streamed, //!< As Tiled, but run() only fetches the points affecting one strip of tiles at a time, so memory use does not grow with the output extent
+    };
+
     //! KDE parameters
     struct Parameters
     {
@@ -103,11 +117,34 @@ class ANALYSIS_EXPORT QgsKernelDensityEstimation
     //! QgsKernelDensityEstimation cannot be copied.
     QgsKernelDensityEstimation &operator=( const QgsKernelDensityEstimation &other ) = delete;
 
+    ~QgsKernelDensityEstimation();
+
+    /**
+     * Sets the \a method used to calculate the output surface. This must be called before prepare().
+     *
+     * The Streamed method only applies to surfaces calculated by run(). When features are added
+     * manually via addFeature(), it behaves like the Tiled method.
+     *
+     * \see method()
+     * \since QGIS 3.12
+     */
+    void setMethod( Method method ) { mMethod = method; }
+
+    /**
+     * Returns the method used to calculate the output surface.
+     * \see setMethod()
+     * \since QGIS 3.12
+     */
+    Method method() const { return mMethod; }
+
     /**
      * Runs the KDE calculation across the whole layer at once. Either call this method, or manually
      * call run(), addFeature() and finalise() separately.
+     *
+     * An optional \a feedback object can be set for progress reports and cancellation support
+     * (since QGIS 3.12).
      */
-    Result run();
+    Result run( QgsFeedback *feedback = nullptr );
 
     /**
      * Prepares the output file for writing and setups up the surface calculation. This must be called
@@ -148,6 +185,25 @@ class ANALYSIS_EXPORT QgsKernelDensityEstimation
 
     QgsRectangle calculateBounds() const;
 
+    //! Returns the largest search radius used by any feature
+    double maximumRadius() const;
+
+    /**
+     * Calculates the range of pixels covered by the kernel of a point at \a x, \a y with a kernel of \a buffer pixels,
+     * matching the block read and written back by the PointByPoint method. \a centerRowMin is the row of the pixel center
+     * used for the kernel distance of the first row, see addFeature().
+     */
+    void pixelFootprint( double x, double y, int buffer, int &colMin, int &colMax, int &rowMin, int &rowMax, int &centerRowMin ) const;
+
+    //! Adds a point to the tiles affected by its kernel (Tiled and Streamed methods only)
+    void addPointToTiles( const QgsPointXY &point, double radius, double weight, int buffer );
+
+    //! Calculates and writes all tiles currently held in mTiles
+    Result writeTiles();
+
+    //! Returns the number of tile rows which are calculated and written at once
+    int stripTileRowCount() const;
+
     QgsFeatureSource *mSource = nullptr;
 
     QString mOutputFile;
@@ -165,6 +221,11 @@ class ANALYSIS_EXPORT QgsKernelDensityEstimation
 
     int mBufferSize;
 
+    Method mMethod = PointByPoint;
+    int mRows = 0;
+    int mCols = 0;
+    std::unique_ptr< QgsKernelDensityTiles > mTiles;
+
     QgsRasterDataProvider *mProvider = nullptr;
 
     int radiusSizeInPixels( double radius ) const;
@@ -30,7 +30,11 @@
 #include <QFile>
 #include <QDebug>
 #include <QFileInfo>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+#include <algorithm>
 #include <iterator>
+#include <vector>
 
 
 
@@ -401,16 +405,27 @@ int QgsNineCellFilter::processRasterCPU( QgsFeedback *feedback )
     return 6;
   }
 
-  //keep only three scanlines in memory at a time, make room for initial and final nodata
-  std::size_t bufferSize( sizeof( float ) * ( xSize + 2 ) );
-  float *scanLine1 = ( float * ) CPLMalloc( bufferSize );
-  float *scanLine2 = ( float * ) CPLMalloc( bufferSize );
-  float *scanLine3 = ( float * ) CPLMalloc( bufferSize );
-
-  float *resultLine = ( float * ) CPLMalloc( sizeof( float ) * xSize );
+  // the raster is processed in horizontal bands, each read with a single IO call together with the
+  // row above and the row below it. Batches of bands are processed in parallel, and the results are
+  // written in order from this thread (GDAL dataset handles must not be shared between threads)
+  struct Band
+  {
+    int firstRow = 0;
+    int rowCount = 0;
+    std::vector< float > input;
+    std::vector< float > output;
+  };
+
+  // one band per thread allowed in the global pool. Aim for bands of about a million cells, so that all
+  // threads get some work even for smaller rasters, but keep them tall enough for the row overlaps to be cheap
+  const int bandsPerBatch = std::max( 1, QThreadPool::globalInstance()->maxThreadCount() );
+  const int bandHeight = std::max( 16, std::min( { 1024, ( 1 << 20 ) / xSize, ( ySize + bandsPerBatch - 1 ) / bandsPerBatch } ) );
+  //make room for initial and final nodata columns
+  const std::size_t rowSize = static_cast< std::size_t >( xSize ) + 2;
+  std::vector< Band > bands( bandsPerBatch );
 
   //values outside the layer extent (if the 3x3 window is on the border) are sent to the processing method as (input) nodata values
-  for ( int yIndex = 0; yIndex < ySize; ++yIndex )
+  for ( int batchStart = 0; batchStart < ySize; batchStart += bandHeight * bandsPerBatch )
   {
     if ( feedback && feedback->isCanceled() )
     {
@@ -419,74 +434,77 @@ int QgsNineCellFilter::processRasterCPU( QgsFeedback *feedback )
 
     if ( feedback )
     {
-      feedback->setProgress( 100.0 * static_cast< double >( yIndex ) / ySize );
+      feedback->setProgress( 100.0 * static_cast< double >( batchStart ) / ySize );
     }
 
-    if ( yIndex == 0 )
+    QVector< Band * > batch;
+    for ( int i = 0; i < bandsPerBatch; ++i )
     {
-      //fill scanline 1 with (input) nodata for the values above the first row and feed scanline2 with the first row
-      for ( int a = 0; a < xSize + 2 ; ++a )
-      {
-        scanLine1[a] = mInputNodataValue;
-      }
-      // Read scanline2
-      if ( GDALRasterIO( rasterBand, GF_Read, 0, 0, xSize, 1, &scanLine2[1], xSize, 1, GDT_Float32, 0, 0 ) != CE_None )
+      Band &band = bands[ i ];
+      band.firstRow = batchStart + i * bandHeight;
+      if ( band.firstRow >= ySize )
+        break;
+
+      band.rowCount = std::min( bandHeight, ySize - band.firstRow );
+      // rows above the first and below the last row of the raster, and the extra columns, are left as nodata
+      band.input.assign( rowSize * ( band.rowCount + 2 ), mInputNodataValue );
+      band.output.resize( static_cast< std::size_t >( xSize ) * band.rowCount );
+
+      const int readStart = std::max( 0, band.firstRow - 1 );
+      const int readEnd = std::min( ySize, band.firstRow + band.rowCount + 1 );
+      float *readBuffer = band.input.data() + rowSize * ( readStart - band.firstRow + 1 ) + 1;
+      if ( GDALRasterIO( rasterBand, GF_Read, 0, readStart, xSize, readEnd - readStart, readBuffer, xSize, readEnd - readStart,
+                         GDT_Float32, 0, static_cast< int >( sizeof( float ) * rowSize ) ) != CE_None )
       {
         QgsDebugMsg( QStringLiteral( "Raster IO Error" ) );
       }
-    }
-    else
-    {
-      //normally fetch only scanLine3 and release scanline 1 if we move forward one row
-      CPLFree( scanLine1 );
-      scanLine1 = scanLine2;
-      scanLine2 = scanLine3;
-      scanLine3 = ( float * ) CPLMalloc( bufferSize );
+      batch << &band;
     }
 
-    // Read scanline 3
-    if ( yIndex == ySize - 1 ) //fill the row below the bottom with nodata values
-    {
-      for ( int a = 0; a < xSize + 2; ++a )
-      {
-        scanLine3[a] = mInputNodataValue;
-      }
-    }
-    else
+    auto processBand = [this, xSize, rowSize, feedback]( Band * band )
     {
-      if ( GDALRasterIO( rasterBand, GF_Read, 0, yIndex + 1, xSize, 1, &scanLine3[1], xSize, 1, GDT_Float32, 0, 0 ) != CE_None )
+      for ( int row = 0; row < band->rowCount; ++row )
       {
-        QgsDebugMsg( QStringLiteral( "Raster IO Error" ) );
-      }
-    }
-    // Set first and last extra columns to nodata
-    scanLine1[0] = scanLine1[xSize + 1] = mInputNodataValue;
-    scanLine2[0] = scanLine2[xSize + 1] = mInputNodataValue;
-    scanLine3[0] = scanLine3[xSize + 1] = mInputNodataValue;
+        if ( feedback && feedback->isCanceled() )
+          return;
 
+        float *scanLine1 = band->input.data() + rowSize * row;
+        float *scanLine2 = scanLine1 + rowSize;
+        float *scanLine3 = scanLine2 + rowSize;
+        float *resultLine = band->output.data() + static_cast< std::size_t >( xSize ) * row;
 
+        // j is the x axis index, skip 0 and last cell that have been filled with nodata
+        for ( int xIndex = 0; xIndex < xSize ; ++xIndex )
+        {
+          // cells(x, y) x11, x21, x31, x12, x22, x32, x13, x23, x33
+          resultLine[ xIndex ] = processNineCellWindow( &scanLine1[ xIndex ], &scanLine1[ xIndex + 1 ], &scanLine1[ xIndex + 2 ],
+                                 &scanLine2[ xIndex ], &scanLine2[ xIndex + 1 ], &scanLine2[ xIndex + 2 ],
+                                 &scanLine3[ xIndex ], &scanLine3[ xIndex + 1 ], &scanLine3[ xIndex + 2 ] );
+        }
+      }
+    };
 
-    // j is the x axis index, skip 0 and last cell that have been filled with nodata
-    for ( int xIndex = 0; xIndex < xSize ; ++xIndex )
-    {
-      // cells(x, y) x11, x21, x31, x12, x22, x32, x13, x23, x33
-      resultLine[ xIndex ] = processNineCellWindow( &scanLine1[ xIndex ], &scanLine1[ xIndex + 1 ], &scanLine1[ xIndex + 2 ],
-                             &scanLine2[ xIndex ], &scanLine2[ xIndex + 1 ], &scanLine2[ xIndex + 2 ],
-                             &scanLine3[ xIndex ], &scanLine3[ xIndex + 1 ], &scanLine3[ xIndex + 2 ] );
+    // with a single thread allowed, the band is processed on this thread
+    if ( batch.size() > 1 )
+      QtConcurrent::blockingMap( batch, processBand );
+    else
+      std::for_each( batch.begin(), batch.end(), processBand );
 
+    if ( feedback && feedback->isCanceled() )
+    {
+      break;
     }
 
-    if ( GDALRasterIO( outputRasterBand, GF_Write, 0, yIndex, xSize, 1, resultLine, xSize, 1, GDT_Float32, 0, 0 ) != CE_None )
+    for ( Band *band : qgis::as_const( batch ) )
     {
-      QgsDebugMsg( QStringLiteral( "Raster IO Error" ) );
+      if ( GDALRasterIO( outputRasterBand, GF_Write, 0, band->firstRow, xSize, band->rowCount, band->output.data(),
+                         xSize, band->rowCount, GDT_Float32, 0, 0 ) != CE_None )
+      {
+        QgsDebugMsg( QStringLiteral( "Raster IO Error" ) );
+      }
     }
   }
 
-  CPLFree( resultLine );
-  CPLFree( scanLine1 );
-  CPLFree( scanLine2 );
-  CPLFree( scanLine3 );
-
   if ( feedback && feedback->isCanceled() )
   {
     //delete the dataset without closing (because it is faster)
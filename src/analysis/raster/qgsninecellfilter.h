@@ -98,7 +98,8 @@ class ANALYSIS_EXPORT QgsNineCellFilter
     gdal::dataset_unique_ptr openOutputFile( GDALDatasetH inputDataset, GDALDriverH outputDriver );
 
     /**
-     * \brief processRasterCPU executes the computation on the CPU
+     * \brief processRasterCPU executes the computation on the CPU, processing horizontal bands
+     * of the raster in parallel
      * \param feedback instance of QgsFeedback, to allow for progress monitoring and cancellation
      * \return an opaque integer for error codes: 0 in case of success
      */
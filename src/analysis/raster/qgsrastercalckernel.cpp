@@ -0,0 +1,233 @@
+/***************************************************************************
+                         qgsrastercalckernel.cpp
+                         -----------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by the QGIS project
+    email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsrastercalckernel_p.h"
+#include "qgsrasterblock.h"
+
+#include <algorithm>
+#include <cmath>
+
+///@cond PRIVATE
+
+QgsRasterCalcKernel::QgsRasterCalcKernel( const QgsRasterCalcNode &node )
+{
+  int depth = 0;
+  mValid = compile( &node, depth ) && depth == 1;
+}
+
+bool QgsRasterCalcKernel::compile( const QgsRasterCalcNode *node, int &depth )
+{
+  Instruction instruction;
+  instruction.type = node->mType;
+
+  switch ( node->mType )
+  {
+    case QgsRasterCalcNode::tNumber:
+      instruction.number = node->mNumber;
+      depth++;
+      break;
+
+    case QgsRasterCalcNode::tRasterRef:
+      instruction.input = mRasterReferences.indexOf( node->mRasterName );
+      if ( instruction.input < 0 )
+      {
+        instruction.input = mRasterReferences.count();
+        mRasterReferences << node->mRasterName;
+      }
+      depth++;
+      break;
+
+    case QgsRasterCalcNode::tOperator:
+      if ( node->mOperator == QgsRasterCalcNode::opNONE || !node->mLeft || !compile( node->mLeft, depth ) )
+        return false;
+
+      // unary operators ignore their right operand
+      if ( !isUnary( node->mOperator ) )
+      {
+        if ( !node->mRight || !compile( node->mRight, depth ) )
+          return false;
+        depth--;
+      }
+      instruction.op = node->mOperator;
+      break;
+
+    case QgsRasterCalcNode::tMatrix:
+      return false;
+  }
+
+  mStackSize = std::max( mStackSize, depth );
+  mProgram.emplace_back( instruction );
+  return true;
+}
+
+void QgsRasterCalcKernel::evaluate( const std::vector<const QgsRasterBlock *> &inputs, int nCols, int startRow, int endRow, double nodataValue, float *result ) const
+{
+  if ( !mValid || static_cast< int >( inputs.size() ) != mRasterReferences.count() )
+    return;
+
+  // one row of each input, converted to double with nodata replaced by the result nodata value
+  std::vector< double > rows( inputs.size() * static_cast< std::size_t >( nCols ) );
+  std::vector< double > stack( static_cast< std::size_t >( mStackSize ) );
+
+  for ( int row = startRow; row < endRow; ++row )
+  {
+    for ( std::size_t i = 0; i < inputs.size(); ++i )
+    {
+      double *inputRow = rows.data() + i * nCols;
+      bool isNoData = false;
+      for ( int col = 0; col < nCols; ++col )
+      {
+        const double value = inputs[i]->valueAndNoData( row, col, isNoData );
+        inputRow[col] = isNoData ? nodataValue : value;
+      }
+    }
+
+    for ( int col = 0; col < nCols; ++col )
+    {
+      double *top = stack.data() - 1;
+      for ( const Instruction &instruction : mProgram )
+      {
+        switch ( instruction.type )
+        {
+          case QgsRasterCalcNode::tNumber:
+            *++top = instruction.number;
+            break;
+
+          case QgsRasterCalcNode::tRasterRef:
+            *++top = rows[ static_cast< std::size_t >( instruction.input ) * nCols + col ];
+            break;
+
+          case QgsRasterCalcNode::tOperator:
+            if ( isUnary( instruction.op ) )
+            {
+              if ( *top != nodataValue )
+                *top = unaryOperation( instruction.op, *top, nodataValue );
+            }
+            else
+            {
+              const double arg2 = *top--;
+              //operations with nodata values always generate nodata
+              *top = ( *top == nodataValue || arg2 == nodataValue ) ? nodataValue : binaryOperation( instruction.op, *top, arg2, nodataValue );
+            }
+            break;
+
+          case QgsRasterCalcNode::tMatrix:
+            break;
+        }
+      }
+      *result++ = static_cast< float >( stack[0] );
+    }
+  }
+}
+
+bool QgsRasterCalcKernel::isUnary( QgsRasterCalcNode::Operator op )
+{
+  switch ( op )
+  {
+    case QgsRasterCalcNode::opSQRT:
+    case QgsRasterCalcNode::opSIN:
+    case QgsRasterCalcNode::opCOS:
+    case QgsRasterCalcNode::opTAN:
+    case QgsRasterCalcNode::opASIN:
+    case QgsRasterCalcNode::opACOS:
+    case QgsRasterCalcNode::opATAN:
+    case QgsRasterCalcNode::opSIGN:
+    case QgsRasterCalcNode::opLOG:
+    case QgsRasterCalcNode::opLOG10:
+    case QgsRasterCalcNode::opABS:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// must match QgsRasterMatrix::oneArgumentOperation()
+double QgsRasterCalcKernel::unaryOperation( QgsRasterCalcNode::Operator op, double value, double nodataValue )
+{
+  switch ( op )
+  {
+    case QgsRasterCalcNode::opSQRT:
+      //no complex numbers
+      return value < 0 ? nodataValue : std::sqrt( value );
+    case QgsRasterCalcNode::opSIN:
+      return std::sin( value );
+    case QgsRasterCalcNode::opCOS:
+      return std::cos( value );
+    case QgsRasterCalcNode::opTAN:
+      return std::tan( value );
+    case QgsRasterCalcNode::opASIN:
+      return std::asin( value );
+    case QgsRasterCalcNode::opACOS:
+      return std::acos( value );
+    case QgsRasterCalcNode::opATAN:
+      return std::atan( value );
+    case QgsRasterCalcNode::opSIGN:
+      return -value;
+    case QgsRasterCalcNode::opLOG:
+      return value <= 0 ? nodataValue : ::log( value );
+    case QgsRasterCalcNode::opLOG10:
+      return value <= 0 ? nodataValue : ::log10( value );
+    case QgsRasterCalcNode::opABS:
+      return ::fabs( value );
+    default:
+      return value;
+  }
+}
+
+// must match QgsRasterMatrix::calculateTwoArgumentOp()
+double QgsRasterCalcKernel::binaryOperation( QgsRasterCalcNode::Operator op, double arg1, double arg2, double nodataValue )
+{
+  switch ( op )
+  {
+    case QgsRasterCalcNode::opPLUS:
+      return arg1 + arg2;
+    case QgsRasterCalcNode::opMINUS:
+      return arg1 - arg2;
+    case QgsRasterCalcNode::opMUL:
+      return arg1 * arg2;
+    case QgsRasterCalcNode::opDIV:
+      return arg2 == 0 ? nodataValue : arg1 / arg2;
+    case QgsRasterCalcNode::opPOW:
+      if ( ( arg1 == 0 && arg2 < 0 ) || ( arg1 < 0 && ( arg2 - std::floor( arg2 ) ) > 0 ) )
+        return nodataValue;
+      return std::pow( arg1, arg2 );
+    case QgsRasterCalcNode::opEQ:
+      return ( arg1 == arg2 ? 1.0 : 0.0 );
+    case QgsRasterCalcNode::opNE:
+      return ( arg1 == arg2 ? 0.0 : 1.0 );
+    case QgsRasterCalcNode::opGT:
+      return ( arg1 > arg2 ? 1.0 : 0.0 );
+    case QgsRasterCalcNode::opLT:
+      return ( arg1 < arg2 ? 1.0 : 0.0 );
+    case QgsRasterCalcNode::opGE:
+      return ( arg1 >= arg2 ? 1.0 : 0.0 );
+    case QgsRasterCalcNode::opLE:
+      return ( arg1 <= arg2 ? 1.0 : 0.0 );
+    case QgsRasterCalcNode::opAND:
+      return ( arg1 && arg2 ? 1.0 : 0.0 );
+    case QgsRasterCalcNode::opOR:
+      return ( arg1 || arg2 ? 1.0 : 0.0 );
+    case QgsRasterCalcNode::opMAX:
+      return std::max( arg1, arg2 );
+    case QgsRasterCalcNode::opMIN:
+      return std::min( arg1, arg2 );
+    default:
+      return nodataValue;
+  }
+}
+
+///@endcond
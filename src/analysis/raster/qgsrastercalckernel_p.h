@@ -0,0 +1,109 @@
+/***************************************************************************
+                         qgsrastercalckernel_p.h
+                         -----------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by the QGIS project
+    email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSRASTERCALCKERNEL_P_H
+#define QGSRASTERCALCKERNEL_P_H
+
+#define SIP_NO_FILE
+
+/// @cond PRIVATE
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QGIS API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+
+#include "qgsrastercalcnode.h"
+
+#include <QStringList>
+#include <vector>
+
+class QgsRasterBlock;
+
+/**
+ * \ingroup analysis
+ * Evaluates a raster calculator expression cell by cell.
+ *
+ * The expression tree is flattened into a postfix program, which is run for every
+ * cell of the input blocks using a small value stack. Unlike QgsRasterCalcNode::calculate(),
+ * no intermediate matrices are allocated for the nodes of the expression, so large blocks
+ * can be evaluated cheaply, and evaluate() can be called concurrently from several threads.
+ *
+ * The results are identical to the ones of QgsRasterCalcNode::calculate().
+ *
+ * \since QGIS 3.12
+ */
+class QgsRasterCalcKernel
+{
+  public:
+
+    /**
+     * Creates a kernel for the expression represented by \a node. Expressions containing
+     * matrix nodes are not supported, and result in an invalid kernel.
+     */
+    explicit QgsRasterCalcKernel( const QgsRasterCalcNode &node );
+
+    /**
+     * Returns TRUE if the expression could be compiled.
+     */
+    bool isValid() const { return mValid; }
+
+    /**
+     * Returns the names of the rasters referenced by the expression. The input blocks
+     * passed to evaluate() must follow the same order.
+     */
+    QStringList rasterReferences() const { return mRasterReferences; }
+
+    /**
+     * Evaluates the expression for rows \a startRow (inclusive) to \a endRow (exclusive)
+     * of the \a inputs blocks, which must all be \a nCols columns wide.
+     *
+     * Input nodata values are converted to \a nodataValue, which is also used for invalid
+     * results. Results are written to \a result, one row of \a nCols values after the other,
+     * starting with \a startRow.
+     */
+    void evaluate( const std::vector< const QgsRasterBlock * > &inputs, int nCols, int startRow, int endRow, double nodataValue, float *result ) const;
+
+  private:
+
+    struct Instruction
+    {
+      QgsRasterCalcNode::Type type = QgsRasterCalcNode::tNumber;
+      QgsRasterCalcNode::Operator op = QgsRasterCalcNode::opNONE;
+      double number = 0;
+      int input = -1;
+    };
+
+    bool compile( const QgsRasterCalcNode *node, int &depth );
+
+    static bool isUnary( QgsRasterCalcNode::Operator op );
+    static double unaryOperation( QgsRasterCalcNode::Operator op, double value, double nodataValue );
+    static double binaryOperation( QgsRasterCalcNode::Operator op, double arg1, double arg2, double nodataValue );
+
+    std::vector< Instruction > mProgram;
+    QStringList mRasterReferences;
+    int mStackSize = 0;
+    bool mValid = false;
+};
+
+/// @endcond
+
+#endif // QGSRASTERCALCKERNEL_P_H
@@ -17,6 +17,7 @@
 
 #include "qgsgdalutils.h"
 #include "qgsrastercalculator.h"
+#include "qgsrastercalckernel_p.h"
 #include "qgsrasterdataprovider.h"
 #include "qgsrasterinterface.h"
 #include "qgsrasterlayer.h"
@@ -27,6 +28,8 @@
 #include "qgsproject.h"
 
 #include <QFile>
+#include <QThread>
+#include <QtConcurrentMap>
 
 #include <cpl_string.h>
 #include <gdalwarper.h>
@@ -157,40 +160,49 @@ QgsRasterCalculator::Result QgsRasterCalculator::processCalculation( QgsFeedback
   // in the expression
   bool requiresMatrix = ! calcNode->findNodes( QgsRasterCalcNode::Type::tMatrix ).isEmpty();
 
-  // Take the fast route (process one line at a time) if we can
+  // Take the fast route (process blocks of rows, evaluating the expression cell by cell) if we can
   if ( ! requiresMatrix )
   {
-    // Map of raster names -> blocks
-    std::map<QString, std::unique_ptr<QgsRasterBlock>> inputBlocks;
-    std::map<QString, QgsRasterCalculatorEntry> uniqueRasterEntries;
-    const QList<const QgsRasterCalcNode *> rasterRefNodes = calcNode->findNodes( QgsRasterCalcNode::Type::tRasterRef );
-    for ( const QgsRasterCalcNode *r : rasterRefNodes )
+    const QgsRasterCalcKernel kernel( *calcNode );
+    if ( !kernel.isValid() )
     {
-      QString layerRef( r->toString().remove( 0, 1 ) );
-      layerRef.chop( 1 );
-      if ( ! inputBlocks.count( layerRef ) )
+      gdal::fast_delete_and_close( outputDataset, outputDriver, mOutputFile );
+      return CalculationError;
+    }
+
+    // Raster entries and blocks, in the order of the kernel's raster references
+    const QStringList rasterReferences = kernel.rasterReferences();
+    std::vector<QgsRasterCalculatorEntry> uniqueRasterEntries;
+    for ( const QString &layerRef : rasterReferences )
+    {
+      const QgsRasterCalculatorEntry *entry = nullptr;
+      for ( const QgsRasterCalculatorEntry &ref : qgis::as_const( mRasterEntries ) )
       {
-        for ( const QgsRasterCalculatorEntry &ref : qgis::as_const( mRasterEntries ) )
-        {
-          if ( ref.ref == layerRef )
-          {
-            uniqueRasterEntries[layerRef] = ref;
-            inputBlocks[layerRef ] = qgis::make_unique<QgsRasterBlock>();
-          }
-        }
+        if ( ref.ref == layerRef )
+          entry = &ref;
+      }
+      if ( !entry )
+      {
+        QgsDebugMsg( QStringLiteral( "Error: could not find raster data for \"%1\"" ).arg( layerRef ) );
+        gdal::fast_delete_and_close( outputDataset, outputDriver, mOutputFile );
+        return CalculationError;
       }
+      uniqueRasterEntries.emplace_back( *entry );
     }
-
-    //read / write line by line
-    QMap<QString, QgsRasterBlock * > _rasterData;
-    // Cast to float
-    std::vector<float> castedResult( static_cast<size_t>( mNumOutputColumns ), 0 );
+    std::vector<std::unique_ptr<QgsRasterBlock>> inputBlocks( uniqueRasterEntries.size() );
+    std::vector<const QgsRasterBlock *> inputData( uniqueRasterEntries.size() );
+
+    // read / write blocks of about a million cells at once. Blocks are read and written from this thread,
+    // as data providers and GDAL datasets cannot be shared between threads, but evaluated in parallel
+    const int blockRows = std::max( 1, std::min( mNumOutputRows, ( 1 << 20 ) / std::max( 1, mNumOutputColumns ) ) );
+    const int rowsPerTask = std::max( 1, blockRows / ( 4 * std::max( 1, QThread::idealThreadCount() ) ) );
+    std::vector<float> castedResult( static_cast<size_t>( mNumOutputColumns ) * blockRows, 0 );
     auto rowHeight = mOutputRectangle.height() / mNumOutputRows;
-    for ( size_t row = 0; row < static_cast<size_t>( mNumOutputRows ); ++row )
+    for ( int startRow = 0; startRow < mNumOutputRows; startRow += blockRows )
     {
       if ( feedback )
       {
-        feedback->setProgress( 100.0 * static_cast< double >( row ) / mNumOutputRows );
+        feedback->setProgress( 100.0 * static_cast< double >( startRow ) / mNumOutputRows );
       }
 
       if ( feedback && feedback->isCanceled() )
@@ -198,51 +210,45 @@ QgsRasterCalculator::Result QgsRasterCalculator::processCalculation( QgsFeedback
         break;
       }
 
-      // Calculates the rect for a single row read
+      const int nRows = std::min( blockRows, mNumOutputRows - startRow );
+
+      // Calculates the rect for the rows to read
       QgsRectangle rect( mOutputRectangle );
-      rect.setYMaximum( rect.yMaximum() - rowHeight * row );
-      rect.setYMinimum( rect.yMaximum() - rowHeight );
+      rect.setYMaximum( rect.yMaximum() - rowHeight * startRow );
+      rect.setYMinimum( rect.yMaximum() - rowHeight * nRows );
 
       // Read rows into input blocks
-      for ( auto &layerRef : inputBlocks )
+      for ( std::size_t i = 0; i < uniqueRasterEntries.size(); ++i )
       {
-        QgsRasterCalculatorEntry ref = uniqueRasterEntries[layerRef.first];
+        const QgsRasterCalculatorEntry &ref = uniqueRasterEntries[i];
         if ( ref.raster->crs() != mOutputCrs )
         {
           QgsRasterProjector proj;
           proj.setCrs( ref.raster->crs(), mOutputCrs, mTransformContext );
           proj.setInput( ref.raster->dataProvider() );
           proj.setPrecision( QgsRasterProjector::Exact );
-          layerRef.second.reset( proj.block( ref.bandNumber, rect, mNumOutputColumns, 1 ) );
+          inputBlocks[i].reset( proj.block( ref.bandNumber, rect, mNumOutputColumns, nRows ) );
         }
         else
         {
-          layerRef.second.reset( ref.raster->dataProvider()->block( ref.bandNumber, rect, mNumOutputColumns, 1 ) );
+          inputBlocks[i].reset( ref.raster->dataProvider()->block( ref.bandNumber, rect, mNumOutputColumns, nRows ) );
         }
+        inputData[i] = inputBlocks[i].get();
       }
 
-      // 1 row X mNumOutputColumns matrix
-      QgsRasterMatrix resultMatrix( mNumOutputColumns, 1, nullptr, outputNodataValue );
+      QVector<int> taskRows;
+      for ( int row = 0; row < nRows; row += rowsPerTask )
+        taskRows << row;
 
-      _rasterData.clear();
-      for ( const auto &layerRef : inputBlocks )
+      QtConcurrent::blockingMap( taskRows, [&]( int firstRow )
       {
-        _rasterData.insert( layerRef.first, layerRef.second.get() );
-      }
+        const int lastRow = std::min( nRows, firstRow + rowsPerTask );
+        kernel.evaluate( inputData, mNumOutputColumns, firstRow, lastRow, outputNodataValue, castedResult.data() + static_cast<size_t>( firstRow ) * mNumOutputColumns );
+      } );
 
-      if ( calcNode->calculate( _rasterData, resultMatrix, 0 ) )
-      {
-        std::copy( resultMatrix.data(), resultMatrix.data() + mNumOutputColumns, castedResult.begin() );
-        if ( GDALRasterIO( outputRasterBand, GF_Write, 0, row, mNumOutputColumns, 1, castedResult.data(), mNumOutputColumns, 1, GDT_Float32, 0, 0 ) != CE_None )
-        {
-          QgsDebugMsg( QStringLiteral( "RasterIO error!" ) );
-        }
-      }
-      else
+      if ( GDALRasterIO( outputRasterBand, GF_Write, 0, startRow, mNumOutputColumns, nRows, castedResult.data(), mNumOutputColumns, nRows, GDT_Float32, 0, 0 ) != CE_None )
       {
-        //delete the dataset without closing (because it is faster)
-        gdal::fast_delete_and_close( outputDataset, outputDriver, mOutputFile );
-        return CalculationError;
+        QgsDebugMsg( QStringLiteral( "RasterIO error!" ) );
       }
     }
 
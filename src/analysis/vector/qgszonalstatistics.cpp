@@ -23,12 +23,16 @@
 #include "qgsvectordataprovider.h"
 #include "qgsvectorlayer.h"
 #include "processing/qgsrasteranalysisutils.h"
+#include "qgsrasterblock.h"
 #include "qgsrasterdataprovider.h"
 #include "qgsrasterlayer.h"
 #include "qgslogger.h"
 #include "qgsproject.h"
 
 #include <QFile>
+#include <QSet>
+#include <QThread>
+#include <QtConcurrentMap>
 
 QgsZonalStatistics::QgsZonalStatistics( QgsVectorLayer *polygonLayer, QgsRasterLayer *rasterLayer, const QString &attributePrefix, int rasterBand, QgsZonalStatistics::Statistics stats )
   : QgsZonalStatistics( polygonLayer,
@@ -223,49 +227,9 @@ int QgsZonalStatistics::calculateStatistics( QgsFeedback *feedback )
   FeatureStats featureStats( statsStoreValues, statsStoreValueCount );
   int featureCounter = 0;
 
-  QgsChangedAttributesMap changeMap;
-  while ( fi.nextFeature( f ) )
+  // builds the attributes for the statistics of a zone
+  auto statisticsAttributes = [&]( FeatureStats & featureStats )
   {
-    if ( feedback && feedback->isCanceled() )
-    {
-      break;
-    }
-
-    if ( feedback )
-    {
-      feedback->setProgress( 100.0 * static_cast< double >( featureCounter ) / featureCount );
-    }
-
-    if ( !f.hasGeometry() )
-    {
-      ++featureCounter;
-      continue;
-    }
-    QgsGeometry featureGeometry = f.geometry();
-
-    QgsRectangle featureRect = featureGeometry.boundingBox().intersect( rasterBBox );
-    if ( featureRect.isEmpty() )
-    {
-      ++featureCounter;
-      continue;
-    }
-
-    int nCellsX, nCellsY;
-    QgsRectangle rasterBlockExtent;
-    QgsRasterAnalysisUtils::cellInfoForBBox( rasterBBox, featureRect, mCellSizeX, mCellSizeY, nCellsX, nCellsY, nCellsXProvider, nCellsYProvider, rasterBlockExtent );
-
-    featureStats.reset();
-    QgsRasterAnalysisUtils::statisticsFromMiddlePointTest( mRasterInterface, mRasterBand, featureGeometry, nCellsX, nCellsY, mCellSizeX, mCellSizeY,
-    rasterBlockExtent, [ &featureStats ]( double value ) { featureStats.addValue( value ); } );
-
-    if ( featureStats.count <= 1 )
-    {
-      //the cell resolution is probably larger than the polygon area. We switch to precise pixel - polygon intersection in this case
-      featureStats.reset();
-      QgsRasterAnalysisUtils::statisticsFromPreciseIntersection( mRasterInterface, mRasterBand, featureGeometry, nCellsX, nCellsY, mCellSizeX, mCellSizeY,
-      rasterBlockExtent, [ &featureStats ]( double value, double weight ) { featureStats.addValue( value, weight ); } );
-    }
-
     //write the statistics value to the vector data provider
     QgsAttributeMap changeAttributeMap;
     if ( mStatistics & QgsZonalStatistics::Count )
@@ -334,9 +298,115 @@ int QgsZonalStatistics::calculateStatistics( QgsFeedback *feedback )
       if ( mStatistics & QgsZonalStatistics::Variety )
         changeAttributeMap.insert( varietyIndex, QVariant( featureStats.valueCount.count() ) );
     }
+    return changeAttributeMap;
+  };
 
-    changeMap.insert( f.id(), changeAttributeMap );
-    ++featureCounter;
+  QgsChangedAttributesMap changeMap;
+  if ( mMethod == Rasterized )
+  {
+    std::vector< QgsFeatureId > ids;
+    std::vector< FeatureStats > stats;
+    QgsFeatureIds overlappingZoneIds;
+    calculateRasterizedStatistics( fi, featureCount, ids, stats, featureStats, overlappingZoneIds, feedback );
+
+    // zones covering no more than a single cell center are handled like for the PerFeature method,
+    // using precise pixel - polygon intersection. Zones sharing cells with other zones cannot be
+    // handled with a single zone per cell, so these are calculated one by one like for the PerFeature method
+    QgsFeatureIds perFeatureZoneIds = overlappingZoneIds;
+    QHash< QgsFeatureId, std::size_t > zoneIndex;
+    for ( std::size_t i = 0; i < ids.size(); ++i )
+    {
+      zoneIndex.insert( ids[i], i );
+      if ( stats[i].count <= 1 )
+        perFeatureZoneIds.insert( ids[i] );
+    }
+
+    if ( !perFeatureZoneIds.isEmpty() && !( feedback && feedback->isCanceled() ) )
+    {
+      QgsFeatureRequest perFeatureRequest( request );
+      perFeatureRequest.setFilterFids( perFeatureZoneIds );
+      QgsFeatureIterator perFeatureIt = vectorProvider->getFeatures( perFeatureRequest );
+      while ( perFeatureIt.nextFeature( f ) )
+      {
+        if ( feedback && feedback->isCanceled() )
+        {
+          break;
+        }
+
+        const QgsGeometry featureGeometry = f.geometry();
+        const QgsRectangle featureRect = featureGeometry.boundingBox().intersect( rasterBBox );
+        int nCellsX, nCellsY;
+        QgsRectangle rasterBlockExtent;
+        QgsRasterAnalysisUtils::cellInfoForBBox( rasterBBox, featureRect, mCellSizeX, mCellSizeY, nCellsX, nCellsY, nCellsXProvider, nCellsYProvider, rasterBlockExtent );
+
+        FeatureStats &zoneStats = stats[ zoneIndex.value( f.id() ) ];
+        if ( overlappingZoneIds.contains( f.id() ) )
+        {
+          zoneStats.reset();
+          QgsRasterAnalysisUtils::statisticsFromMiddlePointTest( mRasterInterface, mRasterBand, featureGeometry, nCellsX, nCellsY, mCellSizeX, mCellSizeY,
+          rasterBlockExtent, [ &zoneStats ]( double value ) { zoneStats.addValue( value ); } );
+        }
+        if ( zoneStats.count <= 1 )
+        {
+          zoneStats.reset();
+          QgsRasterAnalysisUtils::statisticsFromPreciseIntersection( mRasterInterface, mRasterBand, featureGeometry, nCellsX, nCellsY, mCellSizeX, mCellSizeY,
+          rasterBlockExtent, [ &zoneStats ]( double value, double weight ) { zoneStats.addValue( value, weight ); } );
+        }
+      }
+    }
+
+    for ( std::size_t i = 0; i < ids.size(); ++i )
+    {
+      changeMap.insert( ids[i], statisticsAttributes( stats[i] ) );
+    }
+  }
+  else
+  {
+    while ( fi.nextFeature( f ) )
+    {
+      if ( feedback && feedback->isCanceled() )
+      {
+        break;
+      }
+
+      if ( feedback )
+      {
+        feedback->setProgress( 100.0 * static_cast< double >( featureCounter ) / featureCount );
+      }
+
+      if ( !f.hasGeometry() )
+      {
+        ++featureCounter;
+        continue;
+      }
+      QgsGeometry featureGeometry = f.geometry();
+
+      QgsRectangle featureRect = featureGeometry.boundingBox().intersect( rasterBBox );
+      if ( featureRect.isEmpty() )
+      {
+        ++featureCounter;
+        continue;
+      }
+
+      int nCellsX, nCellsY;
+      QgsRectangle rasterBlockExtent;
+      QgsRasterAnalysisUtils::cellInfoForBBox( rasterBBox, featureRect, mCellSizeX, mCellSizeY, nCellsX, nCellsY, nCellsXProvider, nCellsYProvider, rasterBlockExtent );
+
+      featureStats.reset();
+      QgsRasterAnalysisUtils::statisticsFromMiddlePointTest( mRasterInterface, mRasterBand, featureGeometry, nCellsX, nCellsY, mCellSizeX, mCellSizeY,
+      rasterBlockExtent, [ &featureStats ]( double value ) { featureStats.addValue( value ); } );
+
+      if ( featureStats.count <= 1 )
+      {
+        //the cell resolution is probably larger than the polygon area. We switch to precise pixel - polygon intersection in this case
+        featureStats.reset();
+        QgsRasterAnalysisUtils::statisticsFromPreciseIntersection( mRasterInterface, mRasterBand, featureGeometry, nCellsX, nCellsY, mCellSizeX, mCellSizeY,
+        rasterBlockExtent, [ &featureStats ]( double value, double weight ) { featureStats.addValue( value, weight ); } );
+      }
+
+      changeMap.insert( f.id(), statisticsAttributes( featureStats ) );
+      ++featureCounter;
+    }
   }
 
   vectorProvider->changeAttributeValues( changeMap );
@@ -356,6 +426,205 @@ int QgsZonalStatistics::calculateStatistics( QgsFeedback *feedback )
   return 0;
 }
 
+///@cond PRIVATE
+
+//! A zone for the Rasterized method, as rings in the raster CRS
+struct QgsZonalStatisticsZone
+{
+  QVector< QgsPolylineXY > rings;
+  int firstRow = 0;
+  int lastRow = -1;
+};
+
+/**
+ * Sets the cells of a raster row whose center is inside \a zone to \a zoneIndex, using the even-odd rule.
+ * \a centerY is the y coordinate of the cell centers of the row.
+ * The indices of zones sharing a cell center with another zone are added to \a overlappingZones.
+ */
+static void rasterizeZoneRow( const QgsZonalStatisticsZone &zone, int zoneIndex, double centerY, double xMin, double cellSizeX, int nCols, int *gridRow,
+                              std::vector< double > &crossings, QSet< int > &overlappingZones )
+{
+  crossings.clear();
+  for ( const QgsPolylineXY &ring : zone.rings )
+  {
+    for ( int i = 1; i < ring.size(); ++i )
+    {
+      const QgsPointXY &p1 = ring.at( i - 1 );
+      const QgsPointXY &p2 = ring.at( i );
+      if ( ( p1.y() > centerY ) != ( p2.y() > centerY ) )
+        crossings.push_back( p1.x() + ( centerY - p1.y() ) * ( p2.x() - p1.x() ) / ( p2.y() - p1.y() ) );
+    }
+  }
+  std::sort( crossings.begin(), crossings.end() );
+
+  for ( std::size_t i = 0; i + 1 < crossings.size(); i += 2 )
+  {
+    // cells with their center between the two crossings
+    const double firstCol = std::max( 0.0, std::ceil( ( crossings[i] - xMin ) / cellSizeX - 0.5 ) );
+    const double lastCol = std::min( nCols - 1.0, std::ceil( ( crossings[i + 1] - xMin ) / cellSizeX - 0.5 ) - 1 );
+    for ( int col = static_cast< int >( firstCol ); col <= lastCol; ++col )
+    {
+      if ( gridRow[col] >= 0 && gridRow[col] != zoneIndex )
+      {
+        overlappingZones.insert( gridRow[col] );
+        overlappingZones.insert( zoneIndex );
+      }
+      gridRow[col] = zoneIndex;
+    }
+  }
+}
+
+///@endcond
+
+void QgsZonalStatistics::calculateRasterizedStatistics( QgsFeatureIterator &features, long featureCount, std::vector<QgsFeatureId> &ids,
+    std::vector<FeatureStats> &stats, const FeatureStats &emptyStats, QgsFeatureIds &overlappingZoneIds, QgsFeedback *feedback )
+{
+  const QgsRectangle rasterBBox = mRasterInterface->extent();
+  const int nCols = mRasterInterface->xSize() > 0 ? mRasterInterface->xSize() : static_cast< int >( std::round( rasterBBox.width() / mCellSizeX ) );
+  const int nRows = mRasterInterface->ySize() > 0 ? mRasterInterface->ySize() : static_cast< int >( std::round( rasterBBox.height() / mCellSizeY ) );
+  if ( nCols <= 0 || nRows <= 0 )
+    return;
+
+  // collect the zones intersecting the raster (first 10% of progress)
+  std::vector< QgsZonalStatisticsZone > zones;
+  QgsFeature f;
+  long featureCounter = 0;
+  while ( features.nextFeature( f ) )
+  {
+    if ( feedback && feedback->isCanceled() )
+    {
+      return;
+    }
+
+    if ( feedback && featureCount > 0 )
+    {
+      feedback->setProgress( 10.0 * static_cast< double >( featureCounter ) / featureCount );
+    }
+    ++featureCounter;
+
+    if ( !f.hasGeometry() )
+      continue;
+
+    QgsGeometry geometry = f.geometry();
+    const QgsRectangle featureRect = geometry.boundingBox().intersect( rasterBBox );
+    if ( featureRect.isEmpty() )
+      continue;
+
+    if ( QgsWkbTypes::isCurvedType( geometry.wkbType() ) )
+      geometry.convertToStraightSegment();
+
+    QgsZonalStatisticsZone zone;
+    const QgsMultiPolygonXY parts = geometry.isMultipart() ? geometry.asMultiPolygon() : QgsMultiPolygonXY() << geometry.asPolygon();
+    for ( const QgsPolygonXY &part : parts )
+      zone.rings.append( part );
+    zone.firstRow = std::max( 0, static_cast< int >( std::floor( ( rasterBBox.yMaximum() - featureRect.yMaximum() ) / mCellSizeY ) ) );
+    zone.lastRow = std::min( nRows - 1, static_cast< int >( std::floor( ( rasterBBox.yMaximum() - featureRect.yMinimum() ) / mCellSizeY ) ) );
+
+    ids.emplace_back( f.id() );
+    zones.emplace_back( std::move( zone ) );
+  }
+  stats.assign( zones.size(), emptyStats );
+
+  // the raster is processed in strips of about a million cells. Each strip gets its own zone grid, holding the
+  // index of the zone for every cell, filled with the zones intersecting the strip in feature order
+  const int stripRows = std::max( 1, std::min( nRows, ( 1 << 20 ) / nCols ) );
+  const int stripCount = ( nRows + stripRows - 1 ) / stripRows;
+  std::vector< std::vector< int > > stripZones( static_cast< std::size_t >( stripCount ) );
+  for ( std::size_t i = 0; i < zones.size(); ++i )
+  {
+    for ( int strip = zones[i].firstRow / stripRows; strip <= zones[i].lastRow / stripRows; ++strip )
+      stripZones[ static_cast< std::size_t >( strip ) ].push_back( static_cast< int >( i ) );
+  }
+
+  struct Strip
+  {
+    int index = 0;
+    std::unique_ptr< QgsRasterBlock > block;
+    QHash< int, FeatureStats > stats;
+    QSet< int > overlappingZones;
+  };
+
+  // blocks are read from this thread, as the raster interface cannot be shared between threads,
+  // and the strips of a batch are then rasterized and accumulated in parallel
+  const int stripsPerBatch = std::max( 1, QThread::idealThreadCount() );
+  std::vector< Strip > batch;
+  for ( int batchStart = 0; batchStart < stripCount; batchStart += stripsPerBatch )
+  {
+    if ( feedback && feedback->isCanceled() )
+    {
+      return;
+    }
+
+    if ( feedback )
+    {
+      feedback->setProgress( 10.0 + 90.0 * static_cast< double >( batchStart ) / stripCount );
+    }
+
+    batch.clear();
+    for ( int index = batchStart; index < std::min( stripCount, batchStart + stripsPerBatch ); ++index )
+    {
+      const int firstRow = index * stripRows;
+      const int rows = std::min( stripRows, nRows - firstRow );
+      const QgsRectangle stripExtent( rasterBBox.xMinimum(), rasterBBox.yMaximum() - ( firstRow + rows ) * mCellSizeY,
+                                      rasterBBox.xMinimum() + nCols * mCellSizeX, rasterBBox.yMaximum() - firstRow * mCellSizeY );
+      Strip strip;
+      strip.index = index;
+      strip.block.reset( mRasterInterface->block( mRasterBand, stripExtent, nCols, rows ) );
+      batch.emplace_back( std::move( strip ) );
+    }
+
+    QtConcurrent::blockingMap( batch, [&]( Strip & strip )
+    {
+      if ( !strip.block || strip.block->isEmpty() )
+        return;
+
+      const int firstRow = strip.index * stripRows;
+      const int rows = strip.block->height();
+      std::vector< int > grid( static_cast< std::size_t >( nCols ) * rows, -1 );
+      std::vector< double > crossings;
+      for ( int zoneIndex : stripZones[ static_cast< std::size_t >( strip.index ) ] )
+      {
+        const QgsZonalStatisticsZone &zone = zones[ static_cast< std::size_t >( zoneIndex ) ];
+        const int lastRow = std::min( firstRow + rows - 1, zone.lastRow );
+        for ( int row = std::max( firstRow, zone.firstRow ); row <= lastRow; ++row )
+        {
+          rasterizeZoneRow( zone, zoneIndex, rasterBBox.yMaximum() - ( row + 0.5 ) * mCellSizeY, rasterBBox.xMinimum(), mCellSizeX, nCols,
+                            grid.data() + static_cast< std::size_t >( row - firstRow ) * nCols, crossings, strip.overlappingZones );
+        }
+      }
+
+      bool isNoData = false;
+      const int *cellZone = grid.data();
+      for ( int row = 0; row < rows; ++row )
+      {
+        for ( int col = 0; col < nCols; ++col, ++cellZone )
+        {
+          if ( *cellZone < 0 )
+            continue;
+
+          const double pixelValue = strip.block->valueAndNoData( row, col, isNoData );
+          if ( isNoData || !QgsRasterAnalysisUtils::validPixel( pixelValue ) )
+            continue;
+
+          auto it = strip.stats.find( *cellZone );
+          if ( it == strip.stats.end() )
+            it = strip.stats.insert( *cellZone, emptyStats );
+          it->addValue( pixelValue );
+        }
+      }
+    } );
+
+    // merge in strip order, so that values are collected row by row like for the PerFeature method
+    for ( const Strip &strip : batch )
+    {
+      for ( auto it = strip.stats.constBegin(); it != strip.stats.constEnd(); ++it )
+        stats[ static_cast< std::size_t >( it.key() ) ].merge( it.value() );
+      for ( int zoneIndex : strip.overlappingZones )
+        overlappingZoneIds.insert( ids[ static_cast< std::size_t >( zoneIndex ) ] );
+    }
+  }
+}
+
 QString QgsZonalStatistics::getUniqueFieldName( const QString &fieldName, const QList<QgsField> &newFields )
 {
   QgsVectorDataProvider *dp = mPolygonLayer->dataProvider();
@@ -23,10 +23,12 @@
 
 #include <limits>
 #include <cfloat>
+#include <vector>
 
 #include "qgis_analysis.h"
 #include "qgsfeedback.h"
 #include "qgscoordinatereferencesystem.h"
+#include "qgsfeatureid.h"
 
 class QgsGeometry;
 class QgsVectorLayer;
@@ -35,6 +37,7 @@ class QgsRasterInterface;
 class QgsRasterDataProvider;
 class QgsRectangle;
 class QgsField;
+class QgsFeatureIterator;
 
 /**
  * \ingroup analysis
@@ -63,6 +66,16 @@ class ANALYSIS_EXPORT QgsZonalStatistics
     };
     Q_DECLARE_FLAGS( Statistics, Statistic )
 
+    /**
+     * Methods for assigning raster cells to zones.
+     * \since QGIS 3.12
+     */
+    enum Method
+    {
+      PerFeature, //!< Each zone is handled separately, reading the raster cells within its bounding box (default)
+      Rasterized, //!< Zones are rasterized into a grid aligned with the raster, and the statistics for all zones are calculated in a single parallel pass over the raster
+    };
+
     /**
      * Convenience constructor for QgsZonalStatistics, using an input raster layer.
      *
@@ -112,6 +125,25 @@ class ANALYSIS_EXPORT QgsZonalStatistics
                         int rasterBand = 1,
                         QgsZonalStatistics::Statistics stats = QgsZonalStatistics::Statistics( QgsZonalStatistics::Count | QgsZonalStatistics::Sum | QgsZonalStatistics::Mean ) );
 
+    /**
+     * Returns the method used for assigning raster cells to zones.
+     * \see setMethod()
+     * \since QGIS 3.12
+     */
+    Method method() const { return mMethod; }
+
+    /**
+     * Sets the \a method used for assigning raster cells to zones.
+     *
+     * The Rasterized method reads every raster cell only once, whatever the number of zones,
+     * and is much faster for layers with many zones. Zones sharing raster cells with other zones
+     * are calculated one by one, like for the PerFeature method, and give the same results.
+     *
+     * \see method()
+     * \since QGIS 3.12
+     */
+    void setMethod( Method method ) { mMethod = method; }
+
     /**
      * Starts the calculation
      * \returns 0 in case of success
@@ -159,6 +191,22 @@ class ANALYSIS_EXPORT QgsZonalStatistics
           if ( mStoreValues )
             values.append( value );
         }
+
+        //! Adds the values collected by \a other
+        void merge( const FeatureStats &other )
+        {
+          sum += other.sum;
+          count += other.count;
+          min = std::min( min, other.min );
+          max = std::max( max, other.max );
+          if ( mStoreValueCounts )
+          {
+            for ( auto it = other.valueCount.constBegin(); it != other.valueCount.constEnd(); ++it )
+              valueCount.insert( it.key(), valueCount.value( it.key(), 0 ) + it.value() );
+          }
+          if ( mStoreValues )
+            values.append( other.values );
+        }
         double sum = 0.0;
         double count = 0.0;
         double max = std::numeric_limits<double>::lowest();
@@ -173,6 +221,15 @@ class ANALYSIS_EXPORT QgsZonalStatistics
 
     QString getUniqueFieldName( const QString &fieldName, const QList<QgsField> &newFields );
 
+    /**
+     * Calculates the statistics for all zones returned by \a features at once, using the Rasterized method.
+     * The statistics for the zone with id \a ids[i] are stored in \a stats[i]. The ids of zones sharing
+     * cells with other zones, whose statistics are not reliable, are added to \a overlappingZoneIds.
+     */
+    void calculateRasterizedStatistics( QgsFeatureIterator &features, long featureCount, std::vector< QgsFeatureId > &ids,
+                                        std::vector< FeatureStats > &stats, const FeatureStats &emptyStats,
+                                        QgsFeatureIds &overlappingZoneIds, QgsFeedback *feedback );
+
     QgsRasterInterface *mRasterInterface = nullptr;
     QgsCoordinateReferenceSystem mRasterCrs;
 
@@ -184,6 +241,7 @@ class ANALYSIS_EXPORT QgsZonalStatistics
     QgsVectorLayer *mPolygonLayer = nullptr;
     QString mAttributePrefix;
     Statistics mStatistics = QgsZonalStatistics::All;
+    Method mMethod = PerFeature;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS( QgsZonalStatistics::Statistics )
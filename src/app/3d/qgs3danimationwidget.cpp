@@ -18,6 +18,7 @@
 #include "qgs3danimationsettings.h"
 #include "qgsapplication.h"
 #include "qgscameracontroller.h"
+#include "qgscamerapose.h"
 #include "qgs3danimationexportdialog.h"
 #include "qgs3dmapsettings.h"
 #include "qgsoffscreen3dengine.h"
@@ -185,9 +186,29 @@ void Qgs3DAnimationWidget::onAnimationTimer()
   else
   {
     sliderTime->setValue( sliderTime->value() + 1 );
+
+    // the slider moves by 1/100 s each tick - request data for the upcoming part of the animation ten times a second
+    if ( sliderTime->value() % 10 == 0 )
+      prefetchAhead();
   }
 }
 
+void Qgs3DAnimationWidget::prefetchAhead()
+{
+  if ( !mScene )
+    return;
+
+  // camera pose which is going to be reached in one second
+  const float time = std::min( sliderTime->value() + 100, sliderTime->maximum() ) / 100.;
+  Qgs3DAnimationSettings::Keyframe kf = mAnimationSettings->interpolate( time );
+  QgsCameraPose pose;
+  pose.setCenterPoint( kf.point );
+  pose.setDistanceFromCenterPoint( kf.dist );
+  pose.setPitchAngle( kf.pitch );
+  pose.setHeadingAngle( kf.yaw );
+  mScene->prefetch( pose );
+}
+
 void Qgs3DAnimationWidget::onExportAnimation()
 {
   if ( !mMap || !mAnimationSettings )
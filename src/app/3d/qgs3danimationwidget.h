@@ -24,6 +24,7 @@
 
 class Qgs3DAnimationSettings;
 class QgsCameraController;
+class Qgs3DMapScene;
 class Qgs3DMapSettings;
 
 class Qgs3DAnimationWidget : public QWidget, private Ui::Animation3DWidget
@@ -35,6 +36,9 @@ class Qgs3DAnimationWidget : public QWidget, private Ui::Animation3DWidget
 
     void setCameraController( QgsCameraController *cameraController );
 
+    //! Sets the scene which is asked to preload data for the upcoming part of the animation during playback
+    void setScene( Qgs3DMapScene *scene ) { mScene = scene; }
+
     void setMap( Qgs3DMapSettings *map );
 
     void setAnimation( const Qgs3DAnimationSettings &animation );
@@ -62,10 +66,12 @@ class Qgs3DAnimationWidget : public QWidget, private Ui::Animation3DWidget
     void setEditControlsEnabled( bool enabled );
     float askForKeyframeTime( float defaultTime, bool *ok );
     int findIndexForKeyframe( float time );
+    void prefetchAhead();
 
   private:
     std::unique_ptr<Qgs3DAnimationSettings> mAnimationSettings;
     QgsCameraController *mCameraController;
+    Qgs3DMapScene *mScene = nullptr;
     Qgs3DMapSettings *mMap;
     QTimer *mAnimationTimer = nullptr;
 };
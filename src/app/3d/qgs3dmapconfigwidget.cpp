@@ -51,6 +51,11 @@ Qgs3DMapConfigWidget::Qgs3DMapConfigWidget( Qgs3DMapSettings *map, QgsMapCanvas
   cboTerrainType->addItem( tr( "DEM (Raster layer)" ), QgsTerrainGenerator::Dem );
   cboTerrainType->addItem( tr( "Online" ), QgsTerrainGenerator::Online );
 
+  cboTerrainCache->addItem( tr( "Disabled" ), QgsDemTerrainGenerator::NoCache );
+  cboTerrainCache->addItem( tr( "Store Loaded Tiles" ), QgsDemTerrainGenerator::OnDemandCache );
+  cboTerrainCache->addItem( tr( "Pre-generate All Tiles" ), QgsDemTerrainGenerator::PregeneratedCache );
+  cboTerrainCache->setToolTip( tr( "Height maps read from the elevation layer can be cached on disk, so that the terrain loads quickly next time" ) );
+
   QgsTerrainGenerator *terrainGen = mMap->terrainGenerator();
   if ( terrainGen && terrainGen->type() == QgsTerrainGenerator::Dem )
   {
@@ -59,6 +64,7 @@ Qgs3DMapConfigWidget::Qgs3DMapConfigWidget( Qgs3DMapSettings *map, QgsMapCanvas
     spinTerrainResolution->setValue( demTerrainGen->resolution() );
     spinTerrainSkirtHeight->setValue( demTerrainGen->skirtHeight() );
     cboTerrainLayer->setLayer( demTerrainGen->layer() );
+    cboTerrainCache->setCurrentIndex( cboTerrainCache->findData( demTerrainGen->heightMapCacheMode() ) );
   }
   else if ( terrainGen && terrainGen->type() == QgsTerrainGenerator::Online )
   {
@@ -66,6 +72,7 @@ Qgs3DMapConfigWidget::Qgs3DMapConfigWidget( Qgs3DMapSettings *map, QgsMapCanvas
     QgsOnlineTerrainGenerator *onlineTerrainGen = static_cast<QgsOnlineTerrainGenerator *>( terrainGen );
     spinTerrainResolution->setValue( onlineTerrainGen->resolution() );
     spinTerrainSkirtHeight->setValue( onlineTerrainGen->skirtHeight() );
+    cboTerrainCache->setCurrentIndex( cboTerrainCache->findData( QgsDemTerrainGenerator::NoCache ) );
   }
   else
   {
@@ -73,6 +80,7 @@ Qgs3DMapConfigWidget::Qgs3DMapConfigWidget( Qgs3DMapSettings *map, QgsMapCanvas
     cboTerrainLayer->setLayer( nullptr );
     spinTerrainResolution->setValue( 16 );
     spinTerrainSkirtHeight->setValue( 10 );
+    cboTerrainCache->setCurrentIndex( cboTerrainCache->findData( QgsDemTerrainGenerator::NoCache ) );
   }
 
   spinCameraFieldOfView->setValue( mMap->fieldOfView() );
@@ -128,16 +136,23 @@ void Qgs3DMapConfigWidget::apply()
         tGenNeedsUpdate = false;
     }
 
+    const QgsDemTerrainGenerator::HeightMapCacheMode cacheMode = static_cast<QgsDemTerrainGenerator::HeightMapCacheMode>( cboTerrainCache->currentData().toInt() );
     if ( tGenNeedsUpdate )
     {
       QgsDemTerrainGenerator *demTerrainGen = new QgsDemTerrainGenerator;
       demTerrainGen->setCrs( mMap->crs(), QgsProject::instance()->transformContext() );
+      demTerrainGen->setHeightMapCacheMode( cacheMode );
       demTerrainGen->setLayer( demLayer );
       demTerrainGen->setResolution( spinTerrainResolution->value() );
       demTerrainGen->setSkirtHeight( spinTerrainSkirtHeight->value() );
       mMap->setTerrainGenerator( demTerrainGen );
       needsUpdateOrigin = true;
     }
+    else
+    {
+      // changing the cache mode does not change the terrain itself
+      static_cast<QgsDemTerrainGenerator *>( mMap->terrainGenerator() )->setHeightMapCacheMode( cacheMode );
+    }
   }
   else if ( terrainType == QgsTerrainGenerator::Online )
   {
@@ -209,6 +224,8 @@ void Qgs3DMapConfigWidget::onTerrainTypeChanged()
   spinTerrainSkirtHeight->setVisible( !isFlat );
   labelTerrainLayer->setVisible( isDem );
   cboTerrainLayer->setVisible( isDem );
+  labelTerrainCache->setVisible( isDem );
+  cboTerrainCache->setVisible( isDem );
 
   updateMaxZoomLevel();
 }
@@ -18,6 +18,7 @@ email                : morb at ozemail dot com dot au
 #include <cstdio>
 #include <cmath>
 #include <nlohmann/json.hpp>
+#include <QtConcurrentMap>
 
 #include "qgis.h"
 #include "qgsgeometry.h"
@@ -33,6 +34,7 @@ email                : morb at ozemail dot com dot au
 #include "qgsmessagelog.h"
 #include "qgspointxy.h"
 #include "qgsrectangle.h"
+#include "qgswkbptr.h"
 
 #include "qgsvectorlayer.h"
 #include "qgsgeometryvalidator.h"
@@ -339,6 +341,37 @@ void QgsGeometry::fromWkb( const QByteArray &wkb )
   reset( QgsGeometryFactory::geomFromWkb( ptr ) );
 }
 
+void QgsGeometry::fromWkbRecycled( const QByteArray &wkb )
+{
+  QgsConstWkbPtr ptr( wkb );
+  if ( !fromWkbInPlace( ptr ) )
+    reset( QgsGeometryFactory::geomFromWkb( ptr ) );
+}
+
+bool QgsGeometry::fromWkbInPlace( const QgsConstWkbPtr &wkb )
+{
+  // we can only recycle the geometry if nobody else is referencing it
+  if ( !d->geometry || d->ref > 1 || !wkb )
+    return false;
+
+  try
+  {
+    QgsConstWkbPtr headerPtr( wkb );
+    const QgsWkbTypes::Type type = headerPtr.readHeader();
+    if ( QgsWkbTypes::flatType( type ) != QgsWkbTypes::flatType( d->geometry->wkbType() ) )
+      return false;
+
+    QgsConstWkbPtr ptr( wkb );
+    return d->geometry->fromWkb( ptr );
+  }
+  catch ( const QgsWkbException &e )
+  {
+    Q_UNUSED( e )
+    QgsDebugMsg( "WKB exception: " + e.what() );
+    return false;
+  }
+}
+
 QgsWkbTypes::Type QgsGeometry::wkbType() const
 {
   if ( !d->geometry )
@@ -2631,6 +2664,99 @@ QgsGeometry QgsGeometry::unaryUnion( const QVector<QgsGeometry> &geometries )
   return result;
 }
 
+///@cond PRIVATE
+//! Returns position of a point along the Morton (z-order) curve, with coordinates normalized to 0..1
+static quint32 mortonCode( double x, double y )
+{
+  auto spreadBits = []( quint32 v ) -> quint32
+  {
+    v = ( v | ( v << 8 ) ) & 0x00FF00FF;
+    v = ( v | ( v << 4 ) ) & 0x0F0F0F0F;
+    v = ( v | ( v << 2 ) ) & 0x33333333;
+    v = ( v | ( v << 1 ) ) & 0x55555555;
+    return v;
+  };
+  const quint32 ix = static_cast< quint32 >( qBound( 0.0, x, 1.0 ) * 65535 );
+  const quint32 iy = static_cast< quint32 >( qBound( 0.0, y, 1.0 ) * 65535 );
+  return spreadBits( ix ) | ( spreadBits( iy ) << 1 );
+}
+///@endcond
+
+QgsGeometry QgsGeometry::parallelUnaryUnion( const QVector<QgsGeometry> &geometries, int partitionSize )
+{
+  partitionSize = std::max( partitionSize, 2 );
+  if ( geometries.size() <= partitionSize )
+    return unaryUnion( geometries );
+
+  QgsRectangle extent;
+  extent.setMinimal();
+  QVector< QPair< quint32, int > > order;
+  order.reserve( geometries.size() );
+  QVector< QgsPointXY > centers;
+  centers.reserve( geometries.size() );
+  for ( int i = 0; i < geometries.size(); ++i )
+  {
+    if ( geometries.at( i ).isNull() )
+      continue;
+
+    // calculating the bounding box here also means the geometries will not modify their cached
+    // bounding box later, when they are accessed from worker threads
+    const QgsRectangle bbox = geometries.at( i ).boundingBox();
+    extent.combineExtentWith( bbox );
+    centers << bbox.center();
+    order << qMakePair( quint32( 0 ), i );
+  }
+  if ( order.isEmpty() )
+    return unaryUnion( QVector< QgsGeometry >() );
+
+  const double width = extent.width() > 0 ? extent.width() : 1;
+  const double height = extent.height() > 0 ? extent.height() : 1;
+  for ( int i = 0; i < order.size(); ++i )
+  {
+    order[i].first = mortonCode( ( centers.at( i ).x() - extent.xMinimum() ) / width,
+                                 ( centers.at( i ).y() - extent.yMinimum() ) / height );
+  }
+  centers.clear();
+  std::stable_sort( order.begin(), order.end(), []( const QPair< quint32, int > &a, const QPair< quint32, int > &b ) { return a.first < b.first; } );
+
+  // every partition is a run of spatially close geometries
+  QVector< QVector< QgsGeometry > > partitions;
+  partitions.reserve( order.size() / partitionSize + 1 );
+  for ( int i = 0; i < order.size(); i += partitionSize )
+  {
+    QVector< QgsGeometry > partition;
+    partition.reserve( std::min( partitionSize, order.size() - i ) );
+    for ( int j = i; j < std::min( i + partitionSize, order.size() ); ++j )
+      partition << geometries.at( order.at( j ).second );
+    partitions << partition;
+  }
+  order.clear();
+
+  // unite the partitions, then merge the results of neighboring partitions until a single geometry is left
+  while ( true )
+  {
+    const QVector< QgsGeometry > results = QtConcurrent::blockingMapped< QVector< QgsGeometry > >( partitions, &QgsGeometry::unaryUnion );
+    for ( const QgsGeometry &result : results )
+    {
+      if ( !result.mLastError.isEmpty() )
+        return result;
+    }
+
+    if ( results.size() == 1 )
+      return results.at( 0 );
+
+    partitions.clear();
+    for ( int i = 0; i < results.size(); i += 2 )
+    {
+      QVector< QgsGeometry > partition;
+      partition << results.at( i );
+      if ( i + 1 < results.size() )
+        partition << results.at( i + 1 );
+      partitions << partition;
+    }
+  }
+}
+
 QgsGeometry QgsGeometry::polygonize( const QVector<QgsGeometry> &geometryList )
 {
   QgsGeos geos( nullptr );
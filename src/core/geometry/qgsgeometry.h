@@ -301,10 +301,26 @@ class CORE_EXPORT QgsGeometry
 
     /**
      * Set the geometry, feeding in the buffer containing OGC Well-Known Binary
+     *
      * \since QGIS 3.0
      */
     void fromWkb( const QByteArray &wkb );
 
+    /**
+     * Set the geometry, feeding in the buffer containing OGC Well-Known Binary, recycling
+     * the existing geometry storage where possible.
+     *
+     * If the geometry is not shared with any other QgsGeometry object and the WKB contains a geometry
+     * of the same type, the existing geometry is decoded in place and its coordinate storage gets recycled.
+     * Otherwise this behaves like fromWkb().
+     *
+     * This is used by feature iterators handling requests with the QgsFeatureRequest::RecycleGeometry flag.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.12
+     */
+    void fromWkbRecycled( const QByteArray &wkb ) SIP_SKIP;
+
     /**
      * Returns type of the geometry as a WKB type (point / linestring / polygon etc.)
      * \see type
@@ -2024,6 +2040,27 @@ class CORE_EXPORT QgsGeometry
      */
     static QgsGeometry unaryUnion( const QVector<QgsGeometry> &geometries );
 
+    /**
+     * Compute the unary union on a list of \a geometries using multiple threads.
+     *
+     * The input geometries are sorted spatially (by the position of their bounding box centers
+     * along a space filling curve) and split into partitions of at most \a partitionSize geometries.
+     * Partitions are united in parallel, the partial results are then merged hierarchically, always
+     * combining results of neighboring partitions.
+     *
+     * The result is equivalent to unaryUnion(), but it scales with the number of available cores
+     * and GEOS never has to node all input geometries at once. If the input contains no more than
+     * \a partitionSize geometries, this is identical to calling unaryUnion(). Null geometries
+     * in the input are ignored.
+     *
+     * If uniting any of the partitions (or partial results) fails, the remaining work is abandoned
+     * and a null geometry is returned, with lastError() set to the error reported by GEOS.
+     *
+     * \see unaryUnion()
+     * \since QGIS 3.12
+     */
+    static QgsGeometry parallelUnaryUnion( const QVector<QgsGeometry> &geometries, int partitionSize = 1000 );
+
     /**
      * Creates a GeometryCollection geometry containing possible polygons formed from the constituent
      * linework of a set of \a geometries. The input geometries must be fully noded (i.e. nodes exist
@@ -2380,6 +2417,12 @@ class CORE_EXPORT QgsGeometry
      */
     void reset( std::unique_ptr< QgsAbstractGeometry > newGeometry );
 
+    /**
+     * Decodes \a wkb into the existing geometry, recycling its storage. Returns FALSE
+     * if that is not possible, i.e. the geometry is shared or it has a different type.
+     */
+    bool fromWkbInPlace( const QgsConstWkbPtr &wkb );
+
     static void convertToPolyline( const QgsPointSequence &input, QgsPolylineXY &output );
     static void convertPolygon( const QgsPolygon &input, QgsPolygonXY &output );
 
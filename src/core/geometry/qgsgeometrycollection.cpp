@@ -27,6 +27,7 @@ email                : marco.hugentobler at sourcepole dot com
 #include "qgsmultipolygon.h"
 #include "qgswkbptr.h"
 #include "qgsgeos.h"
+#include "qgslogger.h"
 
 #include <nlohmann/json.hpp>
 #include <memory>
@@ -323,15 +324,53 @@ bool QgsGeometryCollection::fromWkb( QgsConstWkbPtr &wkbPtr )
   QVector<QgsAbstractGeometry *> geometryListBackup = mGeometries;
   mGeometries.clear();
   mGeometries.reserve( nGeometries );
+  bool recycled = false;
   for ( int i = 0; i < nGeometries; ++i )
   {
-    std::unique_ptr< QgsAbstractGeometry > geom( QgsGeometryFactory::geomFromWkb( wkbPtr ) );  // also updates wkbPtr
+    std::unique_ptr< QgsAbstractGeometry > geom;
+
+    // if there is an existing part of the same type, decode the new part into it to recycle its storage
+    QgsAbstractGeometry *existingPart = i < geometryListBackup.size() ? geometryListBackup.at( i ) : nullptr;
+    if ( existingPart )
+    {
+      try
+      {
+        QgsConstWkbPtr partPtr( wkbPtr );
+        if ( QgsWkbTypes::flatType( QgsConstWkbPtr( wkbPtr ).readHeader() ) == QgsWkbTypes::flatType( existingPart->wkbType() )
+             && existingPart->fromWkb( partPtr ) )  // also updates partPtr
+        {
+          geometryListBackup[i] = nullptr;
+          geom.reset( existingPart );
+          wkbPtr = partPtr;
+          recycled = true;
+        }
+      }
+      catch ( const QgsWkbException &e )
+      {
+        Q_UNUSED( e )
+        QgsDebugMsg( "WKB exception: " + e.what() );
+      }
+    }
+
+    if ( !geom )
+      geom = QgsGeometryFactory::geomFromWkb( wkbPtr );  // also updates wkbPtr
+
     if ( geom )
     {
       if ( !addGeometry( geom.release() ) )
       {
         qDeleteAll( mGeometries );
-        mGeometries = geometryListBackup;
+        if ( recycled )
+        {
+          // some of the original parts have been overwritten already, there is nothing to restore
+          qDeleteAll( geometryListBackup );
+          mGeometries.clear();
+          clearCache();
+        }
+        else
+        {
+          mGeometries = geometryListBackup;
+        }
         return false;
       }
     }
@@ -52,17 +52,28 @@ void QgsPolygon::clear()
 
 bool QgsPolygon::fromWkb( QgsConstWkbPtr &wkbPtr )
 {
-  clear();
   if ( !wkbPtr )
   {
+    clear();
     return false;
   }
 
   QgsWkbTypes::Type type = wkbPtr.readHeader();
   if ( QgsWkbTypes::flatType( type ) != QgsWkbTypes::Polygon )
   {
+    clear();
     return false;
   }
+
+  // keep the existing rings around - their coordinate storage gets recycled for the new rings
+  QVector< QgsCurve * > recycledRings;
+  recycledRings.reserve( 1 + mInteriorRings.size() );
+  if ( mExteriorRing )
+    recycledRings << mExteriorRing.release();
+  recycledRings << mInteriorRings;
+  mInteriorRings.clear();
+
+  clear();
   mWkbType = type;
 
   QgsWkbTypes::Type ringType;
@@ -89,7 +100,16 @@ bool QgsPolygon::fromWkb( QgsConstWkbPtr &wkbPtr )
   wkbPtr >> nRings;
   for ( int i = 0; i < nRings; ++i )
   {
-    std::unique_ptr< QgsLineString > line( new QgsLineString() );
+    std::unique_ptr< QgsLineString > line;
+    if ( i < recycledRings.size() && qgsgeometry_cast< QgsLineString * >( recycledRings.at( i ) ) )
+    {
+      line.reset( static_cast< QgsLineString * >( recycledRings.at( i ) ) );
+      recycledRings[i] = nullptr;
+    }
+    else
+    {
+      line.reset( new QgsLineString() );
+    }
     line->fromWkbPoints( ringType, wkbPtr );
     /*if ( !line->isRing() )
     {
@@ -105,6 +125,7 @@ bool QgsPolygon::fromWkb( QgsConstWkbPtr &wkbPtr )
       mInteriorRings.append( line.release() );
     }
   }
+  qDeleteAll( recycledRings );
 
   return true;
 }
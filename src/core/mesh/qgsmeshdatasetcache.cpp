@@ -0,0 +1,229 @@
+/***************************************************************************
+                         qgsmeshdatasetcache.cpp
+                         -----------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by the QGIS project
+    email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsmeshdatasetcache.h"
+
+#include <cstring>
+
+uint qHash( const QgsMeshDatasetCache::BlockKey &key, uint seed )
+{
+  return qHash( key.group, seed ) ^ qHash( key.dataset, seed + 1 ) ^ qHash( key.block, seed + 2 ) ^ ( key.activeFlags ? 0x9e3779b9 : 0 );
+}
+
+//! Returns size of a single value of the data block in bytes
+static size_t valueSize( QgsMeshDataBlock::DataType type )
+{
+  switch ( type )
+  {
+    case QgsMeshDataBlock::ActiveFlagInteger:
+      return sizeof( int );
+    case QgsMeshDataBlock::ScalarDouble:
+      return sizeof( double );
+    case QgsMeshDataBlock::Vector2DDouble:
+      return 2 * sizeof( double );
+  }
+  return 0; // no warnings
+}
+
+QgsMeshDatasetCache::QgsMeshDatasetCache( QgsMeshDataProvider *provider, int blockSize, qint64 maximumMemory )
+  : mProvider( provider )
+  , mBlockSize( std::max( 1, blockSize ) )
+  , mMaximumMemory( maximumMemory )
+{
+}
+
+void QgsMeshDatasetCache::setMaximumMemory( qint64 maximumMemory )
+{
+  mMaximumMemory = maximumMemory;
+  evict();
+}
+
+QgsMeshDataBlock QgsMeshDatasetCache::datasetValues( const QgsMeshDatasetIndex &index, int valueIndex, int count )
+{
+  return readRange( index, false, valueIndex, count );
+}
+
+QgsMeshDataBlock QgsMeshDatasetCache::areFacesActive( const QgsMeshDatasetIndex &index, int faceIndex, int count )
+{
+  return readRange( index, true, faceIndex, count );
+}
+
+bool QgsMeshDatasetCache::hasDatasetValues( const QgsMeshDatasetIndex &index, int valueIndex, int count ) const
+{
+  if ( count <= 0 )
+    return true;
+
+  const int firstBlock = valueIndex / mBlockSize;
+  const int lastBlock = ( valueIndex + count - 1 ) / mBlockSize;
+  for ( int b = firstBlock; b <= lastBlock; ++b )
+  {
+    if ( !mBlocks.contains( BlockKey{ index.group(), index.dataset(), b, false } ) )
+      return false;
+  }
+  return true;
+}
+
+void QgsMeshDatasetCache::prefetch( const QgsMeshDatasetIndex &index )
+{
+  if ( !mProvider || !index.isValid() || index.dataset() >= mProvider->datasetCount( index.group() ) )
+    return;
+
+  if ( mPrefetchQueue.contains( index ) )
+    return;
+
+  if ( hasDatasetValues( index, 0, valueCount( index, false ) ) )
+    return;
+
+  mPrefetchQueue.append( index );
+}
+
+bool QgsMeshDatasetCache::prefetchNextBlock()
+{
+  while ( !mPrefetchQueue.isEmpty() )
+  {
+    const QgsMeshDatasetIndex index = mPrefetchQueue.first();
+    for ( const bool activeFlags : { false, true } )
+    {
+      const int totalCount = valueCount( index, activeFlags );
+      const int blockCount = ( totalCount + mBlockSize - 1 ) / mBlockSize;
+      for ( int b = 0; b < blockCount; ++b )
+      {
+        const BlockKey key{ index.group(), index.dataset(), b, activeFlags };
+        if ( mBlocks.contains( key ) )
+          continue;
+
+        block( key, totalCount );
+        evict();
+        return true;
+      }
+    }
+
+    // all blocks of the dataset are cached
+    mPrefetchQueue.removeFirst();
+  }
+  return false;
+}
+
+void QgsMeshDatasetCache::cancelPrefetch()
+{
+  mPrefetchQueue.clear();
+}
+
+void QgsMeshDatasetCache::clear()
+{
+  mBlocks.clear();
+  mLru.clear();
+  mMemoryUsage = 0;
+  mPrefetchQueue.clear();
+}
+
+int QgsMeshDatasetCache::valueCount( const QgsMeshDatasetIndex &index, bool activeFlags ) const
+{
+  if ( activeFlags )
+    return mProvider->faceCount();
+
+  const QgsMeshDatasetGroupMetadata metadata = mProvider->datasetGroupMetadata( index );
+  return metadata.dataType() == QgsMeshDatasetGroupMetadata::DataOnVertices ? mProvider->vertexCount() : mProvider->faceCount();
+}
+
+QgsMeshDataBlock QgsMeshDatasetCache::block( const BlockKey &key, int totalCount )
+{
+  auto it = mBlocks.find( key );
+  if ( it != mBlocks.end() )
+  {
+    // move to the front of the least recently used list
+    mLru.splice( mLru.begin(), mLru, it->lruPosition );
+    return it->data;
+  }
+
+  const int first = key.block * mBlockSize;
+  const int count = std::min( mBlockSize, totalCount - first );
+  const QgsMeshDatasetIndex index( key.group, key.dataset );
+  QgsMeshDataBlock data = key.activeFlags ? mProvider->areFacesActive( index, first, count )
+                          : mProvider->datasetValues( index, first, count );
+
+  // do not keep blocks which could not be read
+  if ( data.count() != count )
+    return QgsMeshDataBlock();
+
+  mLru.push_front( key );
+  const qint64 size = static_cast<qint64>( count ) * static_cast<qint64>( valueSize( data.type() ) );
+  mBlocks.insert( key, BlockEntry{ data, size, mLru.begin() } );
+  mMemoryUsage += size;
+  return data;
+}
+
+QgsMeshDataBlock QgsMeshDatasetCache::readRange( const QgsMeshDatasetIndex &index, bool activeFlags, int first, int count )
+{
+  if ( !mProvider || count <= 0 || first < 0 )
+    return QgsMeshDataBlock();
+
+  const int totalCount = valueCount( index, activeFlags );
+  if ( first + count > totalCount )
+  {
+    // out of range requests are passed to the provider as they are
+    return activeFlags ? mProvider->areFacesActive( index, first, count ) : mProvider->datasetValues( index, first, count );
+  }
+
+  const int firstBlock = first / mBlockSize;
+  const int lastBlock = ( first + count - 1 ) / mBlockSize;
+
+  QgsMeshDataBlock result;
+  for ( int b = firstBlock; b <= lastBlock; ++b )
+  {
+    const QgsMeshDataBlock data = block( BlockKey{ index.group(), index.dataset(), b, activeFlags }, totalCount );
+    if ( !data.isValid() )
+    {
+      result = QgsMeshDataBlock();
+      break;
+    }
+
+    const int blockFirst = b * mBlockSize;
+    const int from = std::max( first, blockFirst );
+    const int to = std::min( first + count, blockFirst + data.count() );
+
+    if ( firstBlock == lastBlock && from == blockFirst && to - from == data.count() )
+    {
+      // the whole range is a single cached block - share its data
+      result = data;
+      break;
+    }
+
+    if ( !result.isValid() )
+      result = QgsMeshDataBlock( data.type(), count );
+
+    const size_t size = valueSize( data.type() );
+    memcpy( static_cast<char *>( result.buffer() ) + static_cast<size_t>( from - first ) * size,
+            static_cast<const char *>( data.constBuffer() ) + static_cast<size_t>( from - blockFirst ) * size,
+            static_cast<size_t>( to - from ) * size );
+  }
+
+  // only evict once the range is assembled, so that its own blocks are not discarded while reading
+  evict();
+  return result;
+}
+
+void QgsMeshDatasetCache::evict()
+{
+  while ( mMemoryUsage > mMaximumMemory && !mLru.empty() )
+  {
+    const BlockKey key = mLru.back();
+    mLru.pop_back();
+    mMemoryUsage -= mBlocks.value( key ).size;
+    mBlocks.remove( key );
+  }
+}
@@ -0,0 +1,168 @@
+/***************************************************************************
+                         qgsmeshdatasetcache.h
+                         ---------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by the QGIS project
+    email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSMESHDATASETCACHE_H
+#define QGSMESHDATASETCACHE_H
+
+#define SIP_NO_FILE
+
+#include <list>
+
+#include <QHash>
+#include <QList>
+
+#include "qgis_core.h"
+#include "qgsmeshdataprovider.h"
+
+/**
+ * \ingroup core
+ *
+ * Cache of dataset values read from a mesh data provider.
+ *
+ * Values of datasets (and active flags of faces) are read from the provider in blocks of fixed
+ * number of values and kept in memory, so that going back and forth between datasets (e.g. when
+ * animating time steps) does not read the same data repeatedly. Only blocks covering the requested
+ * range of values are read, so a region of interest may be fetched without reading whole datasets.
+ *
+ * Total size of cached blocks is bounded by a memory budget. When the budget is exceeded,
+ * least recently used blocks are discarded first.
+ *
+ * Datasets which are likely to be requested next may be queued for prefetching with prefetch()
+ * and then read one block at a time with prefetchNextBlock(), e.g. when the application is idle.
+ *
+ * The cache is not thread safe, like the data providers themselves, and should only be used
+ * from the thread of the mesh layer.
+ *
+ * \note The API is considered EXPERIMENTAL and can be changed without a notice
+ *
+ * \since QGIS 3.12
+ */
+class CORE_EXPORT QgsMeshDatasetCache
+{
+  public:
+    //! Default number of values in a single block
+    static const int DEFAULT_BLOCK_SIZE = 65536;
+
+    //! Default memory budget of the cache in bytes
+    static const qint64 DEFAULT_MAXIMUM_MEMORY = 256 * 1024 * 1024;
+
+    /**
+     * Constructs cache for datasets of the \a provider, with blocks of \a blockSize values,
+     * using at most \a maximumMemory bytes. Ownership of the provider is not transferred.
+     */
+    explicit QgsMeshDatasetCache( QgsMeshDataProvider *provider, int blockSize = DEFAULT_BLOCK_SIZE, qint64 maximumMemory = DEFAULT_MAXIMUM_MEMORY );
+
+    //! Returns the provider which the cache reads from
+    QgsMeshDataProvider *provider() const { return mProvider; }
+
+    //! Returns number of values in a single block
+    int blockSize() const { return mBlockSize; }
+
+    //! Returns the memory budget of the cache in bytes
+    qint64 maximumMemory() const { return mMaximumMemory; }
+
+    //! Sets the memory budget of the cache in bytes, evicting least recently used blocks if needed
+    void setMaximumMemory( qint64 maximumMemory );
+
+    //! Returns size of data of all cached blocks in bytes
+    qint64 memoryUsage() const { return mMemoryUsage; }
+
+    /**
+     * Returns \a count values of the dataset starting from \a valueIndex, like QgsMeshDataProvider::datasetValues().
+     * Blocks which are not cached yet are read from the provider.
+     */
+    QgsMeshDataBlock datasetValues( const QgsMeshDatasetIndex &index, int valueIndex, int count );
+
+    /**
+     * Returns \a count active flags of faces of the dataset starting from \a faceIndex, like QgsMeshDataProvider::areFacesActive().
+     * Blocks which are not cached yet are read from the provider.
+     */
+    QgsMeshDataBlock areFacesActive( const QgsMeshDatasetIndex &index, int faceIndex, int count );
+
+    //! Returns whether all values of the dataset in the range are cached
+    bool hasDatasetValues( const QgsMeshDatasetIndex &index, int valueIndex, int count ) const;
+
+    /**
+     * Queues all values and active flags of the dataset with \a index for reading. Datasets which are
+     * already queued, invalid or fully cached are ignored.
+     */
+    void prefetch( const QgsMeshDatasetIndex &index );
+
+    //! Returns whether there are datasets queued for prefetching
+    bool hasPendingPrefetch() const { return !mPrefetchQueue.isEmpty(); }
+
+    /**
+     * Reads the next block of the datasets queued for prefetching which is not cached yet.
+     * Returns TRUE if there are more blocks to read.
+     */
+    bool prefetchNextBlock();
+
+    //! Removes datasets queued for prefetching
+    void cancelPrefetch();
+
+    //! Removes all cached blocks and datasets queued for prefetching
+    void clear();
+
+  private:
+
+    struct BlockKey
+    {
+      int group;
+      int dataset;
+      int block;
+      bool activeFlags;
+
+      bool operator==( const BlockKey &other ) const
+      {
+        return group == other.group && dataset == other.dataset && block == other.block && activeFlags == other.activeFlags;
+      }
+    };
+
+    friend uint qHash( const BlockKey &key, uint seed );
+
+    struct BlockEntry
+    {
+      QgsMeshDataBlock data;
+      qint64 size;
+      std::list<BlockKey>::iterator lruPosition;
+    };
+
+    //! Returns number of values of the dataset (or number of active flags)
+    int valueCount( const QgsMeshDatasetIndex &index, bool activeFlags ) const;
+
+    //! Returns the block, reading it from the provider if it is not cached
+    QgsMeshDataBlock block( const BlockKey &key, int totalCount );
+
+    //! Joins blocks covering the range to a single data block
+    QgsMeshDataBlock readRange( const QgsMeshDatasetIndex &index, bool activeFlags, int first, int count );
+
+    void evict();
+
+    QgsMeshDataProvider *mProvider = nullptr;
+    int mBlockSize;
+    qint64 mMaximumMemory;
+    qint64 mMemoryUsage = 0;
+
+    QHash<BlockKey, BlockEntry> mBlocks;
+    //! Keys of cached blocks, most recently used first
+    std::list<BlockKey> mLru;
+
+    //! Datasets queued for prefetching
+    QList<QgsMeshDatasetIndex> mPrefetchQueue;
+};
+
+#endif // QGSMESHDATASETCACHE_H
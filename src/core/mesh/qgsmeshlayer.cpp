@@ -18,12 +18,15 @@
 #include <cstddef>
 #include <limits>
 
+#include <QElapsedTimer>
+#include <QTimer>
 #include <QUuid>
 
 #include "qgscolorramp.h"
 #include "qgslogger.h"
 #include "qgsmaplayerlegend.h"
 #include "qgsmeshdataprovider.h"
+#include "qgsmeshdatasetcache.h"
 #include "qgsmeshlayer.h"
 #include "qgsmeshlayerrenderer.h"
 #include "qgsmeshlayerutils.h"
@@ -142,6 +145,11 @@ QgsMeshLayerRendererCache *QgsMeshLayer::rendererCache()
   return mRendererCache.get();
 }
 
+QgsMeshDatasetCache *QgsMeshLayer::datasetCache()
+{
+  return mDatasetCache.get();
+}
+
 QgsMeshRendererSettings QgsMeshLayer::rendererSettings() const
 {
   return mRendererSettings;
@@ -238,6 +246,52 @@ void QgsMeshLayer::onDatasetGroupsAdded( int count )
     assignDefaultStyleToDatasetGroup( i );
 }
 
+void QgsMeshLayer::prefetchNeighborDatasets()
+{
+  if ( !mDatasetCache )
+    return;
+
+  // when animating, the following time steps are needed next - but stepping back is common too
+  const QList<int> offsets = { 1, 2, -1 };
+  const QList<QgsMeshDatasetIndex> activeDatasets = { mRendererSettings.activeScalarDataset(), mRendererSettings.activeVectorDataset() };
+  for ( const int offset : offsets )
+  {
+    for ( const QgsMeshDatasetIndex &index : activeDatasets )
+    {
+      if ( index.isValid() && index.dataset() + offset >= 0 )
+        mDatasetCache->prefetch( QgsMeshDatasetIndex( index.group(), index.dataset() + offset ) );
+    }
+  }
+
+  if ( mDatasetCache->hasPendingPrefetch() && !mPrefetchScheduled )
+  {
+    mPrefetchScheduled = true;
+    QTimer::singleShot( 0, this, &QgsMeshLayer::prefetchDatasetBlocks );
+  }
+}
+
+void QgsMeshLayer::prefetchDatasetBlocks()
+{
+  mPrefetchScheduled = false;
+  if ( !mDatasetCache )
+    return;
+
+  // providers are not thread safe, so the blocks are read in the main thread in short
+  // slices, leaving the event loop responsive in between
+  const int maxSliceTime = 20; // milliseconds
+  QElapsedTimer timer;
+  timer.start();
+  bool hasMore = true;
+  while ( hasMore && timer.elapsed() < maxSliceTime )
+    hasMore = mDatasetCache->prefetchNextBlock();
+
+  if ( hasMore )
+  {
+    mPrefetchScheduled = true;
+    QTimer::singleShot( 0, this, &QgsMeshLayer::prefetchDatasetBlocks );
+  }
+}
+
 static QgsColorRamp *_createDefaultColorRamp()
 {
   QgsColorRamp *ramp = QgsStyle::defaultStyle()->colorRamp( QStringLiteral( "Plasma" ) );
@@ -296,7 +350,12 @@ QgsMapLayerRenderer *QgsMeshLayer::createMapRenderer( QgsRenderContext &renderer
   if ( !mRendererCache )
     mRendererCache.reset( new QgsMeshLayerRendererCache() );
 
-  return new QgsMeshLayerRenderer( this, rendererContext );
+  QgsMeshLayerRenderer *renderer = new QgsMeshLayerRenderer( this, rendererContext );
+
+  // data of the active datasets are already read by the renderer, continue with those likely needed next
+  prefetchNeighborDatasets();
+
+  return renderer;
 }
 
 bool QgsMeshLayer::readSymbology( const QDomNode &node, QString &errorMessage,
@@ -482,11 +541,16 @@ void QgsMeshLayer::reload()
 
     //clear the rendererCache
     mRendererCache.reset( new QgsMeshLayerRendererCache() );
+
+    //clear the cached dataset values
+    if ( mDatasetCache )
+      mDatasetCache->clear();
   }
 }
 
 bool QgsMeshLayer::setDataProvider( QString const &provider, const QgsDataProvider::ProviderOptions &options )
 {
+  mDatasetCache.reset();
   delete mDataProvider;
 
   mProviderKey = provider;
@@ -511,6 +575,8 @@ bool QgsMeshLayer::setDataProvider( QString const &provider, const QgsDataProvid
 
   setCrs( mDataProvider->crs() );
 
+  mDatasetCache.reset( new QgsMeshDatasetCache( mDataProvider ) );
+
   if ( provider == QStringLiteral( "mesh_memory" ) )
   {
     // required so that source differs between memory layers
@@ -28,6 +28,7 @@
 
 class QgsMapLayerRenderer;
 struct QgsMeshLayerRendererCache;
+class QgsMeshDatasetCache;
 class QgsSymbol;
 class QgsTriangularMesh;
 class QgsRenderContext;
@@ -201,6 +202,17 @@ class CORE_EXPORT QgsMeshLayer : public QgsMapLayer
      */
     QgsMeshLayerRendererCache *rendererCache() SIP_SKIP;
 
+    /**
+     * Returns cache of dataset values read from the data provider (NULLPTR if the layer has no valid provider).
+     *
+     * Neighboring datasets of the active datasets are prefetched to the cache after the layer
+     * is rendered, so that going through time steps does not wait for reading the data.
+     *
+     * \note Not available in Python bindings
+     * \since QGIS 3.12
+     */
+    QgsMeshDatasetCache *datasetCache() SIP_SKIP;
+
     //! Returns renderer settings
     QgsMeshRendererSettings rendererSettings() const;
     //! Sets new renderer settings
@@ -301,8 +313,12 @@ class CORE_EXPORT QgsMeshLayer : public QgsMapLayer
     void assignDefaultStyleToDatasetGroup( int groupIndex );
     void setDefaultRendererSettings();
 
+    //! Queues datasets next to the active datasets for prefetching to the dataset cache
+    void prefetchNeighborDatasets();
+
   private slots:
     void onDatasetGroupsAdded( int count );
+    void prefetchDatasetBlocks();
 
   private:
     //! Pointer to data provider derived from the abastract base class QgsMeshDataProvider
@@ -317,6 +333,12 @@ class CORE_EXPORT QgsMeshLayer : public QgsMapLayer
     //! Pointer to the cache with data used for last rendering
     std::unique_ptr<QgsMeshLayerRendererCache> mRendererCache;
 
+    //! Cache of dataset values read from the data provider
+    std::unique_ptr<QgsMeshDatasetCache> mDatasetCache;
+
+    //! Whether reading of prefetched blocks is scheduled
+    bool mPrefetchScheduled = false;
+
     //! Renderer configuration
     QgsMeshRendererSettings mRendererSettings;
 
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <limits>
+#include <numeric>
 
 #include "qgsmeshlayerinterpolator.h"
 
@@ -34,6 +35,9 @@
 #include "qgscoordinatetransform.h"
 #include "qgsmeshdataprovider.h"
 
+#include <QThread>
+#include <QtConcurrentMap>
+
 QgsMeshLayerInterpolator::QgsMeshLayerInterpolator( const QgsTriangularMesh &m,
     const QVector<double> &datasetValues, const QgsMeshDataBlock &activeFaceFlagValues,
     bool dataIsOnVertices,
@@ -75,78 +79,179 @@ QgsRasterBlock *QgsMeshLayerInterpolator::block( int, const QgsRectangle &extent
   double *data = reinterpret_cast<double *>( outputBlock->bits() );
 
   const QVector<QgsMeshFace> &triangles = mTriangularMesh.triangles();
-  const QVector<QgsMeshVertex> &vertices = mTriangularMesh.vertices();
+  const QVector<int> &trianglesToNativeFaces = mTriangularMesh.trianglesToNativeFaces();
 
   // currently expecting that triangulation does not add any new extra vertices on the way
   if ( mDataOnVertices )
     Q_ASSERT( mDatasetValues.count() == mTriangularMesh.vertices().count() );
 
-  for ( int i = 0; i < triangles.size(); ++i )
+  // pixels covered by the triangles only depend on the extent and size of the block, not on the values
+  const QSize size( width, height );
+  std::shared_ptr<QgsMeshLayerInterpolatorCoverage> coverage = mCoverage;
+  if ( !coverage || !coverage->isCompatible( mContext, extent, size, triangles.count() ) )
+    coverage = std::make_shared<QgsMeshLayerInterpolatorCoverage>( mContext, extent, size, triangles.count() );
+
+  if ( !coverage->calculate( mTriangularMesh, mContext, feedback ) )
+    return outputBlock.release();
+
+  // bands are disjoint ranges of rows, so they can be written in parallel
+  std::vector<const QgsMeshLayerInterpolatorCoverage::Band *> bands;
+  bands.reserve( coverage->mBands.size() );
+  for ( const QgsMeshLayerInterpolatorCoverage::Band &band : coverage->mBands )
+    bands.push_back( &band );
+
+  QtConcurrent::blockingMap( bands, [&]( const QgsMeshLayerInterpolatorCoverage::Band * band )
   {
-    if ( feedback && feedback->isCanceled() )
-      break;
+    if ( ( feedback && feedback->isCanceled() ) || mContext.renderingStopped() )
+      return;
 
-    if ( mContext.renderingStopped() )
-      break;
+    // pixels are in the order of triangles, so later triangles overwrite values on shared edges as before
+    for ( const QgsMeshLayerInterpolatorCoverage::Pixel &pixel : band->pixels )
+    {
+      const int nativeFaceIndex = trianglesToNativeFaces[pixel.triangle];
+      if ( !mActiveFaceFlagValues.active( nativeFaceIndex ) )
+        continue;
 
-    const QgsMeshFace &face = triangles[i];
+      double val;
+      if ( mDataOnVertices )
+      {
+        const QgsMeshFace &face = triangles[pixel.triangle];
+        const double lam3 = 1.0 - pixel.lam1 - pixel.lam2;
+        val = pixel.lam1 * mDatasetValues[face[2]] + pixel.lam2 * mDatasetValues[face[1]] + lam3 * mDatasetValues[face[0]];
+      }
+      else
+      {
+        val = mDatasetValues[nativeFaceIndex];
+      }
 
-    const int v1 = face[0], v2 = face[1], v3 = face[2];
-    const QgsPoint p1 = vertices[v1], p2 = vertices[v2], p3 = vertices[v3];
+      if ( !std::isnan( val ) )
+      {
+        data[pixel.offset] = val;
+        outputBlock->setIsData( pixel.offset );
+      }
+    }
+  } );
 
-    const int nativeFaceIndex = mTriangularMesh.trianglesToNativeFaces()[i];
-    const bool isActive = mActiveFaceFlagValues.active( nativeFaceIndex );
-    if ( !isActive )
-      continue;
+  return outputBlock.release();
+}
+
+//
+// QgsMeshLayerInterpolatorCoverage
+//
+
+QgsMeshLayerInterpolatorCoverage::QgsMeshLayerInterpolatorCoverage( const QgsRenderContext &context, const QgsRectangle &extent, const QSize &size, int triangleCount )
+  : mExtent( extent )
+  , mSize( size )
+  , mTriangleCount( triangleCount )
+  , mTopLeft( context.mapToPixel().toMapCoordinates( 0, 0 ) )
+  , mBottomRight( context.mapToPixel().toMapCoordinates( size.width(), size.height() ) )
+  , mRotation( context.mapToPixel().mapRotation() )
+  , mSourceCrs( context.coordinateTransform().sourceCrs() )
+  , mDestinationCrs( context.coordinateTransform().destinationCrs() )
+{
+}
+
+bool QgsMeshLayerInterpolatorCoverage::isCompatible( const QgsRenderContext &context, const QgsRectangle &extent, const QSize &size, int triangleCount ) const
+{
+  return mExtent == extent &&
+         mSize == size &&
+         mTriangleCount == triangleCount &&
+         mTopLeft == context.mapToPixel().toMapCoordinates( 0, 0 ) &&
+         mBottomRight == context.mapToPixel().toMapCoordinates( size.width(), size.height() ) &&
+         qgsDoubleNear( mRotation, context.mapToPixel().mapRotation() ) &&
+         mSourceCrs == context.coordinateTransform().sourceCrs() &&
+         mDestinationCrs == context.coordinateTransform().destinationCrs();
+}
+
+bool QgsMeshLayerInterpolatorCoverage::calculate( const QgsTriangularMesh &mesh, const QgsRenderContext &context, QgsRasterBlockFeedback *feedback )
+{
+  QMutexLocker locker( &mMutex );
+  if ( mCalculated )
+    return true;
 
-    QgsRectangle bbox = QgsMeshLayerUtils::triangleBoundingBox( p1, p2, p3 );
-    if ( !extent.intersects( bbox ) )
+  if ( mSize.isEmpty() )
+  {
+    mCalculated = true;
+    return true;
+  }
+
+  const QVector<QgsMeshFace> &triangles = mesh.triangles();
+  const QVector<QgsMeshVertex> &vertices = mesh.vertices();
+  const QgsMapToPixel &mapToPixel = context.mapToPixel();
+
+  // a few bands for each thread, so that the work gets balanced when triangles are not spread evenly
+  const int bandCount = std::max( 1, std::min( mSize.height(), QThread::idealThreadCount() * 4 ) );
+  const int rowsPerBand = ( mSize.height() + bandCount - 1 ) / bandCount;
+
+  struct TriangleRect
+  {
+    int triangle;
+    int left, right, top, bottom;
+  };
+
+  // assign the triangles to the bands their screen bounding boxes overlap
+  std::vector< std::vector<TriangleRect> > bandTriangles( bandCount );
+  for ( int i = 0; i < triangles.size(); ++i )
+  {
+    if ( ( feedback && feedback->isCanceled() ) || context.renderingStopped() )
+      return false;
+
+    const QgsMeshFace &face = triangles[i];
+    const QgsRectangle bbox = QgsMeshLayerUtils::triangleBoundingBox( vertices[face[0]], vertices[face[1]], vertices[face[2]] );
+    if ( !mExtent.intersects( bbox ) )
       continue;
 
     // Get the BBox of the element in pixels
-    int topLim, bottomLim, leftLim, rightLim;
-    QgsMeshLayerUtils::boundingBoxToScreenRectangle( mContext.mapToPixel(), mOutputSize, bbox, leftLim, rightLim, topLim, bottomLim );
+    TriangleRect rect;
+    rect.triangle = i;
+    QgsMeshLayerUtils::boundingBoxToScreenRectangle( mapToPixel, mSize, bbox, rect.left, rect.right, rect.top, rect.bottom );
+    if ( rect.top > rect.bottom || rect.left > rect.right )
+      continue;
 
-    // interpolate in the bounding box of the face
-    for ( int j = topLim; j <= bottomLim; j++ )
+    for ( int band = rect.top / rowsPerBand; band <= rect.bottom / rowsPerBand; ++band )
+      bandTriangles[band].push_back( rect );
+  }
+
+  mBands.assign( bandCount, Band() );
+  std::vector<int> bandIndexes( bandCount );
+  std::iota( bandIndexes.begin(), bandIndexes.end(), 0 );
+
+  const int width = mSize.width();
+  QtConcurrent::blockingMap( bandIndexes, [&]( int bandIndex )
+  {
+    const int firstRow = bandIndex * rowsPerBand;
+    const int lastRow = std::min( mSize.height(), firstRow + rowsPerBand ) - 1;
+    std::vector<Pixel> &pixels = mBands[bandIndex].pixels;
+
+    for ( const TriangleRect &rect : bandTriangles[bandIndex] )
     {
-      double *line = data + ( j * width );
-      for ( int k = leftLim; k <= rightLim; k++ )
-      {
-        double val;
-        const QgsPointXY p = mContext.mapToPixel().toMapCoordinates( k, j );
-        if ( mDataOnVertices )
-          val = QgsMeshLayerUtils::interpolateFromVerticesData(
-                  p1,
-                  p2,
-                  p3,
-                  mDatasetValues[v1],
-                  mDatasetValues[v2],
-                  mDatasetValues[v3],
-                  p );
-        else
-        {
-          int face = mTriangularMesh.trianglesToNativeFaces()[i];
-          val = QgsMeshLayerUtils::interpolateFromFacesData(
-                  p1,
-                  p2,
-                  p3,
-                  mDatasetValues[face],
-                  p
-                );
-        }
+      if ( ( feedback && feedback->isCanceled() ) || context.renderingStopped() )
+        return;
+
+      const QgsMeshFace &face = triangles[rect.triangle];
+      const QgsPointXY p1 = vertices[face[0]], p2 = vertices[face[1]], p3 = vertices[face[2]];
 
-        if ( !std::isnan( val ) )
+      for ( int j = std::max( rect.top, firstRow ); j <= std::min( rect.bottom, lastRow ); j++ )
+      {
+        for ( int k = rect.left; k <= rect.right; k++ )
         {
-          line[k] = val;
-          outputBlock->setIsData( j, k );
+          const QgsPointXY p = mapToPixel.toMapCoordinates( k, j );
+          double lam1, lam2, lam3;
+          if ( QgsMeshLayerUtils::calculateBarycentricCoordinates( p1, p2, p3, p, lam1, lam2, lam3 ) )
+            pixels.push_back( { j * width + k, rect.triangle, lam1, lam2 } );
         }
       }
     }
+  } );
 
+  if ( ( feedback && feedback->isCanceled() ) || context.renderingStopped() )
+  {
+    mBands.clear();
+    return false;
   }
 
-  return outputBlock.release();
+  mCalculated = true;
+  return true;
 }
 
 ///@endcond
@@ -28,11 +28,16 @@ class QgsMeshDatasetIndex;
 #include "qgis_sip.h"
 
 #include <QSize>
+#include <QMutex>
+#include <memory>
+#include <vector>
 #include "qgsmaplayerrenderer.h"
 #include "qgstriangularmesh.h"
 #include "qgsrasterinterface.h"
 #include "qgssinglebandpseudocolorrenderer.h"
 #include "qgsrastershader.h"
+#include "qgscoordinatereferencesystem.h"
+#include "qgspointxy.h"
 
 class QgsRenderContext;
 
@@ -44,6 +49,69 @@ class QgsRenderContext;
 
 ///@cond PRIVATE
 
+/**
+ * \ingroup core
+ * Coverage of a raster block by the triangles of a triangular mesh.
+ *
+ * For each pixel inside a triangle, the coverage keeps the triangle and the barycentric
+ * coordinates of the pixel within the triangle, so rendering of other datasets of the mesh
+ * (e.g. other time steps) with the same extent and output size only needs to weight the
+ * values on the vertices. The pixels are grouped in bands of rows, which are calculated
+ * and interpolated in parallel.
+ *
+ * The coverage is calculated on the first call of calculate() and may be shared by
+ * interpolators running in different threads.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.12
+ */
+class CORE_EXPORT QgsMeshLayerInterpolatorCoverage SIP_SKIP
+{
+  public:
+    //! Constructs coverage (not calculated yet) of a raster block with \a extent and \a size for a mesh with \a triangleCount triangles
+    QgsMeshLayerInterpolatorCoverage( const QgsRenderContext &context, const QgsRectangle &extent, const QSize &size, int triangleCount );
+
+    //! Returns whether the coverage may be used for a raster block with \a extent and \a size for a mesh with \a triangleCount triangles
+    bool isCompatible( const QgsRenderContext &context, const QgsRectangle &extent, const QSize &size, int triangleCount ) const;
+
+    /**
+     * Calculates the coverage by triangles of the \a mesh if it has not been calculated yet.
+     * Returns FALSE if the calculation was canceled.
+     */
+    bool calculate( const QgsTriangularMesh &mesh, const QgsRenderContext &context, QgsRasterBlockFeedback *feedback = nullptr );
+
+  private:
+    //! Pixel covered by a triangle
+    struct Pixel
+    {
+      int offset;   //!< Index of the pixel within the block
+      int triangle; //!< Index of the triangle in the triangular mesh
+      double lam1;  //!< Weight of the third vertex of the triangle
+      double lam2;  //!< Weight of the second vertex of the triangle (the first vertex has the remaining weight)
+    };
+
+    //! Pixels in a range of rows, in the order of the triangles covering them
+    struct Band
+    {
+      std::vector<Pixel> pixels;
+    };
+
+    QgsRectangle mExtent;
+    QSize mSize;
+    int mTriangleCount = 0;
+    QgsPointXY mTopLeft;
+    QgsPointXY mBottomRight;
+    double mRotation = 0;
+    QgsCoordinateReferenceSystem mSourceCrs;
+    QgsCoordinateReferenceSystem mDestinationCrs;
+
+    QMutex mMutex;
+    bool mCalculated = false;
+    std::vector<Band> mBands;
+
+    friend class QgsMeshLayerInterpolator;
+};
+
 /**
  * \ingroup core
  * Interpolate mesh scalar dataset to raster block
@@ -68,6 +136,14 @@ class QgsMeshLayerInterpolator : public QgsRasterInterface SIP_SKIP
     int bandCount() const override;
     QgsRasterBlock *block( int, const QgsRectangle &extent, int width, int height, QgsRasterBlockFeedback *feedback = nullptr ) override;
 
+    /**
+     * Sets the coverage of output blocks by triangles, which may have been calculated by
+     * a previous interpolator for the same mesh, extent and size. If the coverage is not
+     * compatible with a requested block, a new coverage is calculated for the block.
+     * \since QGIS 3.12
+     */
+    void setCoverage( const std::shared_ptr<QgsMeshLayerInterpolatorCoverage> &coverage ) { mCoverage = coverage; }
+
   private:
     const QgsTriangularMesh &mTriangularMesh;
     const QVector<double> &mDatasetValues;
@@ -75,6 +151,7 @@ class QgsMeshLayerInterpolator : public QgsRasterInterface SIP_SKIP
     const QgsRenderContext &mContext;
     bool mDataOnVertices = true;
     QSize mOutputSize;
+    std::shared_ptr<QgsMeshLayerInterpolatorCoverage> mCoverage;
 };
 
 ///@endcond
@@ -24,6 +24,7 @@
 #include "qgsfield.h"
 #include "qgslogger.h"
 #include "qgsmeshlayer.h"
+#include "qgsmeshdatasetcache.h"
 #include "qgspointxy.h"
 #include "qgsrenderer.h"
 #include "qgssinglebandpseudocolorrenderer.h"
@@ -47,6 +48,7 @@ QgsMeshLayerRenderer::QgsMeshLayerRenderer( QgsMeshLayer *layer, QgsRenderContex
   Q_ASSERT( layer->triangularMesh() );
   Q_ASSERT( layer->rendererCache() );
   Q_ASSERT( layer->dataProvider() );
+  Q_ASSERT( layer->datasetCache() );
 
   mNativeMesh = *( layer->nativeMesh() );
   mTriangularMesh = *( layer->triangularMesh() );
@@ -56,6 +58,24 @@ QgsMeshLayerRenderer::QgsMeshLayerRenderer( QgsMeshLayer *layer, QgsRenderContex
   copyVectorDatasetValues( layer );
 
   calculateOutputSize();
+
+  // triangles cover the same pixels in all datasets, e.g. when going through time steps
+  if ( mRendererSettings.activeScalarDataset().isValid() )
+  {
+    QgsMeshLayerRendererCache *cache = layer->rendererCache();
+    if ( !cache->mScalarCoverage || !cache->mScalarCoverage->isCompatible( context, context.extent(), mOutputSize, mTriangularMesh.triangles().count() ) )
+      cache->mScalarCoverage = std::make_shared<QgsMeshLayerInterpolatorCoverage>( context, context.extent(), mOutputSize, mTriangularMesh.triangles().count() );
+    mScalarCoverage = cache->mScalarCoverage;
+  }
+
+  // flow grids of the vector datasets are kept for the following renderings, e.g. while panning
+  if ( mRendererSettings.activeVectorDataset().isValid() )
+  {
+    QgsMeshLayerRendererCache *cache = layer->rendererCache();
+    if ( !cache->mVectorFlowGrids )
+      cache->mVectorFlowGrids = std::make_shared<QgsMeshVectorFlowGridCache>();
+    mVectorFlowGrids = cache->mVectorFlowGrids;
+  }
 }
 
 QgsFeedback *QgsMeshLayerRenderer::feedback() const
@@ -103,7 +123,8 @@ void QgsMeshLayerRenderer::copyScalarDatasetValues( QgsMeshLayer *layer )
     mScalarDataOnVertices = metadata.dataType() == QgsMeshDatasetGroupMetadata::DataOnVertices;
 
     // populate scalar values
-    QgsMeshDataBlock vals = layer->dataProvider()->datasetValues(
+    QgsMeshDatasetCache *datasetCache = layer->datasetCache();
+    QgsMeshDataBlock vals = datasetCache->datasetValues(
                               datasetIndex,
                               0,
                               mScalarDataOnVertices ? mNativeMesh.vertices.count() : mNativeMesh.faces.count() );
@@ -112,7 +133,7 @@ void QgsMeshLayerRenderer::copyScalarDatasetValues( QgsMeshLayer *layer )
     mScalarDatasetValues = QgsMeshLayerUtils::calculateMagnitudes( vals );
 
     // populate face active flag, always defined on faces
-    mScalarActiveFaceFlagValues = layer->dataProvider()->areFacesActive(
+    mScalarActiveFaceFlagValues = datasetCache->areFacesActive(
                                     datasetIndex,
                                     0,
                                     mNativeMesh.faces.count() );
@@ -189,7 +210,7 @@ void QgsMeshLayerRenderer::copyVectorDatasetValues( QgsMeshLayer *layer )
       else
         count = mNativeMesh.faces.count();
 
-      mVectorDatasetValues = layer->dataProvider()->datasetValues(
+      mVectorDatasetValues = layer->datasetCache()->datasetValues(
                                datasetIndex,
                                0,
                                count );
@@ -326,6 +347,7 @@ void QgsMeshLayerRenderer::renderScalarDataset()
                                          mScalarDataOnVertices,
                                          context,
                                          mOutputSize );
+  interpolator.setCoverage( mScalarCoverage );
   QgsSingleBandPseudoColorRenderer renderer( &interpolator, 0, sh );  // takes ownership of sh
   renderer.setClassificationMin( scalarSettings.classificationMinimum() );
   renderer.setClassificationMax( scalarSettings.classificationMaximum() );
@@ -360,7 +382,9 @@ void QgsMeshLayerRenderer::renderVectorDataset()
         mRendererSettings.vectorSettings( index.group() ),
         *renderContext(),
         mLayerExtent,
-        mOutputSize ) );
+        mOutputSize,
+        mVectorFlowGrids,
+        index ) );
 
   renderer->draw();
 }
@@ -36,6 +36,7 @@ class QgsMeshLayer;
 #include "qgsmeshtracerenderer.h"
 
 class QgsRenderContext;
+class QgsMeshLayerInterpolatorCoverage;
 
 ///@cond PRIVATE
 
@@ -64,6 +65,8 @@ struct CORE_NO_EXPORT QgsMeshLayerRendererCache
   double mScalarDatasetMinimum = std::numeric_limits<double>::quiet_NaN();
   double mScalarDatasetMaximum = std::numeric_limits<double>::quiet_NaN();
   QgsMeshRendererScalarSettings::DataInterpolationMethod mDataInterpolationMethod = QgsMeshRendererScalarSettings::None;
+  //! Coverage of the rendered image by triangles, reused while the extent and image size do not change
+  std::shared_ptr<QgsMeshLayerInterpolatorCoverage> mScalarCoverage;
 
   // vector dataset
   QgsMeshDatasetIndex mActiveVectorDatasetIndex;
@@ -74,6 +77,8 @@ struct CORE_NO_EXPORT QgsMeshLayerRendererCache
   double mVectorDatasetGroupMagMinimum = std::numeric_limits<double>::quiet_NaN();
   double mVectorDatasetGroupMagMaximum = std::numeric_limits<double>::quiet_NaN();
   bool mVectorDataOnVertices = true;
+  //! Flow grids of the vector datasets defined on vertices used to trace streamlines, e.g. for each rendered time step
+  std::shared_ptr<QgsMeshVectorFlowGridCache> mVectorFlowGrids;
 
 };
 
@@ -123,6 +128,7 @@ class QgsMeshLayerRenderer : public QgsMapLayerRenderer
     bool mScalarDataOnVertices = true;
     double mScalarDatasetMinimum = std::numeric_limits<double>::quiet_NaN();
     double mScalarDatasetMaximum = std::numeric_limits<double>::quiet_NaN();
+    std::shared_ptr<QgsMeshLayerInterpolatorCoverage> mScalarCoverage;
 
     // copy of the vector dataset
     QgsMeshDataBlock mVectorDatasetValues;
@@ -132,6 +138,7 @@ class QgsMeshLayerRenderer : public QgsMapLayerRenderer
     double mVectorDatasetGroupMagMinimum = std::numeric_limits<double>::quiet_NaN();
     double mVectorDatasetGroupMagMaximum = std::numeric_limits<double>::quiet_NaN();
     bool mVectorDataOnVertices = true;
+    std::shared_ptr<QgsMeshVectorFlowGridCache> mVectorFlowGrids;
 
     // copy of rendering settings
     QgsMeshRendererSettings mRendererSettings;
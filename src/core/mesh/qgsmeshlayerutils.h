@@ -69,6 +69,23 @@ class CORE_EXPORT QgsMeshLayerUtils
       const QgsRectangle &bbox,
       int &leftLim, int &rightLim, int &topLim, int &bottomLim );
 
+    /**
+    * Calculates barycentric coordinates of a point within a triangle, as used by interpolateFromVerticesData()
+    * \param p1 first vertex of the triangle
+    * \param p2 second vertex of the triangle
+    * \param p3 third vertex of the triangle
+    * \param pt point where to calculate the coordinates
+    * \param lam1 weight of p3
+    * \param lam2 weight of p2
+    * \param lam3 weight of p1
+    * \returns FALSE if the point is outside the triangle or the triangle is not valid
+    *
+    * \since QGIS 3.12
+    */
+    static bool calculateBarycentricCoordinates(
+      const QgsPointXY &p1, const QgsPointXY &p2, const QgsPointXY &p3, const QgsPointXY &pt,
+      double &lam1, double &lam2, double &lam3 );
+
     /**
     * Interpolates value based on known values on the vertices of a triangle
     * \param p1 first vertex of the triangle
@@ -23,6 +23,8 @@
 #include <spatialindex/SpatialIndex.h>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QThread>
+#include <QtConcurrentMap>
 #include <memory>
 
 using namespace SpatialIndex;
@@ -120,16 +122,20 @@ class QgsMeshSpatialIndexCopyVisitor : public SpatialIndex::IVisitor
  * \ingroup core
  * \class QgsMeshFaceIteratorDataStream
  * \brief Utility class for bulk loading of R-trees. Not a part of public API.
+ *
+ * Bounding boxes of all faces are calculated upfront (in parallel for large meshes) into
+ * a packed array of coordinates, so that the bulk loading only needs to wrap them in R-tree data.
+ *
  * \note not available in Python bindings
 */
 class QgsMeshFaceIteratorDataStream : public IDataStream
 {
   public:
-    //! constructor - needs to load all data to a vector for later access when bulk loading
+    //! constructor - calculates bounding boxes of all faces for later access when bulk loading
     explicit QgsMeshFaceIteratorDataStream( const QgsMesh &triangularMesh, QgsFeedback *feedback = nullptr )
-      : mMesh( triangularMesh )
-      , mFeedback( feedback )
+      : mFeedback( feedback )
     {
+      calculateBounds( triangularMesh );
       readNextEntry();
     }
 
@@ -159,7 +165,7 @@ class QgsMeshFaceIteratorDataStream : public IDataStream
     //! returns the total number of entries available in the stream.
     uint32_t size() override
     {
-      return static_cast<uint32_t>( mMesh.faceCount() );
+      return static_cast<uint32_t>( faceCount() );
     }
 
     //! sets the stream pointer to the first entry, if possible.
@@ -169,13 +175,17 @@ class QgsMeshFaceIteratorDataStream : public IDataStream
     }
 
   protected:
+    int faceCount() const
+    {
+      return static_cast<int>( mBounds.size() / 4 );
+    }
+
     void readNextEntry()
     {
-      SpatialIndex::Region r;
-      const int faceCount = mMesh.faceCount();
-      if ( mIterator < faceCount )
+      if ( mIterator < faceCount() )
       {
-        r = faceToRegion( mMesh, mIterator );
+        const double *bounds = mBounds.data() + 4 * static_cast<size_t>( mIterator );
+        const SpatialIndex::Region r( bounds, bounds + 2, 2 );
         mNextData = new RTree::Data(
           0,
           nullptr,
@@ -186,8 +196,47 @@ class QgsMeshFaceIteratorDataStream : public IDataStream
     }
 
   private:
+
+    //! Number of faces processed by a single job when calculating bounding boxes
+    static const int CHUNK_SIZE = 16384;
+
+    void calculateBounds( const QgsMesh &mesh )
+    {
+      const int count = mesh.faceCount();
+      mBounds.resize( 4 * static_cast<size_t>( count ) );
+
+      auto calculateChunk = [this, &mesh]( int first, int last )
+      {
+        for ( int i = first; i < last; ++i )
+        {
+          const Region r = faceToRegion( mesh, i );
+          double *bounds = mBounds.data() + 4 * static_cast<size_t>( i );
+          bounds[0] = r.getLow( 0 );
+          bounds[1] = r.getLow( 1 );
+          bounds[2] = r.getHigh( 0 );
+          bounds[3] = r.getHigh( 1 );
+        }
+      };
+
+      if ( count <= CHUNK_SIZE || QThread::idealThreadCount() < 2 )
+      {
+        calculateChunk( 0, count );
+        return;
+      }
+
+      std::vector<std::pair<int, int>> chunks;
+      for ( int first = 0; first < count; first += CHUNK_SIZE )
+        chunks.emplace_back( first, std::min( first + CHUNK_SIZE, count ) );
+
+      QtConcurrent::blockingMap( chunks, [&calculateChunk]( const std::pair<int, int> &chunk )
+      {
+        calculateChunk( chunk.first, chunk.second );
+      } );
+    }
+
     int mIterator = 0;
-    const QgsMesh &mMesh;
+    //! Packed bounding boxes of faces - xmin, ymin, xmax, ymax for each face
+    std::vector<double> mBounds;
     RTree::Data *mNextData = nullptr;
     QgsFeedback *mFeedback = nullptr;
 };
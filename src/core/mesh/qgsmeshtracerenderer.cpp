@@ -17,6 +17,10 @@
 
 #include "qgsmeshtracerenderer.h"
 #include "qgsmeshlayerrenderer.h"
+
+#include <QThread>
+#include <QtConcurrentMap>
+
 ///@cond PRIVATE
 
 QgsVector QgsMeshVectorValueInterpolator::vectorValue( const QgsPointXY &point ) const
@@ -166,6 +170,182 @@ void QgsMeshVectorValueInterpolator::activeFaceFilter( QgsVector &vector, int fa
     vector = QgsVector( std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN() ) ;
 }
 
+QgsMeshVectorFlowGrid::QgsMeshVectorFlowGrid( const QgsRectangle &extent, double cellSize )
+  : mCellSize( cellSize )
+{
+  const double firstColumn = std::floor( extent.xMinimum() / cellSize );
+  const double firstRow = std::floor( extent.yMinimum() / cellSize );
+  mXMinimum = firstColumn * cellSize;
+  mYMinimum = firstRow * cellSize;
+  // at least two nodes in each direction, so that there is always a cell to interpolate within
+  mColumns = std::max( 2, static_cast<int>( std::ceil( extent.xMaximum() / cellSize ) - firstColumn ) + 1 );
+  mRows = std::max( 2, static_cast<int>( std::ceil( extent.yMaximum() / cellSize ) - firstRow ) + 1 );
+}
+
+qint64 QgsMeshVectorFlowGrid::nodeCount( const QgsRectangle &extent, double cellSize )
+{
+  const qint64 columns = std::max( 2LL, static_cast<qint64>( std::ceil( extent.xMaximum() / cellSize ) - std::floor( extent.xMinimum() / cellSize ) ) + 1 );
+  const qint64 rows = std::max( 2LL, static_cast<qint64>( std::ceil( extent.yMaximum() / cellSize ) - std::floor( extent.yMinimum() / cellSize ) ) + 1 );
+  return columns * rows;
+}
+
+QgsRectangle QgsMeshVectorFlowGrid::extent() const
+{
+  return QgsRectangle( mXMinimum, mYMinimum, mXMinimum + ( mColumns - 1 ) * mCellSize, mYMinimum + ( mRows - 1 ) * mCellSize );
+}
+
+bool QgsMeshVectorFlowGrid::sample( QgsMeshVectorValueInterpolator &interpolator, const QgsRenderContext &context )
+{
+  mValues.resize( 2 * mColumns * mRows );
+  float *values = mValues.data();
+
+  // bands of rows, each with its own interpolator as the interpolator caches the last face found
+  struct Band
+  {
+    int firstRow;
+    int lastRow;
+    std::unique_ptr<QgsMeshVectorValueInterpolator> interpolator;
+  };
+
+  const int bandCount = std::min( mRows, 4 * std::max( 1, QThread::idealThreadCount() ) );
+  std::vector<Band> bands( static_cast<size_t>( bandCount ) );
+  for ( int b = 0; b < bandCount; ++b )
+  {
+    bands[b].firstRow = static_cast<int>( static_cast<qint64>( mRows ) * b / bandCount );
+    bands[b].lastRow = static_cast<int>( static_cast<qint64>( mRows ) * ( b + 1 ) / bandCount ) - 1;
+    bands[b].interpolator.reset( interpolator.clone() );
+  }
+
+  QtConcurrent::blockingMap( bands, [this, values, &context]( Band & band )
+  {
+    for ( int row = band.firstRow; row <= band.lastRow; ++row )
+    {
+      if ( context.renderingStopped() )
+        return;
+
+      const double y = mYMinimum + row * mCellSize;
+      float *rowValues = values + 2 * static_cast<size_t>( row ) * static_cast<size_t>( mColumns );
+      for ( int column = 0; column < mColumns; ++column )
+      {
+        const QgsVector vector = band.interpolator->vectorValue( QgsPointXY( mXMinimum + column * mCellSize, y ) );
+        rowValues[2 * column] = static_cast<float>( vector.x() );
+        rowValues[2 * column + 1] = static_cast<float>( vector.y() );
+      }
+    }
+  } );
+
+  return !context.renderingStopped();
+}
+
+QgsVector QgsMeshVectorFlowGrid::vectorValue( const QgsPointXY &point ) const
+{
+  const double gridX = ( point.x() - mXMinimum ) / mCellSize;
+  const double gridY = ( point.y() - mYMinimum ) / mCellSize;
+  if ( !( gridX >= 0 && gridY >= 0 && gridX <= mColumns - 1 && gridY <= mRows - 1 ) || mValues.isEmpty() )
+    return QgsVector( std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN() );
+
+  const int column = std::min( static_cast<int>( gridX ), mColumns - 2 );
+  const int row = std::min( static_cast<int>( gridY ), mRows - 2 );
+  const double fx = gridX - column;
+  const double fy = gridY - row;
+
+  const float *bottom = mValues.constData() + 2 * ( static_cast<size_t>( row ) * static_cast<size_t>( mColumns ) + static_cast<size_t>( column ) );
+  const float *top = bottom + 2 * static_cast<size_t>( mColumns );
+  const float *corners[4] = { bottom, bottom + 2, top, top + 2 };
+
+  bool allValid = true;
+  for ( const float *corner : corners )
+    allValid &= !std::isnan( corner[0] ) && !std::isnan( corner[1] );
+
+  if ( !allValid )
+  {
+    // on the border of the mesh or of inactive faces, do not mix with invalid values
+    const float *nearest = corners[( fx < 0.5 ? 0 : 1 ) + ( fy < 0.5 ? 0 : 2 )];
+    return QgsVector( nearest[0], nearest[1] );
+  }
+
+  const double w00 = ( 1 - fx ) * ( 1 - fy );
+  const double w10 = fx * ( 1 - fy );
+  const double w01 = ( 1 - fx ) * fy;
+  const double w11 = fx * fy;
+  return QgsVector( w00 * corners[0][0] + w10 * corners[1][0] + w01 * corners[2][0] + w11 * corners[3][0],
+                    w00 * corners[0][1] + w10 * corners[1][1] + w01 * corners[2][1] + w11 * corners[3][1] );
+}
+
+std::shared_ptr<const QgsMeshVectorFlowGrid> QgsMeshVectorFlowGridCache::grid( const QgsMeshDatasetIndex &datasetIndex,
+    int triangleCount,
+    const QgsRectangle &extent,
+    const QgsRectangle &layerExtent,
+    double mapUnitsPerPixel,
+    QgsMeshVectorValueInterpolator &interpolator,
+    const QgsRenderContext &context )
+{
+  const QgsRectangle area = extent.intersect( layerExtent );
+  if ( area.isEmpty() || !( mapUnitsPerPixel > 0 ) )
+    return nullptr;
+
+  // cells are a power of two in size, so that the grid is reused by renderings with similar scale
+  const double requestedCellSize = std::pow( 2.0, std::ceil( std::log2( mapUnitsPerPixel ) ) );
+  const QgsCoordinateReferenceSystem crs = context.coordinateTransform().destinationCrs();
+
+  QMutexLocker locker( &mMutex );
+
+  for ( int i = 0; i < mEntries.count(); ++i )
+  {
+    const Entry &entry = mEntries.at( i );
+    if ( entry.datasetIndex == datasetIndex &&
+         entry.triangleCount == triangleCount &&
+         entry.crs == crs &&
+         qgsDoubleNear( entry.requestedCellSize, requestedCellSize ) &&
+         entry.grid->extent().contains( area ) )
+    {
+      mEntries.move( i, 0 );
+      return mEntries.at( 0 ).grid;
+    }
+  }
+
+  // add a margin to the grid so that it can be reused while panning,
+  // the margin (and then the resolution) is reduced when the grid would be too large
+  double cellSize = requestedCellSize;
+  double margin = std::max( area.width(), area.height() ) / 2;
+  QgsRectangle gridExtent = area.buffered( margin ).intersect( layerExtent );
+  while ( QgsMeshVectorFlowGrid::nodeCount( gridExtent, cellSize ) > MAXIMUM_NODE_COUNT )
+  {
+    if ( margin > 0 )
+    {
+      margin = margin / 2 < cellSize ? 0 : margin / 2;
+      gridExtent = area.buffered( margin ).intersect( layerExtent );
+    }
+    else
+    {
+      cellSize *= 2;
+    }
+  }
+
+  std::shared_ptr<QgsMeshVectorFlowGrid> grid = std::make_shared<QgsMeshVectorFlowGrid>( gridExtent, cellSize );
+  if ( !grid->sample( interpolator, context ) )
+    return nullptr;
+
+  mEntries.prepend( Entry{ datasetIndex, triangleCount, crs, requestedCellSize, grid } );
+
+  qint64 memoryUsage = 0;
+  for ( const Entry &entry : qgis::as_const( mEntries ) )
+    memoryUsage += entry.grid->memoryUsage();
+  while ( memoryUsage > MAXIMUM_MEMORY && mEntries.count() > 1 )
+  {
+    memoryUsage -= mEntries.last().grid->memoryUsage();
+    mEntries.removeLast();
+  }
+
+  return grid;
+}
+
+void QgsMeshVectorFlowGridCache::clear()
+{
+  QMutexLocker locker( &mMutex );
+  mEntries.clear();
+}
+
 QSize QgsMeshStreamField::size() const
 {
   return mFieldSize;
@@ -191,6 +371,7 @@ QgsPointXY QgsMeshStreamField::positionToMapCoordinates( const QPoint &pixelPosi
 
 QgsMeshStreamField::QgsMeshStreamField( const QgsTriangularMesh &triangularMesh, const QgsMeshDataBlock &dataSetVectorValues, const QgsMeshDataBlock &scalarActiveFaceFlagValues, const QgsRectangle &layerExtent, double magnitudeMaximum, bool dataIsOnVertices, const QgsRenderContext &rendererContext, int resolution ):
   mFieldResolution( resolution ),
+  mTriangleCount( triangularMesh.triangles().count() ),
   mLayerExtent( layerExtent ),
   mMagMax( magnitudeMaximum ),
   mRenderContext( rendererContext )
@@ -225,6 +406,10 @@ QgsMeshStreamField::QgsMeshStreamField( const QgsMeshStreamField &other ):
   mMapToFieldPixel( other.mMapToFieldPixel ),
   mPixelFillingCount( other.mPixelFillingCount ),
   mMaxPixelFillingCount( other.mMaxPixelFillingCount ),
+  mFlowGridCache( other.mFlowGridCache ),
+  mDatasetIndex( other.mDatasetIndex ),
+  mTriangleCount( other.mTriangleCount ),
+  mFlowGrid( other.mFlowGrid ),
   mLayerExtent( other.mLayerExtent ),
   mMapExtent( other.mMapExtent ),
   mFieldTopLeftInDeviceCoordinates( other.mFieldTopLeftInDeviceCoordinates ),
@@ -273,6 +458,7 @@ void QgsMeshStreamField::updateSize( const QgsRenderContext &renderContext )
     mValid = false;
     mFieldSize = QSize();
     mFieldTopLeftInDeviceCoordinates = QPoint();
+    mFlowGrid.reset();
     initField();
     return;
   }
@@ -324,6 +510,8 @@ void QgsMeshStreamField::updateSize( const QgsRenderContext &renderContext )
                                     fieldWidth,
                                     fieldHeight, 0 );
 
+  updateFlowGrid( interestZoneExtent, layerExtent );
+
   initField();
   mValid = true;
 }
@@ -337,6 +525,36 @@ void QgsMeshStreamField::updateSize( const QgsRenderContext &renderContext, int
   updateSize( renderContext );
 }
 
+void QgsMeshStreamField::setFlowGridCache( const std::shared_ptr<QgsMeshVectorFlowGridCache> &cache, const QgsMeshDatasetIndex &datasetIndex )
+{
+  mFlowGridCache = cache;
+  mDatasetIndex = datasetIndex;
+  mFlowGrid.reset();
+}
+
+void QgsMeshStreamField::updateFlowGrid( const QgsRectangle &interestZoneExtent, const QgsRectangle &layerExtent )
+{
+  mFlowGrid.reset();
+  if ( !mFlowGridCache || !mVectorValueInterpolator )
+    return;
+
+  mFlowGrid = mFlowGridCache->grid( mDatasetIndex,
+                                    mTriangleCount,
+                                    interestZoneExtent,
+                                    layerExtent,
+                                    mMapToFieldPixel.mapUnitsPerPixel(),
+                                    *mVectorValueInterpolator,
+                                    mRenderContext );
+}
+
+QgsVector QgsMeshStreamField::vectorValue( const QgsPointXY &mapPosition ) const
+{
+  if ( mFlowGrid )
+    return mFlowGrid->vectorValue( mapPosition );
+
+  return mVectorValueInterpolator->vectorValue( mapPosition );
+}
+
 bool QgsMeshStreamField::isValid() const
 {
   return mValid;
@@ -426,7 +644,7 @@ void QgsMeshStreamField::addTrace( QPoint startPixel )
   while ( !mRenderContext.renderingStopped() )
   {
     QgsPointXY mapPosition = positionToMapCoordinates( currentPixel, QgsPointXY( x1, y1 ) );
-    vector = mVectorValueInterpolator->vectorValue( mapPosition ) ;
+    vector = vectorValue( mapPosition ) ;
 
     if ( std::isnan( vector.x() ) || std::isnan( vector.y() ) )
     {
@@ -750,6 +968,10 @@ QgsMeshStreamField &QgsMeshStreamField::operator=( const QgsMeshStreamField &oth
   mMapToFieldPixel = other.mMapToFieldPixel ;
   mPixelFillingCount = other.mPixelFillingCount ;
   mMaxPixelFillingCount = other.mMaxPixelFillingCount ;
+  mFlowGridCache = other.mFlowGridCache;
+  mDatasetIndex = other.mDatasetIndex;
+  mTriangleCount = other.mTriangleCount;
+  mFlowGrid = other.mFlowGrid;
   mLayerExtent = other.mLayerExtent ;
   mMapExtent = other.mMapExtent;
   mFieldTopLeftInDeviceCoordinates = other.mFieldTopLeftInDeviceCoordinates ;
@@ -857,7 +1079,7 @@ QgsVector QgsMeshVectorValueInterpolatorFromFace::interpolatedValuePrivate( int
            point );
 }
 
-QgsMeshVectorStreamlineRenderer::QgsMeshVectorStreamlineRenderer( const QgsTriangularMesh &triangularMesh, const QgsMeshDataBlock &dataSetVectorValues, const QgsMeshDataBlock &scalarActiveFaceFlagValues, bool dataIsOnVertices, const QgsMeshRendererVectorSettings &settings, QgsRenderContext &rendererContext, const QgsRectangle &layerExtent, double magMax ):
+QgsMeshVectorStreamlineRenderer::QgsMeshVectorStreamlineRenderer( const QgsTriangularMesh &triangularMesh, const QgsMeshDataBlock &dataSetVectorValues, const QgsMeshDataBlock &scalarActiveFaceFlagValues, bool dataIsOnVertices, const QgsMeshRendererVectorSettings &settings, QgsRenderContext &rendererContext, const QgsRectangle &layerExtent, double magMax, const std::shared_ptr<QgsMeshVectorFlowGridCache> &flowGridCache, const QgsMeshDatasetIndex &datasetIndex ):
   mRendererContext( rendererContext )
 {
   mStreamLineField.reset( new QgsMeshStreamlinesField( triangularMesh,
@@ -866,6 +1088,10 @@ QgsMeshVectorStreamlineRenderer::QgsMeshVectorStreamlineRenderer( const QgsTrian
                           layerExtent,
                           magMax, dataIsOnVertices, rendererContext ) );
 
+  // values of datasets defined on faces are kept exact, without interpolation on a grid
+  if ( flowGridCache && dataIsOnVertices )
+    mStreamLineField->setFlowGridCache( flowGridCache, datasetIndex );
+
   mStreamLineField->updateSize( rendererContext );
   mStreamLineField->setPixelFillingDensity( settings.streamLinesSettings().seedingDensity() );
   mStreamLineField->setLineWidth(
@@ -1257,6 +1483,14 @@ QgsMeshVectorTraceRenderer::QgsMeshVectorTraceRenderer( QgsMeshLayer *layer, con
                    vectorDataOnVertices,
                    rendererContext ) )  ;
 
+  // flow grids of datasets defined on vertices are shared with the rendering of the layer
+  if ( vectorDataOnVertices )
+  {
+    if ( !cache->mVectorFlowGrids )
+      cache->mVectorFlowGrids = std::make_shared<QgsMeshVectorFlowGridCache>();
+    mParticleField->setFlowGridCache( cache->mVectorFlowGrids, datasetIndex );
+  }
+
   mParticleField->setMinimizeFieldSize( false );
   mParticleField->updateSize( mRendererContext );
 }
@@ -21,6 +21,8 @@
 
 #include <QVector>
 #include <QSize>
+#include <QMutex>
+#include <memory>
 
 #include "qgis_core.h"
 #include "qgis.h"
@@ -28,6 +30,7 @@
 #include "qgsmeshlayer.h"
 #include "qgsmeshlayerutils.h"
 #include "qgsmeshvectorrenderer.h"
+#include "qgscoordinatereferencesystem.h"
 
 
 ///@cond PRIVATE
@@ -42,7 +45,7 @@
  * \note not available in Python bindings
  * \since QGIS 3.12
  */
-class QgsMeshVectorValueInterpolator
+class CORE_EXPORT QgsMeshVectorValueInterpolator
 {
   public:
     //! Constructor
@@ -95,7 +98,7 @@ class QgsMeshVectorValueInterpolator
  * \note not available in Python bindings
  * \since QGIS 3.12
  */
-class QgsMeshVectorValueInterpolatorFromVertex: public QgsMeshVectorValueInterpolator
+class CORE_EXPORT QgsMeshVectorValueInterpolatorFromVertex: public QgsMeshVectorValueInterpolator
 {
   public:
     //! Constructor
@@ -153,6 +156,110 @@ class QgsMeshVectorValueInterpolatorFromFace: public QgsMeshVectorValueInterpola
     QgsVector interpolatedValuePrivate( int faceIndex, const QgsPointXY point ) const override;
 };
 
+/**
+ * \ingroup core
+ *
+ * Vector values of a dataset sampled on a regular grid in map coordinates.
+ *
+ * Values are sampled on the nodes of the grid in parallel and are interpolated bilinearly
+ * between the nodes, so streamlines and particle traces can be integrated without searching
+ * for the face containing each position. Nodes outside of the mesh or on inactive faces have
+ * invalid (NaN) values; next to such nodes, the value of the nearest node is used.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.12
+ */
+class CORE_EXPORT QgsMeshVectorFlowGrid
+{
+  public:
+    //! Constructs grid with nodes on multiples of \a cellSize covering the \a extent. Values are not sampled yet.
+    QgsMeshVectorFlowGrid( const QgsRectangle &extent, double cellSize );
+
+    /**
+     * Samples values of the \a interpolator on the nodes of the grid.
+     * Returns FALSE if rendering of the \a context has been stopped meanwhile.
+     */
+    bool sample( QgsMeshVectorValueInterpolator &interpolator, const QgsRenderContext &context );
+
+    //! Returns the vector interpolated at the \a point, or an invalid (NaN) vector if the point is outside of the grid or of the mesh
+    QgsVector vectorValue( const QgsPointXY &point ) const;
+
+    //! Returns the extent covered by nodes of the grid
+    QgsRectangle extent() const;
+
+    //! Returns size of a cell of the grid in map units
+    double cellSize() const { return mCellSize; }
+
+    //! Returns number of nodes of a grid covering the \a extent with \a cellSize
+    static qint64 nodeCount( const QgsRectangle &extent, double cellSize );
+
+    //! Returns size of the sampled values in bytes
+    qint64 memoryUsage() const { return static_cast<qint64>( mValues.size() ) * static_cast<qint64>( sizeof( float ) ); }
+
+  private:
+    double mXMinimum = 0;
+    double mYMinimum = 0;
+    double mCellSize = 1;
+    int mColumns = 0;
+    int mRows = 0;
+    //! Components x and y of the vectors on the nodes, row by row from the bottom
+    QVector<float> mValues;
+};
+
+/**
+ * \ingroup core
+ *
+ * Cache of flow grids of the datasets of a mesh layer.
+ *
+ * Grids are kept for each dataset (e.g. each time step) and cover the rendered extent with
+ * a margin, so that rendering of streamlines while panning or going back and forth between
+ * time steps reuses the sampled values. Total size of the grids is bounded, least recently
+ * used grids are discarded first. The cache may be used from several rendering threads.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.12
+ */
+class CORE_EXPORT QgsMeshVectorFlowGridCache
+{
+  public:
+    //! Maximum total size of the cached grids in bytes
+    static const qint64 MAXIMUM_MEMORY = 128 * 1024 * 1024;
+
+    //! Maximum number of nodes of a single grid
+    static const qint64 MAXIMUM_NODE_COUNT = 4 * 1024 * 1024;
+
+    /**
+     * Returns grid of the dataset with \a datasetIndex covering the \a extent (in map coordinates of the \a context)
+     * with cells not smaller than \a mapUnitsPerPixel. If no such grid is cached, the values of the \a interpolator
+     * are sampled on a new grid, which also covers a margin around the extent within the \a layerExtent.
+     * Returns NULLPTR if the extent is outside of the layer extent or the rendering has been stopped.
+     */
+    std::shared_ptr<const QgsMeshVectorFlowGrid> grid( const QgsMeshDatasetIndex &datasetIndex,
+        int triangleCount,
+        const QgsRectangle &extent,
+        const QgsRectangle &layerExtent,
+        double mapUnitsPerPixel,
+        QgsMeshVectorValueInterpolator &interpolator,
+        const QgsRenderContext &context );
+
+    //! Removes all cached grids
+    void clear();
+
+  private:
+    struct Entry
+    {
+      QgsMeshDatasetIndex datasetIndex;
+      int triangleCount;
+      QgsCoordinateReferenceSystem crs;
+      double requestedCellSize;
+      std::shared_ptr<const QgsMeshVectorFlowGrid> grid;
+    };
+
+    QMutex mMutex;
+    //! Cached grids, most recently used first
+    QList<Entry> mEntries;
+};
+
 /**
  * \ingroup core
  *
@@ -254,6 +361,13 @@ class QgsMeshStreamField
     //! Sets if the size of the field has to be minimized of all the mesh is in the device
     void setMinimizeFieldSize( bool minimizeFieldSize );
 
+    /**
+     * Sets the \a cache of flow grids used for the dataset with \a datasetIndex, which may be shared with
+     * other fields of the same layer. Has to be called before the size of the field is updated.
+     * By default, no flow grid is used and vector values are interpolated on the mesh.
+     */
+    void setFlowGridCache( const std::shared_ptr<QgsMeshVectorFlowGridCache> &cache, const QgsMeshDatasetIndex &datasetIndex );
+
     //! Assignment operator
     QgsMeshStreamField &operator=( const QgsMeshStreamField &other );
 
@@ -264,6 +378,8 @@ class QgsMeshStreamField
 
   private:
     QgsPointXY positionToMapCoordinates( const QPoint &pixelPosition, const QgsPointXY &positionInPixel );
+    void updateFlowGrid( const QgsRectangle &interestZoneExtent, const QgsRectangle &layerExtent );
+    QgsVector vectorValue( const QgsPointXY &mapPosition ) const;
     bool addPixelToChunkTrace( QPoint &pixel,
                                QgsMeshStreamField::FieldData &data,
                                std::list<QPair<QPoint, QgsMeshStreamField::FieldData> > &chunkTrace );
@@ -291,6 +407,10 @@ class QgsMeshStreamField
     int mPixelFillingCount = 0;
     int mMaxPixelFillingCount = 0;
     std::unique_ptr<QgsMeshVectorValueInterpolator> mVectorValueInterpolator;
+    std::shared_ptr<QgsMeshVectorFlowGridCache> mFlowGridCache;
+    QgsMeshDatasetIndex mDatasetIndex;
+    int mTriangleCount = 0;
+    std::shared_ptr<const QgsMeshVectorFlowGrid> mFlowGrid;
     QgsRectangle mLayerExtent;
     QgsRectangle mMapExtent;
     QPoint mFieldTopLeftInDeviceCoordinates;
@@ -494,7 +614,9 @@ class QgsMeshVectorStreamlineRenderer: public QgsMeshVectorRenderer
                                      const QgsMeshRendererVectorSettings &settings,
                                      QgsRenderContext &rendererContext,
                                      const QgsRectangle &layerExtent,
-                                     double magMax );
+                                     double magMax,
+                                     const std::shared_ptr<QgsMeshVectorFlowGridCache> &flowGridCache = nullptr,
+                                     const QgsMeshDatasetIndex &datasetIndex = QgsMeshDatasetIndex() );
 
     void draw() override;
 
@@ -452,7 +452,9 @@ QgsMeshVectorRenderer *QgsMeshVectorRenderer::makeVectorRenderer( const QgsTrian
     const QgsMeshRendererVectorSettings &settings,
     QgsRenderContext &context,
     const QgsRectangle &layerExtent,
-    QSize size )
+    QSize size,
+    const std::shared_ptr<QgsMeshVectorFlowGridCache> &flowGridCache,
+    const QgsMeshDatasetIndex &datasetIndex )
 {
   QgsMeshVectorRenderer *renderer = nullptr;
 
@@ -478,7 +480,9 @@ QgsMeshVectorRenderer *QgsMeshVectorRenderer::makeVectorRenderer( const QgsTrian
         settings,
         context,
         layerExtent,
-        datasetMagMaximumValue );
+        datasetMagMaximumValue,
+        flowGridCache,
+        datasetIndex );
       break;
   }
 
@@ -23,6 +23,7 @@
 
 #include <QVector>
 #include <QSize>
+#include <memory>
 
 #include "qgis_core.h"
 #include "qgsmeshdataprovider.h"
@@ -31,6 +32,7 @@
 #include "qgspointxy.h"
 
 class QgsRenderContext;
+class QgsMeshVectorFlowGridCache;
 
 ///@cond PRIVATE
 
@@ -48,7 +50,11 @@ class QgsMeshVectorRenderer
 
     virtual void draw() = 0;
 
-    //! Vector renderer factory. The returned renderer type depend on the settings
+    /**
+     * Vector renderer factory. The returned renderer type depend on the settings.
+     * Streamlines of datasets defined on vertices are traced on flow grids of the dataset with \a datasetIndex
+     * from \a flowGridCache (since QGIS 3.12).
+     */
     static QgsMeshVectorRenderer *makeVectorRenderer(
       const QgsTriangularMesh &m,
       const QgsMeshDataBlock &datasetVectorValues,
@@ -60,7 +66,9 @@ class QgsMeshVectorRenderer
       const QgsMeshRendererVectorSettings &settings,
       QgsRenderContext &context,
       const QgsRectangle &layerExtent,
-      QSize size );
+      QSize size,
+      const std::shared_ptr<QgsMeshVectorFlowGridCache> &flowGridCache = nullptr,
+      const QgsMeshDatasetIndex &datasetIndex = QgsMeshDatasetIndex() );
 };
 
 /**
@@ -17,6 +17,8 @@
 
 #include <memory>
 #include <QList>
+#include <QThread>
+#include <QtConcurrentMap>
 #include "qgspolygon.h"
 #include "qgslinestring.h"
 #include "qgstriangularmesh.h"
@@ -27,6 +29,62 @@
 #include "qgslogger.h"
 #include "qgsmeshspatialindex.h"
 
+//! Number of vertices or faces processed by a single job of the parallel update
+static const int UPDATE_CHUNK_SIZE = 16384;
+
+/**
+ * Splits range [0, count) to chunks of at most UPDATE_CHUNK_SIZE items and calls
+ * \a func( first, last ) for each chunk, in parallel for large ranges.
+ */
+template<typename Func>
+static void processInChunks( int count, const Func &func )
+{
+  if ( count <= UPDATE_CHUNK_SIZE || QThread::idealThreadCount() < 2 )
+  {
+    if ( count > 0 )
+      func( 0, count );
+    return;
+  }
+
+  std::vector<std::pair<int, int>> chunks;
+  chunks.reserve( static_cast<size_t>( count / UPDATE_CHUNK_SIZE + 1 ) );
+  for ( int first = 0; first < count; first += UPDATE_CHUNK_SIZE )
+    chunks.emplace_back( first, std::min( first + UPDATE_CHUNK_SIZE, count ) );
+
+  QtConcurrent::blockingMap( chunks, [&func]( const std::pair<int, int> &chunk )
+  {
+    func( chunk.first, chunk.second );
+  } );
+}
+
+//! Returns number of triangles created from a native face by ear clipping
+static int triangleCount( const QgsMeshFace &face )
+{
+  return std::max( 0, face.size() - 2 );
+}
+
+/**
+ * Triangulates native \a face to the preallocated \a triangles and writes \a nativeIndex
+ * to the same number of items of \a trianglesToNativeFaces
+ */
+static void triangulateFace( const QgsMeshFace &face, int nativeIndex, QgsMeshFace *triangles, int *trianglesToNativeFaces )
+{
+  int vertexCount = face.size();
+  if ( vertexCount < 3 )
+    return;
+
+  while ( vertexCount > 3 )
+  {
+    // clip one ear from last 2 and first vertex
+    *triangles++ = { face[vertexCount - 2], face[vertexCount - 1], face[0] };
+    *trianglesToNativeFaces++ = nativeIndex;
+    --vertexCount;
+  }
+
+  *triangles = { face[1], face[2], face[0] };
+  *trianglesToNativeFaces = nativeIndex;
+}
+
 static void ENP_centroid_step( const QPolygonF &pX, double &cx, double &cy, double &signedArea, int i, int i1 )
 {
   double x0 = 0.0; // Current vertex X
@@ -74,22 +132,14 @@ static void ENP_centroid( const QPolygonF &pX, double &cx, double &cy )
 
 void QgsTriangularMesh::triangulate( const QgsMeshFace &face, int nativeIndex )
 {
-  int vertexCount = face.size();
-  if ( vertexCount < 3 )
+  const int count = triangleCount( face );
+  if ( count == 0 )
     return;
 
-  while ( vertexCount > 3 )
-  {
-    // clip one ear from last 2 and first vertex
-    const QgsMeshFace ear = { face[vertexCount - 2], face[vertexCount - 1], face[0] };
-    mTriangularMesh.faces.push_back( ear );
-    mTrianglesToNativeFaces.push_back( nativeIndex );
-    --vertexCount;
-  }
-
-  const QgsMeshFace triangle = { face[1], face[2], face[0] };
-  mTriangularMesh.faces.push_back( triangle );
-  mTrianglesToNativeFaces.push_back( nativeIndex );
+  const int offset = mTriangularMesh.faces.size();
+  mTriangularMesh.faces.resize( offset + count );
+  mTrianglesToNativeFaces.resize( offset + count );
+  triangulateFace( face, nativeIndex, mTriangularMesh.faces.data() + offset, mTrianglesToNativeFaces.data() + offset );
 }
 
 QgsTriangularMesh::~QgsTriangularMesh() = default;
@@ -107,69 +157,134 @@ void QgsTriangularMesh::update( QgsMesh *nativeMesh, QgsRenderContext *context )
        mCoordinateTransform.destinationCrs() == context->coordinateTransform().destinationCrs() )
     return;
 
-  // CLEAN-UP
-  mTriangularMesh.vertices.clear();
-  mTriangularMesh.faces.clear();
-  mTrianglesToNativeFaces.clear();
-  mNativeMeshFaceCentroids.clear();
+  // the triangulation only depends on the native faces - when the mesh itself did not change
+  // (e.g. only the destination CRS of the map did), it is enough to re-project the vertices
+  const bool reuseTriangulation = mTriangularMesh.vertices.size() == nativeMesh->vertices.size() &&
+                                  mNativeMeshFaceCentroids.size() == nativeMesh->faces.size();
 
-  // TRANSFORM VERTICES
   mCoordinateTransform = context->coordinateTransform();
-  mTriangularMesh.vertices.resize( nativeMesh->vertices.size() );
-  for ( int i = 0; i < nativeMesh->vertices.size(); ++i )
+  transformVertices( *nativeMesh );
+
+  if ( !reuseTriangulation )
+    triangulateFaces( *nativeMesh );
+
+  calculateCentroids( *nativeMesh );
+
+  // CALCULATE SPATIAL INDEX
+  mSpatialIndex = QgsMeshSpatialIndex( mTriangularMesh );
+}
+
+void QgsTriangularMesh::transformVertices( const QgsMesh &nativeMesh )
+{
+  const QVector<QgsMeshVertex> &nativeVertices = nativeMesh.vertices;
+  mTriangularMesh.vertices.resize( nativeVertices.size() );
+  QgsMeshVertex *mapVertices = mTriangularMesh.vertices.data();
+
+  if ( !mCoordinateTransform.isValid() )
+  {
+    std::copy( nativeVertices.constBegin(), nativeVertices.constEnd(), mapVertices );
+    return;
+  }
+
+  processInChunks( nativeVertices.size(), [&]( int first, int last )
   {
-    const QgsMeshVertex &vertex = nativeMesh->vertices.at( i );
-    if ( mCoordinateTransform.isValid() )
+    // each job uses its own copy of the transform - copies are safe to use from another thread
+    const QgsCoordinateTransform transform( mCoordinateTransform );
+    const int count = last - first;
+    QVector<double> x( count ), y( count ), z( count, 0.0 );
+    for ( int i = 0; i < count; ++i )
     {
-      try
-      {
-        QgsPointXY mapPoint = mCoordinateTransform.transform( QgsPointXY( vertex.x(), vertex.y() ) );
-        QgsMeshVertex mapVertex( mapPoint );
-        mapVertex.addZValue( vertex.z() );
-        mapVertex.setM( vertex.m() );
-        mTriangularMesh.vertices[i] = mapVertex;
-      }
-      catch ( QgsCsException &cse )
-      {
-        Q_UNUSED( cse )
-        QgsDebugMsg( QStringLiteral( "Caught CRS exception %1" ).arg( cse.what() ) );
-        mTriangularMesh.vertices[i] = vertex;
-      }
+      const QgsMeshVertex &vertex = nativeVertices.at( first + i );
+      x[i] = vertex.x();
+      y[i] = vertex.y();
     }
-    else
+
+    bool transformed = true;
+    try
     {
-      mTriangularMesh.vertices[i] = vertex;
+      transform.transformCoords( count, x.data(), y.data(), z.data() );
     }
-  }
+    catch ( QgsCsException & )
+    {
+      transformed = false;
+    }
+
+    for ( int i = 0; i < count; ++i )
+    {
+      const QgsMeshVertex &vertex = nativeVertices.at( first + i );
+      QgsPointXY mapPoint( x[i], y[i] );
+      if ( !transformed )
+      {
+        // some of the vertices could not be transformed - transform them one by one
+        // and keep the native coordinates of those which fail
+        try
+        {
+          mapPoint = transform.transform( QgsPointXY( vertex.x(), vertex.y() ) );
+        }
+        catch ( QgsCsException &cse )
+        {
+          Q_UNUSED( cse )
+          QgsDebugMsg( QStringLiteral( "Caught CRS exception %1" ).arg( cse.what() ) );
+          mapVertices[first + i] = vertex;
+          continue;
+        }
+      }
+      QgsMeshVertex mapVertex( mapPoint );
+      mapVertex.addZValue( vertex.z() );
+      mapVertex.setM( vertex.m() );
+      mapVertices[first + i] = mapVertex;
+    }
+  } );
+}
 
-  // CREATE TRIANGULAR MESH
-  for ( int i = 0; i < nativeMesh->faces.size(); ++i )
+void QgsTriangularMesh::triangulateFaces( const QgsMesh &nativeMesh )
+{
+  const QVector<QgsMeshFace> &nativeFaces = nativeMesh.faces;
+
+  // offsets of the first triangle of each native face, so that faces can be triangulated
+  // independently while keeping the same order of triangles as a sequential triangulation
+  QVector<int> offsets( nativeFaces.size() + 1 );
+  offsets[0] = 0;
+  for ( int i = 0; i < nativeFaces.size(); ++i )
+    offsets[i + 1] = offsets[i] + triangleCount( nativeFaces.at( i ) );
+
+  const int trianglesCount = offsets.last();
+  mTriangularMesh.faces.clear();
+  mTriangularMesh.faces.resize( trianglesCount );
+  mTrianglesToNativeFaces.clear();
+  mTrianglesToNativeFaces.resize( trianglesCount );
+  QgsMeshFace *triangles = mTriangularMesh.faces.data();
+  int *trianglesToNativeFaces = mTrianglesToNativeFaces.data();
+
+  processInChunks( nativeFaces.size(), [&]( int first, int last )
   {
-    const QgsMeshFace &face = nativeMesh->faces.at( i ) ;
-    triangulate( face, i );
-  }
+    for ( int i = first; i < last; ++i )
+      triangulateFace( nativeFaces.at( i ), i, triangles + offsets.at( i ), trianglesToNativeFaces + offsets.at( i ) );
+  } );
+}
+
+void QgsTriangularMesh::calculateCentroids( const QgsMesh &nativeMesh )
+{
+  const QVector<QgsMeshFace> &nativeFaces = nativeMesh.faces;
+  const QVector<QgsMeshVertex> &mapVertices = mTriangularMesh.vertices; // we need projected vertices
+  mNativeMeshFaceCentroids.resize( nativeFaces.size() );
+  QgsMeshVertex *centroids = mNativeMeshFaceCentroids.data();
 
-  // CALCULATE CENTROIDS
-  mNativeMeshFaceCentroids.resize( nativeMesh->faces.size() );
-  for ( int i = 0; i < nativeMesh->faces.size(); ++i )
+  processInChunks( nativeFaces.size(), [&]( int first, int last )
   {
-    const QgsMeshFace &face = nativeMesh->faces.at( i ) ;
-    QVector<QPointF> points;
-    points.reserve( face.size() );
-    for ( int j = 0; j < face.size(); ++j )
+    QPolygonF poly;
+    for ( int i = first; i < last; ++i )
     {
-      int index = face.at( j );
-      const QgsMeshVertex &vertex = mTriangularMesh.vertices[index]; // we need projected vertices
-      points.push_back( vertex.toQPointF() );
+      const QgsMeshFace &face = nativeFaces.at( i );
+      poly.resize( face.size() );
+      for ( int j = 0; j < face.size(); ++j )
+        poly[j] = mapVertices.at( face.at( j ) ).toQPointF();
+
+      double cx, cy;
+      ENP_centroid( poly, cx, cy );
+      centroids[i] = QgsMeshVertex( cx, cy );
     }
-    QPolygonF poly( points );
-    double cx, cy;
-    ENP_centroid( poly, cx, cy );
-    mNativeMeshFaceCentroids[i] = QgsMeshVertex( cx, cy );
-  }
-
-  // CALCULATE SPATIAL INDEX
-  mSpatialIndex = QgsMeshSpatialIndex( mTriangularMesh );
+  } );
 }
 
 const QVector<QgsMeshVertex> &QgsTriangularMesh::vertices() const
@@ -53,6 +53,11 @@ class CORE_EXPORT QgsTriangularMesh
 
     /**
      * Constructs triangular mesh from layer's native mesh and context. Populates spatial index.
+     *
+     * Vertices are transformed and faces triangulated in parallel for large meshes. When only
+     * the coordinate transform changed since the last update, the triangulation is kept and
+     * only the vertices, centroids and spatial index are updated.
+     *
      * \param nativeMesh QgsMesh to access native vertices and faces
      * \param context Rendering context to estimate number of triagles to create for an face
     */
@@ -121,6 +126,15 @@ class CORE_EXPORT QgsTriangularMesh
      */
     void triangulate( const QgsMeshFace &face, int nativeIndex );
 
+    //! Transforms native vertices to the map CRS with mCoordinateTransform
+    void transformVertices( const QgsMesh &nativeMesh );
+
+    //! Triangulates all native faces, keeping the order of triangles of the native faces
+    void triangulateFaces( const QgsMesh &nativeMesh );
+
+    //! Calculates centroids of native faces from vertices in the map CRS
+    void calculateCentroids( const QgsMesh &nativeMesh );
+
     // vertices: map CRS; 0-N ... native vertices, N+1 - len ... extra vertices
     // faces are derived triangles
     QgsMesh mTriangularMesh;
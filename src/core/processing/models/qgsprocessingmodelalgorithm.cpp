@@ -27,9 +27,16 @@
 #include "qgsapplication.h"
 #include "qgsprocessingparametertype.h"
 #include "qgsexpressioncontextutils.h"
+#include "qgsprocessingbufferedfeedback_p.h"
+#include "qgsprocessingfeaturepipe_p.h"
+#include "qgsmessagelog.h"
 
 #include <QFile>
 #include <QTextStream>
+#include <QtConcurrentRun>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadPool>
 
 ///@cond NOT_STABLE
 
@@ -236,6 +243,196 @@ bool QgsProcessingModelAlgorithm::childOutputIsRequired( const QString &childId,
   return false;
 }
 
+///@cond PRIVATE
+
+/**
+ * Returns TRUE if a child algorithm parameter \a value refers to a layer which is owned
+ * by the \a context's temporary layer store, e.g. an in-memory output of another child
+ * algorithm. These layers are bound to the model's thread and cannot be accessed from
+ * a child algorithm running in a background thread.
+ */
+static bool refersToTemporaryLayer( const QVariant &value, QgsProcessingContext &context )
+{
+  if ( value.canConvert<QgsProcessingFeatureSourceDefinition>() )
+    return refersToTemporaryLayer( value.value<QgsProcessingFeatureSourceDefinition>().source.staticValue(), context );
+  else if ( value.canConvert<QgsProperty>() )
+    return refersToTemporaryLayer( value.value<QgsProperty>().staticValue(), context );
+  else if ( value.type() == QVariant::List || value.type() == QVariant::StringList )
+  {
+    const QVariantList values = value.toList();
+    for ( const QVariant &v : values )
+    {
+      if ( refersToTemporaryLayer( v, context ) )
+        return true;
+    }
+    return false;
+  }
+  else if ( qobject_cast< QgsMapLayer * >( qvariant_cast<QObject *>( value ) ) )
+  {
+    // layer objects cannot be safely shared with another thread
+    return true;
+  }
+  else if ( value.type() != QVariant::String )
+    return false;
+
+  const QString string = value.toString();
+  if ( string.isEmpty() )
+    return false;
+
+  const QMap< QString, QgsMapLayer * > layers = context.temporaryLayerStore()->mapLayers();
+  for ( QgsMapLayer *layer : layers )
+  {
+    if ( layer->id() == string )
+      return true;
+
+    // memory layers can't be reopened from their source, so they can only be used from the store
+    if ( layer->providerType() == QLatin1String( "memory" ) && ( layer->name() == string || layer->source() == string ) )
+      return true;
+  }
+  return false;
+}
+
+/**
+ * State of a model child algorithm which is executed in a background thread.
+ */
+struct QgsProcessingModelBackgroundChild
+{
+  std::unique_ptr< QgsProcessingAlgorithm > algorithm;
+  std::unique_ptr< QgsProcessingContext > context;
+  std::unique_ptr< QgsProcessingBufferedFeedback > feedback;
+  QVariantMap parameters;
+  QVariantMap results;
+  bool ok = false;
+  QTime time;
+  QFuture< void > future;
+  //! Pipe streaming the child's input features from another child, if any
+  std::shared_ptr< QgsProcessingFeaturePipe > inputPipe;
+  //! Pipe streaming the child's output features to another child, if any
+  std::shared_ptr< QgsProcessingFeaturePipe > outputPipe;
+};
+
+/**
+ * Child algorithms currently executing in background threads. On destruction all
+ * children still running are canceled and waited for, so that no worker outlives the
+ * model execution (e.g. when another child throws an exception).
+ */
+struct QgsProcessingModelBackgroundChildren
+{
+  ~QgsProcessingModelBackgroundChildren()
+  {
+    // wake up children blocked on a pipe whose other end will never be read or written
+    for ( const std::shared_ptr< QgsProcessingFeaturePipe > &pipe : qgis::as_const( pipes ) )
+    {
+      pipe->abort();
+      pipe->close();
+    }
+    for ( auto &it : running )
+    {
+      it.second->feedback->cancel();
+      it.second->future.waitForFinished();
+    }
+  }
+
+  std::map< QString, std::unique_ptr< QgsProcessingModelBackgroundChild > > running;
+
+  //! Pipes streaming features between children, by producing child ID
+  QMap< QString, std::shared_ptr< QgsProcessingFeaturePipe > > pipes;
+
+  //! Protects finished
+  QMutex mutex;
+  QWaitCondition condition;
+  //! IDs of children which have completed executing, but have not yet been post processed
+  QStringList finished;
+};
+
+/**
+ * Returns the child algorithms which can stream features from the child algorithm they
+ * depend on, instead of reading an intermediate layer, as a map of consuming child ID to
+ * producing child ID.
+ *
+ * Both children must be feature based algorithms, the consumer must read its INPUT from
+ * the producer's OUTPUT and depend on no other child, and the producer's output must not
+ * be used elsewhere (including as a model output).
+ */
+static QMap< QString, QString > streamableChildAlgorithms( const QMap< QString, QgsProcessingModelChildAlgorithm > &children, const QSet< QString > &toExecute )
+{
+  auto isStreamable = []( const QgsProcessingModelChildAlgorithm & child )
+  {
+    return dynamic_cast< const QgsProcessingFeatureBasedAlgorithm * >( child.algorithm() )
+           && !( child.algorithm()->flags() & QgsProcessingAlgorithm::FlagNoThreading );
+  };
+
+  // count direct references to each child
+  QMap< QString, int > references;
+  for ( const QString &childId : toExecute )
+  {
+    const QgsProcessingModelChildAlgorithm &child = children[ childId ];
+    const QStringList dependencies = child.dependencies();
+    for ( const QString &dependency : dependencies )
+      references[ dependency ]++;
+
+    const QMap< QString, QgsProcessingModelChildParameterSources > sources = child.parameterSources();
+    for ( auto it = sources.constBegin(); it != sources.constEnd(); ++it )
+    {
+      for ( const QgsProcessingModelChildParameterSource &source : it.value() )
+      {
+        if ( source.source() == QgsProcessingModelChildParameterSource::ChildOutput )
+          references[ source.outputChildId() ]++;
+      }
+    }
+  }
+
+  QMap< QString, QString > streamable;
+  for ( const QString &childId : toExecute )
+  {
+    const QgsProcessingModelChildAlgorithm &child = children[ childId ];
+    if ( !isStreamable( child ) || !child.dependencies().isEmpty() )
+      continue;
+
+    const QgsProcessingParameterDefinition *inputDefinition = child.algorithm()->parameterDefinition( QStringLiteral( "INPUT" ) );
+    if ( !inputDefinition || inputDefinition->type() != QgsProcessingParameterFeatureSource::typeName() )
+      continue;
+
+    const QgsProcessingModelChildParameterSources inputSources = child.parameterSources().value( QStringLiteral( "INPUT" ) );
+    if ( inputSources.size() != 1 || inputSources.at( 0 ).source() != QgsProcessingModelChildParameterSource::ChildOutput
+         || inputSources.at( 0 ).outputName() != QLatin1String( "OUTPUT" ) )
+      continue;
+
+    const QString producerId = inputSources.at( 0 ).outputChildId();
+    if ( !toExecute.contains( producerId ) || references.value( producerId ) != 1 || !isStreamable( children[ producerId ] ) )
+      continue;
+
+    // the consumer must not take any other parameters from a child algorithm
+    bool otherChildSources = false;
+    const QMap< QString, QgsProcessingModelChildParameterSources > sources = child.parameterSources();
+    for ( auto it = sources.constBegin(); it != sources.constEnd() && !otherChildSources; ++it )
+    {
+      for ( const QgsProcessingModelChildParameterSource &source : it.value() )
+      {
+        if ( source.source() == QgsProcessingModelChildParameterSource::ChildOutput && source.outputChildId() != producerId )
+          otherChildSources = true;
+      }
+    }
+    if ( otherChildSources )
+      continue;
+
+    bool isModelOutput = false;
+    const QMap< QString, QgsProcessingModelOutput > outputs = children[ producerId ].modelOutputs();
+    for ( const QgsProcessingModelOutput &output : outputs )
+    {
+      if ( output.childOutputName() == QLatin1String( "OUTPUT" ) )
+        isModelOutput = true;
+    }
+    if ( isModelOutput )
+      continue;
+
+    streamable.insert( childId, producerId );
+  }
+  return streamable;
+}
+
+///@endcond
+
 QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
   QSet< QString > toExecute;
@@ -255,24 +452,83 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
   QVariantMap childResults;
   QVariantMap finalResults;
   QSet< QString > executed;
-  bool executedAlg = true;
-  while ( executedAlg && executed.count() < toExecute.count() )
+
+  auto childCompleted = [&]( const QgsProcessingModelChildAlgorithm & child, const QVariantMap & results, const QTime & childTime, const QVariantMap & profile )
   {
-    executedAlg = false;
+    const QString childId = child.childId();
+    childResults.insert( childId, results );
+
+    // look through child alg's outputs to determine whether any of these should be copied
+    // to the final model outputs
+    QMap<QString, QgsProcessingModelOutput> outputs = child.modelOutputs();
+    QMap<QString, QgsProcessingModelOutput>::const_iterator outputIt = outputs.constBegin();
+    for ( ; outputIt != outputs.constEnd(); ++outputIt )
+    {
+      finalResults.insert( childId + ':' + outputIt->name(), results.value( outputIt->childOutputName() ) );
+    }
+
+    executed.insert( childId );
+    modelFeedback.setCurrentStep( executed.count() );
+    if ( feedback )
+    {
+      feedback->pushInfo( QObject::tr( "OK. Execution took %1 s (%2 outputs)." ).arg( childTime.elapsed() / 1000.0 ).arg( results.count() ) );
+      if ( !profile.isEmpty() )
+      {
+        QVariantMap childProfile = profile;
+        childProfile.insert( QStringLiteral( "child_id" ), childId );
+        feedback->reportProfile( childProfile );
+      }
+    }
+  };
+
+  // children which do not depend on each other are executed concurrently in background threads,
+  // while children which cannot be moved to another thread are run directly on the model's thread.
+  // Children streaming features to each other must all be running at the same time, so the pool
+  // is allowed to grow up to one thread per child
+  QThreadPool pool;
+  pool.setMaxThreadCount( std::max( QThread::idealThreadCount(), toExecute.count() ) );
+  QgsProcessingModelBackgroundChildren background;
+
+  // the model's progress includes the progress of all children running in the background
+  auto reportBackgroundChildren = [&]
+  {
+    if ( !feedback )
+      return;
+
+    double childrenProgress = 0;
+    for ( const auto &it : background.running )
+    {
+      it.second->feedback->flush( feedback );
+      childrenProgress += it.second->feedback->lastProgress() / 100.0;
+    }
+    feedback->setProgress( 100.0 * ( executed.count() + childrenProgress ) / toExecute.count() );
+  };
+
+  // consuming child ID to producing child ID, for chains of feature based algorithms which
+  // stream features from one to the next instead of creating intermediate layers
+  const QMap< QString, QString > streamedInputs = streamableChildAlgorithms( mChildAlgorithms, toExecute );
+  QMap< QString, QString > streamedOutputs;
+  for ( auto it = streamedInputs.constBegin(); it != streamedInputs.constEnd(); ++it )
+    streamedOutputs.insert( it.value(), it.key() );
+
+  while ( executed.count() < toExecute.count() )
+  {
+    bool startedAlg = false;
     const auto constToExecute = toExecute;
     for ( const QString &childId : constToExecute )
     {
       if ( feedback && feedback->isCanceled() )
         break;
 
-      if ( executed.contains( childId ) )
+      if ( executed.contains( childId ) || background.running.count( childId ) )
         continue;
 
       bool canExecute = true;
       const auto constDependsOnChildAlgorithms = dependsOnChildAlgorithms( childId );
       for ( const QString &dependency : constDependsOnChildAlgorithms )
       {
-        if ( !executed.contains( dependency ) )
+        // features streamed from a dependency can be read as soon as it has started
+        if ( !executed.contains( dependency ) && !background.pipes.contains( dependency ) )
         {
           canExecute = false;
           break;
@@ -282,7 +538,7 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
       if ( !canExecute )
         continue;
 
-      executedAlg = true;
+      startedAlg = true;
       if ( feedback )
         feedback->pushDebugInfo( QObject::tr( "Prepare algorithm: %1" ).arg( childId ) );
 
@@ -291,17 +547,19 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
       QgsExpressionContext expContext = baseContext;
       expContext << QgsExpressionContextUtils::processingAlgorithmScope( child.algorithm(), parameters, context )
                  << createExpressionContextScopeForChildAlgorithm( childId, context, parameters, childResults );
-      context.setExpressionContext( expContext );
 
       QVariantMap childParams = parametersForChildAlgorithm( child, parameters, childResults, expContext );
       if ( feedback )
-        feedback->setProgressText( QObject::tr( "Running %1 [%2/%3]" ).arg( child.description() ).arg( executed.count() + 1 ).arg( toExecute.count() ) );
+        feedback->setProgressText( QObject::tr( "Running %1 [%2/%3]" ).arg( child.description() ).arg( executed.count() + static_cast< int >( background.running.size() ) + 1 ).arg( toExecute.count() ) );
 
       QStringList params;
+      bool canRunInBackground = !( child.algorithm()->flags() & QgsProcessingAlgorithm::FlagNoThreading );
       for ( auto childParamIt = childParams.constBegin(); childParamIt != childParams.constEnd(); ++childParamIt )
       {
         params << QStringLiteral( "%1: %2" ).arg( childParamIt.key(),
                child.algorithm()->parameterDefinition( childParamIt.key() )->valueAsPythonString( childParamIt.value(), context ) );
+        if ( canRunInBackground && refersToTemporaryLayer( childParamIt.value(), context ) )
+          canRunInBackground = false;
       }
 
       if ( feedback )
@@ -313,10 +571,110 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
       QTime childTime;
       childTime.start();
 
+      const std::shared_ptr< QgsProcessingFeaturePipe > inputPipe = background.pipes.value( streamedInputs.value( childId ) );
+      if ( canRunInBackground )
+      {
+        std::unique_ptr< QgsProcessingModelBackgroundChild > backgroundChild = qgis::make_unique< QgsProcessingModelBackgroundChild >();
+        backgroundChild->time = childTime;
+        backgroundChild->inputPipe = inputPipe;
+        if ( streamedOutputs.contains( childId ) )
+        {
+          // stream the output to the consuming child instead of writing it to an intermediate layer
+          backgroundChild->outputPipe = QgsProcessingFeaturePipe::create();
+          childParams.insert( QStringLiteral( "OUTPUT" ), backgroundChild->outputPipe->uri() );
+          if ( feedback )
+            feedback->pushDebugInfo( QObject::tr( "Streaming output features to %1" ).arg( streamedOutputs.value( childId ) ) );
+        }
+        backgroundChild->parameters = childParams;
+        backgroundChild->algorithm.reset( child.algorithm()->create( child.configuration() ) );
+
+        // messages are collected and replayed from this thread while the model waits for children
+        // to complete, so that messages of concurrently running children are not interleaved line by line
+        backgroundChild->feedback = qgis::make_unique< QgsProcessingBufferedFeedback >();
+        if ( feedback )
+          QObject::connect( feedback, &QgsFeedback::canceled, backgroundChild->feedback.get(), &QgsFeedback::cancel, Qt::DirectConnection );
+
+        // each child gets its own context, so that results from concurrent children can be
+        // collected independently before being merged into the model's context
+        backgroundChild->context = qgis::make_unique< QgsProcessingContext >();
+        backgroundChild->context->copyThreadSafeSettings( context );
+        backgroundChild->context->setExpressionContext( expContext );
+        backgroundChild->context->setFeedback( backgroundChild->feedback.get() );
+
+        if ( !backgroundChild->algorithm->prepare( childParams, *backgroundChild->context, backgroundChild->feedback.get() ) )
+        {
+          backgroundChild->feedback->flush( feedback );
+          QString error = QObject::tr( "Error encountered while running %1" ).arg( child.description() );
+          if ( feedback )
+            feedback->reportError( error );
+          throw QgsProcessingException( error );
+        }
+
+        QgsProcessingModelBackgroundChild *runningChild = backgroundChild.get();
+        if ( runningChild->outputPipe )
+        {
+          background.pipes.insert( childId, runningChild->outputPipe );
+          // the consumer reads the pipe's URI as the producer's output
+          QVariantMap pipeResults;
+          pipeResults.insert( QStringLiteral( "OUTPUT" ), runningChild->outputPipe->uri() );
+          childResults.insert( childId, pipeResults );
+        }
+        background.running[ childId ] = std::move( backgroundChild );
+        runningChild->future = QtConcurrent::run( &pool, [runningChild, childId, &background]
+        {
+          try
+          {
+            runningChild->results = runningChild->algorithm->runPrepared( runningChild->parameters, *runningChild->context, runningChild->feedback.get() );
+            runningChild->ok = true;
+          }
+          catch ( QgsProcessingException &e )
+          {
+            QgsMessageLog::logMessage( e.what(), QObject::tr( "Processing" ), Qgis::Critical );
+            runningChild->feedback->reportError( e.what() );
+          }
+
+          // make sure the other end of any pipe is not left waiting, e.g. if the child failed
+          if ( runningChild->outputPipe )
+            runningChild->outputPipe->close();
+          if ( runningChild->inputPipe )
+            runningChild->inputPipe->abort();
+
+          QMutexLocker locker( &background.mutex );
+          background.finished << childId;
+          background.condition.wakeAll();
+        } );
+        continue;
+      }
+
+      context.setExpressionContext( expContext );
+
+      // run the steps individually rather than calling run(), so that the child's profile can be reported
       bool ok = false;
+      QVariantMap results;
       std::unique_ptr< QgsProcessingAlgorithm > childAlg( child.algorithm()->create( child.configuration() ) );
-      QVariantMap results = childAlg->run( childParams, context, &modelFeedback, &ok, child.configuration() );
+      if ( childAlg->prepare( childParams, context, &modelFeedback ) )
+      {
+        try
+        {
+          results = childAlg->runPrepared( childParams, context, &modelFeedback );
+          ok = true;
+        }
+        catch ( QgsProcessingException &e )
+        {
+          QgsMessageLog::logMessage( e.what(), QObject::tr( "Processing" ), Qgis::Critical );
+          modelFeedback.reportError( e.what() );
+        }
+      }
+      if ( ok )
+      {
+        QVariantMap ppRes = childAlg->postProcess( context, &modelFeedback );
+        if ( !ppRes.isEmpty() )
+          results = ppRes;
+      }
+      const QVariantMap childProfile = childAlg->profile();
       childAlg.reset( nullptr );
+      if ( inputPipe )
+        inputPipe->abort();
       if ( !ok )
       {
         QString error = QObject::tr( "Error encountered while running %1" ).arg( child.description() );
@@ -324,25 +682,59 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
           feedback->reportError( error );
         throw QgsProcessingException( error );
       }
-      childResults.insert( childId, results );
+      childCompleted( child, results, childTime, childProfile );
+    }
 
-      // look through child alg's outputs to determine whether any of these should be copied
-      // to the final model outputs
-      QMap<QString, QgsProcessingModelOutput> outputs = child.modelOutputs();
-      QMap<QString, QgsProcessingModelOutput>::const_iterator outputIt = outputs.constBegin();
-      for ( ; outputIt != outputs.constEnd(); ++outputIt )
+    if ( background.running.empty() )
+    {
+      if ( !startedAlg || ( feedback && feedback->isCanceled() ) )
+        break;
+      continue;
+    }
+
+    // wait until a background child completes, unless other children may have become ready in the meantime.
+    // Messages and progress of the running children are forwarded periodically while waiting
+    QStringList finished;
+    while ( true )
+    {
       {
-        finalResults.insert( childId + ':' + outputIt->name(), results.value( outputIt->childOutputName() ) );
+        QMutexLocker locker( &background.mutex );
+        if ( !startedAlg && background.finished.isEmpty() )
+          background.condition.wait( &background.mutex, 200 );
+        finished = background.finished;
+        background.finished.clear();
       }
-
-      executed.insert( childId );
-      modelFeedback.setCurrentStep( executed.count() );
-      if ( feedback )
-        feedback->pushInfo( QObject::tr( "OK. Execution took %1 s (%2 outputs)." ).arg( childTime.elapsed() / 1000.0 ).arg( results.count() ) );
+      reportBackgroundChildren();
+      if ( startedAlg || !finished.isEmpty() )
+        break;
     }
 
-    if ( feedback && feedback->isCanceled() )
-      break;
+    for ( const QString &childId : qgis::as_const( finished ) )
+    {
+      std::unique_ptr< QgsProcessingModelBackgroundChild > finishedChild = std::move( background.running[ childId ] );
+      background.running.erase( childId );
+      finishedChild->future.waitForFinished();
+
+      const QgsProcessingModelChildAlgorithm &child = mChildAlgorithms[ childId ];
+      QVariantMap results = finishedChild->results;
+      if ( finishedChild->ok )
+      {
+        QVariantMap ppRes = finishedChild->algorithm->postProcess( *finishedChild->context, finishedChild->feedback.get() );
+        if ( !ppRes.isEmpty() )
+          results = ppRes;
+        context.takeResultsFrom( *finishedChild->context );
+      }
+      finishedChild->feedback->flush( feedback );
+
+      if ( !finishedChild->ok )
+      {
+        QString error = QObject::tr( "Error encountered while running %1" ).arg( child.description() );
+        if ( feedback )
+          feedback->reportError( error );
+        throw QgsProcessingException( error );
+      }
+      childCompleted( child, results, finishedChild->time, finishedChild->algorithm->profile() );
+    }
   }
   if ( feedback )
     feedback->pushDebugInfo( QObject::tr( "Model processed OK. Executed %1 algorithms total in %2 s." ).arg( executed.count() ).arg( totalTime.elapsed() / 1000.0 ) );
@@ -29,7 +29,17 @@
 #include "qgsprocessingfeedback.h"
 #include "qgsmeshlayer.h"
 #include "qgsexpressioncontextutils.h"
+#include "qgsprocessingbufferedfeedback_p.h"
+#include "qgsprocessingprofiler_p.h"
 
+#include <QThread>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QtConcurrentMap>
+#include <atomic>
+
+
+QgsProcessingAlgorithm::QgsProcessingAlgorithm() = default;
 
 QgsProcessingAlgorithm::~QgsProcessingAlgorithm()
 {
@@ -444,6 +454,8 @@ QVariantMap QgsProcessingAlgorithm::run( const QVariantMap &parameters, QgsProce
     *ok = true;
 
   QVariantMap ppRes = alg->postProcess( context, feedback );
+  if ( feedback && !alg->profile().isEmpty() )
+    feedback->reportProfile( alg->profile() );
   if ( !ppRes.isEmpty() )
     return ppRes;
   else
@@ -454,9 +466,18 @@ bool QgsProcessingAlgorithm::prepare( const QVariantMap &parameters, QgsProcessi
 {
   Q_ASSERT_X( QThread::currentThread() == context.temporaryLayerStore()->thread(), "QgsProcessingAlgorithm::prepare", "prepare() must be called from the same thread as context was created in" );
   Q_ASSERT_X( !mHasPrepared, "QgsProcessingAlgorithm::prepare", "prepare() has already been called for the algorithm instance" );
+
+  if ( context.flags() & QgsProcessingContext::ProfileExecution )
+    mProfiler = qgis::make_unique< QgsProcessingProfiler >();
+  QgsProcessingProfiler::Scope profilerScope( mProfiler.get() );
+  QElapsedTimer timer;
+  timer.start();
+
   try
   {
     mHasPrepared = prepareAlgorithm( parameters, context, feedback );
+    if ( mProfiler )
+      mProfiler->setPrepareTime( timer.nsecsElapsed() );
     return mHasPrepared;
   }
   catch ( QgsProcessingException &e )
@@ -497,9 +518,16 @@ QVariantMap QgsProcessingAlgorithm::runPrepared( const QVariantMap &parameters,
     runContext = mLocalContext.get();
   }
 
+  // sources and sinks used by the algorithm record their timings in the profiler installed for this thread
+  QgsProcessingProfiler::Scope profilerScope( mProfiler.get() );
+  QElapsedTimer timer;
+  timer.start();
+
   try
   {
     QVariantMap runResults = processAlgorithm( parameters, *runContext, feedback );
+    if ( mProfiler )
+      mProfiler->setProcessTime( timer.nsecsElapsed() );
 
     mHasExecuted = true;
     if ( mLocalContext )
@@ -540,9 +568,20 @@ QVariantMap QgsProcessingAlgorithm::postProcess( QgsProcessingContext &context,
   }
 
   mHasPostProcessed = true;
+  QgsProcessingProfiler::Scope profilerScope( mProfiler.get() );
+  QElapsedTimer timer;
+  timer.start();
   try
   {
-    return postProcessAlgorithm( context, feedback );
+    QVariantMap results = postProcessAlgorithm( context, feedback );
+    if ( mProfiler )
+    {
+      mProfiler->setPostProcessTime( timer.nsecsElapsed() );
+      mProfile = mProfiler->report();
+      mProfile.insert( QStringLiteral( "algorithm" ), id() );
+      mProfiler.reset();
+    }
+    return results;
   }
   catch ( QgsProcessingException &e )
   {
@@ -552,6 +591,11 @@ QVariantMap QgsProcessingAlgorithm::postProcess( QgsProcessingContext &context,
   }
 }
 
+QVariantMap QgsProcessingAlgorithm::profile() const
+{
+  return mProfile;
+}
+
 QString QgsProcessingAlgorithm::parameterAsString( const QVariantMap &parameters, const QString &name, const QgsProcessingContext &context ) const
 {
   return QgsProcessingParameters::parameterAsString( parameterDefinition( name ), parameters, context );
@@ -907,6 +951,109 @@ QgsCoordinateReferenceSystem QgsProcessingFeatureBasedAlgorithm::sourceCrs() con
     return QgsCoordinateReferenceSystem();
 }
 
+///@cond PRIVATE
+
+//! Consecutive input features processed by one worker thread
+struct QgsProcessingFeatureChunk
+{
+  QgsFeatureList features;
+  //! Output of processFeature() for each processed input feature
+  QVector< QgsFeatureList > results;
+  QString error;
+  std::unique_ptr< QgsProcessingContext > context;
+  std::unique_ptr< QgsProcessingBufferedFeedback > feedback;
+};
+
+///@endcond
+
+void QgsProcessingFeatureBasedAlgorithm::processFeaturesInParallel( QgsProcessingFeatureBasedAlgorithm *algorithm, QgsFeatureIterator &iterator, QgsFeatureSink &sink, long count,
+    QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+{
+  // features are read in batches of chunks, every chunk is processed by a single thread using its own copy of the context.
+  // Results are written to the sink on this thread, in the order of input features.
+  const int chunkSize = 32;
+  const int chunkCount = std::max( 1, QThread::idealThreadCount() ) * 4;
+
+  // progress is reported by the workers as soon as a feature is processed, messages are only forwarded
+  // with the output features
+  QMutex progressMutex;
+  std::atomic< long > processed( 0 );
+  const double step = count > 0 ? 100.0 / count : 1;
+  feedback->setProgress( 0 );
+
+  std::vector< QgsProcessingFeatureChunk > chunks( chunkCount );
+  for ( QgsProcessingFeatureChunk &chunk : chunks )
+  {
+    chunk.context = qgis::make_unique< QgsProcessingContext >();
+    chunk.context->copyThreadSafeSettings( context );
+    chunk.feedback = qgis::make_unique< QgsProcessingBufferedFeedback >();
+    chunk.feedback->forwardProgress( feedback, &progressMutex );
+    chunk.context->setFeedback( chunk.feedback.get() );
+    QObject::connect( feedback, &QgsFeedback::canceled, chunk.feedback.get(), &QgsFeedback::cancel, Qt::DirectConnection );
+  }
+
+  QgsFeature f;
+  bool finished = false;
+  while ( !finished && !feedback->isCanceled() )
+  {
+    int usedChunks = 0;
+    for ( ; usedChunks < chunkCount && !finished; ++usedChunks )
+    {
+      QgsProcessingFeatureChunk &chunk = chunks[ usedChunks ];
+      chunk.features.clear();
+      chunk.results.clear();
+      chunk.error.clear();
+      while ( chunk.features.size() < chunkSize )
+      {
+        if ( !iterator.nextFeature( f ) )
+        {
+          finished = true;
+          break;
+        }
+        chunk.features << f;
+      }
+    }
+    if ( chunks[ usedChunks - 1 ].features.isEmpty() )
+      usedChunks--;
+
+    QtConcurrent::blockingMap( chunks.begin(), chunks.begin() + usedChunks, [algorithm, &processed, step]( QgsProcessingFeatureChunk & chunk )
+    {
+      for ( const QgsFeature &feature : qgis::as_const( chunk.features ) )
+      {
+        if ( chunk.feedback->isCanceled() )
+          break;
+
+        chunk.context->expressionContext().setFeature( feature );
+        try
+        {
+          chunk.results << algorithm->processFeature( feature, *chunk.context, chunk.feedback.get() );
+        }
+        catch ( QgsProcessingException &e )
+        {
+          chunk.error = e.what();
+          break;
+        }
+        chunk.feedback->setProgress( ++processed * step );
+      }
+      chunk.context->expressionContext().lastScope()->removeFeature();
+    } );
+
+    for ( int i = 0; i < usedChunks; ++i )
+    {
+      QgsProcessingFeatureChunk &chunk = chunks[ i ];
+      for ( const QgsFeatureList &transformed : qgis::as_const( chunk.results ) )
+      {
+        for ( QgsFeature transformedFeature : transformed )
+          sink.addFeature( transformedFeature, QgsFeatureSink::FastInsert );
+      }
+      chunk.feedback->flush( feedback );
+
+      if ( !chunk.error.isEmpty() )
+        throw QgsProcessingException( chunk.error );
+    }
+  }
+}
+
 QVariantMap QgsProcessingFeatureBasedAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
   prepareSource( parameters, context );
@@ -928,25 +1075,40 @@ QVariantMap QgsProcessingFeatureBasedAlgorithm::processAlgorithm( const QVariant
 
   long count = mSource->featureCount();
 
-  QgsFeature f;
-  QgsFeatureIterator it = mSource->getFeatures( request(), sourceFlags() );
-
-  double step = count > 0 ? 100.0 / count : 1;
-  int current = 0;
-  while ( it.nextFeature( f ) )
+  if ( ( flags() & FlagSupportsParallelFeatureProcessing ) && supportsParallelFeatureProcessing( parameters ) )
+  {
+    QgsFeatureIterator it = mSource->getFeatures( request(), sourceFlags() );
+    processFeaturesInParallel( this, it, *sink, count, context, feedback );
+  }
+  else
   {
-    if ( feedback->isCanceled() )
+    // features are processed one at a time, so the iterator may recycle geometry storage of the previous feature
+    QgsFeatureRequest req = request();
+    req.setFlags( req.flags() | QgsFeatureRequest::RecycleGeometry );
+
+    QgsFeature f;
+    QgsFeatureIterator it = mSource->getFeatures( req, sourceFlags() );
+
+    double step = count > 0 ? 100.0 / count : 1;
+    int current = 0;
+    while ( it.nextFeature( f ) )
     {
-      break;
-    }
+      if ( feedback->isCanceled() )
+      {
+        break;
+      }
+
+      context.expressionContext().setFeature( f );
+      const QgsFeatureList transformed = processFeature( f, context, feedback );
+      for ( QgsFeature transformedFeature : transformed )
+        sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
 
-    context.expressionContext().setFeature( f );
-    const QgsFeatureList transformed = processFeature( f, context, feedback );
-    for ( QgsFeature transformedFeature : transformed )
-      sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
+      // release the expression context's reference to the feature, so that its geometry can be recycled
+      context.expressionContext().lastScope()->removeFeature();
 
-    feedback->setProgress( current * step );
-    current++;
+      feedback->setProgress( current * step );
+      current++;
+    }
   }
 
   mSource.reset();
@@ -964,6 +1126,11 @@ QgsFeatureRequest QgsProcessingFeatureBasedAlgorithm::request() const
   return QgsFeatureRequest();
 }
 
+bool QgsProcessingFeatureBasedAlgorithm::supportsParallelFeatureProcessing( const QVariantMap & ) const
+{
+  return true;
+}
+
 bool QgsProcessingFeatureBasedAlgorithm::supportInPlaceEdit( const QgsMapLayer *l ) const
 {
   const QgsVectorLayer *layer = qobject_cast< const QgsVectorLayer * >( l );
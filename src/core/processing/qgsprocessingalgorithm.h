@@ -35,6 +35,7 @@ class QgsFeatureSink;
 class QgsProcessingModelAlgorithm;
 class QgsProcessingAlgorithmConfigurationWidget;
 class QgsMeshLayer;
+class QgsProcessingProfiler;
 
 #ifdef SIP_RUN
 % ModuleHeaderCode
@@ -76,6 +77,7 @@ class CORE_EXPORT QgsProcessingAlgorithm
       FlagDisplayNameIsLiteral = 1 << 7, //!< Algorithm's display name is a static literal string, and should not be translated or automatically formatted. For use with algorithms named after commands, e.g. GRASS 'v.in.ogr'.
       FlagSupportsInPlaceEdits = 1 << 8, //!< Algorithm supports in-place editing
       FlagKnownIssues = 1 << 9, //!< Algorithm has known issues
+      FlagSupportsParallelFeatureProcessing = 1 << 10, //!< QgsProcessingFeatureBasedAlgorithm::processFeature() is re-entrant and can be called for multiple features at once from different threads (since QGIS 3.12)
       FlagDeprecated = FlagHideFromToolbox | FlagHideFromModeler, //!< Algorithm is deprecated
     };
     Q_DECLARE_FLAGS( Flags, Flag )
@@ -87,7 +89,7 @@ class CORE_EXPORT QgsProcessingAlgorithm
      * its parameterDefinitions() and outputDefinitions(). Alternatively, calling create() will return
      * a pre-initialized copy of the algorithm.
      */
-    QgsProcessingAlgorithm() = default;
+    QgsProcessingAlgorithm();
 
     virtual ~QgsProcessingAlgorithm();
 
@@ -366,6 +368,27 @@ class CORE_EXPORT QgsProcessingAlgorithm
      */
     QVariantMap postProcess( QgsProcessingContext &context, QgsProcessingFeedback *feedback );
 
+    /**
+     * Returns the execution profile of the algorithm instance, which is available after postProcess()
+     * has been called when the context used for execution has the QgsProcessingContext::ProfileExecution
+     * flag set. An empty map is returned otherwise.
+     *
+     * The profile contains the following keys:
+     *
+     * - "algorithm": algorithm ID
+     * - "prepare_time", "process_time", "post_process_time": time spent in the prepare, process and post process steps, in seconds
+     * - "source_time": time spent fetching features from feature sources while processing, in seconds
+     * - "sink_time": time spent writing features to feature sinks while processing, in seconds
+     * - "features_read", "features_written": number of features fetched from sources and written to sinks
+     * - "process_peak_memory_increase": increase of the peak resident memory of the whole process during the
+     *   execution, in bytes (or -1 if unknown). As the peak is measured for the process, this includes memory
+     *   used by anything else running at the same time, and it is 0 if the execution stayed below an earlier peak
+     *
+     * \see QgsProcessingFeedback::reportProfile()
+     * \since QGIS 3.12
+     */
+    QVariantMap profile() const;
+
     /**
      * If an algorithm subclass implements a custom parameters widget, a copy of this widget
      * should be constructed and returned by this method.
@@ -915,6 +938,8 @@ class CORE_EXPORT QgsProcessingAlgorithm
     bool mHasExecuted = false;
     bool mHasPostProcessed = false;
     std::unique_ptr< QgsProcessingContext > mLocalContext;
+    std::unique_ptr< QgsProcessingProfiler > mProfiler;
+    QVariantMap mProfile;
 
     bool createAutoOutputForParameter( QgsProcessingParameterDefinition *parameter );
 
@@ -989,6 +1014,13 @@ class CORE_EXPORT QgsProcessingFeatureBasedAlgorithm : public QgsProcessingAlgor
      * prevent the algorithm execution from continuing. This can be annoying for users though as it
      * can break valid model execution - so use with extreme caution, and consider using
      * \a feedback to instead report non-fatal processing failures for features instead.
+     *
+     * If the algorithm's flags() include QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing
+     * and supportsParallelFeatureProcessing() returns TRUE for the algorithm's parameters,
+     * this method will be called from multiple threads at once, each thread using its own copy
+     * of the \a context and its own \a feedback object. Implementations must not modify any state
+     * of the algorithm in this case. Output features and messages are still forwarded in the order of
+     * the input features.
      */
     virtual QgsFeatureList processFeature( const QgsFeature &feature, QgsProcessingContext &context, QgsProcessingFeedback *feedback ) SIP_THROW( QgsProcessingException ) = 0 SIP_VIRTUALERRORHANDLER( processing_exception_handler );
 
@@ -1099,6 +1131,20 @@ class CORE_EXPORT QgsProcessingFeatureBasedAlgorithm : public QgsProcessingAlgor
      */
     virtual QgsFeatureRequest request() const;
 
+    /**
+     * Returns TRUE if processFeature() can be called from multiple threads at once when
+     * the algorithm is run with the specified \a parameters.
+     *
+     * This is only called if the algorithm's flags() include QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing.
+     * Subclasses can override it to fall back to sequential processing for parameter values which
+     * are not safe to evaluate from multiple threads, e.g. data defined parameters.
+     *
+     * The default implementation returns TRUE.
+     *
+     * \since QGIS 3.12
+     */
+    virtual bool supportsParallelFeatureProcessing( const QVariantMap &parameters ) const;
+
     /**
      * Checks whether this algorithm supports in-place editing on the given \a layer
      * Default implementation for feature based algorithms run some basic compatibility
@@ -1118,6 +1164,13 @@ class CORE_EXPORT QgsProcessingFeatureBasedAlgorithm : public QgsProcessingAlgor
 
   private:
 
+    /**
+     * Processes all features from \a iterator by calling processFeature() of the \a algorithm from
+     * multiple threads, and writes the results to \a sink in the order of input features.
+     */
+    static void processFeaturesInParallel( QgsProcessingFeatureBasedAlgorithm *algorithm, QgsFeatureIterator &iterator, QgsFeatureSink &sink, long count,
+                                           QgsProcessingContext &context, QgsProcessingFeedback *feedback ) SIP_SKIP;
+
     std::unique_ptr< QgsProcessingFeatureSource > mSource;
 
 };
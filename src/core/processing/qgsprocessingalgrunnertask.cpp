@@ -82,6 +82,8 @@ void QgsProcessingAlgRunnerTask::finished( bool result )
   if ( result )
   {
     ppResults = mAlgorithm->postProcess( mContext, mFeedback );
+    if ( !mAlgorithm->profile().isEmpty() )
+      mFeedback->reportProfile( mAlgorithm->profile() );
   }
   emit executed( result, !ppResults.isEmpty() ? ppResults : mResults );
 }
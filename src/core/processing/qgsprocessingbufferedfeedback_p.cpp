@@ -0,0 +1,124 @@
+/***************************************************************************
+                         qgsprocessingbufferedfeedback_p.cpp
+                         -----------------------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by the QGIS project
+    email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsprocessingbufferedfeedback_p.h"
+#include "qgis.h"
+
+/// @cond PRIVATE
+
+QgsProcessingBufferedFeedback::QgsProcessingBufferedFeedback()
+{
+  connect( this, &QgsFeedback::progressChanged, this, [ = ]( double progress )
+  {
+    QMutexLocker locker( &mMutex );
+    mLastProgress = progress;
+  }, Qt::DirectConnection );
+}
+
+void QgsProcessingBufferedFeedback::setProgressText( const QString &text )
+{
+  addMessage( ProgressText, text );
+}
+
+void QgsProcessingBufferedFeedback::reportError( const QString &error, bool fatalError )
+{
+  addMessage( fatalError ? FatalError : Error, error );
+}
+
+void QgsProcessingBufferedFeedback::pushInfo( const QString &info )
+{
+  addMessage( Info, info );
+}
+
+void QgsProcessingBufferedFeedback::pushCommandInfo( const QString &info )
+{
+  addMessage( CommandInfo, info );
+}
+
+void QgsProcessingBufferedFeedback::pushDebugInfo( const QString &info )
+{
+  addMessage( DebugInfo, info );
+}
+
+void QgsProcessingBufferedFeedback::pushConsoleInfo( const QString &info )
+{
+  addMessage( ConsoleInfo, info );
+}
+
+void QgsProcessingBufferedFeedback::forwardProgress( QgsFeedback *feedback, QMutex *mutex )
+{
+  connect( this, &QgsFeedback::progressChanged, feedback, [feedback, mutex]( double progress )
+  {
+    QMutexLocker locker( mutex );
+    if ( progress > feedback->progress() )
+      feedback->setProgress( progress );
+  }, Qt::DirectConnection );
+}
+
+double QgsProcessingBufferedFeedback::lastProgress() const
+{
+  QMutexLocker locker( &mMutex );
+  return mLastProgress;
+}
+
+void QgsProcessingBufferedFeedback::addMessage( MessageType type, const QString &message )
+{
+  QMutexLocker locker( &mMutex );
+  mMessages << qMakePair( type, message );
+}
+
+void QgsProcessingBufferedFeedback::flush( QgsProcessingFeedback *feedback )
+{
+  QList< QPair< MessageType, QString > > messages;
+  {
+    QMutexLocker locker( &mMutex );
+    messages.swap( mMessages );
+  }
+
+  if ( feedback )
+  {
+    for ( const QPair< MessageType, QString > &message : qgis::as_const( messages ) )
+    {
+      switch ( message.first )
+      {
+        case ProgressText:
+          feedback->setProgressText( message.second );
+          break;
+        case Error:
+          feedback->reportError( message.second, false );
+          break;
+        case FatalError:
+          feedback->reportError( message.second, true );
+          break;
+        case Info:
+          feedback->pushInfo( message.second );
+          break;
+        case CommandInfo:
+          feedback->pushCommandInfo( message.second );
+          break;
+        case DebugInfo:
+          feedback->pushDebugInfo( message.second );
+          break;
+        case ConsoleInfo:
+          feedback->pushConsoleInfo( message.second );
+          break;
+      }
+    }
+  }
+}
+
+/// @endcond
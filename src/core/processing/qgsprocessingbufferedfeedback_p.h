@@ -0,0 +1,110 @@
+/***************************************************************************
+                         qgsprocessingbufferedfeedback_p.h
+                         ---------------------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by the QGIS project
+    email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPROCESSINGBUFFEREDFEEDBACK_P_H
+#define QGSPROCESSINGBUFFEREDFEEDBACK_P_H
+
+#define SIP_NO_FILE
+
+/// @cond PRIVATE
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QGIS API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+
+#include "qgis_core.h"
+#include "qgsprocessingfeedback.h"
+
+#include <QList>
+#include <QMutex>
+#include <QPair>
+
+/**
+ * \ingroup core
+ * Feedback object for processing code running in worker threads. Messages are
+ * collected and later forwarded to another feedback object by calling flush()
+ * from the thread which owns that feedback object. Messages may be reported and
+ * flushed from different threads at the same time.
+ *
+ * Progress can be forwarded immediately instead, see forwardProgress().
+ *
+ * \since QGIS 3.12
+ */
+class CORE_EXPORT QgsProcessingBufferedFeedback : public QgsProcessingFeedback
+{
+  public:
+
+    /**
+     * Constructor for QgsProcessingBufferedFeedback.
+     */
+    QgsProcessingBufferedFeedback();
+
+    void setProgressText( const QString &text ) override;
+    void reportError( const QString &error, bool fatalError = false ) override;
+    void pushInfo( const QString &info ) override;
+    void pushCommandInfo( const QString &info ) override;
+    void pushDebugInfo( const QString &info ) override;
+    void pushConsoleInfo( const QString &info ) override;
+
+    /**
+     * Forwards progress reported to this object to \a feedback, directly from the thread
+     * which reports it. Calls to \a feedback are serialized by \a mutex, which must be shared
+     * by all objects forwarding progress to the same \a feedback. Progress is only forwarded
+     * if it is higher than the current progress of \a feedback.
+     */
+    void forwardProgress( QgsFeedback *feedback, QMutex *mutex );
+
+    /**
+     * Returns the last progress reported to this object. Unlike progress(), this
+     * can be called while another thread reports progress.
+     */
+    double lastProgress() const;
+
+    /**
+     * Forwards all collected messages to \a feedback, in the order in which
+     * they were reported, and clears them.
+     */
+    void flush( QgsProcessingFeedback *feedback );
+
+  private:
+
+    enum MessageType
+    {
+      ProgressText,
+      Error,
+      FatalError,
+      Info,
+      CommandInfo,
+      DebugInfo,
+      ConsoleInfo,
+    };
+
+    void addMessage( MessageType type, const QString &message );
+
+    mutable QMutex mMutex;
+    QList< QPair< MessageType, QString > > mMessages;
+    double mLastProgress = 0;
+};
+
+/// @endcond
+
+#endif // QGSPROCESSINGBUFFEREDFEEDBACK_P_H
@@ -92,7 +92,10 @@ void QgsProcessingContext::setInvalidGeometryCheck( QgsFeatureRequest::InvalidGe
 
 void QgsProcessingContext::takeResultsFrom( QgsProcessingContext &context )
 {
-  setLayersToLoadOnCompletion( context.mLayersToLoadOnCompletion );
+  // merge, rather than replace, so that results from several contexts can be collected
+  // (e.g. from model child algorithms executed in parallel)
+  for ( auto it = context.mLayersToLoadOnCompletion.constBegin(); it != context.mLayersToLoadOnCompletion.constEnd(); ++it )
+    addLayerToLoadOnCompletion( it.key(), it.value() );
   context.mLayersToLoadOnCompletion.clear();
   tempLayerStore.transferLayersFromStore( context.temporaryLayerStore() );
 }
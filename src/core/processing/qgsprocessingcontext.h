@@ -48,6 +48,7 @@ class CORE_EXPORT QgsProcessingContext
     enum Flag
     {
       // UseSelectionIfPresent = 1 << 0,
+      ProfileExecution = 1 << 1, //!< Collect execution statistics for algorithms, see QgsProcessingAlgorithm::profile() (since QGIS 3.12)
     };
     Q_DECLARE_FLAGS( Flags, Flag )
 
@@ -0,0 +1,356 @@
+/***************************************************************************
+                         qgsprocessingfeaturepipe_p.cpp
+                         ------------------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by the QGIS project
+    email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsprocessingfeaturepipe_p.h"
+#include "qgsexception.h"
+#include "qgsgeometryengine.h"
+#include "qgsmessagelog.h"
+
+#include <QHash>
+#include <QUuid>
+
+///@cond PRIVATE
+
+typedef QHash< QString, std::weak_ptr< QgsProcessingFeaturePipe > > QgsProcessingFeaturePipeRegistry;
+Q_GLOBAL_STATIC( QgsProcessingFeaturePipeRegistry, sPipeRegistry )
+Q_GLOBAL_STATIC( QMutex, sPipeRegistryMutex )
+
+QgsProcessingFeaturePipe::QgsProcessingFeaturePipe( int capacity )
+  : mUri( QStringLiteral( "pipe:%1" ).arg( QUuid::createUuid().toString() ) )
+  , mCapacity( std::max( 1, capacity ) )
+{
+}
+
+QgsProcessingFeaturePipe::~QgsProcessingFeaturePipe()
+{
+  QMutexLocker locker( sPipeRegistryMutex() );
+  sPipeRegistry()->remove( mUri );
+}
+
+std::shared_ptr<QgsProcessingFeaturePipe> QgsProcessingFeaturePipe::create( int capacity )
+{
+  std::shared_ptr< QgsProcessingFeaturePipe > pipe( new QgsProcessingFeaturePipe( capacity ) );
+  QMutexLocker locker( sPipeRegistryMutex() );
+  sPipeRegistry()->insert( pipe->uri(), pipe );
+  return pipe;
+}
+
+std::shared_ptr<QgsProcessingFeaturePipe> QgsProcessingFeaturePipe::fromUri( const QString &uri )
+{
+  QMutexLocker locker( sPipeRegistryMutex() );
+  return sPipeRegistry()->value( uri ).lock();
+}
+
+bool QgsProcessingFeaturePipe::isPipeUri( const QString &string )
+{
+  return string.startsWith( QLatin1String( "pipe:" ) );
+}
+
+QgsFeatureSink *QgsProcessingFeaturePipe::createSink( const QgsFields &fields, QgsWkbTypes::Type wkbType, const QgsCoordinateReferenceSystem &crs )
+{
+  std::shared_ptr< QgsProcessingFeaturePipe > pipe = fromUri( mUri );
+  if ( !pipe )
+    return nullptr;
+
+  QMutexLocker locker( &mMutex );
+  if ( mHasSink || mClosed )
+    return nullptr;
+
+  mHasSink = true;
+  mFields = fields;
+  mWkbType = wkbType;
+  mCrs = crs;
+  mDefined.wakeAll();
+  return new QgsProcessingFeaturePipeSink( pipe );
+}
+
+QgsFeatureSource *QgsProcessingFeaturePipe::createSource()
+{
+  std::shared_ptr< QgsProcessingFeaturePipe > pipe = fromUri( mUri );
+  if ( !pipe )
+    return nullptr;
+
+  return new QgsProcessingFeaturePipeSource( pipe );
+}
+
+void QgsProcessingFeaturePipe::close()
+{
+  QMutexLocker locker( &mMutex );
+  mClosed = true;
+  mDefined.wakeAll();
+  mNotEmpty.wakeAll();
+}
+
+void QgsProcessingFeaturePipe::abort()
+{
+  QMutexLocker locker( &mMutex );
+  mAborted = true;
+  mQueue.clear();
+  mNotFull.wakeAll();
+}
+
+bool QgsProcessingFeaturePipe::registerReader()
+{
+  QMutexLocker locker( &mMutex );
+  if ( mHasReader )
+    return false;
+
+  mHasReader = true;
+  return true;
+}
+
+void QgsProcessingFeaturePipe::waitForDefinition()
+{
+  QMutexLocker locker( &mMutex );
+  while ( !mHasSink && !mClosed )
+    mDefined.wait( &mMutex );
+}
+
+bool QgsProcessingFeaturePipe::push( QgsFeature &feature )
+{
+  QMutexLocker locker( &mMutex );
+  while ( static_cast< int >( mQueue.size() ) >= mCapacity && !mAborted )
+    mNotFull.wait( &mMutex );
+
+  // once the reader is gone features are discarded, like for a sink without a destination
+  if ( mAborted )
+    return true;
+
+  mQueue.emplace_back( feature );
+  mNotEmpty.wakeOne();
+  return true;
+}
+
+bool QgsProcessingFeaturePipe::pop( QgsFeature &feature )
+{
+  QMutexLocker locker( &mMutex );
+  while ( mQueue.empty() && !mClosed && !mAborted )
+    mNotEmpty.wait( &mMutex );
+
+  if ( mQueue.empty() || mAborted )
+    return false;
+
+  feature = std::move( mQueue.front() );
+  mQueue.pop_front();
+  mNotFull.wakeOne();
+  return true;
+}
+
+//
+// QgsProcessingFeaturePipeSink
+//
+
+QgsProcessingFeaturePipeSink::QgsProcessingFeaturePipeSink( const std::shared_ptr<QgsProcessingFeaturePipe> &pipe )
+  : mPipe( pipe )
+{
+}
+
+QgsProcessingFeaturePipeSink::~QgsProcessingFeaturePipeSink()
+{
+  mPipe->close();
+}
+
+bool QgsProcessingFeaturePipeSink::addFeature( QgsFeature &feature, QgsFeatureSink::Flags )
+{
+  return mPipe->push( feature );
+}
+
+bool QgsProcessingFeaturePipeSink::addFeatures( QgsFeatureList &features, QgsFeatureSink::Flags flags )
+{
+  bool result = true;
+  for ( QgsFeature &feature : features )
+  {
+    result = addFeature( feature, flags ) && result;
+  }
+  return result;
+}
+
+//
+// QgsProcessingFeaturePipeSource
+//
+
+QgsProcessingFeaturePipeSource::QgsProcessingFeaturePipeSource( const std::shared_ptr<QgsProcessingFeaturePipe> &pipe )
+  : mPipe( pipe )
+{
+}
+
+QgsFeatureIterator QgsProcessingFeaturePipeSource::getFeatures( const QgsFeatureRequest &request ) const
+{
+  mPipe->waitForDefinition();
+  if ( !mPipe->registerReader() )
+  {
+    QgsMessageLog::logMessage( QObject::tr( "Features from %1 can only be read once, a second iteration returns no features" ).arg( mPipe->uri() ),
+                               QObject::tr( "Processing" ), Qgis::Critical );
+    return QgsFeatureIterator();
+  }
+  return QgsFeatureIterator( new QgsProcessingFeaturePipeIterator( mPipe, request ) );
+}
+
+QString QgsProcessingFeaturePipeSource::sourceName() const
+{
+  return mPipe->uri();
+}
+
+QgsCoordinateReferenceSystem QgsProcessingFeaturePipeSource::sourceCrs() const
+{
+  mPipe->waitForDefinition();
+  return mPipe->mCrs;
+}
+
+QgsFields QgsProcessingFeaturePipeSource::fields() const
+{
+  mPipe->waitForDefinition();
+  return mPipe->mFields;
+}
+
+QgsWkbTypes::Type QgsProcessingFeaturePipeSource::wkbType() const
+{
+  mPipe->waitForDefinition();
+  return mPipe->mWkbType;
+}
+
+long QgsProcessingFeaturePipeSource::featureCount() const
+{
+  return -1;
+}
+
+QgsRectangle QgsProcessingFeaturePipeSource::sourceExtent() const
+{
+  return QgsRectangle();
+}
+
+//
+// QgsProcessingFeaturePipeIterator
+//
+
+QgsProcessingFeaturePipeIterator::QgsProcessingFeaturePipeIterator( const std::shared_ptr<QgsProcessingFeaturePipe> &pipe, const QgsFeatureRequest &request )
+  : QgsAbstractFeatureIterator( request )
+  , mPipe( pipe )
+{
+  if ( mRequest.destinationCrs().isValid() && mRequest.destinationCrs() != mPipe->mCrs )
+  {
+    mTransform = QgsCoordinateTransform( mPipe->mCrs, mRequest.destinationCrs(), mRequest.transformContext() );
+  }
+  try
+  {
+    mFilterRect = filterRectToSourceCrs( mTransform );
+  }
+  catch ( QgsCsException & )
+  {
+    // can't reproject mFilterRect
+    close();
+    return;
+  }
+
+  if ( !mFilterRect.isNull() && mRequest.flags() & QgsFeatureRequest::ExactIntersect )
+  {
+    mSelectRectGeom = QgsGeometry::fromRect( mFilterRect );
+    mSelectRectEngine.reset( QgsGeometry::createGeometryEngine( mSelectRectGeom.constGet() ) );
+    mSelectRectEngine->prepareGeometry();
+  }
+
+  // expression and feature ID list filters are applied by the base class, on features returned by fetchFeature()
+  if ( mRequest.filterType() == QgsFeatureRequest::FilterExpression )
+    mRequest.expressionContext()->setFields( mPipe->mFields );
+
+  if ( mRequest.flags() & QgsFeatureRequest::SubsetOfAttributes )
+    mSubsetOfAttributes = mRequest.subsetOfAttributes();
+}
+
+QgsProcessingFeaturePipeIterator::~QgsProcessingFeaturePipeIterator()
+{
+  close();
+}
+
+bool QgsProcessingFeaturePipeIterator::rewind()
+{
+  // features are consumed as they are read
+  return false;
+}
+
+bool QgsProcessingFeaturePipeIterator::close()
+{
+  if ( mClosed )
+    return false;
+
+  if ( !mAtEnd )
+  {
+    // e.g. when the request has a limit, the writer's remaining features are lost
+    QgsMessageLog::logMessage( QObject::tr( "Stopped reading features from %1 before the end of the stream, remaining features are discarded" ).arg( mPipe->uri() ),
+                               QObject::tr( "Processing" ), Qgis::Warning );
+  }
+
+  // the reader won't request any more features, so make sure the writer is not left waiting for it
+  mPipe->abort();
+  mClosed = true;
+  return true;
+}
+
+bool QgsProcessingFeaturePipeIterator::fetchFeature( QgsFeature &feature )
+{
+  feature.setValid( false );
+
+  if ( mClosed )
+    return false;
+
+  while ( mPipe->pop( feature ) )
+  {
+    if ( mRequest.filterType() == QgsFeatureRequest::FilterFid && feature.id() != mRequest.filterFid() )
+      continue;
+
+    if ( !mFilterRect.isNull() )
+    {
+      if ( !feature.hasGeometry() )
+        continue;
+
+      if ( mSelectRectEngine ? !mSelectRectEngine->intersects( feature.geometry().constGet() )
+           : !feature.geometry().boundingBoxIntersects( mFilterRect ) )
+        continue;
+    }
+
+    feature.setFields( mPipe->mFields );
+
+    if ( mRequest.flags() & QgsFeatureRequest::NoGeometry )
+    {
+      feature.clearGeometry();
+    }
+    else
+    {
+      geometryToDestinationCrs( feature, mTransform );
+    }
+
+    if ( mRequest.flags() & QgsFeatureRequest::SubsetOfAttributes )
+    {
+      // attributes which were not requested are set to NULL, as done by other feature iterators
+      QgsAttributes attributes = feature.attributes();
+      for ( int i = 0; i < attributes.count(); ++i )
+      {
+        if ( !mSubsetOfAttributes.contains( i ) )
+          attributes[i] = QVariant();
+      }
+      feature.setAttributes( attributes );
+    }
+
+    feature.setValid( true );
+    return true;
+  }
+
+  mAtEnd = true;
+  return false;
+}
+
+///@endcond
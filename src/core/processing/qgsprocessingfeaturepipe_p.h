@@ -0,0 +1,254 @@
+/***************************************************************************
+                         qgsprocessingfeaturepipe_p.h
+                         ----------------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by the QGIS project
+    email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPROCESSINGFEATUREPIPE_P_H
+#define QGSPROCESSINGFEATUREPIPE_P_H
+
+#define SIP_NO_FILE
+
+/// @cond PRIVATE
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QGIS API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+
+#include "qgis_core.h"
+#include "qgsfeature.h"
+#include "qgsfeaturesink.h"
+#include "qgsfeaturesource.h"
+#include "qgsfeatureiterator.h"
+#include "qgscoordinatereferencesystem.h"
+#include "qgscoordinatetransform.h"
+#include "qgsgeometryengine.h"
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <deque>
+#include <memory>
+
+/**
+ * \ingroup core
+ * A bounded queue of features which connects a feature sink in one thread to a
+ * feature source read from another thread, so that features can stream from one
+ * algorithm to the next without being stored in an intermediate layer.
+ *
+ * Pipes are identified by a unique "pipe:" URI, which can be used as a destination
+ * for QgsProcessingUtils::createFeatureSink() and as a layer reference for
+ * QgsProcessingUtils::variantToSource().
+ *
+ * The producer blocks while the queue is full, and the consumer blocks while it is
+ * empty. Features can only be read once: a pipe source does not support rewinding
+ * or multiple iterations. A second call to QgsProcessingFeaturePipeSource::getFeatures()
+ * logs an error and returns no features, and closing the iterator before the end of the
+ * stream logs a warning, as the remaining features are discarded.
+ *
+ * \since QGIS 3.12
+ */
+class CORE_EXPORT QgsProcessingFeaturePipe
+{
+  public:
+
+    ~QgsProcessingFeaturePipe();
+
+    /**
+     * Creates a new pipe which holds up to \a capacity queued features, and registers
+     * it so that it can be retrieved by uri() until it is destroyed.
+     */
+    static std::shared_ptr< QgsProcessingFeaturePipe > create( int capacity = 10000 );
+
+    /**
+     * Returns the pipe with matching \a uri, or NULLPTR if no such pipe exists.
+     */
+    static std::shared_ptr< QgsProcessingFeaturePipe > fromUri( const QString &uri );
+
+    /**
+     * Returns TRUE if \a string is a pipe URI.
+     */
+    static bool isPipeUri( const QString &string );
+
+    /**
+     * Returns the unique URI identifying the pipe.
+     */
+    QString uri() const { return mUri; }
+
+    /**
+     * Creates the sink which writes features into the pipe, with the specified \a fields,
+     * \a wkbType and \a crs. These properties are made available to the reading side of the pipe.
+     *
+     * Only one sink can be created for each pipe, subsequent calls return NULLPTR. Destroying the
+     * sink closes the pipe.
+     *
+     * The caller takes ownership of the returned object.
+     */
+    QgsFeatureSink *createSink( const QgsFields &fields, QgsWkbTypes::Type wkbType, const QgsCoordinateReferenceSystem &crs );
+
+    /**
+     * Creates a source which reads features from the pipe.
+     *
+     * Properties of the source (such as its fields) block until the sink has been created or
+     * the pipe is closed.
+     *
+     * The caller takes ownership of the returned object.
+     */
+    QgsFeatureSource *createSource();
+
+    /**
+     * Closes the writing side of the pipe. Readers will see the end of the stream once
+     * all queued features have been read.
+     */
+    void close();
+
+    /**
+     * Closes the reading side of the pipe. Any queued features are discarded, and features
+     * added to the pipe afterwards are silently ignored.
+     */
+    void abort();
+
+  private:
+
+    explicit QgsProcessingFeaturePipe( int capacity );
+
+    //! Waits until the sink was created or the pipe was closed
+    void waitForDefinition();
+
+    //! Registers the pipe's only reader. Returns FALSE if features were already requested from the pipe.
+    bool registerReader();
+
+    //! Adds a feature to the queue, blocking while the queue is full
+    bool push( QgsFeature &feature );
+
+    //! Takes the next feature from the queue, blocking while the queue is empty. Returns FALSE at the end of the stream.
+    bool pop( QgsFeature &feature );
+
+    QString mUri;
+    int mCapacity = 10000;
+
+    QMutex mMutex;
+    QWaitCondition mNotEmpty;
+    QWaitCondition mNotFull;
+    QWaitCondition mDefined;
+
+    std::deque< QgsFeature > mQueue;
+    bool mHasSink = false;
+    bool mHasReader = false;
+    bool mClosed = false;
+    bool mAborted = false;
+
+    QgsFields mFields;
+    QgsWkbTypes::Type mWkbType = QgsWkbTypes::Unknown;
+    QgsCoordinateReferenceSystem mCrs;
+
+    friend class QgsProcessingFeaturePipeSink;
+    friend class QgsProcessingFeaturePipeSource;
+    friend class QgsProcessingFeaturePipeIterator;
+};
+
+/**
+ * \ingroup core
+ * Feature sink writing into a QgsProcessingFeaturePipe.
+ * \since QGIS 3.12
+ */
+class CORE_EXPORT QgsProcessingFeaturePipeSink : public QgsFeatureSink
+{
+  public:
+
+    QgsProcessingFeaturePipeSink( const std::shared_ptr< QgsProcessingFeaturePipe > &pipe );
+    ~QgsProcessingFeaturePipeSink() override;
+
+    bool addFeature( QgsFeature &feature, QgsFeatureSink::Flags flags = nullptr ) override;
+    bool addFeatures( QgsFeatureList &features, QgsFeatureSink::Flags flags = nullptr ) override;
+
+  private:
+
+    std::shared_ptr< QgsProcessingFeaturePipe > mPipe;
+};
+
+/**
+ * \ingroup core
+ * Feature source reading from a QgsProcessingFeaturePipe.
+ * \since QGIS 3.12
+ */
+class CORE_EXPORT QgsProcessingFeaturePipeSource : public QgsFeatureSource
+{
+  public:
+
+    QgsProcessingFeaturePipeSource( const std::shared_ptr< QgsProcessingFeaturePipe > &pipe );
+
+    QgsFeatureIterator getFeatures( const QgsFeatureRequest &request = QgsFeatureRequest() ) const override;
+    QString sourceName() const override;
+    QgsCoordinateReferenceSystem sourceCrs() const override;
+    QgsFields fields() const override;
+    QgsWkbTypes::Type wkbType() const override;
+
+    /**
+     * Returns -1, as the number of features is not known before the stream has completed.
+     */
+    long featureCount() const override;
+
+    /**
+     * Returns a null rectangle, as the extent is not known before the stream has completed.
+     */
+    QgsRectangle sourceExtent() const override;
+
+  private:
+
+    std::shared_ptr< QgsProcessingFeaturePipe > mPipe;
+};
+
+/**
+ * \ingroup core
+ * Feature iterator reading from a QgsProcessingFeaturePipe. Closing the iterator
+ * closes the reading side of the pipe.
+ *
+ * All filters, flags, the limit and the order by clauses of the feature request are applied.
+ * Ordering features requires reading the whole stream before the first feature is returned.
+ * \since QGIS 3.12
+ */
+class CORE_EXPORT QgsProcessingFeaturePipeIterator : public QgsAbstractFeatureIterator
+{
+  public:
+
+    QgsProcessingFeaturePipeIterator( const std::shared_ptr< QgsProcessingFeaturePipe > &pipe, const QgsFeatureRequest &request );
+    ~QgsProcessingFeaturePipeIterator() override;
+
+    bool rewind() override;
+    bool close() override;
+
+  protected:
+
+    bool fetchFeature( QgsFeature &feature ) override;
+
+  private:
+
+    std::shared_ptr< QgsProcessingFeaturePipe > mPipe;
+    QgsCoordinateTransform mTransform;
+    QgsRectangle mFilterRect;
+    QgsGeometry mSelectRectGeom;
+    std::unique_ptr< QgsGeometryEngine > mSelectRectEngine;
+    QgsAttributeList mSubsetOfAttributes;
+    //! TRUE once all features written to the pipe have been read
+    bool mAtEnd = false;
+};
+
+/// @endcond
+
+#endif // QGSPROCESSINGFEATUREPIPE_P_H
@@ -18,6 +18,7 @@
 #include "qgsprocessingfeedback.h"
 #include "qgsgeos.h"
 #include "qgsprocessingprovider.h"
+#include <QJsonDocument>
 #include <ogr_api.h>
 #include <gdal_version.h>
 #if PROJ_VERSION_MAJOR > 4
@@ -78,6 +79,36 @@ void QgsProcessingFeedback::pushVersionInfo( const QgsProcessingProvider *provid
   }
 }
 
+void QgsProcessingFeedback::reportProfile( const QVariantMap &profile )
+{
+  mProfiles << profile;
+
+  QString name = profile.value( QStringLiteral( "algorithm" ) ).toString();
+  if ( profile.contains( QStringLiteral( "child_id" ) ) )
+    name = QStringLiteral( "%1 (%2)" ).arg( profile.value( QStringLiteral( "child_id" ) ).toString(), name );
+
+  pushDebugInfo( tr( "Profile for %1: prepare %2 s, process %3 s (reading %4 s, writing %5 s), post process %6 s, %7 features read, %8 features written, process peak memory increase %9 MB" )
+                 .arg( name )
+                 .arg( profile.value( QStringLiteral( "prepare_time" ) ).toDouble() )
+                 .arg( profile.value( QStringLiteral( "process_time" ) ).toDouble() )
+                 .arg( profile.value( QStringLiteral( "source_time" ) ).toDouble() )
+                 .arg( profile.value( QStringLiteral( "sink_time" ) ).toDouble() )
+                 .arg( profile.value( QStringLiteral( "post_process_time" ) ).toDouble() )
+                 .arg( profile.value( QStringLiteral( "features_read" ) ).toLongLong() )
+                 .arg( profile.value( QStringLiteral( "features_written" ) ).toLongLong() )
+                 .arg( profile.value( QStringLiteral( "process_peak_memory_increase" ) ).toLongLong() / ( 1024.0 * 1024.0 ), 0, 'f', 1 ) );
+}
+
+QVariantList QgsProcessingFeedback::profiles() const
+{
+  return mProfiles;
+}
+
+QString QgsProcessingFeedback::profilesAsJson() const
+{
+  return QString::fromUtf8( QJsonDocument::fromVariant( mProfiles ).toJson() );
+}
+
 
 QgsProcessingMultiStepFeedback::QgsProcessingMultiStepFeedback( int childAlgorithmCount, QgsProcessingFeedback *feedback )
   : mChildSteps( childAlgorithmCount )
@@ -123,6 +154,11 @@ void QgsProcessingMultiStepFeedback::pushConsoleInfo( const QString &info )
   mFeedback->pushConsoleInfo( info );
 }
 
+void QgsProcessingMultiStepFeedback::reportProfile( const QVariantMap &profile )
+{
+  mFeedback->reportProfile( profile );
+}
+
 void QgsProcessingMultiStepFeedback::updateOverallProgress( double progress )
 {
   double baseProgress = 100.0 * static_cast< double >( mCurrentStep ) / mChildSteps;
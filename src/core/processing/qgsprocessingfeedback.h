@@ -99,6 +99,40 @@ class CORE_EXPORT QgsProcessingFeedback : public QgsFeedback
      */
     void pushVersionInfo( const QgsProcessingProvider *provider = nullptr );
 
+    /**
+     * Reports the execution \a profile of an algorithm, as returned by QgsProcessingAlgorithm::profile().
+     *
+     * The base class implementation stores the profile, so that all profiles reported during
+     * an execution can be retrieved with profiles() or profilesAsJson(), and pushes a summary
+     * of it as a debugging message.
+     *
+     * \see profiles()
+     * \since QGIS 3.12
+     */
+    virtual void reportProfile( const QVariantMap &profile );
+
+    /**
+     * Returns all execution profiles reported to the feedback object, in the order in
+     * which they were reported.
+     *
+     * \see reportProfile()
+     * \see profilesAsJson()
+     * \since QGIS 3.12
+     */
+    QVariantList profiles() const;
+
+    /**
+     * Returns all execution profiles reported to the feedback object as a JSON array.
+     *
+     * \see profiles()
+     * \since QGIS 3.12
+     */
+    QString profilesAsJson() const;
+
+  private:
+
+    QVariantList mProfiles;
+
 };
 
 
@@ -139,6 +173,7 @@ class CORE_EXPORT QgsProcessingMultiStepFeedback : public QgsProcessingFeedback
     void pushCommandInfo( const QString &info ) override;
     void pushDebugInfo( const QString &info ) override;
     void pushConsoleInfo( const QString &info ) override;
+    void reportProfile( const QVariantMap &profile ) override;
 
   private slots:
 
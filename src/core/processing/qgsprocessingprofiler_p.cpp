@@ -0,0 +1,131 @@
+/***************************************************************************
+                         qgsprocessingprofiler_p.cpp
+                         ---------------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by the QGIS project
+    email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsprocessingprofiler_p.h"
+
+#include <QElapsedTimer>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+///@cond PRIVATE
+
+thread_local QgsProcessingProfiler *QgsProcessingProfiler::sCurrent = nullptr;
+
+QgsProcessingProfiler::Scope::Scope( QgsProcessingProfiler *profiler )
+  : mPrevious( QgsProcessingProfiler::sCurrent )
+{
+  QgsProcessingProfiler::sCurrent = profiler;
+}
+
+QgsProcessingProfiler::Scope::~Scope()
+{
+  QgsProcessingProfiler::sCurrent = mPrevious;
+}
+
+QgsProcessingProfiler *QgsProcessingProfiler::current()
+{
+  return sCurrent;
+}
+
+qint64 QgsProcessingProfiler::peakMemoryUsage()
+{
+#ifdef Q_OS_UNIX
+  struct rusage usage;
+  if ( getrusage( RUSAGE_SELF, &usage ) != 0 )
+    return -1;
+#ifdef Q_OS_MACOS
+  return static_cast< qint64 >( usage.ru_maxrss );
+#else
+  // reported in kilobytes
+  return static_cast< qint64 >( usage.ru_maxrss ) * 1024;
+#endif
+#else
+  return -1;
+#endif
+}
+
+void QgsProcessingProfiler::addSourceTime( qint64 time, long features )
+{
+  mSourceTime += time;
+  mFeaturesRead += features;
+}
+
+void QgsProcessingProfiler::addSinkTime( qint64 time, long features )
+{
+  mSinkTime += time;
+  mFeaturesWritten += features;
+}
+
+QVariantMap QgsProcessingProfiler::report() const
+{
+  QVariantMap report;
+  report.insert( QStringLiteral( "prepare_time" ), mPrepareTime / 1e9 );
+  report.insert( QStringLiteral( "process_time" ), mProcessTime / 1e9 );
+  report.insert( QStringLiteral( "post_process_time" ), mPostProcessTime / 1e9 );
+  report.insert( QStringLiteral( "source_time" ), mSourceTime / 1e9 );
+  report.insert( QStringLiteral( "sink_time" ), mSinkTime / 1e9 );
+  report.insert( QStringLiteral( "features_read" ), static_cast< qint64 >( mFeaturesRead ) );
+  report.insert( QStringLiteral( "features_written" ), static_cast< qint64 >( mFeaturesWritten ) );
+  // the peak is process wide, so only its increase during the execution can be related to the algorithm
+  const qint64 peakMemory = peakMemoryUsage();
+  report.insert( QStringLiteral( "process_peak_memory_increase" ), peakMemory >= 0 && mInitialPeakMemory >= 0 ? peakMemory - mInitialPeakMemory : -1 );
+  return report;
+}
+
+//
+// QgsProcessingProfilingFeatureIterator
+//
+
+QgsProcessingProfilingFeatureIterator::QgsProcessingProfilingFeatureIterator( const QgsFeatureIterator &iterator, QgsProcessingProfiler *profiler )
+  : QgsAbstractFeatureIterator( QgsFeatureRequest() ) // filtering is already handled by the wrapped iterator
+  , mIterator( iterator )
+  , mProfiler( profiler )
+{
+}
+
+QgsProcessingProfilingFeatureIterator::~QgsProcessingProfilingFeatureIterator()
+{
+  close();
+}
+
+bool QgsProcessingProfilingFeatureIterator::rewind()
+{
+  return mIterator.rewind();
+}
+
+bool QgsProcessingProfilingFeatureIterator::close()
+{
+  return mIterator.close();
+}
+
+bool QgsProcessingProfilingFeatureIterator::isValid() const
+{
+  return mIterator.isValid();
+}
+
+bool QgsProcessingProfilingFeatureIterator::fetchFeature( QgsFeature &feature )
+{
+  QElapsedTimer timer;
+  timer.start();
+  const bool result = mIterator.nextFeature( feature );
+  mProfiler->addSourceTime( timer.nsecsElapsed(), result ? 1 : 0 );
+  return result;
+}
+
+///@endcond
@@ -0,0 +1,147 @@
+/***************************************************************************
+                         qgsprocessingprofiler_p.h
+                         -------------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by the QGIS project
+    email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPROCESSINGPROFILER_P_H
+#define QGSPROCESSINGPROFILER_P_H
+
+#define SIP_NO_FILE
+
+/// @cond PRIVATE
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QGIS API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+
+#include "qgis_core.h"
+#include "qgsfeatureiterator.h"
+
+#include <QVariantMap>
+#include <atomic>
+
+/**
+ * \ingroup core
+ * Collects execution statistics for a single algorithm execution.
+ *
+ * While a profiler is installed for a thread (see Scope), QgsProcessingFeatureSource
+ * and QgsProcessingFeatureSink record the time spent fetching and writing features
+ * from that thread.
+ *
+ * \since QGIS 3.12
+ */
+class CORE_EXPORT QgsProcessingProfiler
+{
+  public:
+
+    /**
+     * Installs a profiler for the current thread for the lifetime of the scope object,
+     * restoring the previously installed profiler afterwards.
+     */
+    class Scope
+    {
+      public:
+        explicit Scope( QgsProcessingProfiler *profiler );
+        ~Scope();
+
+        Scope( const Scope &other ) = delete;
+        Scope &operator=( const Scope &other ) = delete;
+
+      private:
+        QgsProcessingProfiler *mPrevious = nullptr;
+    };
+
+    /**
+     * Returns the profiler installed for the current thread, or NULLPTR if no
+     * execution is being profiled.
+     */
+    static QgsProcessingProfiler *current();
+
+    /**
+     * Returns the peak resident memory used by the process so far, in bytes, or -1
+     * if it cannot be determined on this platform.
+     */
+    static qint64 peakMemoryUsage();
+
+    //! Records time spent in an algorithm's prepareAlgorithm() step, in nanoseconds
+    void setPrepareTime( qint64 time ) { mPrepareTime = time; }
+    //! Records time spent in an algorithm's processAlgorithm() step, in nanoseconds
+    void setProcessTime( qint64 time ) { mProcessTime = time; }
+    //! Records time spent in an algorithm's postProcessAlgorithm() step, in nanoseconds
+    void setPostProcessTime( qint64 time ) { mPostProcessTime = time; }
+
+    //! Records \a time (in nanoseconds) spent fetching \a features from a source
+    void addSourceTime( qint64 time, long features );
+    //! Records \a time (in nanoseconds) spent writing \a features to a sink
+    void addSinkTime( qint64 time, long features );
+
+    /**
+     * Returns a report of the collected statistics, in the format used by
+     * QgsProcessingAlgorithm::profile().
+     */
+    QVariantMap report() const;
+
+  private:
+
+    static thread_local QgsProcessingProfiler *sCurrent;
+
+    qint64 mInitialPeakMemory = peakMemoryUsage();
+    qint64 mPrepareTime = 0;
+    qint64 mProcessTime = 0;
+    qint64 mPostProcessTime = 0;
+
+    // sources and sinks may be used from worker threads of an algorithm
+    std::atomic< qint64 > mSourceTime{ 0 };
+    std::atomic< qint64 > mSinkTime{ 0 };
+    std::atomic< qint64 > mFeaturesRead{ 0 };
+    std::atomic< qint64 > mFeaturesWritten{ 0 };
+};
+
+/**
+ * \ingroup core
+ * Feature iterator wrapping another iterator, recording the time spent fetching
+ * features into a QgsProcessingProfiler.
+ *
+ * \since QGIS 3.12
+ */
+class CORE_EXPORT QgsProcessingProfilingFeatureIterator : public QgsAbstractFeatureIterator
+{
+  public:
+
+    QgsProcessingProfilingFeatureIterator( const QgsFeatureIterator &iterator, QgsProcessingProfiler *profiler );
+    ~QgsProcessingProfilingFeatureIterator() override;
+
+    bool rewind() override;
+    bool close() override;
+    bool isValid() const override;
+
+  protected:
+
+    bool fetchFeature( QgsFeature &feature ) override;
+
+  private:
+
+    QgsFeatureIterator mIterator;
+    QgsProcessingProfiler *mProfiler = nullptr;
+};
+
+/// @endcond
+
+#endif // QGSPROCESSINGPROFILER_P_H
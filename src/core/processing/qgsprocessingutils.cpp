@@ -33,6 +33,10 @@
 #include "qgsmeshlayer.h"
 #include "qgsreferencedgeometry.h"
 #include "qgsrasterfilewriter.h"
+#include "qgsprocessingfeaturepipe_p.h"
+#include "qgsprocessingprofiler_p.h"
+
+#include <QElapsedTimer>
 
 QList<QgsRasterLayer *> QgsProcessingUtils::compatibleRasterLayers( QgsProject *project, bool sort )
 {
@@ -324,6 +328,15 @@ QgsProcessingFeatureSource *QgsProcessingUtils::variantToSource( const QVariant
   if ( layerRef.isEmpty() )
     return nullptr;
 
+  if ( QgsProcessingFeaturePipe::isPipeUri( layerRef ) )
+  {
+    // features streamed from another algorithm
+    std::shared_ptr< QgsProcessingFeaturePipe > pipe = QgsProcessingFeaturePipe::fromUri( layerRef );
+    if ( !pipe )
+      return nullptr;
+    return new QgsProcessingFeatureSource( pipe->createSource(), context, true );
+  }
+
   QgsVectorLayer *vl = qobject_cast< QgsVectorLayer *>( QgsProcessingUtils::mapLayerFromString( layerRef, context, true, LayerHint::Vector ) );
   if ( !vl )
     return nullptr;
@@ -525,7 +538,16 @@ QgsFeatureSink *QgsProcessingUtils::createFeatureSink( QString &destination, Qgs
     options.insert( QStringLiteral( "fileEncoding" ), context.defaultEncoding().isEmpty() ? QStringLiteral( "system" ) : context.defaultEncoding() );
   }
 
-  if ( destination.isEmpty() || destination.startsWith( QLatin1String( "memory:" ) ) )
+  if ( QgsProcessingFeaturePipe::isPipeUri( destination ) )
+  {
+    // features are streamed to another algorithm
+    std::shared_ptr< QgsProcessingFeaturePipe > pipe = QgsProcessingFeaturePipe::fromUri( destination );
+    QgsFeatureSink *sink = pipe ? pipe->createSink( fields, geometryType, crs ) : nullptr;
+    if ( !sink )
+      throw QgsProcessingException( QObject::tr( "Could not create pipe %1" ).arg( destination ) );
+    return new QgsProcessingFeatureSink( sink, destination, context, true );
+  }
+  else if ( destination.isEmpty() || destination.startsWith( QLatin1String( "memory:" ) ) )
   {
     // strip "memory:" from start of destination
     if ( destination.startsWith( QLatin1String( "memory:" ) ) )
@@ -951,6 +973,16 @@ QgsProcessingFeatureSource::~QgsProcessingFeatureSource()
     delete mSource;
 }
 
+///@cond PRIVATE
+//! Wraps \a iterator to record fetching times, if the current algorithm execution is being profiled
+static QgsFeatureIterator profiledIterator( const QgsFeatureIterator &iterator )
+{
+  if ( QgsProcessingProfiler *profiler = QgsProcessingProfiler::current() )
+    return QgsFeatureIterator( new QgsProcessingProfilingFeatureIterator( iterator, profiler ) );
+  return iterator;
+}
+///@endcond
+
 QgsFeatureIterator QgsProcessingFeatureSource::getFeatures( const QgsFeatureRequest &request, Flags flags ) const
 {
   QgsFeatureRequest req( request );
@@ -964,7 +996,7 @@ QgsFeatureIterator QgsProcessingFeatureSource::getFeatures( const QgsFeatureRequ
     req.setInvalidGeometryCallback( mInvalidGeometryCallback );
   }
 
-  return mSource->getFeatures( req );
+  return profiledIterator( mSource->getFeatures( req ) );
 }
 
 QgsFeatureSource::FeatureAvailability QgsProcessingFeatureSource::hasFeatures() const
@@ -985,7 +1017,7 @@ QgsFeatureIterator QgsProcessingFeatureSource::getFeatures( const QgsFeatureRequ
   req.setInvalidGeometryCheck( mInvalidGeometryCheck );
   req.setInvalidGeometryCallback( mInvalidGeometryCallback );
   req.setTransformErrorCallback( mTransformErrorCallback );
-  return mSource->getFeatures( req );
+  return profiledIterator( mSource->getFeatures( req ) );
 }
 
 QgsCoordinateReferenceSystem QgsProcessingFeatureSource::sourceCrs() const
@@ -1074,7 +1106,13 @@ QgsProcessingFeatureSink::~QgsProcessingFeatureSink()
 
 bool QgsProcessingFeatureSink::addFeature( QgsFeature &feature, QgsFeatureSink::Flags flags )
 {
+  QgsProcessingProfiler *profiler = QgsProcessingProfiler::current();
+  QElapsedTimer timer;
+  if ( profiler )
+    timer.start();
   bool result = QgsProxyFeatureSink::addFeature( feature, flags );
+  if ( profiler )
+    profiler->addSinkTime( timer.nsecsElapsed(), 1 );
   if ( !result )
     mContext.feedback()->reportError( QObject::tr( "Feature could not be written to %1" ).arg( mSinkName ) );
   return result;
@@ -1082,7 +1120,13 @@ bool QgsProcessingFeatureSink::addFeature( QgsFeature &feature, QgsFeatureSink::
 
 bool QgsProcessingFeatureSink::addFeatures( QgsFeatureList &features, QgsFeatureSink::Flags flags )
 {
+  QgsProcessingProfiler *profiler = QgsProcessingProfiler::current();
+  QElapsedTimer timer;
+  if ( profiler )
+    timer.start();
   bool result = QgsProxyFeatureSink::addFeatures( features, flags );
+  if ( profiler )
+    profiler->addSinkTime( timer.nsecsElapsed(), features.count() );
   if ( !result )
     mContext.feedback()->reportError( QObject::tr( "%1 feature(s) could not be written to %2" ).arg( features.count() ).arg( mSinkName ) );
   return result;
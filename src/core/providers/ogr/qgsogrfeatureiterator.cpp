@@ -482,15 +482,27 @@ bool QgsOgrFeatureIterator::readFeature( gdal::ogr_feature_unique_ptr fet, QgsFe
 
     if ( geom )
     {
-      QgsGeometry g = QgsOgrUtils::ogrGeometryToQgsGeometry( geom );
-
-      // Insure that multipart datasets return multipart geometry
-      if ( QgsWkbTypes::isMultiType( mSource->mWkbType ) && !g.isMultipart() )
+      if ( mRequest.flags() & QgsFeatureRequest::RecycleGeometry )
       {
-        g.convertToMultiType();
+        // take over the geometry of the previous feature, so that the new geometry can be decoded into it.
+        // Multipart datasets are promoted to multipart already when decoding, keeping the geometry types stable.
+        QgsGeometry g = feature.geometry();
+        feature.clearGeometry();
+        QgsOgrUtils::ogrGeometryToQgsGeometry( geom, g, mWkbBuffer, QgsWkbTypes::isMultiType( mSource->mWkbType ) );
+        feature.setGeometry( g );
       }
+      else
+      {
+        QgsGeometry g = QgsOgrUtils::ogrGeometryToQgsGeometry( geom );
+
+        // Insure that multipart datasets return multipart geometry
+        if ( QgsWkbTypes::isMultiType( mSource->mWkbType ) && !g.isMultipart() )
+        {
+          g.convertToMultiType();
+        }
 
-      feature.setGeometry( g );
+        feature.setGeometry( g );
+      }
     }
     else
       feature.clearGeometry();
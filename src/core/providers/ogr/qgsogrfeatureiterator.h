@@ -102,6 +102,9 @@ class QgsOgrFeatureIterator : public QgsAbstractFeatureIteratorFromSource<QgsOgr
     bool mFirstFieldIsFid = false;
     QgsFields mFieldsWithoutFid;
 
+    //! Scratch buffer for geometry conversion, reused between features with QgsFeatureRequest::RecycleGeometry
+    mutable QByteArray mWkbBuffer;
+
     bool fetchFeatureWithId( QgsFeatureId id, QgsFeature &feature ) const;
 
     void resetReading();
@@ -0,0 +1,731 @@
+/***************************************************************************
+  qgsearcut_p.cpp
+  --------------------------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by the QGIS project
+  Email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsearcut_p.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+///@cond PRIVATE
+
+std::vector<uint32_t> QgsEarcut::triangulate( const std::vector<double> &coords, const std::vector<uint32_t> &holeIndices )
+{
+  QgsEarcut earcut( coords );
+  earcut.run( holeIndices );
+  return std::move( earcut.mTriangles );
+}
+
+QgsEarcut::QgsEarcut( const std::vector<double> &coords )
+  : mCoords( coords )
+{
+}
+
+void QgsEarcut::run( const std::vector<uint32_t> &holeIndices )
+{
+  const std::size_t vertexCount = mCoords.size() / 2;
+  const std::size_t outerLen = holeIndices.empty() ? vertexCount : holeIndices.front();
+
+  Node *outerNode = linkedList( 0, outerLen, true );
+  if ( !outerNode || outerNode->next == outerNode->prev )
+    return;
+
+  mTriangles.reserve( 3 * ( vertexCount + 2 * holeIndices.size() ) );
+
+  if ( !holeIndices.empty() )
+    outerNode = eliminateHoles( holeIndices, outerNode );
+
+  // for more complex shapes use z-order curve hash to speed up the search for ears
+  if ( vertexCount > 80 )
+  {
+    double maxX = mMinX = mCoords[0];
+    double maxY = mMinY = mCoords[1];
+    for ( std::size_t i = 1; i < outerLen; ++i )
+    {
+      const double x = mCoords[2 * i];
+      const double y = mCoords[2 * i + 1];
+      mMinX = std::min( mMinX, x );
+      mMinY = std::min( mMinY, y );
+      maxX = std::max( maxX, x );
+      maxY = std::max( maxY, y );
+    }
+
+    // minX, minY and invSize are used to transform coords into integers for z-order calculation
+    const double size = std::max( maxX - mMinX, maxY - mMinY );
+    mInvSize = size != 0 ? 32767 / size : 0;
+    mHashing = mInvSize != 0;
+  }
+
+  earcutLinked( outerNode );
+}
+
+QgsEarcut::Node *QgsEarcut::linkedList( std::size_t start, std::size_t end, bool clockwise )
+{
+  if ( end <= start )
+    return nullptr;
+
+  // signed area of the ring
+  double sum = 0;
+  for ( std::size_t i = start, j = end - 1; i < end; j = i++ )
+    sum += ( mCoords[2 * j] - mCoords[2 * i] ) * ( mCoords[2 * i + 1] + mCoords[2 * j + 1] );
+
+  // create a circular doubly linked list from polygon points in the specified winding order
+  Node *last = nullptr;
+  if ( clockwise == ( sum > 0 ) )
+  {
+    for ( std::size_t i = start; i < end; ++i )
+      last = insertNode( i, mCoords[2 * i], mCoords[2 * i + 1], last );
+  }
+  else
+  {
+    for ( std::size_t i = end; i-- > start; )
+      last = insertNode( i, mCoords[2 * i], mCoords[2 * i + 1], last );
+  }
+
+  if ( last && equals( last, last->next ) )
+  {
+    Node *next = last->next;
+    removeNode( last );
+    last = next;
+  }
+
+  return last;
+}
+
+QgsEarcut::Node *QgsEarcut::filterPoints( Node *start, Node *end )
+{
+  // eliminate colinear or duplicate points
+  if ( !start )
+    return start;
+  if ( !end )
+    end = start;
+
+  Node *p = start;
+  bool again = false;
+  do
+  {
+    again = false;
+
+    if ( !p->steiner && ( equals( p, p->next ) || area( p->prev, p, p->next ) == 0 ) )
+    {
+      removeNode( p );
+      p = end = p->prev;
+
+      if ( p == p->next )
+        break;
+      again = true;
+    }
+    else
+    {
+      p = p->next;
+    }
+  }
+  while ( again || p != end );
+
+  return end;
+}
+
+void QgsEarcut::earcutLinked( Node *ear, int pass )
+{
+  if ( !ear )
+    return;
+
+  // interlink polygon nodes in z-order
+  if ( !pass && mHashing )
+    indexCurve( ear );
+
+  Node *stop = ear;
+
+  // iterate through ears, slicing them one by one
+  while ( ear->prev != ear->next )
+  {
+    Node *prev = ear->prev;
+    Node *next = ear->next;
+
+    if ( mHashing ? isEarHashed( ear ) : isEar( ear ) )
+    {
+      // cut off the triangle
+      mTriangles.push_back( prev->i );
+      mTriangles.push_back( ear->i );
+      mTriangles.push_back( next->i );
+
+      removeNode( ear );
+
+      // skipping the next vertex leads to less sliver triangles
+      ear = next->next;
+      stop = next->next;
+      continue;
+    }
+
+    ear = next;
+
+    // if we looped through the whole remaining polygon and can't find any more ears
+    if ( ear == stop )
+    {
+      if ( !pass )
+      {
+        // try filtering points and slicing again
+        earcutLinked( filterPoints( ear ), 1 );
+      }
+      else if ( pass == 1 )
+      {
+        // if this didn't work, try curing all small self-intersections locally
+        ear = cureLocalIntersections( filterPoints( ear ) );
+        earcutLinked( ear, 2 );
+      }
+      else if ( pass == 2 )
+      {
+        // as a last resort, try splitting the remaining polygon into two
+        splitEarcut( ear );
+      }
+      break;
+    }
+  }
+}
+
+bool QgsEarcut::isEar( Node *ear ) const
+{
+  const Node *a = ear->prev;
+  const Node *b = ear;
+  const Node *c = ear->next;
+
+  if ( area( a, b, c ) >= 0 )
+    return false; // reflex, can't be an ear
+
+  // now make sure we don't have other points inside the potential ear
+  const double x0 = std::min( { a->x, b->x, c->x } );
+  const double y0 = std::min( { a->y, b->y, c->y } );
+  const double x1 = std::max( { a->x, b->x, c->x } );
+  const double y1 = std::max( { a->y, b->y, c->y } );
+
+  const Node *p = c->next;
+  while ( p != a )
+  {
+    if ( p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 &&
+         pointInTriangle( a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y ) &&
+         area( p->prev, p, p->next ) >= 0 )
+      return false;
+    p = p->next;
+  }
+
+  return true;
+}
+
+bool QgsEarcut::isEarHashed( Node *ear ) const
+{
+  const Node *a = ear->prev;
+  const Node *b = ear;
+  const Node *c = ear->next;
+
+  if ( area( a, b, c ) >= 0 )
+    return false; // reflex, can't be an ear
+
+  // triangle bbox
+  const double x0 = std::min( { a->x, b->x, c->x } );
+  const double y0 = std::min( { a->y, b->y, c->y } );
+  const double x1 = std::max( { a->x, b->x, c->x } );
+  const double y1 = std::max( { a->y, b->y, c->y } );
+
+  // z-order range for the current triangle bbox
+  const int32_t minZ = zOrder( x0, y0 );
+  const int32_t maxZ = zOrder( x1, y1 );
+
+  auto isBlocking = [ = ]( const Node * p )
+  {
+    return p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 && p != a && p != c &&
+           pointInTriangle( a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y ) &&
+           area( p->prev, p, p->next ) >= 0;
+  };
+
+  const Node *p = ear->prevZ;
+  const Node *n = ear->nextZ;
+
+  // look for points inside the triangle in both directions
+  while ( p && p->z >= minZ && n && n->z <= maxZ )
+  {
+    if ( isBlocking( p ) )
+      return false;
+    p = p->prevZ;
+
+    if ( isBlocking( n ) )
+      return false;
+    n = n->nextZ;
+  }
+
+  // look for remaining points in decreasing z-order
+  while ( p && p->z >= minZ )
+  {
+    if ( isBlocking( p ) )
+      return false;
+    p = p->prevZ;
+  }
+
+  // look for remaining points in increasing z-order
+  while ( n && n->z <= maxZ )
+  {
+    if ( isBlocking( n ) )
+      return false;
+    n = n->nextZ;
+  }
+
+  return true;
+}
+
+QgsEarcut::Node *QgsEarcut::cureLocalIntersections( Node *start )
+{
+  // go through all polygon nodes and cure small local self-intersections
+  Node *p = start;
+  do
+  {
+    Node *a = p->prev;
+    Node *b = p->next->next;
+
+    if ( !equals( a, b ) && intersects( a, p, p->next, b ) && locallyInside( a, b ) && locallyInside( b, a ) )
+    {
+      mTriangles.push_back( a->i );
+      mTriangles.push_back( p->i );
+      mTriangles.push_back( b->i );
+
+      // remove two nodes involved
+      removeNode( p );
+      removeNode( p->next );
+
+      p = start = b;
+    }
+    p = p->next;
+  }
+  while ( p != start );
+
+  return filterPoints( p );
+}
+
+void QgsEarcut::splitEarcut( Node *start )
+{
+  // look for a valid diagonal that divides the polygon into two
+  Node *a = start;
+  do
+  {
+    Node *b = a->next->next;
+    while ( b != a->prev )
+    {
+      if ( a->i != b->i && isValidDiagonal( a, b ) )
+      {
+        // split the polygon in two by the diagonal
+        Node *c = splitPolygon( a, b );
+
+        // filter colinear points around the cuts
+        a = filterPoints( a, a->next );
+        c = filterPoints( c, c->next );
+
+        // run earcut on each half
+        earcutLinked( a );
+        earcutLinked( c );
+        return;
+      }
+      b = b->next;
+    }
+    a = a->next;
+  }
+  while ( a != start );
+}
+
+QgsEarcut::Node *QgsEarcut::eliminateHoles( const std::vector<uint32_t> &holeIndices, Node *outerNode )
+{
+  // link every hole into the outer loop, producing a single-ring polygon without holes
+  const std::size_t vertexCount = mCoords.size() / 2;
+  std::vector<Node *> queue;
+  queue.reserve( holeIndices.size() );
+  for ( std::size_t i = 0; i < holeIndices.size(); ++i )
+  {
+    const std::size_t start = holeIndices[i];
+    const std::size_t end = i < holeIndices.size() - 1 ? holeIndices[i + 1] : vertexCount;
+    Node *list = linkedList( start, end, false );
+    if ( !list )
+      continue;
+    if ( list == list->next )
+      list->steiner = true;
+    queue.push_back( leftmost( list ) );
+  }
+
+  std::sort( queue.begin(), queue.end(), []( const Node * a, const Node * b ) { return a->x < b->x; } );
+
+  // process holes from left to right
+  for ( Node *hole : queue )
+    outerNode = eliminateHole( hole, outerNode );
+
+  return outerNode;
+}
+
+QgsEarcut::Node *QgsEarcut::eliminateHole( Node *hole, Node *outerNode )
+{
+  // find a bridge between the hole and the outer polygon and link it
+  Node *bridge = findHoleBridge( hole, outerNode );
+  if ( !bridge )
+    return outerNode;
+
+  Node *bridgeReverse = splitPolygon( bridge, hole );
+
+  // filter collinear points around the cuts
+  filterPoints( bridgeReverse, bridgeReverse->next );
+  return filterPoints( bridge, bridge->next );
+}
+
+QgsEarcut::Node *QgsEarcut::findHoleBridge( Node *hole, Node *outerNode ) const
+{
+  // David Eberly's algorithm for finding a bridge between hole and outer polygon
+  Node *p = outerNode;
+  const double hx = hole->x;
+  const double hy = hole->y;
+  double qx = -std::numeric_limits<double>::infinity();
+  Node *m = nullptr;
+
+  // find a segment intersected by a ray from the hole's leftmost point to the left;
+  // segment's endpoint with lesser x will be potential connection point
+  do
+  {
+    if ( hy <= p->y && hy >= p->next->y && p->next->y != p->y )
+    {
+      const double x = p->x + ( hy - p->y ) * ( p->next->x - p->x ) / ( p->next->y - p->y );
+      if ( x <= hx && x > qx )
+      {
+        qx = x;
+        m = p->x < p->next->x ? p : p->next;
+        if ( x == hx )
+          return m; // hole touches outer segment; pick leftmost endpoint
+      }
+    }
+    p = p->next;
+  }
+  while ( p != outerNode );
+
+  if ( !m )
+    return nullptr;
+
+  // look for points inside the triangle of hole point, segment intersection and endpoint;
+  // if there are no points found, we have a valid connection;
+  // otherwise choose the point of the minimum angle with the ray as connection point
+  const Node *stop = m;
+  const double mx = m->x;
+  const double my = m->y;
+  double tanMin = std::numeric_limits<double>::infinity();
+
+  p = m;
+  do
+  {
+    if ( hx >= p->x && p->x >= mx && hx != p->x &&
+         pointInTriangle( hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y ) )
+    {
+      const double tan = std::fabs( hy - p->y ) / ( hx - p->x ); // tangential
+
+      if ( locallyInside( p, hole ) &&
+           ( tan < tanMin || ( tan == tanMin && ( p->x > m->x || ( p->x == m->x && sectorContainsSector( m, p ) ) ) ) ) )
+      {
+        m = p;
+        tanMin = tan;
+      }
+    }
+    p = p->next;
+  }
+  while ( p != stop );
+
+  return m;
+}
+
+void QgsEarcut::indexCurve( Node *start ) const
+{
+  // interlink polygon nodes in z-order
+  Node *p = start;
+  do
+  {
+    if ( p->z == 0 )
+      p->z = zOrder( p->x, p->y );
+    p->prevZ = p->prev;
+    p->nextZ = p->next;
+    p = p->next;
+  }
+  while ( p != start );
+
+  p->prevZ->nextZ = nullptr;
+  p->prevZ = nullptr;
+
+  sortLinked( p );
+}
+
+int32_t QgsEarcut::zOrder( double x, double y ) const
+{
+  // z-order of a point given coords and inverse of the longer side of data bbox
+  int32_t ix = static_cast< int32_t >( ( x - mMinX ) * mInvSize );
+  int32_t iy = static_cast< int32_t >( ( y - mMinY ) * mInvSize );
+
+  ix = ( ix | ( ix << 8 ) ) & 0x00FF00FF;
+  ix = ( ix | ( ix << 4 ) ) & 0x0F0F0F0F;
+  ix = ( ix | ( ix << 2 ) ) & 0x33333333;
+  ix = ( ix | ( ix << 1 ) ) & 0x55555555;
+
+  iy = ( iy | ( iy << 8 ) ) & 0x00FF00FF;
+  iy = ( iy | ( iy << 4 ) ) & 0x0F0F0F0F;
+  iy = ( iy | ( iy << 2 ) ) & 0x33333333;
+  iy = ( iy | ( iy << 1 ) ) & 0x55555555;
+
+  return ix | ( iy << 1 );
+}
+
+QgsEarcut::Node *QgsEarcut::splitPolygon( Node *a, Node *b )
+{
+  // link two polygon vertices with a bridge; if the vertices belong to the same ring, it splits polygon into two;
+  // if one belongs to the outer ring and another to a hole, it merges it into a single ring
+  mNodes.emplace_back( a->i, a->x, a->y );
+  Node *a2 = &mNodes.back();
+  mNodes.emplace_back( b->i, b->x, b->y );
+  Node *b2 = &mNodes.back();
+  Node *an = a->next;
+  Node *bp = b->prev;
+
+  a->next = b;
+  b->prev = a;
+
+  a2->next = an;
+  an->prev = a2;
+
+  b2->next = a2;
+  a2->prev = b2;
+
+  bp->next = b2;
+  b2->prev = bp;
+
+  return b2;
+}
+
+QgsEarcut::Node *QgsEarcut::insertNode( std::size_t i, double x, double y, Node *last )
+{
+  // create a node and optionally link it with previous one (in a circular doubly linked list)
+  mNodes.emplace_back( static_cast< uint32_t >( i ), x, y );
+  Node *p = &mNodes.back();
+
+  if ( !last )
+  {
+    p->prev = p;
+    p->next = p;
+  }
+  else
+  {
+    p->next = last->next;
+    p->prev = last;
+    last->next->prev = p;
+    last->next = p;
+  }
+  return p;
+}
+
+QgsEarcut::Node *QgsEarcut::sortLinked( Node *list )
+{
+  // Simon Tatham's linked list merge sort algorithm
+  int inSize = 1;
+  int numMerges = 0;
+  do
+  {
+    Node *p = list;
+    list = nullptr;
+    Node *tail = nullptr;
+    numMerges = 0;
+
+    while ( p )
+    {
+      numMerges++;
+      Node *q = p;
+      int pSize = 0;
+      for ( int i = 0; i < inSize; i++ )
+      {
+        pSize++;
+        q = q->nextZ;
+        if ( !q )
+          break;
+      }
+      int qSize = inSize;
+
+      while ( pSize > 0 || ( qSize > 0 && q ) )
+      {
+        Node *e = nullptr;
+        if ( pSize != 0 && ( qSize == 0 || !q || p->z <= q->z ) )
+        {
+          e = p;
+          p = p->nextZ;
+          pSize--;
+        }
+        else
+        {
+          e = q;
+          q = q->nextZ;
+          qSize--;
+        }
+
+        if ( tail )
+          tail->nextZ = e;
+        else
+          list = e;
+
+        e->prevZ = tail;
+        tail = e;
+      }
+
+      p = q;
+    }
+
+    tail->nextZ = nullptr;
+    inSize *= 2;
+  }
+  while ( numMerges > 1 );
+
+  return list;
+}
+
+QgsEarcut::Node *QgsEarcut::leftmost( Node *start )
+{
+  Node *p = start;
+  Node *leftmost = start;
+  do
+  {
+    if ( p->x < leftmost->x || ( p->x == leftmost->x && p->y < leftmost->y ) )
+      leftmost = p;
+    p = p->next;
+  }
+  while ( p != start );
+
+  return leftmost;
+}
+
+bool QgsEarcut::sectorContainsSector( const Node *m, const Node *p )
+{
+  // whether sector in vertex m contains sector in vertex p in the same coordinates
+  return area( m->prev, m, p->prev ) < 0 && area( p->next, m, m->next ) < 0;
+}
+
+bool QgsEarcut::pointInTriangle( double ax, double ay, double bx, double by, double cx, double cy, double px, double py )
+{
+  return ( cx - px ) * ( ay - py ) >= ( ax - px ) * ( cy - py ) &&
+         ( ax - px ) * ( by - py ) >= ( bx - px ) * ( ay - py ) &&
+         ( bx - px ) * ( cy - py ) >= ( cx - px ) * ( by - py );
+}
+
+bool QgsEarcut::isValidDiagonal( Node *a, Node *b )
+{
+  // check if a diagonal between two polygon nodes is valid (lies in polygon interior)
+  return a->next->i != b->i && a->prev->i != b->i && !intersectsPolygon( a, b ) && // doesn't intersect other edges
+         ( ( locallyInside( a, b ) && locallyInside( b, a ) && middleInside( a, b ) && // locally visible
+             ( area( a->prev, a, b->prev ) != 0 || area( a, b->prev, b ) != 0 ) ) || // does not create opposite-facing sectors
+           ( equals( a, b ) && area( a->prev, a, a->next ) > 0 && area( b->prev, b, b->next ) > 0 ) ); // special zero-length case
+}
+
+double QgsEarcut::area( const Node *p, const Node *q, const Node *r )
+{
+  // signed area of a triangle
+  return ( q->y - p->y ) * ( r->x - q->x ) - ( q->x - p->x ) * ( r->y - q->y );
+}
+
+bool QgsEarcut::equals( const Node *p1, const Node *p2 )
+{
+  return p1->x == p2->x && p1->y == p2->y;
+}
+
+bool QgsEarcut::intersects( const Node *p1, const Node *q1, const Node *p2, const Node *q2 )
+{
+  // check if two segments intersect
+  const int o1 = sign( area( p1, q1, p2 ) );
+  const int o2 = sign( area( p1, q1, q2 ) );
+  const int o3 = sign( area( p2, q2, p1 ) );
+  const int o4 = sign( area( p2, q2, q1 ) );
+
+  if ( o1 != o2 && o3 != o4 )
+    return true; // general case
+
+  if ( o1 == 0 && onSegment( p1, p2, q1 ) )
+    return true; // p1, q1 and p2 are collinear and p2 lies on p1q1
+  if ( o2 == 0 && onSegment( p1, q2, q1 ) )
+    return true; // p1, q1 and q2 are collinear and q2 lies on p1q1
+  if ( o3 == 0 && onSegment( p2, p1, q2 ) )
+    return true; // p2, q2 and p1 are collinear and p1 lies on p2q2
+  if ( o4 == 0 && onSegment( p2, q1, q2 ) )
+    return true; // p2, q2 and q1 are collinear and q1 lies on p2q2
+
+  return false;
+}
+
+bool QgsEarcut::onSegment( const Node *p, const Node *q, const Node *r )
+{
+  // for collinear points p, q, r, check if point q lies on segment pr
+  return q->x <= std::max( p->x, r->x ) && q->x >= std::min( p->x, r->x ) &&
+         q->y <= std::max( p->y, r->y ) && q->y >= std::min( p->y, r->y );
+}
+
+int QgsEarcut::sign( double value )
+{
+  return value > 0 ? 1 : value < 0 ? -1 : 0;
+}
+
+bool QgsEarcut::intersectsPolygon( const Node *a, const Node *b )
+{
+  // check if a polygon diagonal intersects any polygon segments
+  const Node *p = a;
+  do
+  {
+    if ( p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i &&
+         intersects( p, p->next, a, b ) )
+      return true;
+    p = p->next;
+  }
+  while ( p != a );
+
+  return false;
+}
+
+bool QgsEarcut::locallyInside( const Node *a, const Node *b )
+{
+  // check if a polygon diagonal is locally inside the polygon
+  return area( a->prev, a, a->next ) < 0 ?
+         area( a, b, a->next ) >= 0 && area( a, a->prev, b ) >= 0 :
+         area( a, b, a->prev ) < 0 || area( a, a->next, b ) < 0;
+}
+
+bool QgsEarcut::middleInside( const Node *a, const Node *b )
+{
+  // check if the middle point of a polygon diagonal is inside the polygon
+  const Node *p = a;
+  bool inside = false;
+  const double px = ( a->x + b->x ) / 2;
+  const double py = ( a->y + b->y ) / 2;
+  do
+  {
+    if ( ( ( p->y > py ) != ( p->next->y > py ) ) && p->next->y != p->y &&
+         ( px < ( p->next->x - p->x ) * ( py - p->y ) / ( p->next->y - p->y ) + p->x ) )
+      inside = !inside;
+    p = p->next;
+  }
+  while ( p != a );
+
+  return inside;
+}
+
+void QgsEarcut::removeNode( Node *p )
+{
+  p->next->prev = p->prev;
+  p->prev->next = p->next;
+
+  if ( p->prevZ )
+    p->prevZ->nextZ = p->nextZ;
+  if ( p->nextZ )
+    p->nextZ->prevZ = p->prevZ;
+}
+
+///@endcond
@@ -0,0 +1,142 @@
+/***************************************************************************
+  qgsearcut_p.h
+  --------------------------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by the QGIS project
+  Email                : qgis-developer at lists dot osgeo dot org
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSEARCUT_P_H
+#define QGSEARCUT_P_H
+
+#define SIP_NO_FILE
+
+/// @cond PRIVATE
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QGIS API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+
+#include "qgis_core.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/**
+ * \ingroup core
+ * Polygon triangulation based on ear clipping, following the approach of the
+ * "earcut" library by Mapbox (z-order curve hashing of vertices, hole elimination
+ * by bridging and a sequence of fallback passes for degenerate input).
+ *
+ * Compared to constrained Delaunay triangulation it produces less regular triangles,
+ * but it is considerably faster, works on contiguous coordinate buffers and it never
+ * fails on self-intersecting or otherwise degenerate rings - in the worst case some
+ * area is left out of the output.
+ *
+ * \since QGIS 3.12
+ */
+class CORE_EXPORT QgsEarcut
+{
+  public:
+
+    /**
+     * Triangulates a polygon.
+     *
+     * \param coords flat array of 2D vertex coordinates (x0, y0, x1, y1, ...) of the exterior ring
+     * followed by all interior rings. Rings must not be explicitly closed (last vertex must not repeat the first).
+     * \param holeIndices index of the first vertex of each interior ring (in vertices, not in coordinates)
+     * \returns indices of vertices of the resulting triangles, three per triangle
+     */
+    static std::vector<uint32_t> triangulate( const std::vector<double> &coords, const std::vector<uint32_t> &holeIndices );
+
+  private:
+
+    struct Node
+    {
+      Node( uint32_t index, double x, double y )
+        : i( index ), x( x ), y( y ) {}
+
+      //! vertex index in the coordinate array
+      uint32_t i;
+      double x;
+      double y;
+
+      //! previous and next vertex nodes in the polygon ring
+      Node *prev = nullptr;
+      Node *next = nullptr;
+
+      //! z-order curve value
+      int32_t z = 0;
+
+      //! previous and next nodes in z-order
+      Node *prevZ = nullptr;
+      Node *nextZ = nullptr;
+
+      //! indicates whether this is a steiner point
+      bool steiner = false;
+    };
+
+    QgsEarcut( const std::vector<double> &coords );
+
+    void run( const std::vector<uint32_t> &holeIndices );
+
+    Node *linkedList( std::size_t start, std::size_t end, bool clockwise );
+    Node *filterPoints( Node *start, Node *end = nullptr );
+    void earcutLinked( Node *ear, int pass = 0 );
+    bool isEar( Node *ear ) const;
+    bool isEarHashed( Node *ear ) const;
+    Node *cureLocalIntersections( Node *start );
+    void splitEarcut( Node *start );
+    Node *eliminateHoles( const std::vector<uint32_t> &holeIndices, Node *outerNode );
+    Node *eliminateHole( Node *hole, Node *outerNode );
+    Node *findHoleBridge( Node *hole, Node *outerNode ) const;
+    void indexCurve( Node *start ) const;
+    int32_t zOrder( double x, double y ) const;
+
+    Node *splitPolygon( Node *a, Node *b );
+    Node *insertNode( std::size_t i, double x, double y, Node *last );
+
+    static Node *sortLinked( Node *list );
+    static Node *leftmost( Node *start );
+    static bool sectorContainsSector( const Node *m, const Node *p );
+    static bool pointInTriangle( double ax, double ay, double bx, double by, double cx, double cy, double px, double py );
+    static bool isValidDiagonal( Node *a, Node *b );
+    static double area( const Node *p, const Node *q, const Node *r );
+    static bool equals( const Node *p1, const Node *p2 );
+    static bool intersects( const Node *p1, const Node *q1, const Node *p2, const Node *q2 );
+    static bool onSegment( const Node *p, const Node *q, const Node *r );
+    static int sign( double value );
+    static bool intersectsPolygon( const Node *a, const Node *b );
+    static bool locallyInside( const Node *a, const Node *b );
+    static bool middleInside( const Node *a, const Node *b );
+    static void removeNode( Node *p );
+
+    const std::vector<double> &mCoords;
+
+    //! storage of all nodes - deque keeps node addresses stable while growing
+    std::deque<Node> mNodes;
+
+    std::vector<uint32_t> mTriangles;
+
+    bool mHashing = false;
+    double mMinX = 0;
+    double mMinY = 0;
+    double mInvSize = 0;
+};
+
+/// @endcond
+
+#endif // QGSEARCUT_P_H
@@ -77,7 +77,8 @@ class CORE_EXPORT QgsFeatureRequest
       NoFlags            = 0,
       NoGeometry         = 1,  //!< Geometry is not required. It may still be returned if e.g. required for a filter condition.
       SubsetOfAttributes = 2,  //!< Fetch only a subset of attributes (setSubsetOfAttributes sets this flag)
-      ExactIntersect     = 4   //!< Use exact geometry intersection (slower) instead of bounding boxes
+      ExactIntersect     = 4,  //!< Use exact geometry intersection (slower) instead of bounding boxes
+      RecycleGeometry    = 8,  //!< Allow the iterator to decode the geometry of a fetched feature into the geometry of the feature passed to nextFeature(), recycling its coordinate storage. Must only be used when no pointers to the geometry's parts are kept beyond the current iteration step (since QGIS 3.12)
     };
     Q_DECLARE_FLAGS( Flags, Flag )
 
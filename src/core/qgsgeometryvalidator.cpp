@@ -18,6 +18,10 @@ email                : jef at norbit dot de
 #include "qgsgeometry.h"
 #include "qgslogger.h"
 #include "qgsgeos.h"
+#include "qgsfeedback.h"
+
+#include <numeric>
+#include <QtConcurrentMap>
 
 QgsGeometryValidator::QgsGeometryValidator( const QgsGeometry &geometry, QVector<QgsGeometry::Error> *errors, QgsGeometry::ValidationMethod method )
   : mGeometry( geometry )
@@ -339,10 +343,29 @@ void QgsGeometryValidator::addError( const QgsGeometry::Error &e )
 
 void QgsGeometryValidator::validateGeometry( const QgsGeometry &geometry, QVector<QgsGeometry::Error> &errors, QgsGeometry::ValidationMethod method )
 {
-  QgsGeometryValidator *gv = new QgsGeometryValidator( geometry, &errors, method );
-  connect( gv, &QgsGeometryValidator::errorFound, gv, &QgsGeometryValidator::addError );
-  gv->run();
-  gv->wait();
+  QgsGeometryValidator gv( geometry, &errors, method );
+  connect( &gv, &QgsGeometryValidator::errorFound, &gv, &QgsGeometryValidator::addError );
+  gv.run();
+  gv.wait();
+}
+
+QVector< QVector< QgsGeometry::Error > > QgsGeometryValidator::validateGeometries( const QVector<QgsGeometry> &geometries, QgsGeometry::ValidationMethod method, QgsGeometry::ValidityFlags flags, QgsFeedback *feedback )
+{
+  QVector< QVector< QgsGeometry::Error > > errors( geometries.size() );
+
+  QVector< int > indices( geometries.size() );
+  std::iota( indices.begin(), indices.end(), 0 );
+
+  // each worker only writes to the error list of its own geometry
+  QtConcurrent::blockingMap( indices, [&geometries, &errors, method, flags, feedback]( int index )
+  {
+    if ( feedback && feedback->isCanceled() )
+      return;
+
+    geometries.at( index ).validateGeometry( errors[ index ], method, flags );
+  } );
+
+  return errors;
 }
 
 //
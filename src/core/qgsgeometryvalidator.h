@@ -21,6 +21,8 @@ email                : jef at norbit dot de
 #include <QThread>
 #include "qgsgeometry.h"
 
+class QgsFeedback;
+
 /**
  * \ingroup core
  * \class QgsGeometryValidator
@@ -46,6 +48,21 @@ class CORE_EXPORT QgsGeometryValidator : public QThread
      */
     static void validateGeometry( const QgsGeometry &geometry, QVector<QgsGeometry::Error> &errors SIP_OUT, QgsGeometry::ValidationMethod method = QgsGeometry::ValidatorQgisInternal );
 
+    /**
+     * Validates a list of \a geometries using multiple threads and returns the list of errors found
+     * for each geometry, in the same order as the input \a geometries.
+     *
+     * The \a method and \a flags arguments have the same meaning as for QgsGeometry::validateGeometry().
+     *
+     * If a \a feedback object is specified, it can be used to cancel the validation. Geometries which
+     * were not validated because of the cancellation are reported without errors.
+     *
+     * This method blocks until all geometries are validated.
+     *
+     * \since QGIS 3.12
+     */
+    static QVector< QVector< QgsGeometry::Error > > validateGeometries( const QVector< QgsGeometry > &geometries, QgsGeometry::ValidationMethod method = QgsGeometry::ValidatorQgisInternal, QgsGeometry::ValidityFlags flags = nullptr, QgsFeedback *feedback = nullptr );
+
   signals:
 
     /**
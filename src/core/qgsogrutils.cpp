@@ -500,62 +500,21 @@ QgsWkbTypes::Type QgsOgrUtils::ogrGeometryTypeToQgsWkbType( OGRwkbGeometryType o
   return QgsWkbTypes::Type::Unknown;
 }
 
-QgsGeometry QgsOgrUtils::ogrGeometryToQgsGeometry( OGRGeometryH geom )
+static void ogrGeometryToWkb( OGRGeometryH geom, QByteArray &wkbBuffer, bool forceMultiType )
 {
-  if ( !geom )
-    return QgsGeometry();
-
-  const auto ogrGeomType = OGR_G_GetGeometryType( geom );
-  QgsWkbTypes::Type wkbType = ogrGeometryTypeToQgsWkbType( ogrGeomType );
-
-  // optimised case for some geometry classes, avoiding wkb conversion on OGR/QGIS sides
-  // TODO - extend to other classes!
-  switch ( QgsWkbTypes::flatType( wkbType ) )
-  {
-    case QgsWkbTypes::Point:
-    {
-      return QgsGeometry( ogrGeometryToQgsPoint( geom ) );
-    }
-
-    case QgsWkbTypes::MultiPoint:
-    {
-      return QgsGeometry( ogrGeometryToQgsMultiPoint( geom ) );
-    }
-
-    case QgsWkbTypes::LineString:
-    {
-      // optimised case for line -- avoid wkb conversion
-      return QgsGeometry( ogrGeometryToQgsLineString( geom ) );
-    }
-
-    case QgsWkbTypes::MultiLineString:
-    {
-      // optimised case for line -- avoid wkb conversion
-      return QgsGeometry( ogrGeometryToQgsMultiLineString( geom ) );
-    }
-
-    default:
-      break;
-  };
-
-  // Fallback to inefficient WKB conversions
-
-  if ( wkbFlatten( wkbType ) == wkbGeometryCollection )
-  {
-    // Shapefile MultiPatch can be reported as GeometryCollectionZ of TINZ
-    if ( OGR_G_GetGeometryCount( geom ) >= 1 &&
-         wkbFlatten( OGR_G_GetGeometryType( OGR_G_GetGeometryRef( geom, 0 ) ) ) == wkbTIN )
-    {
-      auto newGeom = OGR_G_ForceToMultiPolygon( OGR_G_Clone( geom ) );
-      auto ret = ogrGeometryToQgsGeometry( newGeom );
-      OGR_G_DestroyGeometry( newGeom );
-      return ret;
-    }
-  }
-
   // get the wkb representation
-  int memorySize = OGR_G_WkbSize( geom );
-  unsigned char *wkb = new unsigned char[memorySize];
+  const int memorySize = OGR_G_WkbSize( geom );
+
+  // single part geometries get wrapped in a multi part collection with a single part,
+  // so we need some extra space for the collection's header
+  const OGRwkbGeometryType flatType = wkbFlatten( OGR_G_GetGeometryType( geom ) );
+  const bool wrapInMulti = forceMultiType && ( flatType == wkbPoint || flatType == wkbLineString || flatType == wkbPolygon
+                           || flatType == wkbCircularString || flatType == wkbCompoundCurve || flatType == wkbCurvePolygon );
+  const int headerSize = wrapInMulti ? 1 + 2 * sizeof( uint32_t ) : 0;
+
+  // resizing does not shrink the allocated buffer, so the buffer gets reused between features
+  wkbBuffer.resize( headerSize + memorySize );
+  unsigned char *wkb = reinterpret_cast< unsigned char * >( wkbBuffer.data() ) + headerSize;
   OGR_G_ExportToWkb( geom, static_cast<OGRwkbByteOrder>( QgsApplication::endian() ), wkb );
 
   // Read original geometry type
@@ -616,11 +575,105 @@ QgsGeometry QgsOgrUtils::ogrGeometryToQgsGeometry( OGRGeometryH geom )
     memcpy( wkb + 1, &newType, sizeof( uint32_t ) );
   }
 
+  if ( wrapInMulti )
+  {
+    uint32_t geomType;
+    memcpy( &geomType, wkb + 1, sizeof( uint32_t ) );
+    const uint32_t multiType = static_cast<uint32_t>( QgsWkbTypes::multiType( static_cast< QgsWkbTypes::Type >( geomType ) ) );
+    const uint32_t numGeoms = 1;
+    unsigned char *header = reinterpret_cast< unsigned char * >( wkbBuffer.data() );
+    header[0] = wkb[0]; // endianness
+    memcpy( header + 1, &multiType, sizeof( uint32_t ) );
+    memcpy( header + 1 + sizeof( uint32_t ), &numGeoms, sizeof( uint32_t ) );
+  }
+}
+
+QgsGeometry QgsOgrUtils::ogrGeometryToQgsGeometry( OGRGeometryH geom )
+{
+  if ( !geom )
+    return QgsGeometry();
+
+  const auto ogrGeomType = OGR_G_GetGeometryType( geom );
+  QgsWkbTypes::Type wkbType = ogrGeometryTypeToQgsWkbType( ogrGeomType );
+
+  // optimised case for some geometry classes, avoiding wkb conversion on OGR/QGIS sides
+  // TODO - extend to other classes!
+  switch ( QgsWkbTypes::flatType( wkbType ) )
+  {
+    case QgsWkbTypes::Point:
+    {
+      return QgsGeometry( ogrGeometryToQgsPoint( geom ) );
+    }
+
+    case QgsWkbTypes::MultiPoint:
+    {
+      return QgsGeometry( ogrGeometryToQgsMultiPoint( geom ) );
+    }
+
+    case QgsWkbTypes::LineString:
+    {
+      // optimised case for line -- avoid wkb conversion
+      return QgsGeometry( ogrGeometryToQgsLineString( geom ) );
+    }
+
+    case QgsWkbTypes::MultiLineString:
+    {
+      // optimised case for line -- avoid wkb conversion
+      return QgsGeometry( ogrGeometryToQgsMultiLineString( geom ) );
+    }
+
+    default:
+      break;
+  };
+
+  // Fallback to inefficient WKB conversions
+
+  if ( wkbFlatten( wkbType ) == wkbGeometryCollection )
+  {
+    // Shapefile MultiPatch can be reported as GeometryCollectionZ of TINZ
+    if ( OGR_G_GetGeometryCount( geom ) >= 1 &&
+         wkbFlatten( OGR_G_GetGeometryType( OGR_G_GetGeometryRef( geom, 0 ) ) ) == wkbTIN )
+    {
+      auto newGeom = OGR_G_ForceToMultiPolygon( OGR_G_Clone( geom ) );
+      auto ret = ogrGeometryToQgsGeometry( newGeom );
+      OGR_G_DestroyGeometry( newGeom );
+      return ret;
+    }
+  }
+
+  QByteArray wkb;
+  ogrGeometryToWkb( geom, wkb, false );
+
   QgsGeometry g;
-  g.fromWkb( wkb, memorySize );
+  g.fromWkb( wkb );
   return g;
 }
 
+void QgsOgrUtils::ogrGeometryToQgsGeometry( OGRGeometryH geom, QgsGeometry &geometry, QByteArray &wkbBuffer, bool forceMultiType )
+{
+  if ( !geom )
+  {
+    geometry = QgsGeometry();
+    return;
+  }
+
+  if ( wkbFlatten( OGR_G_GetGeometryType( geom ) ) == wkbGeometryCollection
+       && OGR_G_GetGeometryCount( geom ) >= 1
+       && wkbFlatten( OGR_G_GetGeometryType( OGR_G_GetGeometryRef( geom, 0 ) ) ) == wkbTIN )
+  {
+    // rare case which needs a conversion by OGR, no point in trying to recycle the geometry
+    geometry = ogrGeometryToQgsGeometry( geom );
+    if ( forceMultiType )
+      geometry.convertToMultiType();
+    return;
+  }
+
+  ogrGeometryToWkb( geom, wkbBuffer, forceMultiType );
+
+  // decodes in place if the geometry is not shared and of the same type
+  geometry.fromWkbRecycled( wkbBuffer );
+}
+
 QgsFeatureList QgsOgrUtils::stringToFeatureList( const QString &string, const QgsFields &fields, QTextCodec *encoding )
 {
   QgsFeatureList features;
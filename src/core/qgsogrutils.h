@@ -235,6 +235,21 @@ class CORE_EXPORT QgsOgrUtils
      */
     static QgsGeometry ogrGeometryToQgsGeometry( OGRGeometryH geom );
 
+    /**
+     * Converts an OGR geometry representation to a QgsGeometry object, decoding it into an
+     * existing \a geometry.
+     *
+     * If \a geometry is not shared with any other QgsGeometry object and it is of the same type as \a geom,
+     * it is decoded in place, recycling the storage of its coordinates. The \a wkbBuffer is used as
+     * a scratch buffer for the conversion and should be kept by the caller across calls.
+     *
+     * If \a forceMultiType is TRUE, single part geometries are converted to the matching multi part type.
+     *
+     * \see ogrGeometryToQgsGeometry()
+     * \since QGIS 3.12
+     */
+    static void ogrGeometryToQgsGeometry( OGRGeometryH geom, QgsGeometry &geometry, QByteArray &wkbBuffer, bool forceMultiType = false );
+
     /**
      * Attempts to parse a string representing a collection of features using OGR. For example, this method can be
      * used to convert a GeoJSON encoded collection to a list of QgsFeatures.
@@ -24,9 +24,11 @@
 #include "qgstriangle.h"
 #include "qgis_sip.h"
 #include "qgsgeometryengine.h"
+#include "qgsearcut_p.h"
 
 #include "poly2tri.h"
 
+#include <QtConcurrentMap>
 #include <QtDebug>
 #include <QMatrix4x4>
 #include <QVector3D>
@@ -260,6 +262,24 @@ static void _ringToPoly2tri( const QgsLineString *ring, std::vector<p2t::Point *
   }
 }
 
+static void _ringToEarcut( const QgsLineString *ring, std::vector<double> &coords, std::vector<float> *z )
+{
+  // the last point is a duplicate of the first one - earcut expects open rings
+  const int pCount = ring->numPoints() - 1;
+
+  const double *srcXData = ring->xData();
+  const double *srcYData = ring->yData();
+  const double *srcZData = ring->zData();
+
+  for ( int i = 0; i < pCount; ++i )
+  {
+    coords.push_back( *srcXData++ );
+    coords.push_back( *srcYData++ );
+    if ( z )
+      z->push_back( *srcZData++ );
+  }
+}
+
 
 inline double _round_coord( double x )
 {
@@ -493,112 +513,164 @@ void QgsTessellator::addPolygon( const QgsPolygon &polygon, float extrusionHeigh
 
     std::unique_ptr<QgsPolygon> polygonNew( _transform_polygon_to_new_base( polygon, pt0, toNewBase.get(), scaleX, scaleY ) );
 
-    if ( _minimum_distance_between_coordinates( *polygonNew ) < 0.001 )
+    // transforms a vertex of the triangulation back from the new base and writes it to the output data array
+    auto addVertex = [&]( double x, double y, double z, bool backFace )
     {
-      // when the distances between coordinates of input points are very small,
-      // the triangulation likes to crash on numerical errors - when the distances are ~ 1e-5
-      // Assuming that the coordinates should be in a projected CRS, we should be able
-      // to simplify geometries that may cause problems and avoid possible crashes
-      QgsGeometry polygonSimplified = QgsGeometry( polygonNew->clone() ).simplify( 0.001 );
-      if ( polygonSimplified.isNull() )
+      QVector4D pt( x, y, mNoZ ? 0 : z, 0 );
+      if ( toOldBase )
+        pt = *toOldBase * pt;
+      const double fx = ( pt.x() / scaleX ) - mOriginX + pt0.x();
+      const double fy = ( pt.y() / scaleY ) - mOriginY + pt0.y();
+      const double fz = mNoZ ? 0 : ( pt.z() + extrusionHeight + pt0.z() );
+      mData << fx << fz << -fy;
+      if ( mAddNormals )
       {
-        QgsMessageLog::logMessage( QObject::tr( "geometry simplification failed - skipping" ), QObject::tr( "3D" ) );
-        return;
+        if ( backFace )
+          mData << -pNormal.x() << -pNormal.z() << pNormal.y();
+        else
+          mData << pNormal.x() << pNormal.z() << - pNormal.y();
       }
-      const QgsPolygon *polygonSimplifiedData = qgsgeometry_cast<const QgsPolygon *>( polygonSimplified.constGet() );
-      if ( _minimum_distance_between_coordinates( *polygonSimplifiedData ) < 0.001 )
+    };
+
+    if ( mAlgorithm == Earcut )
+    {
+      // ear clipping does not have problems with close or duplicate coordinates nor with touching
+      // or self-intersecting rings, so we can skip the (expensive) checks needed for poly2tri
+      std::vector<double> coords;
+      std::vector<float> z;
+      std::vector<uint32_t> holeIndices;
+      int totalPoints = polygonNew->exteriorRing()->numPoints();
+      for ( int i = 0; i < polygonNew->numInteriorRings(); ++i )
+        totalPoints += polygonNew->interiorRing( i )->numPoints();
+      coords.reserve( 2 * totalPoints );
+      if ( !mNoZ )
+        z.reserve( totalPoints );
+
+      _ringToEarcut( qgsgeometry_cast< const QgsLineString * >( polygonNew->exteriorRing() ), coords, mNoZ ? nullptr : &z );
+      for ( int i = 0; i < polygonNew->numInteriorRings(); ++i )
       {
-        // Failed to fix that. It could be a really tiny geometry... or maybe they gave us
-        // geometry in unprojected lat/lon coordinates
-        QgsMessageLog::logMessage( QObject::tr( "geometry's coordinates are too close to each other and simplification failed - skipping" ), QObject::tr( "3D" ) );
-        return;
+        holeIndices.push_back( static_cast< uint32_t >( coords.size() / 2 ) );
+        _ringToEarcut( qgsgeometry_cast< const QgsLineString * >( polygonNew->interiorRing( i ) ), coords, mNoZ ? nullptr : &z );
       }
-      else
+
+      const std::vector<uint32_t> triangles = QgsEarcut::triangulate( coords, holeIndices );
+
+      mData.reserve( mData.size() + triangles.size() * ( ( mAddNormals ? 6 : 3 ) * ( mAddBackFaces ? 2 : 1 ) ) );
+      for ( std::size_t i = 0; i + 2 < triangles.size(); i += 3 )
       {
-        polygonNew.reset( polygonSimplifiedData->clone() );
+        uint32_t idx[3] = { triangles[i], triangles[i + 1], triangles[i + 2] };
+
+        // output vertices in counter-clockwise order (as poly2tri does)
+        const double *a = &coords[2 * idx[0]];
+        const double *b = &coords[2 * idx[1]];
+        const double *c = &coords[2 * idx[2]];
+        if ( ( b[0] - a[0] ) * ( c[1] - a[1] ) - ( c[0] - a[0] ) * ( b[1] - a[1] ) < 0 )
+          std::swap( idx[1], idx[2] );
+
+        for ( int j = 0; j < 3; ++j )
+          addVertex( coords[2 * idx[j]], coords[2 * idx[j] + 1], mNoZ ? 0 : z[idx[j]], false );
+
+        if ( mAddBackFaces )
+        {
+          // the same triangle with reversed order of coordinates and inverted normal
+          for ( int j = 2; j >= 0; --j )
+            addVertex( coords[2 * idx[j]], coords[2 * idx[j] + 1], mNoZ ? 0 : z[idx[j]], true );
+        }
       }
     }
-
-    if ( !_check_intersecting_rings( *polygonNew ) )
+    else
     {
-      // skip the polygon - it would cause a crash inside poly2tri library
-      QgsMessageLog::logMessage( QObject::tr( "polygon rings self-intersect or intersect each other - skipping" ), QObject::tr( "3D" ) );
-      return;
-    }
-
-    QList< std::vector<p2t::Point *> > polylinesToDelete;
-    QHash<p2t::Point *, float> z;
+      if ( _minimum_distance_between_coordinates( *polygonNew ) < 0.001 )
+      {
+        // when the distances between coordinates of input points are very small,
+        // the triangulation likes to crash on numerical errors - when the distances are ~ 1e-5
+        // Assuming that the coordinates should be in a projected CRS, we should be able
+        // to simplify geometries that may cause problems and avoid possible crashes
+        QgsGeometry polygonSimplified = QgsGeometry( polygonNew->clone() ).simplify( 0.001 );
+        if ( polygonSimplified.isNull() )
+        {
+          QgsMessageLog::logMessage( QObject::tr( "geometry simplification failed - skipping" ), QObject::tr( "3D" ) );
+          return;
+        }
+        const QgsPolygon *polygonSimplifiedData = qgsgeometry_cast<const QgsPolygon *>( polygonSimplified.constGet() );
+        if ( _minimum_distance_between_coordinates( *polygonSimplifiedData ) < 0.001 )
+        {
+          // Failed to fix that. It could be a really tiny geometry... or maybe they gave us
+          // geometry in unprojected lat/lon coordinates
+          QgsMessageLog::logMessage( QObject::tr( "geometry's coordinates are too close to each other and simplification failed - skipping" ), QObject::tr( "3D" ) );
+          return;
+        }
+        else
+        {
+          polygonNew.reset( polygonSimplifiedData->clone() );
+        }
+      }
 
-    // polygon exterior
-    std::vector<p2t::Point *> polyline;
-    _ringToPoly2tri( qgsgeometry_cast< const QgsLineString * >( polygonNew->exteriorRing() ), polyline, mNoZ ? nullptr : &z );
-    polylinesToDelete << polyline;
+      if ( !_check_intersecting_rings( *polygonNew ) )
+      {
+        // skip the polygon - it would cause a crash inside poly2tri library
+        QgsMessageLog::logMessage( QObject::tr( "polygon rings self-intersect or intersect each other - skipping" ), QObject::tr( "3D" ) );
+        return;
+      }
 
-    std::unique_ptr<p2t::CDT> cdt( new p2t::CDT( polyline ) );
+      QList< std::vector<p2t::Point *> > polylinesToDelete;
+      QHash<p2t::Point *, float> z;
 
-    // polygon holes
-    for ( int i = 0; i < polygonNew->numInteriorRings(); ++i )
-    {
-      std::vector<p2t::Point *> holePolyline;
-      const QgsLineString *hole = qgsgeometry_cast< const QgsLineString *>( polygonNew->interiorRing( i ) );
+      // polygon exterior
+      std::vector<p2t::Point *> polyline;
+      _ringToPoly2tri( qgsgeometry_cast< const QgsLineString * >( polygonNew->exteriorRing() ), polyline, mNoZ ? nullptr : &z );
+      polylinesToDelete << polyline;
 
-      _ringToPoly2tri( hole, holePolyline, mNoZ ? nullptr : &z );
+      std::unique_ptr<p2t::CDT> cdt( new p2t::CDT( polyline ) );
 
-      cdt->AddHole( holePolyline );
-      polylinesToDelete << holePolyline;
-    }
+      // polygon holes
+      for ( int i = 0; i < polygonNew->numInteriorRings(); ++i )
+      {
+        std::vector<p2t::Point *> holePolyline;
+        const QgsLineString *hole = qgsgeometry_cast< const QgsLineString *>( polygonNew->interiorRing( i ) );
 
-    // run triangulation and write vertices to the output data array
-    try
-    {
-      cdt->Triangulate();
+        _ringToPoly2tri( hole, holePolyline, mNoZ ? nullptr : &z );
 
-      std::vector<p2t::Triangle *> triangles = cdt->GetTriangles();
+        cdt->AddHole( holePolyline );
+        polylinesToDelete << holePolyline;
+      }
 
-      mData.reserve( mData.size() + triangles.size() * ( ( mAddNormals ? 6 : 3 ) * ( mAddBackFaces ? 2 : 1 ) ) );
-      for ( size_t i = 0; i < triangles.size(); ++i )
+      // run triangulation and write vertices to the output data array
+      try
       {
-        p2t::Triangle *t = triangles[i];
-        for ( int j = 0; j < 3; ++j )
-        {
-          p2t::Point *p = t->GetPoint( j );
-          QVector4D pt( p->x, p->y, mNoZ ? 0 : z[p], 0 );
-          if ( toOldBase )
-            pt = *toOldBase * pt;
-          const double fx = ( pt.x() / scaleX ) - mOriginX + pt0.x();
-          const double fy = ( pt.y() / scaleY ) - mOriginY + pt0.y();
-          const double fz = mNoZ ? 0 : ( pt.z() + extrusionHeight + pt0.z() );
-          mData << fx << fz << -fy;
-          if ( mAddNormals )
-            mData << pNormal.x() << pNormal.z() << - pNormal.y();
-        }
+        cdt->Triangulate();
 
-        if ( mAddBackFaces )
+        std::vector<p2t::Triangle *> triangles = cdt->GetTriangles();
+
+        mData.reserve( mData.size() + triangles.size() * ( ( mAddNormals ? 6 : 3 ) * ( mAddBackFaces ? 2 : 1 ) ) );
+        for ( size_t i = 0; i < triangles.size(); ++i )
         {
-          // the same triangle with reversed order of coordinates and inverted normal
-          for ( int j = 2; j >= 0; --j )
+          p2t::Triangle *t = triangles[i];
+          for ( int j = 0; j < 3; ++j )
           {
             p2t::Point *p = t->GetPoint( j );
-            QVector4D pt( p->x, p->y, mNoZ ? 0 : z[p], 0 );
-            if ( toOldBase )
-              pt = *toOldBase * pt;
-            const double fx = ( pt.x() / scaleX ) - mOriginX + pt0.x();
-            const double fy = ( pt.y() / scaleY ) - mOriginY + pt0.y();
-            const double fz = mNoZ ? 0 : ( pt.z() + extrusionHeight + pt0.z() );
-            mData << fx << fz << -fy;
-            if ( mAddNormals )
-              mData << -pNormal.x() << -pNormal.z() << pNormal.y();
+            addVertex( p->x, p->y, mNoZ ? 0 : z[p], false );
+          }
+
+          if ( mAddBackFaces )
+          {
+            // the same triangle with reversed order of coordinates and inverted normal
+            for ( int j = 2; j >= 0; --j )
+            {
+              p2t::Point *p = t->GetPoint( j );
+              addVertex( p->x, p->y, mNoZ ? 0 : z[p], true );
+            }
           }
         }
       }
-    }
-    catch ( ... )
-    {
-      QgsMessageLog::logMessage( QObject::tr( "Triangulation failed. Skipping polygon…" ), QObject::tr( "3D" ) );
-    }
+      catch ( ... )
+      {
+        QgsMessageLog::logMessage( QObject::tr( "Triangulation failed. Skipping polygon…" ), QObject::tr( "3D" ) );
+      }
 
-    for ( int i = 0; i < polylinesToDelete.count(); ++i )
-      qDeleteAll( polylinesToDelete[i] );
+      for ( int i = 0; i < polylinesToDelete.count(); ++i )
+        qDeleteAll( polylinesToDelete[i] );
+    }
   }
 
   // add walls if extrusion is enabled
@@ -611,6 +683,71 @@ void QgsTessellator::addPolygon( const QgsPolygon &polygon, float extrusionHeigh
   }
 }
 
+void QgsTessellator::addPolygons( const QVector<const QgsPolygon *> &polygons, const QVector<float> &extrusionHeights, QVector<int> *startingVertexIndices )
+{
+  Q_ASSERT( extrusionHeights.isEmpty() || extrusionHeights.count() == polygons.count() );
+
+  // number of polygons tessellated by one task - large enough to hide the overhead
+  // of scheduling, small enough to keep all threads busy until the end
+  static const int BATCH_SIZE = 64;
+
+  struct Batch
+  {
+    int first = 0;
+    int count = 0;
+    QVector<float> data;
+    QVector<int> startingVertexIndices;
+  };
+
+  QVector<Batch> batches;
+  batches.reserve( polygons.count() / BATCH_SIZE + 1 );
+  for ( int first = 0; first < polygons.count(); first += BATCH_SIZE )
+  {
+    Batch batch;
+    batch.first = first;
+    batch.count = std::min( BATCH_SIZE, polygons.count() - first );
+    batches << batch;
+  }
+
+  auto tessellateBatch = [this, &polygons, &extrusionHeights]( Batch & batch )
+  {
+    // each batch gets its own tessellator with the same configuration and an empty output array
+    QgsTessellator tessellator( *this );
+    tessellator.mData = QVector<float>();
+    batch.startingVertexIndices.reserve( batch.count );
+    for ( int i = batch.first; i < batch.first + batch.count; ++i )
+    {
+      batch.startingVertexIndices << tessellator.dataVerticesCount();
+      tessellator.addPolygon( *polygons.at( i ), extrusionHeights.isEmpty() ? 0 : extrusionHeights.at( i ) );
+    }
+    batch.data = tessellator.mData;
+  };
+
+  if ( batches.count() == 1 )
+    tessellateBatch( batches[0] );
+  else
+    QtConcurrent::blockingMap( batches, tessellateBatch );
+
+  // concatenate the results in the original order of polygons
+  int totalSize = mData.size();
+  for ( const Batch &batch : qgis::as_const( batches ) )
+    totalSize += batch.data.size();
+  mData.reserve( totalSize );
+  if ( startingVertexIndices )
+    startingVertexIndices->reserve( startingVertexIndices->size() + polygons.count() );
+
+  for ( const Batch &batch : qgis::as_const( batches ) )
+  {
+    if ( startingVertexIndices )
+    {
+      const int offset = dataVerticesCount();
+      for ( int index : batch.startingVertexIndices )
+        startingVertexIndices->append( offset + index );
+    }
+    mData += batch.data;
+  }
+}
+
 QgsPoint getPointFromData( QVector< float >::const_iterator &it )
 {
   // tessellator geometry is x, z, -y
@@ -54,9 +54,49 @@ class CORE_EXPORT QgsTessellator
      */
     QgsTessellator( const QgsRectangle &bounds, bool addNormals, bool invertNormals = false, bool addBackFaces = false, bool noZ = false );
 
+    /**
+     * Algorithm used to triangulate polygons.
+     * \since QGIS 3.12
+     */
+    enum TriangulationAlgorithm
+    {
+      ConstrainedDelaunay, //!< Constrained Delaunay triangulation (poly2tri library). Produces well shaped triangles, but it is slower and fails on degenerate input.
+      Earcut, //!< Ear clipping triangulation. Significantly faster and tolerant to degenerate input, at the expense of less regular triangles.
+    };
+
+    /**
+     * Returns the algorithm used to triangulate polygons.
+     * \see setTriangulationAlgorithm()
+     * \since QGIS 3.12
+     */
+    TriangulationAlgorithm triangulationAlgorithm() const { return mAlgorithm; }
+
+    /**
+     * Sets the \a algorithm used to triangulate polygons. The default is ConstrainedDelaunay.
+     * \see triangulationAlgorithm()
+     * \since QGIS 3.12
+     */
+    void setTriangulationAlgorithm( TriangulationAlgorithm algorithm ) { mAlgorithm = algorithm; }
+
     //! Tessellates a triangle and adds its vertex entries to the output data array
     void addPolygon( const QgsPolygon &polygon, float extrusionHeight );
 
+    /**
+     * Tessellates a list of \a polygons and adds their vertex entries to the output data array.
+     *
+     * The polygons are split into batches which are tessellated in parallel on the global thread pool,
+     * the resulting vertex data are appended to the output data array in the order of the input polygons,
+     * so the result is identical to calling addPolygon() for each of the polygons.
+     *
+     * The \a extrusionHeights list must either be empty (no extrusion) or contain one value for each polygon.
+     *
+     * If \a startingVertexIndices is specified, it will be filled with the index of the first vertex
+     * in the output data array for each of the polygons.
+     *
+     * \since QGIS 3.12
+     */
+    void addPolygons( const QVector<const QgsPolygon *> &polygons, const QVector<float> &extrusionHeights, QVector<int> *startingVertexIndices = nullptr ) SIP_SKIP;
+
     /**
      * Returns array of triangle vertex data
      *
@@ -86,6 +126,7 @@ class CORE_EXPORT QgsTessellator
     QVector<float> mData;
     int mStride;
     bool mNoZ = false;
+    TriangulationAlgorithm mAlgorithm = ConstrainedDelaunay;
 };
 
 #endif // QGSTESSELLATOR_H
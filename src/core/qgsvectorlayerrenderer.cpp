@@ -269,6 +269,14 @@ bool QgsVectorLayerRenderer::render()
     context.setVectorSimplifyMethod( vectorMethod );
   }
 
+  const bool usingSymbolLevels = ( mRenderer->capabilities() & QgsFeatureRenderer::SymbolLevels ) && mRenderer->usingSymbolLevels();
+  if ( !usingSymbolLevels )
+  {
+    // features are rendered one by one and they are not kept around afterwards,
+    // so the iterator may recycle geometry storage of the previous feature
+    featureRequest.setFlags( featureRequest.flags() | QgsFeatureRequest::RecycleGeometry );
+  }
+
   QgsFeatureIterator fit = mSource->getFeatures( featureRequest );
   // Attach an interruption checker so that iterators that have potentially
   // slow fetchFeature() implementations, such as in the WFS provider, can
@@ -276,7 +284,7 @@ bool QgsVectorLayerRenderer::render()
   // in drawRenderer()
   fit.setInterruptionChecker( mInterruptionChecker.get() );
 
-  if ( ( mRenderer->capabilities() & QgsFeatureRenderer::SymbolLevels ) && mRenderer->usingSymbolLevels() )
+  if ( usingSymbolLevels )
     drawRendererLevels( fit );
   else
     drawRenderer( fit );
@@ -354,6 +362,10 @@ void QgsVectorLayerRenderer::drawRenderer( QgsFeatureIterator &fit )
           }
         }
       }
+
+      // do not keep a reference to the feature in the expression context, otherwise its geometry
+      // could not be recycled when fetching the next feature
+      symbolScope->removeFeature();
     }
     catch ( const QgsCsException &cse )
     {
@@ -33,6 +33,7 @@
 #include "qgs3dutils.h"
 #include "qgscameracontroller.h"
 #include "qgschunknode_p.h"
+#include "qgsdemheightmapcache_p.h"
 #include "qgsdemterraingenerator.h"
 #include "qgsflatterraingenerator.h"
 #include "qgsline3dsymbol.h"
@@ -40,15 +41,19 @@
 #include "qgspolygon3dsymbol.h"
 #include "qgsrulebased3drenderer.h"
 #include "qgsterrainentity_p.h"
+#include "qgsvectorlayerchunkloader_p.h"
+#include "qgstilingscheme.h"
 #include "qgsvectorlayer3drenderer.h"
 #include "qgsmeshlayer3drenderer.h"
 #include "qgspoint3dsymbol.h"
+#include "qgspoint3dsymbol_p.h"
 #include "qgssymbollayer.h"
 #include "qgsmarkersymbollayer.h"
 
 #include <QFileInfo>
 #include <QDir>
 #include <QDesktopWidget>
+#include <QTemporaryDir>
 
 class TestQgs3DRendering : public QObject
 {
@@ -59,13 +64,18 @@ class TestQgs3DRendering : public QObject
     void cleanupTestCase();// will be called after the last testfunction was executed.
     void testFlatTerrain();
     void testDemTerrain();
+    void testDemHeightMapCache();
     void testExtrudedPolygons();
     void testLineRendering();
+    void testEmptyVectorLayer();
+    void testMultiTileVectorLayer();
     void testMapTheme();
     void testMesh();
     void testRuleBasedRenderer();
     void testAnimationExport();
     void testBillboardRendering();
+    void testReadObjModel();
+    void testInstancedModel();
 
   private:
     bool renderCheck( const QString &testName, QImage &image, int mismatchCount = 0 );
@@ -260,6 +270,54 @@ void TestQgs3DRendering::testDemTerrain()
   QVERIFY( renderCheck( "dem_terrain_1", img3, 40 ) );
 }
 
+void TestQgs3DRendering::testDemHeightMapCache()
+{
+  QTemporaryDir dir;
+  QVERIFY( dir.isValid() );
+
+  QgsTilingScheme tilingScheme( mLayerDtm->extent(), mLayerDtm->crs() );
+  QByteArray heightMap( 16 * 16 * sizeof( float ), Qt::Uninitialized );
+  float *heights = reinterpret_cast<float *>( heightMap.data() );
+  for ( int i = 0; i < 16 * 16; ++i )
+    heights[i] = i % 7 == 0 ? std::numeric_limits<float>::quiet_NaN() : i * 0.5f;
+
+  QgsDemHeightMapCache cache( dir.path(), mLayerDtm->dataProvider(), tilingScheme, 16 );
+  QgsChunkNodeId tileId( 0, 0, 0 );
+  QByteArray cached;
+  QVERIFY( !cache.hasTile( tileId ) );
+  QVERIFY( !cache.readTile( tileId, cached ) );
+
+  QVERIFY( cache.writeTile( tileId, heightMap ) );
+  QVERIFY( cache.hasTile( tileId ) );
+  QVERIFY( cache.readTile( tileId, cached ) );
+  QCOMPARE( cached, heightMap );  // also compares the NaN values bitwise
+  QVERIFY( !cache.hasTile( QgsChunkNodeId( 1, 0, 1 ) ) );
+
+  // height maps of a different size are rejected
+  QVERIFY( !cache.writeTile( QgsChunkNodeId( 1, 0, 1 ), heightMap.left( 16 ) ) );
+  QVERIFY( !cache.hasTile( QgsChunkNodeId( 1, 0, 1 ) ) );
+
+  // same settings share the cache, other resolution uses a different one
+  QgsDemHeightMapCache cache2( dir.path(), mLayerDtm->dataProvider(), tilingScheme, 16 );
+  QCOMPARE( cache2.directory(), cache.directory() );
+  QVERIFY( cache2.readTile( tileId, cached ) );
+  QgsDemHeightMapCache cache3( dir.path(), mLayerDtm->dataProvider(), tilingScheme, 32 );
+  QVERIFY( cache3.directory() != cache.directory() );
+
+  // sweeping removes tiles until the caches fit in the maximum size
+  QVERIFY( cache.writeTile( QgsChunkNodeId( 1, 0, 1 ), heightMap ) );
+  QVERIFY( cache.writeTile( QgsChunkNodeId( 1, 1, 1 ), heightMap ) );
+  const qint64 tileSize = QFileInfo( cache.directory() + QStringLiteral( "/1-1-1.hm" ) ).size();
+  QVERIFY( tileSize > heightMap.size() );
+  QCOMPARE( QgsDemHeightMapCache::sweep( dir.path(), 3 * tileSize ), 0 );
+  QCOMPARE( QgsDemHeightMapCache::sweep( dir.path(), 2 * tileSize ), 1 );
+  QCOMPARE( QgsDemHeightMapCache::sweep( dir.path(), 0 ), 2 );
+  QVERIFY( !cache.hasTile( tileId ) );
+  QVERIFY( !cache.hasTile( QgsChunkNodeId( 1, 0, 1 ) ) );
+  QVERIFY( !cache.hasTile( QgsChunkNodeId( 1, 1, 1 ) ) );
+  QVERIFY( !cache3.hasTile( tileId ) );
+}
+
 void TestQgs3DRendering::testExtrudedPolygons()
 {
   QgsRectangle fullExtent = mLayerDtm->extent();
@@ -285,6 +343,11 @@ void TestQgs3DRendering::testExtrudedPolygons()
   QImage img = Qgs3DUtils::captureSceneImage( engine, scene );
 
   QVERIFY( renderCheck( "polygon3d_extrusion", img, 40 ) );
+
+  // ear clipping triangulates the polygons differently but they look the same
+  map->setTriangulationAlgorithm( QgsTessellator::Earcut );
+  QImage img2 = Qgs3DUtils::captureSceneImage( engine, scene );
+  QVERIFY( renderCheck( "polygon3d_extrusion", img2, 40 ) );
 }
 
 void TestQgs3DRendering::testLineRendering()
@@ -344,6 +407,85 @@ void TestQgs3DRendering::testLineRendering()
   delete layerLines;
 }
 
+void TestQgs3DRendering::testEmptyVectorLayer()
+{
+  QgsRectangle fullExtent = mLayerDtm->extent();
+
+  std::unique_ptr< QgsVectorLayer > layerEmpty = qgis::make_unique< QgsVectorLayer >( "Polygon?crs=" + mProject->crs().authid(), "empty", "memory" );
+  QgsPolygon3DSymbol *symbol3d = new QgsPolygon3DSymbol;
+  symbol3d->setExtrusionHeight( 10.f );
+  layerEmpty->setRenderer3D( new QgsVectorLayer3DRenderer( symbol3d ) );
+  QCOMPARE( QgsVectorLayerChunkedEntity::leafLevel( layerEmpty.get() ), 0 );
+
+  Qgs3DMapSettings *map = new Qgs3DMapSettings;
+  map->setCrs( mProject->crs() );
+  map->setOrigin( QgsVector3D( fullExtent.center().x(), fullExtent.center().y(), 0 ) );
+  map->setLayers( QList<QgsMapLayer *>() << mLayerRgb << layerEmpty.get() );
+
+  QgsFlatTerrainGenerator *flatTerrain = new QgsFlatTerrainGenerator;
+  flatTerrain->setCrs( map->crs() );
+  flatTerrain->setExtent( fullExtent );
+  map->setTerrainGenerator( flatTerrain );
+
+  QgsOffscreen3DEngine engine;
+  Qgs3DMapScene *scene = new Qgs3DMapScene( *map, &engine );
+  engine.setRootEntity( scene );
+
+  // an empty layer must not prevent the scene from getting ready, nor change the rendering of the terrain
+  scene->cameraController()->setLookingAtPoint( QgsVector3D( 0, 0, 0 ), 2500, 0, 0 );
+  Qgs3DUtils::captureSceneImage( engine, scene );
+  QImage img = Qgs3DUtils::captureSceneImage( engine, scene );
+  QCOMPARE( scene->sceneState(), Qgs3DMapScene::Ready );
+  QVERIFY( renderCheck( "flat_terrain_1", img, 40 ) );
+}
+
+void TestQgs3DRendering::testMultiTileVectorLayer()
+{
+  QgsRectangle fullExtent = mLayerDtm->extent();
+
+  // stacked copies of the buildings, so that the layer is split into several leaf tiles
+  // while still rendering like the buildings layer
+  std::unique_ptr< QgsVectorLayer > layerTiles = qgis::make_unique< QgsVectorLayer >( "Polygon?crs=" + mLayerBuildings->crs().authid(), "buildings", "memory" );
+  QgsFeatureList features;
+  QgsFeature f;
+  for ( int copy = 0; copy < 12; ++copy )
+  {
+    QgsFeatureIterator it = mLayerBuildings->getFeatures( QgsFeatureRequest().setNoAttributes() );
+    while ( it.nextFeature( f ) )
+    {
+      QgsFeature copyFeature( layerTiles->fields() );
+      copyFeature.setGeometry( f.geometry() );
+      features << copyFeature;
+    }
+  }
+  QVERIFY( layerTiles->dataProvider()->addFeatures( features ) );
+  QVERIFY( QgsVectorLayerChunkedEntity::leafLevel( layerTiles.get() ) > 0 );
+  layerTiles->setRenderer3D( mLayerBuildings->renderer3D()->clone() );
+
+  Qgs3DMapSettings *map = new Qgs3DMapSettings;
+  map->setCrs( mProject->crs() );
+  map->setOrigin( QgsVector3D( fullExtent.center().x(), fullExtent.center().y(), 0 ) );
+  map->setLayers( QList<QgsMapLayer *>() << mLayerRgb << layerTiles.get() );
+  QgsPointLightSettings defaultLight;
+  defaultLight.setPosition( QgsVector3D( 0, 1000, 0 ) );
+  map->setPointLights( QList<QgsPointLightSettings>() << defaultLight );
+
+  QgsFlatTerrainGenerator *flatTerrain = new QgsFlatTerrainGenerator;
+  flatTerrain->setCrs( map->crs() );
+  flatTerrain->setExtent( fullExtent );
+  map->setTerrainGenerator( flatTerrain );
+
+  QgsOffscreen3DEngine engine;
+  Qgs3DMapScene *scene = new Qgs3DMapScene( *map, &engine );
+  engine.setRootEntity( scene );
+
+  scene->cameraController()->setLookingAtPoint( QgsVector3D( 0, 0, 250 ), 500, 45, 0 );
+  QImage img = Qgs3DUtils::captureSceneImage( engine, scene );
+
+  // features spread over several tiles must render like the single tile buildings layer
+  QVERIFY( renderCheck( "polygon3d_extrusion", img, 40 ) );
+}
+
 void TestQgs3DRendering::testMapTheme()
 {
   QgsRectangle fullExtent = mLayerDtm->extent();
@@ -582,5 +724,165 @@ void TestQgs3DRendering::testBillboardRendering()
   QVERIFY( renderCheck( "billboard_rendering_2", img2, 40 ) );
 }
 
+void TestQgs3DRendering::testReadObjModel()
+{
+  QTemporaryDir dir;
+  QVERIFY( dir.isValid() );
+  const QString path = dir.filePath( QStringLiteral( "model.obj" ) );
+  auto writeModel = [&path]( const QByteArray & content )
+  {
+    QFile file( path );
+    return file.open( QIODevice::WriteOnly ) && file.write( content ) == content.size();
+  };
+
+  QVERIFY( Qgs3DSymbolImpl::readObjModel( path ).isEmpty() );
+
+  QVERIFY( writeModel( "# square\n"
+                       "o square\n"
+                       "v 0 0 0\n"
+                       "v 1 0 0\n"
+                       "v 1 1 0\n"
+                       "v 0 1 0\n"
+                       "vn 0 0 1\n"
+                       "f 1//1 2//1 3//1 4//1\n"  // quad split to two triangles
+                       "f -4 -2 -1\n"  // relative indexes, without normals
+                       "f 1/1/-1 2/2/-1 3/3/-1\n" ) );  // with texture coordinates
+  const QByteArray data = Qgs3DSymbolImpl::readObjModel( path );
+  QCOMPARE( data.size(), static_cast<int>( 4 * 3 * 6 * sizeof( float ) ) );
+  const float *values = reinterpret_cast<const float *>( data.constData() );
+  auto compareVertex = [values]( int vertex, const QVector3D & position, const QVector3D & normal )
+  {
+    const float *v = values + vertex * 6;
+    return QVector3D( v[0], v[1], v[2] ) == position && QVector3D( v[3], v[4], v[5] ) == normal;
+  };
+  QVERIFY( compareVertex( 0, QVector3D( 0, 0, 0 ), QVector3D( 0, 0, 1 ) ) );
+  QVERIFY( compareVertex( 2, QVector3D( 1, 1, 0 ), QVector3D( 0, 0, 1 ) ) );
+  QVERIFY( compareVertex( 3, QVector3D( 0, 0, 0 ), QVector3D( 0, 0, 1 ) ) );
+  QVERIFY( compareVertex( 5, QVector3D( 0, 1, 0 ), QVector3D( 0, 0, 1 ) ) );
+  // the normal of the face is used for vertices without normals
+  QVERIFY( compareVertex( 6, QVector3D( 0, 0, 0 ), QVector3D( 0, 0, 1 ) ) );
+  QVERIFY( compareVertex( 7, QVector3D( 1, 1, 0 ), QVector3D( 0, 0, 1 ) ) );
+  QVERIFY( compareVertex( 8, QVector3D( 0, 1, 0 ), QVector3D( 0, 0, 1 ) ) );
+  QVERIFY( compareVertex( 10, QVector3D( 1, 0, 0 ), QVector3D( 0, 0, 1 ) ) );
+
+  // malformed models
+  const QList<QByteArray> malformedModels = QList<QByteArray>()
+      << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n"  // index out of range
+      << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 0 1 2\n"  // indexes are 1-based
+      << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf -4 -3 -2\n"  // relative index out of range
+      << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 x\n"  // index is not a number
+      << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1//1 2//1 3//1\n"  // missing normal
+      << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2\n"  // face with two vertices
+      << "v 0 0 0\nv 1 0\nv 0 1 0\nf 1 2 3\n"  // missing coordinate
+      << "v 0 0 0\nv 1 0 a\nv 0 1 0\nf 1 2 3\n";  // coordinate is not a number
+  for ( const QByteArray &model : malformedModels )
+  {
+    QVERIFY( writeModel( model ) );
+    QVERIFY2( Qgs3DSymbolImpl::readObjModel( path ).isEmpty(), model.constData() );
+  }
+}
+
+void TestQgs3DRendering::testInstancedModel()
+{
+  // cube with the size of the default cube shape, with normals of faces
+  QTemporaryDir dir;
+  QVERIFY( dir.isValid() );
+  const QString modelPath = dir.filePath( QStringLiteral( "cube.obj" ) );
+  QFile modelFile( modelPath );
+  QVERIFY( modelFile.open( QIODevice::WriteOnly ) );
+  modelFile.write( "v -5 -5 -5\nv 5 -5 -5\nv 5 5 -5\nv -5 5 -5\n"
+                   "v -5 -5 5\nv 5 -5 5\nv 5 5 5\nv -5 5 5\n"
+                   "vn 0 0 -1\nvn 0 0 1\nvn 0 -1 0\nvn 1 0 0\nvn 0 1 0\nvn -1 0 0\n"
+                   "f 1//1 4//1 3//1 2//1\nf 5//2 6//2 7//2 8//2\nf 1//3 2//3 6//3 5//3\n"
+                   "f 2//4 3//4 7//4 6//4\nf 3//5 4//5 8//5 7//5\nf 4//6 1//6 5//6 8//6\n" );
+  modelFile.close();
+
+  QgsRectangle fullExtent( 0, 0, 1000, 1000 );
+
+  std::unique_ptr<QgsVectorLayer> layerPointsZ( new QgsVectorLayer( "PointZ?crs=EPSG:27700", "points Z", "memory" ) );
+  QgsFeatureList featureList;
+  for ( int i = 0; i < 5; ++i )
+  {
+    QgsFeature f( layerPointsZ->fields() );
+    f.setGeometry( QgsGeometry( new QgsPoint( i * 200, 1000 - i * 150, 20 * i ) ) );
+    featureList << f;
+  }
+  layerPointsZ->dataProvider()->addFeatures( featureList );
+
+  QgsPhongMaterialSettings material;
+  material.setDiffuse( QColor( 200, 100, 50 ) );
+  material.setAmbient( QColor( 80, 40, 20 ) );
+  QMatrix4x4 transform;
+  transform.rotate( 30, 0, 1, 0 );
+  transform.scale( 5 );
+
+  // renders the points with the symbol (or only the terrain without a symbol) and returns the image
+  auto renderPoints = [&]( QgsPoint3DSymbol * symbol )
+  {
+    Qgs3DMapSettings map;
+    map.setCrs( mProject->crs() );
+    map.setOrigin( QgsVector3D( fullExtent.center().x(), fullExtent.center().y(), 0 ) );
+    if ( symbol )
+    {
+      symbol->setMaterial( material );
+      symbol->setTransform( transform );
+      layerPointsZ->setRenderer3D( new QgsVectorLayer3DRenderer( symbol ) );
+      map.setLayers( QList<QgsMapLayer *>() << layerPointsZ.get() );
+    }
+
+    QgsFlatTerrainGenerator *flatTerrain = new QgsFlatTerrainGenerator;
+    flatTerrain->setCrs( map.crs() );
+    flatTerrain->setExtent( fullExtent );
+    map.setTerrainGenerator( flatTerrain );
+
+    QgsOffscreen3DEngine engine;
+    Qgs3DMapScene *scene = new Qgs3DMapScene( map, &engine );
+    engine.setRootEntity( scene );
+    scene->cameraController()->setLookingAtPoint( QgsVector3D( 0, 0, 0 ), 1500, 45, 30 );
+
+    // When running the test on Travis, it would initially return empty rendered image.
+    // Capturing the initial image and throwing it away fixes that. Hopefully we will
+    // find a better fix in the future.
+    Qgs3DUtils::captureSceneImage( engine, scene );
+    return Qgs3DUtils::captureSceneImage( engine, scene );
+  };
+
+  // the model with the material of the symbol is rendered with instancing
+  QgsPoint3DSymbol *modelSymbol = new QgsPoint3DSymbol;
+  modelSymbol->setShape( QgsPoint3DSymbol::Model );
+  QVariantMap modelProperties;
+  modelProperties[QStringLiteral( "model" )] = modelPath;
+  modelProperties[QStringLiteral( "overwriteMaterial" )] = true;
+  modelSymbol->setShapeProperties( modelProperties );
+  const QImage modelImage = renderPoints( modelSymbol );
+
+  QgsPoint3DSymbol *cubeSymbol = new QgsPoint3DSymbol;
+  cubeSymbol->setShape( QgsPoint3DSymbol::Cube );
+  const QImage cubeImage = renderPoints( cubeSymbol );
+
+  const QImage emptyImage = renderPoints( nullptr );
+
+  auto mismatchCount = []( const QImage & image1, const QImage & image2 )
+  {
+    int count = 0;
+    for ( int y = 0; y < image1.height(); ++y )
+    {
+      for ( int x = 0; x < image1.width(); ++x )
+      {
+        const QRgb p1 = image1.pixel( x, y );
+        const QRgb p2 = image2.pixel( x, y );
+        if ( qAbs( qRed( p1 ) - qRed( p2 ) ) > 2 || qAbs( qGreen( p1 ) - qGreen( p2 ) ) > 2 || qAbs( qBlue( p1 ) - qBlue( p2 ) ) > 2 )
+          ++count;
+      }
+    }
+    return count;
+  };
+
+  // the instanced model looks the same as the cube shape
+  QCOMPARE( modelImage.size(), cubeImage.size() );
+  QVERIFY( mismatchCount( modelImage, emptyImage ) > 1000 );
+  QVERIFY( mismatchCount( modelImage, cubeImage ) < 40 );
+}
+
 QGSTEST_MAIN( TestQgs3DRendering )
 #include "testqgs3drendering.moc"
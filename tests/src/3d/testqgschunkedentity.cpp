@@ -0,0 +1,210 @@
+/***************************************************************************
+     testqgschunkedentity.cpp
+     ------------------------
+    Date                 : October 2019
+    Copyright            : (C) 2019 by The QGIS Project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+
+#include <QMatrix4x4>
+#include <QPointer>
+
+#include "qgsaabb.h"
+#include "qgschunkedentity_p.h"
+#include "qgschunkloader_p.h"
+#include "qgschunknode_p.h"
+
+/**
+ * Loader which only finishes when the test emits its finished() signal
+ */
+class TestChunkLoader : public QgsChunkLoader
+{
+    Q_OBJECT
+  public:
+    TestChunkLoader( QgsChunkNode *node )
+      : QgsChunkLoader( node )
+    {}
+
+    Qt3DCore::QEntity *createEntity( Qt3DCore::QEntity *parent ) override
+    {
+      return new Qt3DCore::QEntity( parent );
+    }
+};
+
+/**
+ * Factory keeping track of the loaders in the order in which the jobs were started
+ */
+class TestChunkLoaderFactory : public QgsChunkLoaderFactory
+{
+  public:
+    QgsChunkLoader *createChunkLoader( QgsChunkNode *node ) const override
+    {
+      TestChunkLoader *loader = new TestChunkLoader( node );
+      mLoaders << loader;
+      mTiles << node->tileId().text();
+      return loader;
+    }
+
+    mutable QList< QPointer< TestChunkLoader > > mLoaders;
+    mutable QStringList mTiles;
+};
+
+/**
+ * Quadtree of 100x100 units with a root and four leaf tiles
+ */
+class TestChunkedEntity : public QgsChunkedEntity
+{
+  public:
+    TestChunkedEntity( QgsChunkLoaderFactory *factory )
+      : QgsChunkedEntity( QgsAABB( 0, 0, 0, 100, 10, 100 ), 100, 1, 1, factory )
+    {
+      setMaximumConcurrentJobs( 1 );
+    }
+
+    ~TestChunkedEntity() override
+    {
+      cancelActiveJobs();
+    }
+};
+
+class TestQgsChunkedEntity : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+
+    void testJobOrder();
+    void testCancelStaleJobs();
+
+  private:
+    //! Returns the scene state of a camera at \a cameraPos looking at \a viewCenter
+    static QgsChunkedEntity::SceneState sceneState( const QVector3D &cameraPos, const QVector3D &viewCenter );
+
+    //! Loads the root tile, so that the next update requests the four leaf tiles
+    static void loadRoot( TestChunkedEntity &entity, const TestChunkLoaderFactory &factory, const QgsChunkedEntity::SceneState &state );
+};
+
+void TestQgsChunkedEntity::initTestCase()
+{
+}
+
+void TestQgsChunkedEntity::cleanupTestCase()
+{
+}
+
+QgsChunkedEntity::SceneState TestQgsChunkedEntity::sceneState( const QVector3D &cameraPos, const QVector3D &viewCenter )
+{
+  QgsChunkedEntity::SceneState state;
+  state.cameraPos = cameraPos;
+  state.cameraFov = 45;
+  state.screenSizePx = 1000;
+  QMatrix4x4 projection;
+  projection.perspective( state.cameraFov, 1, 1, 10000 );
+  QMatrix4x4 view;
+  view.lookAt( cameraPos, viewCenter, QVector3D( 0, 0, -1 ) );
+  state.viewProjectionMatrix = projection * view;
+  return state;
+}
+
+void TestQgsChunkedEntity::loadRoot( TestChunkedEntity &entity, const TestChunkLoaderFactory &factory, const QgsChunkedEntity::SceneState &state )
+{
+  entity.update( state );
+  QCOMPARE( factory.mLoaders.count(), 1 );
+  QCOMPARE( factory.mTiles.last(), QStringLiteral( "0/0/0" ) );
+  emit factory.mLoaders.last()->finished();
+  QCOMPARE( entity.rootNode()->state(), QgsChunkNode::Loaded );
+}
+
+void TestQgsChunkedEntity::testJobOrder()
+{
+  TestChunkLoaderFactory factory;
+  std::unique_ptr< TestChunkedEntity > entity = qgis::make_unique< TestChunkedEntity >( &factory );
+
+  // the camera is above the tile with the smallest x and z, and a bit closer to the tile with larger z
+  const QgsChunkedEntity::SceneState state = sceneState( QVector3D( 10, 200, 20 ), QVector3D( 50, 0, 50 ) );
+  loadRoot( *entity, factory, state );
+
+  // only one job at a time, started for the tile with the largest screen error
+  entity->update( state );
+  QgsChunkedEntity::LoadingStatistics statistics = entity->loadingStatistics();
+  QCOMPARE( statistics.activeJobs, 1 );
+  QCOMPARE( statistics.queuedJobs, 3 );
+  QCOMPARE( factory.mTiles.count(), 2 );
+
+  // the following jobs are started when the running job finishes, in order of distance from the camera
+  for ( int i = 1; i < 4; ++i )
+  {
+    emit factory.mLoaders.last()->finished();
+    QCOMPARE( factory.mTiles.count(), 2 + i );
+  }
+  emit factory.mLoaders.last()->finished();
+
+  QCOMPARE( factory.mTiles, QStringList() << QStringLiteral( "0/0/0" ) << QStringLiteral( "1/0/1" ) << QStringLiteral( "1/0/0" )
+            << QStringLiteral( "1/1/1" ) << QStringLiteral( "1/1/0" ) );
+
+  statistics = entity->loadingStatistics();
+  QCOMPARE( statistics.activeJobs, 0 );
+  QCOMPARE( statistics.queuedJobs, 0 );
+  QCOMPARE( statistics.loadedChunks, 5 );
+  QCOMPARE( statistics.finishedLoads, 5 );
+  QCOMPARE( statistics.canceledLoads, 0 );
+}
+
+void TestQgsChunkedEntity::testCancelStaleJobs()
+{
+  TestChunkLoaderFactory factory;
+  std::unique_ptr< TestChunkedEntity > entity = qgis::make_unique< TestChunkedEntity >( &factory );
+
+  const QgsChunkedEntity::SceneState state = sceneState( QVector3D( 10, 200, 20 ), QVector3D( 50, 0, 50 ) );
+  // looking up, away from all tiles
+  const QgsChunkedEntity::SceneState awayState = sceneState( QVector3D( 10, 200, 20 ), QVector3D( 10, 400, 20 ) );
+  loadRoot( *entity, factory, state );
+
+  entity->update( state );
+  QCOMPARE( entity->pendingJobsCount(), 4 );
+  QPointer< TestChunkLoader > runningLoader = factory.mLoaders.last();
+  QgsChunkNode *runningNode = runningLoader->chunk();
+
+  // none of the leaf tiles are needed anymore: the queued and the running loads get canceled
+  QTest::qSleep( 10 );
+  entity->update( awayState );
+  QgsChunkedEntity::LoadingStatistics statistics = entity->loadingStatistics();
+  QCOMPARE( statistics.activeJobs, 0 );
+  QCOMPARE( statistics.queuedJobs, 0 );
+  QCOMPARE( statistics.canceledLoads, 4 );
+  QCOMPARE( runningNode->state(), QgsChunkNode::Skeleton );
+  const QList< QgsChunkNode * > nodes = entity->rootNode()->descendants();
+  for ( QgsChunkNode *node : nodes )
+  {
+    if ( node != entity->rootNode() )
+      QCOMPARE( node->state(), QgsChunkNode::Skeleton );
+  }
+  // the root tile stays loaded
+  QCOMPARE( entity->rootNode()->state(), QgsChunkNode::Loaded );
+
+  // leaf tiles requested again
+  entity->update( state );
+  QCOMPARE( entity->pendingJobsCount(), 4 );
+
+  // tiles requested by a prefetch are kept even when the current view does not need them
+  entity->prefetch( state, 60000 );
+  QTest::qSleep( 10 );
+  entity->update( awayState );
+  statistics = entity->loadingStatistics();
+  QCOMPARE( statistics.activeJobs, 1 );
+  QCOMPARE( statistics.queuedJobs, 3 );
+  QCOMPARE( statistics.canceledLoads, 4 );
+}
+
+QGSTEST_MAIN( TestQgsChunkedEntity )
+#include "testqgschunkedentity.moc"
@@ -21,6 +21,7 @@
 #include "qgspolygon.h"
 #include "qgstessellator.h"
 #include "qgsmultipolygon.h"
+#include "qgsgeometry.h"
 
 static bool qgsVectorNear( const QVector3D &v1, const QVector3D &v2, double eps )
 {
@@ -138,6 +139,8 @@ class TestQgsTessellator : public QObject
     void testCrashEmptyPolygon();
     void testBoundsScaling();
     void testNoZ();
+    void testEarcut();
+    void testAddPolygons();
 
   private:
 };
@@ -386,6 +389,88 @@ void TestQgsTessellator::testNoZ()
   QVERIFY( checkTriangleOutput( t.data(), false, tc ) );
 }
 
+void TestQgsTessellator::testEarcut()
+{
+  QgsPolygon polygon;
+  polygon.fromWkt( "POLYGON((1 1, 2 1, 3 2, 1 2, 1 1))" );
+
+  QList<TriangleCoords> tc;
+  tc << TriangleCoords( QVector3D( 3, 2, 0 ), QVector3D( 1, 2, 0 ), QVector3D( 1, 1, 0 ) );
+  tc << TriangleCoords( QVector3D( 1, 1, 0 ), QVector3D( 2, 1, 0 ), QVector3D( 3, 2, 0 ) );
+
+  QgsTessellator t( 0, 0, false );
+  t.setTriangulationAlgorithm( QgsTessellator::Earcut );
+  QCOMPARE( t.triangulationAlgorithm(), QgsTessellator::Earcut );
+  t.addPolygon( polygon, 0 );
+  QVERIFY( checkTriangleOutput( t.data(), false, tc ) );
+
+  // polygon with a hole - the triangles must cover exactly the polygon's area
+  QgsPolygon polygonHole;
+  polygonHole.fromWkt( "POLYGONZ((0 0 1, 10 0 1, 10 10 1, 0 10 1, 0 0 1),(2 2 1, 2 8 1, 8 8 1, 8 2 1, 2 2 1))" );
+
+  QgsTessellator tHole( 0, 0, true );
+  tHole.setTriangulationAlgorithm( QgsTessellator::Earcut );
+  tHole.addPolygon( polygonHole, 0 );
+  QCOMPARE( tHole.dataVerticesCount(), 24 );
+  std::unique_ptr< QgsMultiPolygon > mp = tHole.asMultiPolygon();
+  QGSCOMPARENEAR( mp->area(), 64, 1e-6 );
+  QVERIFY( QgsGeometry( mp.release() ).within( QgsGeometry( polygonHole.clone() ).buffer( 1e-6, 4 ) ) );
+
+  // rings touching each other are not a problem for ear clipping (they are skipped with poly2tri)
+  QgsPolygon polygonTouching;
+  polygonTouching.fromWkt( "POLYGON((0 0, 4 0, 4 4, 0 4, 0 0),(2 2, 4 2, 3 3, 2 2))" );
+
+  QgsTessellator tTouching( 0, 0, false );
+  tTouching.setTriangulationAlgorithm( QgsTessellator::Earcut );
+  tTouching.addPolygon( polygonTouching, 0 );
+  QGSCOMPARENEAR( tTouching.asMultiPolygon()->area(), 15, 1e-6 );
+
+  // degenerate input must not crash
+  QgsPolygon polygonEmpty;
+  polygonEmpty.fromWkt( "PolygonZ ((0 0 0, 0 0 0, 0 0 0))" );
+  QgsTessellator tEmpty( 0, 0, true );
+  tEmpty.setTriangulationAlgorithm( QgsTessellator::Earcut );
+  tEmpty.addPolygon( polygonEmpty, 0 );
+  QCOMPARE( tEmpty.dataVerticesCount(), 0 );
+}
+
+void TestQgsTessellator::testAddPolygons()
+{
+  // tessellating in batches must give the same result as adding polygons one by one
+  QList< QgsPolygon > polygons;
+  for ( int i = 0; i < 500; ++i )
+  {
+    QgsPolygon p;
+    p.fromWkt( QStringLiteral( "POLYGON((%1 0, %2 0, %2 %3, %1 %3, %1 0),(%4 1, %4 2, %5 2, %5 1, %4 1))" )
+               .arg( i * 10 ).arg( i * 10 + 5 ).arg( 3 + i % 7 ).arg( i * 10 + 1 ).arg( i * 10 + 2 ) );
+    polygons << p;
+  }
+
+  for ( QgsTessellator::TriangulationAlgorithm algorithm : { QgsTessellator::ConstrainedDelaunay, QgsTessellator::Earcut } )
+  {
+    QgsTessellator tSerial( 0, 0, true );
+    tSerial.setTriangulationAlgorithm( algorithm );
+    QVector<int> expectedStartingIndices;
+    QVector<const QgsPolygon *> polygonPtrs;
+    QVector<float> extrusions;
+    for ( int i = 0; i < polygons.count(); ++i )
+    {
+      expectedStartingIndices << tSerial.dataVerticesCount();
+      tSerial.addPolygon( polygons.at( i ), i % 3 );
+      polygonPtrs << &polygons.at( i );
+      extrusions << i % 3;
+    }
+
+    QgsTessellator tBatch( 0, 0, true );
+    tBatch.setTriangulationAlgorithm( algorithm );
+    QVector<int> startingIndices;
+    tBatch.addPolygons( polygonPtrs, extrusions, &startingIndices );
+
+    QCOMPARE( startingIndices, expectedStartingIndices );
+    QCOMPARE( tBatch.data(), tSerial.data() );
+  }
+}
+
 
 QGSTEST_MAIN( TestQgsTessellator )
 #include "testqgstessellator.moc"
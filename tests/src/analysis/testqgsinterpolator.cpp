@@ -16,6 +16,9 @@ Email                : nyall dot dawson at gmail dot com
 
 #include "qgsapplication.h"
 #include "DualEdgeTriangulation.h"
+#include "qgsidwinterpolator.h"
+#include "qgstininterpolator.h"
+#include "qgsvectorlayer.h"
 
 class TestQgsInterpolator : public QObject
 {
@@ -29,6 +32,8 @@ class TestQgsInterpolator : public QObject
     void init() ;// will be called before each testfunction is executed.
     void cleanup() ;// will be called after every testfunction.
     void dualEdge();
+    void idwIndexed();
+    void tinBlock();
 
   private:
 };
@@ -265,5 +270,126 @@ void TestQgsInterpolator::dualEdge()
 //  QVERIFY( tri.getSurroundingTriangles( 0 ).empty() );
 }
 
+void TestQgsInterpolator::idwIndexed()
+{
+  QgsVectorLayer layer( QStringLiteral( "Point?crs=EPSG:3857&field=value:double" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer.isValid() );
+  QgsFeatureList features;
+  for ( int i = 0; i < 20; ++i )
+  {
+    for ( int j = 0; j < 20; ++j )
+    {
+      QgsFeature f( layer.fields() );
+      f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i * 10 + ( j % 3 ), j * 10 + ( i % 4 ) ) ) );
+      f.setAttributes( QgsAttributes() << i * j + i );
+      features << f;
+    }
+  }
+  QVERIFY( layer.dataProvider()->addFeatures( features ) );
+
+  QgsInterpolator::LayerData data;
+  data.source = &layer;
+  data.valueSource = QgsInterpolator::ValueAttribute;
+  data.interpolationAttribute = 0;
+
+  QgsIDWInterpolator all( QList< QgsInterpolator::LayerData >() << data );
+  // using all the points through the index must give the same results as the full search
+  QgsIDWInterpolator allIndexed( QList< QgsInterpolator::LayerData >() << data );
+  allIndexed.setMaximumPoints( 400 );
+  QgsIDWInterpolator nearest( QList< QgsInterpolator::LayerData >() << data );
+  nearest.setMaximumPoints( 1 );
+  QgsIDWInterpolator radius( QList< QgsInterpolator::LayerData >() << data );
+  radius.setSearchRadius( 2 );
+  QVERIFY( allIndexed.isThreadSafe() );
+
+  double result = 0;
+  double expected = 0;
+  for ( double x = -15; x < 215; x += 7.3 )
+  {
+    for ( double y = -15; y < 215; y += 6.1 )
+    {
+      QCOMPARE( all.interpolatePoint( x, y, expected ), 0 );
+      QCOMPARE( allIndexed.interpolatePoint( x, y, result ), 0 );
+      QGSCOMPARENEAR( result, expected, 0.0000001 );
+    }
+  }
+
+  // nearest point only
+  QCOMPARE( nearest.interpolatePoint( 31, 52, result ), 0 );
+  QCOMPARE( result, 18.0 );
+  QCOMPARE( nearest.interpolatePoint( 190, 191, result ), 0 );
+  QCOMPARE( result, 380.0 );
+
+  // exact hit
+  QCOMPARE( radius.interpolatePoint( 50, 1, result ), 0 );
+  QCOMPARE( result, 5.0 );
+  // only one point within the radius
+  QCOMPARE( radius.interpolatePoint( 50, 2, result ), 0 );
+  QCOMPARE( result, 5.0 );
+  // no point within the radius
+  QCOMPARE( radius.interpolatePoint( 55, 5, result ), 1 );
+}
+
+void TestQgsInterpolator::tinBlock()
+{
+  QgsVectorLayer layer( QStringLiteral( "Point?crs=EPSG:3857&field=value:double" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer.isValid() );
+  QgsFeatureList features;
+  for ( int i = 0; i < 30; ++i )
+  {
+    for ( int j = 0; j < 30; ++j )
+    {
+      QgsFeature f( layer.fields() );
+      f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i * 10 + ( ( i * 7 + j * 3 ) % 5 ), j * 10 + ( ( i * 3 + j * 11 ) % 7 ) ) ) );
+      f.setAttributes( QgsAttributes() << ( i - 15 ) * ( j - 10 ) + 0.5 * i );
+      features << f;
+    }
+  }
+  QVERIFY( layer.dataProvider()->addFeatures( features ) );
+
+  QgsInterpolator::LayerData data;
+  data.source = &layer;
+  data.valueSource = QgsInterpolator::ValueAttribute;
+  data.interpolationAttribute = 0;
+
+  QgsTinInterpolator pointInterpolator( QList< QgsInterpolator::LayerData >() << data, QgsTinInterpolator::Linear );
+  QgsTinInterpolator blockInterpolator( QList< QgsInterpolator::LayerData >() << data, QgsTinInterpolator::Linear );
+
+  QVector< double > xValues;
+  for ( double x = -10.5; x < 310; x += 3.7 )
+    xValues << x;
+  QVector< double > yValues;
+  for ( double y = 310.5; y > -10; y -= 4.1 )
+    yValues << y;
+
+  QVector< double > values;
+  QVERIFY( blockInterpolator.interpolateBlock( xValues, yValues, values ) );
+  QCOMPARE( values.size(), xValues.size() * yValues.size() );
+
+  int interpolated = 0;
+  for ( int row = 0; row < yValues.size(); ++row )
+  {
+    for ( int col = 0; col < xValues.size(); ++col )
+    {
+      const double blockValue = values.at( row * xValues.size() + col );
+      double expected = 0;
+      if ( pointInterpolator.interpolatePoint( xValues.at( col ), yValues.at( row ), expected, nullptr ) == 0 )
+      {
+        QGSCOMPARENEAR( blockValue, expected, 0.000001 );
+        interpolated++;
+      }
+      else if ( xValues.at( col ) < 0 || xValues.at( col ) > 300 || yValues.at( row ) < 0 || yValues.at( row ) > 300 )
+      {
+        QVERIFY( std::isnan( blockValue ) );
+      }
+    }
+  }
+  QVERIFY( interpolated > 4000 );
+
+  // Clough-Tocher interpolation is computed cell by cell
+  QgsTinInterpolator ctInterpolator( QList< QgsInterpolator::LayerData >() << data, QgsTinInterpolator::CloughTocher );
+  QVERIFY( !ctInterpolator.interpolateBlock( xValues, yValues, values ) );
+}
+
 QGSTEST_MAIN( TestQgsInterpolator )
 #include "testqgsinterpolator.moc"
@@ -18,6 +18,7 @@ Email                : zilolv at gmail dot com
 
 #include "qgsmeshcalculator.h"
 #include "qgsmeshcalcnode.h"
+#include "qgsmeshcalcutils.h"
 #include "qgsmeshdataprovider.h"
 #include "qgsmeshlayer.h"
 #include "qgsapplication.h"
@@ -46,6 +47,8 @@ class TestQgsMeshCalculator : public QObject
     void singleOp(); //test operators which operate on a single value
 
     void calcWithLayers();
+    void calcWithAggregates_data();
+    void calcWithAggregates(); //test that time steps evaluated one by one match evaluation with all datasets in memory
   private:
 
     QgsMeshLayer *mpMeshLayer = nullptr;
@@ -236,5 +239,62 @@ void TestQgsMeshCalculator::calcWithLayers()
   QCOMPARE( newGroupCount, groupCount + 1 );
 }
 
+void TestQgsMeshCalculator::calcWithAggregates_data()
+{
+  QTest::addColumn<QString>( "formula" );
+
+  QTest::newRow( "max" ) << QStringLiteral( "max_aggr ( \"VertexScalarDataset\" )" );
+  QTest::newRow( "min" ) << QStringLiteral( "min_aggr ( \"VertexScalarDataset\" ) + 1" );
+  QTest::newRow( "sum" ) << QStringLiteral( "sum_aggr ( \"VertexScalarDataset\" )" );
+  QTest::newRow( "average" ) << QStringLiteral( "\"VertexScalarDataset\" - average_aggr ( \"VertexScalarDataset2\" )" );
+  QTest::newRow( "nested" ) << QStringLiteral( "max_aggr ( \"VertexScalarDataset\" - min_aggr ( \"VertexScalarDataset\" ) )" );
+  QTest::newRow( "time varying" ) << QStringLiteral( "\"VertexScalarDataset\" * \"VertexScalarDataset2\"" );
+}
+
+void TestQgsMeshCalculator::calcWithAggregates()
+{
+  QFETCH( QString, formula );
+
+  QString error;
+  std::unique_ptr< QgsMeshCalcNode > node( QgsMeshCalcNode::parseMeshCalcString( formula, error ) );
+  QVERIFY( node );
+
+  // reference evaluation with all datasets in memory
+  const QgsRectangle extent = mpMeshLayer->extent();
+  QgsMeshCalcUtils utils( mpMeshLayer, node->usedDatasetGroupNames(), 0, 3600 );
+  QVERIFY( utils.isValid() );
+  QgsMeshMemoryDatasetGroup expected( "expected" );
+  QVERIFY( node->calculate( utils, expected ) );
+  utils.filter( expected, extent );
+
+  QTemporaryFile tmpFile;
+  tmpFile.open(); // fileName is not available until open
+  QString tmpName = tmpFile.fileName();
+  tmpFile.close();
+
+  QgsMeshCalculator rc( formula, tmpName, extent, 0, 3600, mpMeshLayer );
+  QCOMPARE( static_cast< int >( rc.processCalculation() ), 0 );
+
+  const int groupIndex = mpMeshLayer->dataProvider()->datasetGroupCount() - 1;
+  QCOMPARE( mpMeshLayer->dataProvider()->datasetCount( groupIndex ), expected.datasetCount() );
+  for ( int datasetIndex = 0; datasetIndex < expected.datasetCount(); ++datasetIndex )
+  {
+    const QgsMeshDatasetIndex index( groupIndex, datasetIndex );
+    const std::shared_ptr<const QgsMeshMemoryDataset> ds = expected.constDataset( datasetIndex );
+    QCOMPARE( mpMeshLayer->dataProvider()->datasetMetadata( index ).time(), ds->time );
+
+    const QgsMeshDataBlock values = mpMeshLayer->dataProvider()->datasetValues( index, 0, ds->values.size() );
+    for ( int i = 0; i < ds->values.size(); ++i )
+    {
+      const double expectedValue = ds->values.at( i ).scalar();
+      const double value = values.value( i ).scalar();
+      if ( std::isnan( expectedValue ) )
+        QVERIFY( std::isnan( value ) );
+      else
+        QGSCOMPARENEAR( value, expectedValue, 1e-6 );
+    }
+  }
+}
+
 QGSTEST_MAIN( TestQgsMeshCalculator )
 #include "testqgsmeshcalculator.moc"
@@ -56,6 +56,9 @@ class TestQgsMeshContours : public QObject
     void testQuadAndTriangleFaceScalarPoly_data();
     void testQuadAndTriangleFaceScalarPoly();
 
+    void testMultipleLevelsLines();
+    void testMultipleLevelsPolygons();
+
   private:
     QgsMeshLayer *mpMeshLayer = nullptr;
 };
@@ -221,5 +224,82 @@ void TestQgsMeshContours::testQuadAndTriangleFaceScalarPoly()
   equals( res, expected );
 }
 
+void TestQgsMeshContours::testMultipleLevelsLines()
+{
+  QgsMeshDatasetIndex datasetIndex( 1, 0 );
+
+  QgsMeshContours contours( mpMeshLayer );
+
+  // values of the dataset are x / 1000, values are intentionally not sorted
+  const QVector<double> values = { 2.0, 1.5, 4.0, 1.0 };
+  const QVector<QgsGeometry> res = contours.exportLines( datasetIndex, values, QgsMeshRendererScalarSettings::None );
+  QCOMPARE( res.size(), 4 );
+
+  for ( int i : { 0, 1, 3 } )
+  {
+    QVERIFY( !res.at( i ).isNull() );
+    QCOMPARE( res.at( i ).wkbType(), QgsWkbTypes::MultiLineStringZ );
+    // segments are joined to a single line
+    QCOMPARE( res.at( i ).constGet()->partCount(), 1 );
+    QGSCOMPARENEAR( res.at( i ).length(), 1000, 1e-6 );
+  }
+
+  // the line crosses diagonal of the quad
+  QCOMPARE( res.at( 1 ).constGet()->nCoordinates(), 3 );
+  const QgsRectangle bbox = res.at( 1 ).boundingBox();
+  QGSCOMPARENEAR( bbox.xMinimum(), 1500, 1e-6 );
+  QGSCOMPARENEAR( bbox.xMaximum(), 1500, 1e-6 );
+  QGSCOMPARENEAR( bbox.yMinimum(), 2000, 1e-6 );
+  QGSCOMPARENEAR( bbox.yMaximum(), 3000, 1e-6 );
+
+  // the level is equal to the minimum value, the line is the edge of the mesh with both vertices on the level
+  QCOMPARE( res.at( 3 ).constGet()->nCoordinates(), 2 );
+  const QgsRectangle edgeBbox = res.at( 3 ).boundingBox();
+  QGSCOMPARENEAR( edgeBbox.xMinimum(), 1000, 1e-6 );
+  QGSCOMPARENEAR( edgeBbox.xMaximum(), 1000, 1e-6 );
+  QGSCOMPARENEAR( edgeBbox.yMinimum(), 2000, 1e-6 );
+  QGSCOMPARENEAR( edgeBbox.yMaximum(), 3000, 1e-6 );
+
+  // the inner edge on the level is found by both triangles sharing it, but added only once
+  QCOMPARE( res.at( 0 ).constGet()->nCoordinates(), 2 );
+
+  // outside of the values
+  QVERIFY( res.at( 2 ).isNull() );
+
+  // the same as the lines exported one by one
+  QVERIFY( res.at( 1 ).isGeosEqual( contours.exportLines( datasetIndex, 1.5, QgsMeshRendererScalarSettings::None ) ) );
+}
+
+void TestQgsMeshContours::testMultipleLevelsPolygons()
+{
+  QgsMeshDatasetIndex datasetIndex( 1, 0 );
+
+  QgsMeshContours contours( mpMeshLayer );
+
+  const QVector<QgsGeometry> res = contours.exportPolygons( datasetIndex, { 0.0, 1.0, 1.5, 2.0, 3.0, 4.0 }, QgsMeshRendererScalarSettings::None );
+  QCOMPARE( res.size(), 5 );
+
+  // no values below 1 or above 3
+  QVERIFY( res.at( 0 ).isNull() );
+  QVERIFY( res.at( 4 ).isNull() );
+
+  for ( int i = 1; i < 4; ++i )
+  {
+    QVERIFY( !res.at( i ).isNull() );
+    QCOMPARE( res.at( i ).wkbType(), QgsWkbTypes::MultiPolygonZ );
+    QCOMPARE( res.at( i ).constGet()->partCount(), 1 );
+    QGSCOMPARENEAR( res.at( i ).area(), 500000, 1e-6 );
+  }
+
+  // bands cover the whole mesh without overlaps
+  const QgsGeometry left = res.at( 1 );
+  const QgsGeometry middle = res.at( 2 );
+  QGSCOMPARENEAR( left.intersection( middle ).area(), 0, 1e-6 );
+  QGSCOMPARENEAR( QgsGeometry::unaryUnion( res.mid( 1, 3 ) ).area(), 1500000, 1e-6 );
+
+  // the same as the polygons exported one by one
+  QVERIFY( res.at( 3 ).isGeosEqual( contours.exportPolygons( datasetIndex, 2.0, 3.0, QgsMeshRendererScalarSettings::None ) ) );
+}
+
 QGSTEST_MAIN( TestQgsMeshContours )
 #include "testqgsmeshcontours.moc"
@@ -28,6 +28,10 @@
 #endif
 
 #include <QDir>
+#include <QThreadPool>
+#include <cmath>
+
+#include <gdal.h>
 
 // If true regenerate raster reference images
 const bool REGENERATE_REFERENCES = false;
@@ -47,6 +51,8 @@ class TestNineCellFilters : public QObject
     void testAspect();
     void testRuggedness();
     void testTotalCurvature();
+    void testParallel_data();
+    void testParallel();
 #ifdef HAVE_OPENCL
     void testHillshadeCl();
     void testSlopeCl();
@@ -58,6 +64,9 @@ class TestNineCellFilters : public QObject
 
     void _rasterCompare( QgsAlignRaster::RasterInfo &out, QgsAlignRaster::RasterInfo &ref );
 
+    //! Reads all values of the first band of raster \a fileName
+    static QVector< float > readRaster( const QString &fileName );
+
     template <class T> void _testAlg( const QString &name, bool useOpenCl = false );
 
     static QString referenceFile( const QString &name )
@@ -167,6 +176,77 @@ void TestNineCellFilters::testRuggedness()
   _testAlg<QgsRuggednessFilter>( QStringLiteral( "ruggedness" ) );
 }
 
+QVector< float > TestNineCellFilters::readRaster( const QString &fileName )
+{
+  QVector< float > values;
+  GDALDatasetH dataset = GDALOpen( fileName.toUtf8().constData(), GA_ReadOnly );
+  if ( !dataset )
+    return values;
+
+  const int xSize = GDALGetRasterXSize( dataset );
+  const int ySize = GDALGetRasterYSize( dataset );
+  values.resize( xSize * ySize );
+  if ( GDALRasterIO( GDALGetRasterBand( dataset, 1 ), GF_Read, 0, 0, xSize, ySize, values.data(), xSize, ySize, GDT_Float32, 0, 0 ) != CE_None )
+    values.clear();
+  GDALClose( dataset );
+  return values;
+}
+
+void TestNineCellFilters::testParallel_data()
+{
+  QTest::addColumn<QString>( "name" );
+
+  QTest::newRow( "slope" ) << QStringLiteral( "slope" );
+  QTest::newRow( "aspect" ) << QStringLiteral( "aspect" );
+}
+
+void TestNineCellFilters::testParallel()
+{
+  // the raster is split in different bands depending on the number of threads, the output
+  // must be identical to the sequential result
+  QFETCH( QString, name );
+
+#ifdef HAVE_OPENCL
+  QgsOpenClUtils::setEnabled( false );
+#endif
+
+  const int prevMaxThreads = QThreadPool::globalInstance()->maxThreadCount();
+  QVector< QVector< float > > results;
+  for ( int threads : { 1, 3, 8 } )
+  {
+    QThreadPool::globalInstance()->setMaxThreadCount( threads );
+    const QString tmpFile( tempFile( QStringLiteral( "%1_threads%2" ).arg( name ).arg( threads ) ) );
+    int res = -1;
+    if ( name == QLatin1String( "slope" ) )
+    {
+      QgsSlopeFilter filter( SRC_FILE, tmpFile, "GTiff" );
+      res = filter.processRaster();
+    }
+    else
+    {
+      QgsAspectFilter filter( SRC_FILE, tmpFile, "GTiff" );
+      res = filter.processRaster();
+    }
+    QCOMPARE( res, 0 );
+    results << readRaster( tmpFile );
+    QVERIFY( !results.last().isEmpty() );
+  }
+  QThreadPool::globalInstance()->setMaxThreadCount( prevMaxThreads );
+
+  for ( int i = 1; i < results.count(); ++i )
+  {
+    QCOMPARE( results.at( i ).count(), results.at( 0 ).count() );
+    for ( int j = 0; j < results.at( 0 ).count(); ++j )
+    {
+      // nodata cells compare as equal, NaN != NaN
+      if ( std::isnan( results.at( 0 ).at( j ) ) )
+        QVERIFY( std::isnan( results.at( i ).at( j ) ) );
+      else
+        QCOMPARE( results.at( i ).at( j ), results.at( 0 ).at( j ) );
+    }
+  }
+}
+
 void TestNineCellFilters::_rasterCompare( QgsAlignRaster::RasterInfo &out,  QgsAlignRaster::RasterInfo &ref )
 {
   QSize refSize( ref.rasterSize() );
@@ -26,6 +26,8 @@
 #include <QObject>
 #include <QtTest/QSignalSpy>
 #include <QList>
+#include <QtConcurrentRun>
+#include <QJsonDocument>
 #include "qgis.h"
 #include "qgstest.h"
 #include "qgsrasterlayer.h"
@@ -46,6 +48,7 @@
 #include "qgslayoutitemlabel.h"
 #include "qgscoordinatetransformcontext.h"
 #include "qgsrasterfilewriter.h"
+#include "qgsprocessingfeaturepipe_p.h"
 
 class DummyAlgorithm : public QgsProcessingAlgorithm
 {
@@ -577,6 +580,10 @@ class TestQgsProcessing: public QObject
     void asPythonCommand();
     void modelerAlgorithm();
     void modelExecution();
+    void modelConcurrentExecution();
+    void featurePipe();
+    void modelStreamedExecution();
+    void profileExecution();
     void modelWithProviderWithLimitedTypes();
     void modelVectorOutputIsCompatibleType();
     void modelAcceptableValues();
@@ -7869,6 +7876,311 @@ void TestQgsProcessing::modelExecution()
   QCOMPARE( actualParts, expectedParts );
 }
 
+void TestQgsProcessing::modelConcurrentExecution()
+{
+  // cx1 and cx2 are independent and can run concurrently, cx3 depends on the in-memory output of cx1
+  QgsProcessingModelAlgorithm model;
+  model.addModelParameter( new QgsProcessingParameterFeatureSource( "SOURCE_LAYER" ), QgsProcessingModelParameter( "SOURCE_LAYER" ) );
+
+  QgsProcessingModelChildAlgorithm algc1;
+  algc1.setChildId( "cx1" );
+  algc1.setAlgorithmId( "native:centroids" );
+  algc1.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromModelParameter( "SOURCE_LAYER" ) );
+  QMap<QString, QgsProcessingModelOutput> outputs1;
+  QgsProcessingModelOutput out1( "OUT1" );
+  out1.setChildOutputName( "OUTPUT" );
+  outputs1.insert( QStringLiteral( "OUT1" ), out1 );
+  algc1.setModelOutputs( outputs1 );
+  model.addChildAlgorithm( algc1 );
+
+  QgsProcessingModelChildAlgorithm algc2;
+  algc2.setChildId( "cx2" );
+  algc2.setAlgorithmId( "native:buffer" );
+  algc2.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromModelParameter( "SOURCE_LAYER" ) );
+  algc2.addParameterSources( "DISTANCE", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromStaticValue( 1 ) );
+  QMap<QString, QgsProcessingModelOutput> outputs2;
+  QgsProcessingModelOutput out2( "OUT2" );
+  out2.setChildOutputName( "OUTPUT" );
+  outputs2.insert( QStringLiteral( "OUT2" ), out2 );
+  algc2.setModelOutputs( outputs2 );
+  model.addChildAlgorithm( algc2 );
+
+  QgsProcessingModelChildAlgorithm algc3;
+  algc3.setChildId( "cx3" );
+  algc3.setAlgorithmId( "native:extractbyexpression" );
+  algc3.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromChildOutput( "cx1", "OUTPUT" ) );
+  algc3.addParameterSources( "EXPRESSION", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromStaticValue( "true" ) );
+  QMap<QString, QgsProcessingModelOutput> outputs3;
+  QgsProcessingModelOutput out3( "OUT3" );
+  out3.setChildOutputName( "OUTPUT" );
+  outputs3.insert( QStringLiteral( "OUT3" ), out3 );
+  algc3.setModelOutputs( outputs3 );
+  model.addChildAlgorithm( algc3 );
+  model.updateDestinationParameters();
+
+  QString testDataDir = QStringLiteral( TEST_DATA_DIR ) + '/'; //defined in CmakeLists.txt
+  QString vector = testDataDir + "points.shp";
+  QgsVectorLayer sourceLayer( vector, "points", "ogr" );
+  QVERIFY( sourceLayer.isValid() );
+
+  QVariantMap modelInputs;
+  modelInputs.insert( "SOURCE_LAYER", vector );
+  modelInputs.insert( "cx1:OUT1", QVariant::fromValue( QgsProcessingOutputLayerDefinition( "memory:" ) ) );
+  modelInputs.insert( "cx2:OUT2", QVariant::fromValue( QgsProcessingOutputLayerDefinition( "memory:" ) ) );
+  modelInputs.insert( "cx3:OUT3", QVariant::fromValue( QgsProcessingOutputLayerDefinition( "memory:" ) ) );
+
+  QgsProcessingContext context;
+  QgsProcessingFeedback feedback;
+  bool ok = false;
+  QVariantMap results = model.run( modelInputs, context, &feedback, &ok );
+  QVERIFY( ok );
+
+  // results from all children must be merged into the model's context
+  for ( const QString &output : { QStringLiteral( "cx1:OUT1" ), QStringLiteral( "cx2:OUT2" ), QStringLiteral( "cx3:OUT3" ) } )
+  {
+    QgsVectorLayer *layer = qobject_cast< QgsVectorLayer * >( context.getMapLayer( results.value( output ).toString() ) );
+    QVERIFY( layer );
+    QCOMPARE( layer->featureCount(), sourceLayer.featureCount() );
+    QVERIFY( context.willLoadLayerOnCompletion( layer->id() ) );
+  }
+  QCOMPARE( context.layersToLoadOnCompletion().count(), 3 );
+}
+
+void TestQgsProcessing::featurePipe()
+{
+  QgsFields fields;
+  fields.append( QgsField( QStringLiteral( "id" ), QVariant::Int ) );
+
+  std::shared_ptr< QgsProcessingFeaturePipe > pipe = QgsProcessingFeaturePipe::create( 100 );
+  QVERIFY( QgsProcessingFeaturePipe::isPipeUri( pipe->uri() ) );
+  QCOMPARE( QgsProcessingFeaturePipe::fromUri( pipe->uri() ).get(), pipe.get() );
+  QVERIFY( !QgsProcessingFeaturePipe::fromUri( QStringLiteral( "pipe:xxx" ) ) );
+
+  // producer writes many more features than the pipe can hold
+  QFuture< void > producer = QtConcurrent::run( [pipe, fields]
+  {
+    std::unique_ptr< QgsFeatureSink > sink( pipe->createSink( fields, QgsWkbTypes::Point, QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:4326" ) ) ) );
+    for ( int i = 0; i < 5000; ++i )
+    {
+      QgsFeature f( fields, i );
+      f.setAttributes( QgsAttributes() << i );
+      f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, i ) ) );
+      sink->addFeature( f );
+    }
+  } );
+
+  std::unique_ptr< QgsFeatureSource > source( pipe->createSource() );
+  QCOMPARE( source->fields(), fields );
+  QCOMPARE( source->wkbType(), QgsWkbTypes::Point );
+  QCOMPARE( source->sourceCrs().authid(), QStringLiteral( "EPSG:4326" ) );
+  QCOMPARE( source->featureCount(), -1L );
+
+  // filter rect is applied while streaming
+  QgsFeatureIterator it = source->getFeatures( QgsFeatureRequest().setFilterRect( QgsRectangle( 99.5, 99.5, 200.5, 200.5 ) ) );
+  QgsFeature f;
+  int count = 0;
+  while ( it.nextFeature( f ) )
+  {
+    QCOMPARE( f.attribute( 0 ).toInt(), 100 + count );
+    count++;
+  }
+  QCOMPARE( count, 101 );
+  producer.waitForFinished();
+
+  // closing the reader early must not block the writer
+  pipe = QgsProcessingFeaturePipe::create( 10 );
+  producer = QtConcurrent::run( [pipe, fields]
+  {
+    std::unique_ptr< QgsFeatureSink > sink( pipe->createSink( fields, QgsWkbTypes::NoGeometry, QgsCoordinateReferenceSystem() ) );
+    for ( int i = 0; i < 1000; ++i )
+    {
+      QgsFeature f( fields, i );
+      sink->addFeature( f );
+    }
+  } );
+  source.reset( pipe->createSource() );
+  it = source->getFeatures( QgsFeatureRequest().setLimit( 5 ) );
+  count = 0;
+  while ( it.nextFeature( f ) )
+    count++;
+  QCOMPARE( count, 5 );
+  it = QgsFeatureIterator();
+  producer.waitForFinished();
+
+  // features can only be read once
+  it = source->getFeatures();
+  QVERIFY( !it.nextFeature( f ) );
+
+  // requests are applied to streamed features
+  fields.append( QgsField( QStringLiteral( "name" ), QVariant::String ) );
+  auto streamRequest = [fields]( const QgsFeatureRequest & request ) -> QgsFeatureList
+  {
+    std::shared_ptr< QgsProcessingFeaturePipe > pipe = QgsProcessingFeaturePipe::create( 10 );
+    QFuture< void > producer = QtConcurrent::run( [pipe, fields]
+    {
+      std::unique_ptr< QgsFeatureSink > sink( pipe->createSink( fields, QgsWkbTypes::Point, QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:4326" ) ) ) );
+      for ( int i = 0; i < 100; ++i )
+      {
+        QgsFeature f( fields, i );
+        f.setAttributes( QgsAttributes() << i << QStringLiteral( "f%1" ).arg( i ) );
+        f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, i ) ) );
+        sink->addFeature( f );
+      }
+    } );
+    std::unique_ptr< QgsFeatureSource > source( pipe->createSource() );
+    QgsFeatureList features;
+    QgsFeatureIterator it = source->getFeatures( request );
+    QgsFeature f;
+    while ( it.nextFeature( f ) )
+      features << f;
+    it = QgsFeatureIterator();
+    producer.waitForFinished();
+    return features;
+  };
+
+  QgsFeatureList features = streamRequest( QgsFeatureRequest().setFilterExpression( QStringLiteral( "\"id\" >= 95 or \"name\" = 'f3'" ) ) );
+  QCOMPARE( features.count(), 6 );
+  QCOMPARE( features.at( 0 ).attribute( 0 ).toInt(), 3 );
+  QCOMPARE( features.at( 1 ).attribute( 0 ).toInt(), 95 );
+
+  features = streamRequest( QgsFeatureRequest().setFilterFids( QgsFeatureIds() << 7 << 12 << 1000 ) );
+  QCOMPARE( features.count(), 2 );
+  QCOMPARE( features.at( 0 ).id(), 7LL );
+  QCOMPARE( features.at( 1 ).id(), 12LL );
+
+  features = streamRequest( QgsFeatureRequest().setFilterFid( 42 ) );
+  QCOMPARE( features.count(), 1 );
+  QCOMPARE( features.at( 0 ).attribute( 1 ).toString(), QStringLiteral( "f42" ) );
+
+  features = streamRequest( QgsFeatureRequest().setFlags( QgsFeatureRequest::NoGeometry ).setSubsetOfAttributes( QgsAttributeList() << 1 ).setLimit( 3 ) );
+  QCOMPARE( features.count(), 3 );
+  for ( const QgsFeature &feature : qgis::as_const( features ) )
+  {
+    QVERIFY( !feature.hasGeometry() );
+    QVERIFY( feature.attribute( 0 ).isNull() );
+    QCOMPARE( feature.attribute( 1 ).toString(), QStringLiteral( "f%1" ).arg( feature.id() ) );
+  }
+
+  features = streamRequest( QgsFeatureRequest().setFilterRect( QgsRectangle( 9.5, 9.5, 12.5, 12.5 ) ).setFlags( QgsFeatureRequest::ExactIntersect ) );
+  QCOMPARE( features.count(), 3 );
+  QCOMPARE( features.at( 0 ).geometry().asWkt(), QStringLiteral( "Point (10 10)" ) );
+}
+
+void TestQgsProcessing::modelStreamedExecution()
+{
+  // cx2 reads the output of cx1 as a stream of features instead of an intermediate layer
+  QgsProcessingModelAlgorithm model;
+  model.addModelParameter( new QgsProcessingParameterFeatureSource( "SOURCE_LAYER" ), QgsProcessingModelParameter( "SOURCE_LAYER" ) );
+
+  QgsProcessingModelChildAlgorithm algc1;
+  algc1.setChildId( "cx1" );
+  algc1.setAlgorithmId( "native:centroids" );
+  algc1.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromModelParameter( "SOURCE_LAYER" ) );
+  model.addChildAlgorithm( algc1 );
+
+  QgsProcessingModelChildAlgorithm algc2;
+  algc2.setChildId( "cx2" );
+  algc2.setAlgorithmId( "native:promotetomulti" );
+  algc2.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromChildOutput( "cx1", "OUTPUT" ) );
+  QMap<QString, QgsProcessingModelOutput> outputs2;
+  QgsProcessingModelOutput out2( "OUT" );
+  out2.setChildOutputName( "OUTPUT" );
+  outputs2.insert( QStringLiteral( "OUT" ), out2 );
+  algc2.setModelOutputs( outputs2 );
+  model.addChildAlgorithm( algc2 );
+  model.updateDestinationParameters();
+
+  QString testDataDir = QStringLiteral( TEST_DATA_DIR ) + '/'; //defined in CmakeLists.txt
+  QString vector = testDataDir + "points.shp";
+  QgsVectorLayer sourceLayer( vector, "points", "ogr" );
+  QVERIFY( sourceLayer.isValid() );
+
+  QVariantMap modelInputs;
+  modelInputs.insert( "SOURCE_LAYER", vector );
+  modelInputs.insert( "cx2:OUT", QVariant::fromValue( QgsProcessingOutputLayerDefinition( "memory:" ) ) );
+
+  QgsProcessingContext context;
+  QgsProcessingFeedback feedback;
+  bool ok = false;
+  QVariantMap results = model.run( modelInputs, context, &feedback, &ok );
+  QVERIFY( ok );
+
+  QgsVectorLayer *layer = qobject_cast< QgsVectorLayer * >( context.getMapLayer( results.value( "cx2:OUT" ).toString() ) );
+  QVERIFY( layer );
+  QCOMPARE( layer->featureCount(), sourceLayer.featureCount() );
+  QCOMPARE( layer->wkbType(), QgsWkbTypes::MultiPoint );
+  // no intermediate layer was created for the output of cx1
+  QCOMPARE( context.temporaryLayerStore()->count(), 1 );
+}
+
+void TestQgsProcessing::profileExecution()
+{
+  QString testDataDir = QStringLiteral( TEST_DATA_DIR ) + '/'; //defined in CmakeLists.txt
+  QString vector = testDataDir + "points.shp";
+  QgsVectorLayer sourceLayer( vector, "points", "ogr" );
+  QVERIFY( sourceLayer.isValid() );
+
+  const QgsProcessingAlgorithm *centroids = QgsApplication::processingRegistry()->algorithmById( QStringLiteral( "native:centroids" ) );
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), vector );
+  parameters.insert( QStringLiteral( "OUTPUT" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+  // no profile unless requested
+  QgsProcessingContext context;
+  QgsProcessingFeedback feedback;
+  bool ok = false;
+  centroids->run( parameters, context, &feedback, &ok );
+  QVERIFY( ok );
+  QVERIFY( feedback.profiles().isEmpty() );
+
+  context.setFlags( context.flags() | QgsProcessingContext::ProfileExecution );
+  centroids->run( parameters, context, &feedback, &ok );
+  QVERIFY( ok );
+  QCOMPARE( feedback.profiles().count(), 1 );
+  QVariantMap profile = feedback.profiles().at( 0 ).toMap();
+  QCOMPARE( profile.value( QStringLiteral( "algorithm" ) ).toString(), QStringLiteral( "native:centroids" ) );
+  QCOMPARE( profile.value( QStringLiteral( "features_read" ) ).toLongLong(), static_cast< qlonglong >( sourceLayer.featureCount() ) );
+  QCOMPARE( profile.value( QStringLiteral( "features_written" ) ).toLongLong(), static_cast< qlonglong >( sourceLayer.featureCount() ) );
+  QVERIFY( profile.value( QStringLiteral( "process_time" ) ).toDouble() >= profile.value( QStringLiteral( "source_time" ) ).toDouble() );
+  QVERIFY( profile.contains( QStringLiteral( "prepare_time" ) ) );
+  QVERIFY( profile.contains( QStringLiteral( "post_process_time" ) ) );
+  QVERIFY( profile.contains( QStringLiteral( "process_peak_memory_increase" ) ) );
+
+  const QVariantList fromJson = QJsonDocument::fromJson( feedback.profilesAsJson().toUtf8() ).toVariant().toList();
+  QCOMPARE( fromJson.count(), 1 );
+  QCOMPARE( fromJson.at( 0 ).toMap().value( QStringLiteral( "algorithm" ) ).toString(), QStringLiteral( "native:centroids" ) );
+
+  // models report a profile for every child, followed by the model itself
+  QgsProcessingModelAlgorithm model( QStringLiteral( "model" ), QStringLiteral( "group" ) );
+  model.addModelParameter( new QgsProcessingParameterFeatureSource( "SOURCE_LAYER" ), QgsProcessingModelParameter( "SOURCE_LAYER" ) );
+  QgsProcessingModelChildAlgorithm algc1;
+  algc1.setChildId( "cx1" );
+  algc1.setAlgorithmId( "native:centroids" );
+  algc1.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromModelParameter( "SOURCE_LAYER" ) );
+  model.addChildAlgorithm( algc1 );
+  QgsProcessingModelChildAlgorithm algc2;
+  algc2.setChildId( "cx2" );
+  algc2.setAlgorithmId( "native:centroids" );
+  algc2.addParameterSources( "INPUT", QgsProcessingModelChildParameterSources() << QgsProcessingModelChildParameterSource::fromModelParameter( "SOURCE_LAYER" ) );
+  model.addChildAlgorithm( algc2 );
+
+  QVariantMap modelInputs;
+  modelInputs.insert( "SOURCE_LAYER", vector );
+  QgsProcessingFeedback modelFeedback;
+  model.run( modelInputs, context, &modelFeedback, &ok );
+  QVERIFY( ok );
+  const QVariantList profiles = modelFeedback.profiles();
+  QCOMPARE( profiles.count(), 3 );
+  QSet< QString > childIds;
+  for ( int i = 0; i < 2; ++i )
+  {
+    childIds << profiles.at( i ).toMap().value( QStringLiteral( "child_id" ) ).toString();
+    QCOMPARE( profiles.at( i ).toMap().value( QStringLiteral( "features_read" ) ).toLongLong(), static_cast< qlonglong >( sourceLayer.featureCount() ) );
+  }
+  QCOMPARE( childIds, QSet< QString >() << QStringLiteral( "cx1" ) << QStringLiteral( "cx2" ) );
+  QCOMPARE( profiles.at( 2 ).toMap().value( QStringLiteral( "algorithm" ) ).toString(), QStringLiteral( "model" ) );
+}
+
 void TestQgsProcessing::modelWithProviderWithLimitedTypes()
 {
   QgsApplication::processingRegistry()->addProvider( new DummyProvider4() );
@@ -49,6 +49,7 @@
 #include "qgsvectorlayerlabeling.h"
 #include "qgsstyle.h"
 #include "qgsbookmarkmanager.h"
+#include <QThreadPool>
 
 class TestQgsProcessingAlgs: public QObject
 {
@@ -74,6 +75,9 @@ class TestQgsProcessingAlgs: public QObject
     void parseGeoTags();
     void featureFilterAlg();
     void transformAlg();
+    void parallelFeatureProcessing();
+    void parallelOverlay_data();
+    void parallelOverlay();
     void kmeansCluster();
     void categorizeByStyle();
     void extractBinary();
@@ -520,6 +524,165 @@ void TestQgsProcessingAlgs::transformAlg()
   QVERIFY( ok );
 }
 
+void TestQgsProcessingAlgs::parallelFeatureProcessing()
+{
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:centroids" ) ) );
+  QVERIFY( alg != nullptr );
+  QVERIFY( alg->flags() & QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing );
+
+  std::unique_ptr< QgsProcessingContext > context = qgis::make_unique< QgsProcessingContext >();
+  QgsProject p;
+  context->setProject( &p );
+
+  QgsProcessingFeedback feedback;
+
+  // enough features to be split between many threads
+  QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "Polygon?crs=EPSG:4326&field=col1:integer" ), QStringLiteral( "test" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+  QgsFeatureList features;
+  for ( int i = 0; i < 5000; ++i )
+  {
+    QgsFeature f;
+    f.setAttributes( QgsAttributes() << i );
+    if ( i % 100 != 0 )
+      f.setGeometry( QgsGeometry::fromRect( QgsRectangle( i, 0, i + 2, 2 ) ) );
+    features << f;
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+  p.addMapLayer( layer );
+
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), QStringLiteral( "test" ) );
+  parameters.insert( QStringLiteral( "OUTPUT" ), QStringLiteral( "memory:" ) );
+  bool ok = false;
+  QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+
+  // output must be in the order of input features
+  QgsVectorLayer *output = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+  QVERIFY( output );
+  QCOMPARE( output->featureCount(), 5000L );
+  QgsFeatureIterator it = output->getFeatures();
+  QgsFeature f;
+  int i = 0;
+  while ( it.nextFeature( f ) )
+  {
+    QCOMPARE( f.attribute( 0 ).toInt(), i );
+    if ( i % 100 != 0 )
+      QCOMPARE( f.geometry().asWkt( 0 ), QStringLiteral( "Point (%1 1)" ).arg( i + 1 ) );
+    else
+      QVERIFY( !f.hasGeometry() );
+    i++;
+  }
+  QCOMPARE( i, 5000 );
+
+  // progress is forwarded from the worker threads
+  QGSCOMPARENEAR( feedback.progress(), 100.0, 0.001 );
+
+  // data defined parameters are evaluated sequentially, with the same results
+  std::unique_ptr< QgsProcessingAlgorithm > simplify( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:simplifygeometries" ) ) );
+  QVERIFY( simplify->flags() & QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing );
+  parameters.insert( QStringLiteral( "TOLERANCE" ), QgsProperty::fromExpression( QStringLiteral( "\"col1\" % 3" ) ) );
+  ok = false;
+  results = simplify->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+  output = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+  QVERIFY( output );
+  QCOMPARE( output->featureCount(), 5000L );
+  it = output->getFeatures();
+  i = 0;
+  while ( it.nextFeature( f ) )
+  {
+    QCOMPARE( f.attribute( 0 ).toInt(), i );
+    i++;
+  }
+  QCOMPARE( i, 5000 );
+}
+
+void TestQgsProcessingAlgs::parallelOverlay_data()
+{
+  QTest::addColumn<QString>( "algorithm" );
+
+  QTest::newRow( "intersection" ) << QStringLiteral( "native:intersection" );
+  QTest::newRow( "difference" ) << QStringLiteral( "native:difference" );
+  QTest::newRow( "union" ) << QStringLiteral( "native:union" );
+}
+
+void TestQgsProcessingAlgs::parallelOverlay()
+{
+  QFETCH( QString, algorithm );
+
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( algorithm ) );
+  QVERIFY( alg != nullptr );
+
+  QgsProject p;
+
+  // enough overlapping features to fill several batches
+  QgsVectorLayer *layerA = new QgsVectorLayer( QStringLiteral( "Polygon?crs=EPSG:4326&field=a:integer" ), QStringLiteral( "a" ), QStringLiteral( "memory" ) );
+  QgsVectorLayer *layerB = new QgsVectorLayer( QStringLiteral( "Polygon?crs=EPSG:4326&field=b:integer" ), QStringLiteral( "b" ), QStringLiteral( "memory" ) );
+  QVERIFY( layerA->isValid() );
+  QVERIFY( layerB->isValid() );
+  QgsFeatureList featuresA;
+  QgsFeatureList featuresB;
+  for ( int i = 0; i < 2000; ++i )
+  {
+    const double x = ( i % 50 ) * 3;
+    const double y = ( i / 50 ) * 3;
+    QgsFeature fA;
+    fA.setAttributes( QgsAttributes() << i );
+    fA.setGeometry( QgsGeometry::fromRect( QgsRectangle( x, y, x + 4, y + 4 ) ) );
+    featuresA << fA;
+    QgsFeature fB;
+    fB.setAttributes( QgsAttributes() << i );
+    fB.setGeometry( QgsGeometry::fromRect( QgsRectangle( x + 1, y + 1, x + 2.5, y + 5 ) ) );
+    featuresB << fB;
+  }
+  QVERIFY( layerA->dataProvider()->addFeatures( featuresA ) );
+  QVERIFY( layerB->dataProvider()->addFeatures( featuresB ) );
+  p.addMapLayers( QList< QgsMapLayer * >() << layerA << layerB );
+
+  auto runOverlay = [&]( int maxThreads ) -> QStringList
+  {
+    const int prevMaxThreads = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount( maxThreads );
+
+    QgsProcessingContext context;
+    context.setProject( &p );
+    QgsProcessingFeedback feedback;
+
+    QVariantMap parameters;
+    parameters.insert( QStringLiteral( "INPUT" ), QStringLiteral( "a" ) );
+    parameters.insert( QStringLiteral( "OVERLAY" ), QStringLiteral( "b" ) );
+    parameters.insert( QStringLiteral( "OUTPUT" ), QStringLiteral( "memory:" ) );
+    bool ok = false;
+    QVariantMap results = alg->run( parameters, context, &feedback, &ok );
+    QThreadPool::globalInstance()->setMaxThreadCount( prevMaxThreads );
+    if ( !ok )
+      return QStringList();
+
+    QStringList output;
+    QgsVectorLayer *outputLayer = qobject_cast< QgsVectorLayer * >( context.getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+    if ( !outputLayer )
+      return QStringList();
+    QgsFeatureIterator it = outputLayer->getFeatures();
+    QgsFeature f;
+    while ( it.nextFeature( f ) )
+    {
+      QStringList attributes;
+      for ( const QVariant &v : f.attributes() )
+        attributes << v.toString();
+      output << QStringLiteral( "%1|%2" ).arg( attributes.join( ',' ), f.geometry().asWkt( 6 ) );
+    }
+    return output;
+  };
+
+  const QStringList sequential = runOverlay( 1 );
+  const QStringList parallel = runOverlay( std::max( 4, QThread::idealThreadCount() ) );
+  QVERIFY( !sequential.isEmpty() );
+  QCOMPARE( parallel.count(), sequential.count() );
+  QCOMPARE( parallel, sequential );
+}
+
 void TestQgsProcessingAlgs::kmeansCluster()
 {
   // make some features
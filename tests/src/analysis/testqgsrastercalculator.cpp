@@ -57,6 +57,7 @@ class TestQgsRasterCalculator : public QObject
 
     void calcWithLayers();
     void calcWithReprojectedLayers();
+    void calcInvalidResults();
 
     void errors();
     void toString();
@@ -546,6 +547,57 @@ void TestQgsRasterCalculator::calcWithReprojectedLayers()
   delete block;
 }
 
+void TestQgsRasterCalculator::calcInvalidResults()
+{
+#ifdef HAVE_OPENCL
+  QgsOpenClUtils::setEnabled( false );
+#endif
+
+  QgsRasterCalculatorEntry entry1;
+  entry1.bandNumber = 1;
+  entry1.raster = mpLandsatRasterLayer;
+  entry1.ref = QStringLiteral( "landsat@1" );
+
+  QVector<QgsRasterCalculatorEntry> entries;
+  entries << entry1;
+
+  QgsCoordinateReferenceSystem crs;
+  crs.createFromId( 32633, QgsCoordinateReferenceSystem::EpsgCrsId );
+  QgsRectangle extent( 783235, 3348110, 783350, 3347960 );
+
+  QTemporaryFile tmpFile;
+  tmpFile.open(); // fileName is not available until open
+  QString tmpName = tmpFile.fileName();
+  tmpFile.close();
+
+  // landsat values: 125 125 124 125 125 124
+  // invalid intermediate results must result in nodata, whatever the operations applied to them afterwards
+  QgsRasterCalculator rc( QStringLiteral( "sqrt( \"landsat@1\" - 125 ) + 2 * ( 1 / ( \"landsat@1\" - 125 ) )" ),
+                          tmpName,
+                          QStringLiteral( "GTiff" ),
+                          extent, crs, 2, 3, entries,
+                          QgsProject::instance()->transformContext() );
+  QCOMPARE( static_cast< int >( rc.processCalculation() ), 0 );
+
+  std::unique_ptr< QgsRasterLayer > result = qgis::make_unique< QgsRasterLayer >( tmpName, QStringLiteral( "result" ) );
+  std::unique_ptr< QgsRasterBlock > block( result->dataProvider()->block( 1, extent, 2, 3 ) );
+  for ( int row = 0; row < 3; ++row )
+  {
+    for ( int col = 0; col < 2; ++col )
+    {
+      QVERIFY( block->isNoData( row, col ) );
+    }
+  }
+
+  // an unknown raster reference is a calculation error
+  rc = QgsRasterCalculator( QStringLiteral( "\"landsat@1\" + \"landsat@3\"" ),
+                            tmpName,
+                            QStringLiteral( "GTiff" ),
+                            extent, crs, 2, 3, entries,
+                            QgsProject::instance()->transformContext() );
+  QCOMPARE( static_cast< int >( rc.processCalculation() ), 7 );
+}
+
 void TestQgsRasterCalculator::findNodes()
 {
 
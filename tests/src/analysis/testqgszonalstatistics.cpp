@@ -19,6 +19,7 @@
 #include "qgsapplication.h"
 #include "qgsfeatureiterator.h"
 #include "qgsvectorlayer.h"
+#include "qgsvectordataprovider.h"
 #include "qgsrasterlayer.h"
 #include "qgszonalstatistics.h"
 #include "qgsproject.h"
@@ -42,6 +43,7 @@ class TestQgsZonalStatistics : public QObject
     void testReprojection();
     void testNoData();
     void testSmallPolygons();
+    void testRasterized();
 
   private:
     QgsVectorLayer *mVectorLayer = nullptr;
@@ -343,5 +345,66 @@ void TestQgsZonalStatistics::testSmallPolygons()
   QGSCOMPARENEAR( f.attribute( "nmean" ).toDouble(), 864.285638, 0.001 );
 }
 
+void TestQgsZonalStatistics::testRasterized()
+{
+  QString myDataPath( TEST_DATA_DIR ); //defined in CmakeLists.txt
+  QString myTestDataPath = myDataPath + "/zonalstatistics/";
+
+  // the rasterized method must give the same results as the per feature one for non overlapping zones
+  auto compareMethods = [ = ]( QgsVectorLayer * vectorLayer, QgsRasterLayer * rasterLayer )
+  {
+    QgsZonalStatistics zs( vectorLayer, rasterLayer, QStringLiteral( "p" ), 1, QgsZonalStatistics::All );
+    QCOMPARE( zs.method(), QgsZonalStatistics::PerFeature );
+    QCOMPARE( zs.calculateStatistics( nullptr ), 0 );
+
+    QgsZonalStatistics zsr( vectorLayer, rasterLayer, QStringLiteral( "r" ), 1, QgsZonalStatistics::All );
+    zsr.setMethod( QgsZonalStatistics::Rasterized );
+    QCOMPARE( zsr.method(), QgsZonalStatistics::Rasterized );
+    QCOMPARE( zsr.calculateStatistics( nullptr ), 0 );
+
+    const QStringList stats { QStringLiteral( "count" ), QStringLiteral( "sum" ), QStringLiteral( "mean" ), QStringLiteral( "median" ),
+                              QStringLiteral( "stdev" ), QStringLiteral( "min" ), QStringLiteral( "max" ), QStringLiteral( "range" ),
+                              QStringLiteral( "minority" ), QStringLiteral( "majority" ), QStringLiteral( "variety" ), QStringLiteral( "variance" ) };
+    QgsFeature f;
+    QgsFeatureIterator it = vectorLayer->getFeatures();
+    int count = 0;
+    while ( it.nextFeature( f ) )
+    {
+      for ( const QString &stat : stats )
+      {
+        QGSCOMPARENEAR( f.attribute( QStringLiteral( "r" ) + stat ).toDouble(), f.attribute( QStringLiteral( "p" ) + stat ).toDouble(), 0.000001 );
+      }
+      count++;
+    }
+    QVERIFY( count > 0 );
+  };
+
+  std::unique_ptr< QgsRasterLayer > rasterLayer = qgis::make_unique< QgsRasterLayer >( myTestDataPath + "raster.tif", QStringLiteral( "raster" ), QStringLiteral( "gdal" ) );
+  std::unique_ptr< QgsVectorLayer > vectorLayer = qgis::make_unique< QgsVectorLayer >( mTempPath + "polys2.shp", QStringLiteral( "poly" ), QStringLiteral( "ogr" ) );
+  compareMethods( vectorLayer.get(), rasterLayer.get() );
+
+  // polygons smaller than a pixel
+  vectorLayer = qgis::make_unique< QgsVectorLayer >( mTempPath + "small_polys.shp", QStringLiteral( "poly" ), QStringLiteral( "ogr" ) );
+  compareMethods( vectorLayer.get(), rasterLayer.get() );
+
+  // overlapping polygons, which fall back to the per feature method
+  vectorLayer = qgis::make_unique< QgsVectorLayer >( QStringLiteral( "Polygon?crs=%1" ).arg( rasterLayer->crs().authid() ), QStringLiteral( "poly" ), QStringLiteral( "memory" ) );
+  const QgsRectangle extent = rasterLayer->extent();
+  const double dx = extent.width() / 10;
+  const double dy = extent.height() / 10;
+  QgsFeatureList features;
+  const QList< QgsRectangle > rects { QgsRectangle( extent.xMinimum() + dx, extent.yMinimum() + dy, extent.xMinimum() + 6 * dx, extent.yMinimum() + 6 * dy ),
+                                      QgsRectangle( extent.xMinimum() + 4 * dx, extent.yMinimum() + 4 * dy, extent.xMinimum() + 9 * dx, extent.yMinimum() + 9 * dy ),
+                                      QgsRectangle( extent.xMinimum() + 7 * dx, extent.yMinimum() + dy, extent.xMinimum() + 9 * dx, extent.yMinimum() + 3 * dy ) };
+  for ( const QgsRectangle &rect : rects )
+  {
+    QgsFeature feature;
+    feature.setGeometry( QgsGeometry::fromRect( rect ) );
+    features << feature;
+  }
+  QVERIFY( vectorLayer->dataProvider()->addFeatures( features ) );
+  compareMethods( vectorLayer.get(), rasterLayer.get() );
+}
+
 QGSTEST_MAIN( TestQgsZonalStatistics )
 #include "testqgszonalstatistics.moc"
@@ -141,6 +141,7 @@ class TestQgsGeometry : public QObject
     void exportToGeoJSON();
 
     void wkbInOut();
+    void wkbInPlace();
 
     void directionNeutralSegmentation();
     void poleOfInaccessibility();
@@ -16867,6 +16868,33 @@ void TestQgsGeometry::unaryUnion()
 
   QgsGeometry result( QgsGeometry::unaryUnion( list ) );
   Q_UNUSED( result );
+
+  // parallel union of a grid of overlapping squares, split into many partitions
+  list.clear();
+  for ( int x = 0; x < 20; ++x )
+  {
+    for ( int y = 0; y < 20; ++y )
+    {
+      list << QgsGeometry::fromRect( QgsRectangle( x, y, x + 1.5, y + 1.5 ) );
+      if ( x == 7 && y == 3 )
+        list << empty;
+    }
+  }
+  result = QgsGeometry::parallelUnaryUnion( list, 7 );
+  QVERIFY( result.lastError().isEmpty() );
+  QGSCOMPARENEAR( result.area(), 20.5 * 20.5, 0.0000001 );
+  QCOMPARE( result.constGet()->partCount(), 1 );
+  QVERIFY( result.symDifference( QgsGeometry::unaryUnion( list ) ).area() < 0.0000001 );
+
+  // small input is passed to unaryUnion directly
+  list.clear();
+  list << geom1 << geom2;
+  QCOMPARE( QgsGeometry::parallelUnaryUnion( list ).asWkt(), QgsGeometry::unaryUnion( list ).asWkt() );
+
+  // only null geometries
+  list.clear();
+  list << empty << empty << empty << empty;
+  QVERIFY( QgsGeometry::parallelUnaryUnion( list, 2 ).isEmpty() );
 }
 
 void TestQgsGeometry::dataStream()
@@ -17048,6 +17076,50 @@ void TestQgsGeometry::wkbInOut()
   QCOMPARE( badHeader.wkbType(), QgsWkbTypes::Unknown );
 }
 
+void TestQgsGeometry::wkbInPlace()
+{
+  // decoding WKB into a geometry of the same type reuses the existing storage
+  QgsGeometry g;
+  g.fromWkbRecycled( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((0 0, 10 0, 10 10, 0 0),(1 1, 2 1, 2 2, 1 1))" ) ).asWkb() );
+  QCOMPARE( g.asWkt(), QStringLiteral( "Polygon ((0 0, 10 0, 10 10, 0 0),(1 1, 2 1, 2 2, 1 1))" ) );
+  const QgsAbstractGeometry *storage = g.constGet();
+  g.fromWkbRecycled( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((5 5, 6 5, 6 6, 5 6, 5 5))" ) ).asWkb() );
+  QCOMPARE( g.constGet(), storage );
+  QCOMPARE( g.asWkt(), QStringLiteral( "Polygon ((5 5, 6 5, 6 6, 5 6, 5 5))" ) );
+  g.fromWkbRecycled( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((0 0, 1 0, 1 1, 0 0),(0.1 0.1, 0.2 0.1, 0.2 0.2, 0.1 0.1),(0.5 0.1, 0.6 0.1, 0.6 0.2, 0.5 0.1))" ) ).asWkb() );
+  QCOMPARE( g.asWkt( 1 ), QStringLiteral( "Polygon ((0 0, 1 0, 1 1, 0 0),(0.1 0.1, 0.2 0.1, 0.2 0.2, 0.1 0.1),(0.5 0.1, 0.6 0.1, 0.6 0.2, 0.5 0.1))" ) );
+
+  // shared geometries must not be modified
+  QgsGeometry copy = g;
+  g.fromWkbRecycled( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((5 5, 6 5, 6 6, 5 6, 5 5))" ) ).asWkb() );
+  QCOMPARE( g.asWkt(), QStringLiteral( "Polygon ((5 5, 6 5, 6 6, 5 6, 5 5))" ) );
+  QCOMPARE( copy.asWkt( 1 ), QStringLiteral( "Polygon ((0 0, 1 0, 1 1, 0 0),(0.1 0.1, 0.2 0.1, 0.2 0.2, 0.1 0.1),(0.5 0.1, 0.6 0.1, 0.6 0.2, 0.5 0.1))" ) );
+
+  // different type
+  g.fromWkbRecycled( QgsGeometry::fromWkt( QStringLiteral( "LineString (1 2, 3 4)" ) ).asWkb() );
+  QCOMPARE( g.asWkt(), QStringLiteral( "LineString (1 2, 3 4)" ) );
+
+  // collections
+  g.fromWkbRecycled( QgsGeometry::fromWkt( QStringLiteral( "MultiPolygon (((0 0, 1 0, 1 1, 0 0)),((5 5, 6 5, 6 6, 5 5)))" ) ).asWkb() );
+  storage = g.constGet();
+  g.fromWkbRecycled( QgsGeometry::fromWkt( QStringLiteral( "MultiPolygon (((10 10, 11 10, 11 11, 10 10)))" ) ).asWkb() );
+  QCOMPARE( g.constGet(), storage );
+  QCOMPARE( g.asWkt(), QStringLiteral( "MultiPolygon (((10 10, 11 10, 11 11, 10 10)))" ) );
+  g.fromWkbRecycled( QgsGeometry::fromWkt( QStringLiteral( "MultiPolygon (((0 0, 1 0, 1 1, 0 0)),((5 5, 6 5, 6 6, 5 5),(5.1 5.1, 5.2 5.1, 5.2 5.2, 5.1 5.1)))" ) ).asWkb() );
+  QCOMPARE( g.asWkt( 1 ), QStringLiteral( "MultiPolygon (((0 0, 1 0, 1 1, 0 0)),((5 5, 6 5, 6 6, 5 5),(5.1 5.1, 5.2 5.1, 5.2 5.2, 5.1 5.1)))" ) );
+
+  // invalid WKB clears geometry
+  g.fromWkbRecycled( QByteArray( "\x01\x06", 2 ) );
+  QVERIFY( g.isNull() );
+
+  // plain fromWkb always creates a new geometry
+  g.fromWkbRecycled( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((0 0, 10 0, 10 10, 0 0))" ) ).asWkb() );
+  storage = g.constGet();
+  g.fromWkb( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((5 5, 6 5, 6 6, 5 6, 5 5))" ) ).asWkb() );
+  QVERIFY( g.constGet() != storage );
+  QCOMPARE( g.asWkt(), QStringLiteral( "Polygon ((5 5, 6 5, 6 6, 5 6, 5 5))" ) );
+}
+
 void TestQgsGeometry::directionNeutralSegmentation()
 {
   //Tests, if segmentation of a circularstring is the same in both directions
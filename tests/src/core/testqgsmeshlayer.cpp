@@ -27,6 +27,7 @@
 #include "qgsproject.h"
 #include "qgstriangularmesh.h"
 #include "qgsmeshlayerutils.h"
+#include "qgsmeshdatasetcache.h"
 
 /**
  * \ingroup UnitTests
@@ -67,6 +68,8 @@ class TestQgsMeshLayer : public QObject
 
     void test_reload();
     void test_reload_extra_dataset();
+
+    void test_dataset_cache();
 };
 
 QString TestQgsMeshLayer::readFile( const QString &fname ) const
@@ -666,5 +669,69 @@ void TestQgsMeshLayer::test_reload_extra_dataset()
   QCOMPARE( QgsMeshDatasetValue( 1, -2 ), layer.dataProvider()->datasetValue( ds, 4 ) );
 }
 
+void TestQgsMeshLayer::test_dataset_cache()
+{
+  QVERIFY( mMdalLayer->datasetCache() );
+  QgsMeshDataProvider *dp = mMdalLayer->dataProvider();
+
+  // tiny blocks, so that the mesh with 5 vertices and 2 faces spans several of them
+  QgsMeshDatasetCache cache( dp, 2 );
+  QCOMPARE( cache.memoryUsage(), static_cast<qint64>( 0 ) );
+
+  // only the blocks covering the range are read
+  const QgsMeshDatasetIndex scalarIndex( 1, 0 );
+  QgsMeshDataBlock values = cache.datasetValues( scalarIndex, 1, 3 );
+  QCOMPARE( values.type(), QgsMeshDataBlock::ScalarDouble );
+  QCOMPARE( values.count(), 3 );
+  QCOMPARE( values.value( 0 ), QgsMeshDatasetValue( 2.0 ) );
+  QCOMPARE( values.value( 1 ), QgsMeshDatasetValue( 3.0 ) );
+  QCOMPARE( values.value( 2 ), QgsMeshDatasetValue( 2.0 ) );
+  QCOMPARE( cache.memoryUsage(), static_cast<qint64>( 4 * sizeof( double ) ) );
+  QVERIFY( cache.hasDatasetValues( scalarIndex, 0, 4 ) );
+  QVERIFY( !cache.hasDatasetValues( scalarIndex, 0, 5 ) );
+
+  const QgsMeshDatasetIndex vectorIndex( 2, 0 );
+  values = cache.datasetValues( vectorIndex, 0, 5 );
+  const QgsMeshDataBlock providerValues = dp->datasetValues( vectorIndex, 0, 5 );
+  QCOMPARE( values.type(), QgsMeshDataBlock::Vector2DDouble );
+  QCOMPARE( values.count(), 5 );
+  for ( int i = 0; i < 5; ++i )
+    QCOMPARE( values.value( i ), providerValues.value( i ) );
+
+  const QgsMeshDataBlock active = cache.areFacesActive( scalarIndex, 0, 2 );
+  QCOMPARE( active.count(), 2 );
+  QVERIFY( active.active( 0 ) );
+  QVERIFY( active.active( 1 ) );
+  QCOMPARE( cache.memoryUsage(), static_cast<qint64>( 4 * sizeof( double ) + 10 * sizeof( double ) + 2 * sizeof( int ) ) );
+
+  // least recently used blocks are evicted first
+  cache.setMaximumMemory( 40 );
+  QCOMPARE( cache.memoryUsage(), static_cast<qint64>( 2 * sizeof( double ) + 2 * sizeof( int ) ) );
+  QVERIFY( !cache.hasDatasetValues( scalarIndex, 0, 1 ) );
+  QVERIFY( !cache.hasDatasetValues( vectorIndex, 0, 4 ) );
+  QVERIFY( cache.hasDatasetValues( vectorIndex, 4, 1 ) );
+
+  // prefetching reads one block at a time
+  cache.clear();
+  cache.setMaximumMemory( QgsMeshDatasetCache::DEFAULT_MAXIMUM_MEMORY );
+  const QgsMeshDatasetIndex nextIndex( 1, 1 );
+  cache.prefetch( nextIndex );
+  cache.prefetch( QgsMeshDatasetIndex( 1, 100 ) );
+  QVERIFY( cache.hasPendingPrefetch() );
+  int reads = 0;
+  while ( cache.prefetchNextBlock() )
+    ++reads;
+  QCOMPARE( reads, 4 );
+  QVERIFY( !cache.hasPendingPrefetch() );
+  QVERIFY( cache.hasDatasetValues( nextIndex, 0, 5 ) );
+  values = cache.datasetValues( nextIndex, 0, 5 );
+  QCOMPARE( values.value( 0 ), QgsMeshDatasetValue( 2.0 ) );
+  QCOMPARE( values.value( 2 ), QgsMeshDatasetValue( 4.0 ) );
+
+  // fully cached datasets are not queued again
+  cache.prefetch( nextIndex );
+  QVERIFY( !cache.hasPendingPrefetch() );
+}
+
 QGSTEST_MAIN( TestQgsMeshLayer )
 #include "testqgsmeshlayer.moc"
@@ -24,6 +24,8 @@
 #include <qgsapplication.h>
 #include <qgscoordinatereferencesystem.h>
 #include <qgsproject.h>
+#include <qgsmeshlayerutils.h>
+#include <qgsrendercontext.h>
 
 /**
  * \ingroup UnitTests
@@ -39,6 +41,7 @@ class TestQgsMeshLayerInterpolator: public QObject
     void cleanup() {} // will be called after every testfunction.
 
     void testExportRasterBand();
+    void testCoverage();
   private:
     QString mTestDataDir;
 };
@@ -89,5 +92,61 @@ void TestQgsMeshLayerInterpolator::testExportRasterBand()
   QVERIFY( block->isNoData( 10, 10 ) );
 }
 
+void TestQgsMeshLayerInterpolator::testCoverage()
+{
+  QgsMeshLayer layer( mTestDataDir + "/mesh/quad_and_triangle.2dm",
+                      "Triangle and Quad Mdal",
+                      "mdal" );
+  QVERIFY( layer.isValid() );
+  layer.setCrs( QgsCoordinateReferenceSystem::fromEpsgId( 27700 ) );
+  QgsMeshDatasetIndex index( 0, 0 ); // bed elevation
+
+  const QgsRectangle extent = layer.extent();
+  const QSize size( 20, 10 );
+  QgsRenderContext context;
+  context.setMapToPixel( QgsMapToPixel( 100, extent.center().x(), extent.center().y(), size.width(), size.height(), 0 ) );
+  context.setExtent( extent );
+
+  QgsMesh nativeMesh;
+  layer.dataProvider()->populateMesh( &nativeMesh );
+  QgsTriangularMesh triangularMesh;
+  triangularMesh.update( &nativeMesh, &context );
+
+  QVector<double> values = QgsMeshLayerUtils::calculateMagnitudes( layer.dataProvider()->datasetValues( index, 0, nativeMesh.vertices.count() ) );
+  QgsMeshDataBlock active = layer.dataProvider()->areFacesActive( index, 0, nativeMesh.faces.count() );
+
+  QgsMeshLayerInterpolator interpolator( triangularMesh, values, active, true, context, size );
+  std::unique_ptr<QgsRasterBlock> expected( interpolator.block( 0, extent, size.width(), size.height() ) );
+  QCOMPARE( expected->value( 0, 0 ), 10.0 );
+  QCOMPARE( expected->value( 5, 5 ), 35.0 );
+
+  std::shared_ptr<QgsMeshLayerInterpolatorCoverage> coverage = std::make_shared<QgsMeshLayerInterpolatorCoverage>( context, extent, size, triangularMesh.triangles().count() );
+  QVERIFY( coverage->isCompatible( context, extent, size, triangularMesh.triangles().count() ) );
+  QVERIFY( !coverage->isCompatible( context, extent, QSize( 40, 20 ), triangularMesh.triangles().count() ) );
+  QVERIFY( !coverage->isCompatible( context, extent, size, triangularMesh.triangles().count() + 1 ) );
+
+  // the same coverage reused with other values gives the same result as a fresh interpolation
+  interpolator.setCoverage( coverage );
+  std::unique_ptr<QgsRasterBlock> block( interpolator.block( 0, extent, size.width(), size.height() ) );
+  QCOMPARE( block->data(), expected->data() );
+
+  QVector<double> doubledValues = values;
+  for ( double &value : doubledValues )
+    value *= 2;
+  QgsMeshLayerInterpolator interpolator2( triangularMesh, doubledValues, active, true, context, size );
+  interpolator2.setCoverage( coverage );
+  block.reset( interpolator2.block( 0, extent, size.width(), size.height() ) );
+  for ( int row = 0; row < size.height(); ++row )
+  {
+    for ( int col = 0; col < size.width(); ++col )
+    {
+      if ( expected->isNoData( row, col ) )
+        QVERIFY( block->isNoData( row, col ) );
+      else
+        QGSCOMPARENEAR( block->value( row, col ), 2 * expected->value( row, col ), 1e-9 );
+    }
+  }
+}
+
 QGSTEST_MAIN( TestQgsMeshLayerInterpolator )
 #include "testqgsmeshlayerinterpolator.moc"
@@ -34,6 +34,8 @@
 #include "qgsproject.h"
 #include "qgsmaprenderersequentialjob.h"
 #include "qgsmeshmemorydataprovider.h"
+#include "qgsmeshtracerenderer.h"
+#include "qgsrendercontext.h"
 
 //qgis test includes
 #include "qgsrenderchecker.h"
@@ -78,6 +80,7 @@ class TestQgsMeshRenderer : public QObject
     void test_face_vector_on_user_grid_streamlines();
     void test_vertex_vector_on_user_grid();
     void test_vertex_vector_on_user_grid_streamlines();
+    void test_vector_flow_grid();
 
     void test_signals();
 };
@@ -370,6 +373,58 @@ void TestQgsMeshRenderer::test_vertex_vector_on_user_grid_streamlines()
   QVERIFY( imageCheck( "quad_and_triangle_vertex_vector_user_grid_dataset_streamlines", mMemoryLayer ) );
 }
 
+void TestQgsMeshRenderer::test_vector_flow_grid()
+{
+  QgsMesh nativeMesh;
+  mMemoryLayer->dataProvider()->populateMesh( &nativeMesh );
+  QgsRenderContext context;
+  QgsTriangularMesh triangularMesh;
+  triangularMesh.update( &nativeMesh, &context );
+
+  // vectors linear in coordinates are reproduced exactly by the bilinear interpolation on the grid
+  QgsMeshDataBlock values( QgsMeshDataBlock::Vector2DDouble, nativeMesh.vertices.count() );
+  double *buffer = static_cast<double *>( values.buffer() );
+  for ( int i = 0; i < nativeMesh.vertices.count(); ++i )
+  {
+    buffer[2 * i] = nativeMesh.vertices.at( i ).x() / 1000;
+    buffer[2 * i + 1] = 2 * nativeMesh.vertices.at( i ).y() / 1000;
+  }
+  QgsMeshVectorValueInterpolatorFromVertex interpolator( triangularMesh, values );
+
+  const QgsRectangle layerExtent = mMemoryLayer->extent();
+  const QgsMeshDatasetIndex index( 1, 0 );
+  QgsMeshVectorFlowGridCache cache;
+  std::shared_ptr<const QgsMeshVectorFlowGrid> grid = cache.grid( index, triangularMesh.triangles().count(),
+      QgsRectangle( 1200, 2200, 1800, 2800 ), layerExtent, 10, interpolator, context );
+  QVERIFY( grid );
+  QCOMPARE( grid->cellSize(), 16.0 );
+  // the grid has a margin within the layer extent
+  QVERIFY( grid->extent().contains( QgsRectangle( 1000, 2000, 2100, 3000 ) ) );
+
+  QgsVector vector = grid->vectorValue( QgsPointXY( 1500.5, 2500.25 ) );
+  QGSCOMPARENEAR( vector.x(), 1.5005, 1e-5 );
+  QGSCOMPARENEAR( vector.y(), 5.0005, 1e-5 );
+  vector = grid->vectorValue( QgsPointXY( 2050, 2100 ) );
+  QGSCOMPARENEAR( vector.x(), 2.05, 1e-5 );
+  QGSCOMPARENEAR( vector.y(), 4.2, 1e-5 );
+
+  // outside of the mesh and outside of the grid
+  QVERIFY( std::isnan( grid->vectorValue( QgsPointXY( 2100, 2990 ) ).x() ) );
+  QVERIFY( std::isnan( grid->vectorValue( QgsPointXY( 2900, 2900 ) ).x() ) );
+
+  // panning within the grid at a similar scale reuses the grid
+  QCOMPARE( cache.grid( index, triangularMesh.triangles().count(),
+                        QgsRectangle( 1300, 2300, 1900, 2900 ), layerExtent, 12, interpolator, context ).get(), grid.get() );
+  // other datasets and scales get their own grid
+  QVERIFY( cache.grid( QgsMeshDatasetIndex( 1, 1 ), triangularMesh.triangles().count(),
+                       QgsRectangle( 1300, 2300, 1900, 2900 ), layerExtent, 12, interpolator, context ) != grid );
+  QVERIFY( cache.grid( index, triangularMesh.triangles().count(),
+                       QgsRectangle( 1300, 2300, 1900, 2900 ), layerExtent, 2, interpolator, context ) != grid );
+  // nothing to sample outside of the layer
+  QVERIFY( !cache.grid( index, triangularMesh.triangles().count(),
+                        QgsRectangle( 5000, 5000, 6000, 6000 ), layerExtent, 10, interpolator, context ) );
+}
+
 void TestQgsMeshRenderer::test_signals()
 {
   QSignalSpy spy1( mMemoryLayer, &QgsMapLayer::rendererChanged );
@@ -23,6 +23,8 @@
 #include "qgstriangularmesh.h"
 #include "qgsapplication.h"
 #include "qgsproject.h"
+#include "qgsrendercontext.h"
+#include "qgscoordinatetransform.h"
 
 /**
  * \ingroup UnitTests
@@ -42,6 +44,7 @@ class TestQgsTriangularMesh : public QObject
     void cleanup() {} // will be called after every testfunction.
 
     void test_triangulate();
+    void test_update();
 };
 
 
@@ -102,5 +105,75 @@ void TestQgsTriangularMesh::test_triangulate()
   }
 }
 
+void TestQgsTriangularMesh::test_update()
+{
+  // large enough mesh to be processed in parallel: a grid of quads with triangles in the last row
+  const int columns = 200;
+  const int rows = 200;
+  QgsMesh nativeMesh;
+  for ( int j = 0; j <= rows; ++j )
+    for ( int i = 0; i <= columns; ++i )
+      nativeMesh.vertices.append( QgsMeshVertex( 10.0 + 0.01 * i, 45.0 + 0.01 * j, j ) );
+  for ( int j = 0; j < rows; ++j )
+  {
+    for ( int i = 0; i < columns; ++i )
+    {
+      const int v = j * ( columns + 1 ) + i;
+      if ( j == rows - 1 )
+      {
+        nativeMesh.faces.append( QgsMeshFace( { v, v + 1, v + columns + 1 } ) );
+        nativeMesh.faces.append( QgsMeshFace( { v + 1, v + columns + 2, v + columns + 1 } ) );
+      }
+      else
+        nativeMesh.faces.append( QgsMeshFace( { v, v + 1, v + columns + 2, v + columns + 1 } ) );
+    }
+  }
+  const int trianglesCount = 2 * rows * columns;
+
+  QgsRenderContext context;
+  QgsTriangularMesh mesh;
+  mesh.update( &nativeMesh, &context );
+  QCOMPARE( mesh.vertices().size(), nativeMesh.vertices.size() );
+  QCOMPARE( mesh.triangles().size(), trianglesCount );
+  QCOMPARE( mesh.centroids().size(), nativeMesh.faces.size() );
+
+  // triangles are in the same order as when triangulating the faces one by one
+  QgsTriangularMesh sequentialMesh;
+  for ( int i = 0; i < nativeMesh.faces.size(); ++i )
+    sequentialMesh.triangulate( nativeMesh.faces.at( i ), i );
+  QCOMPARE( mesh.triangles(), sequentialMesh.mTriangularMesh.faces );
+  QCOMPARE( mesh.trianglesToNativeFaces(), sequentialMesh.mTrianglesToNativeFaces );
+
+  QCOMPARE( mesh.vertices().at( 0 ), nativeMesh.vertices.at( 0 ) );
+  QGSCOMPARENEAR( mesh.centroids().at( 0 ).x(), 10.005, 1e-6 );
+  QGSCOMPARENEAR( mesh.centroids().at( 0 ).y(), 45.005, 1e-6 );
+  QCOMPARE( mesh.faceIndexForPoint_v2( QgsPointXY( 10.004, 45.006 ) ), 0 );
+
+  // only the transform changes - triangulation is kept and vertices are reprojected
+  const QgsCoordinateReferenceSystem wgs84( QStringLiteral( "EPSG:4326" ) );
+  const QgsCoordinateReferenceSystem mercator( QStringLiteral( "EPSG:3857" ) );
+  context.setCoordinateTransform( QgsCoordinateTransform( wgs84, mercator, QgsProject::instance() ) );
+  mesh.update( &nativeMesh, &context );
+  QCOMPARE( mesh.triangles(), sequentialMesh.mTriangularMesh.faces );
+  QCOMPARE( mesh.trianglesToNativeFaces(), sequentialMesh.mTrianglesToNativeFaces );
+
+  QgsTriangularMesh projectedMesh;
+  projectedMesh.update( &nativeMesh, &context );
+  QCOMPARE( mesh.vertices().size(), projectedMesh.vertices().size() );
+  for ( int i = 0; i < mesh.vertices().size(); ++i )
+    QCOMPARE( mesh.vertices().at( i ), projectedMesh.vertices().at( i ) );
+  QCOMPARE( mesh.centroids(), projectedMesh.centroids() );
+
+  const QgsPointXY mapVertex = context.coordinateTransform().transform( QgsPointXY( 10.0, 45.0 ) );
+  QGSCOMPARENEAR( mesh.vertices().at( 0 ).x(), mapVertex.x(), 1e-6 );
+  QGSCOMPARENEAR( mesh.vertices().at( 0 ).y(), mapVertex.y(), 1e-6 );
+  QCOMPARE( mesh.vertices().at( 0 ).z(), 0.0 );
+  QCOMPARE( mesh.vertices().at( columns + 1 ).z(), 1.0 );
+
+  const QgsPointXY mapPoint = context.coordinateTransform().transform( QgsPointXY( 10.004, 45.006 ) );
+  QCOMPARE( mesh.faceIndexForPoint_v2( mapPoint ), 0 );
+  QCOMPARE( mesh.faceIndexForPoint_v2( QgsPointXY( 10.004, 45.006 ) ), -1 );
+}
+
 QGSTEST_MAIN( TestQgsTriangularMesh )
 #include "testqgstriangularmesh.moc"
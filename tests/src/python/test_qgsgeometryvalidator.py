@@ -11,6 +11,7 @@ __date__ = '03/10/2016'
 __copyright__ = 'Copyright 2016, The QGIS Project'
 
 from qgis.core import (
+    QgsFeedback,
     QgsGeometry,
     QgsGeometryValidator
 )
@@ -60,6 +61,36 @@ class TestQgsGeometryValidator(unittest.TestCase):
         # make sure validating this geometry doesn't crash QGIS
         QgsGeometryValidator.validateGeometry(g)
 
+    def testValidateGeometries(self):
+        """ Test validating a list of geometries using multiple threads """
+        wkts = ['Polygon ((0 0, 10 0, 10 10, 0 10, 0 0))',
+                'Polygon ((0 0, 10 10, 0 10, 10 0, 0 0))',
+                'LineString (0 0, 1 1)',
+                'Polygon ((0 0, 10 0, 10 10, 0 10, 0 0),(2 2, 12 2, 12 4, 2 4, 2 2))',
+                '']
+        # enough geometries to be split between several threads
+        geometries = [QgsGeometry.fromWkt(wkts[i % len(wkts)]) for i in range(500)]
+
+        for method in (QgsGeometry.ValidatorQgisInternal, QgsGeometry.ValidatorGeos):
+            errors = QgsGeometryValidator.validateGeometries(geometries, method)
+            self.assertEqual(len(errors), len(geometries))
+            for g, geometry_errors in zip(geometries, errors):
+                expected = g.validateGeometry(method)
+                self.assertEqual([(e.what(), e.where()) for e in geometry_errors],
+                                 [(e.what(), e.where()) for e in expected])
+            self.assertFalse(errors[0])
+            self.assertTrue(errors[1])
+            self.assertTrue(errors[3])
+
+        self.assertEqual(QgsGeometryValidator.validateGeometries([]), [])
+
+        # a canceled validation reports no errors
+        feedback = QgsFeedback()
+        feedback.cancel()
+        errors = QgsGeometryValidator.validateGeometries(geometries, QgsGeometry.ValidatorQgisInternal, QgsGeometry.ValidityFlags(), feedback)
+        self.assertEqual(len(errors), len(geometries))
+        self.assertFalse(any(errors))
+
 
 if __name__ == '__main__':
     unittest.main()
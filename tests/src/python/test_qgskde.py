@@ -0,0 +1,93 @@
+# -*- coding: utf-8 -*-
+"""QGIS Unit tests for QgsKernelDensityEstimation.
+
+.. note:: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+"""
+__author__ = 'The QGIS Project'
+__date__ = '18/10/2019'
+__copyright__ = 'Copyright 2019, The QGIS Project'
+
+import qgis  # NOQA
+
+import os
+import shutil
+import tempfile
+
+from osgeo import gdal
+from qgis.core import (QgsFeature,
+                       QgsField,
+                       QgsGeometry,
+                       QgsPointXY,
+                       QgsVectorLayer)
+from qgis.analysis import QgsKernelDensityEstimation
+from qgis.PyQt.QtCore import QVariant
+from qgis.testing import start_app, unittest
+
+start_app()
+
+
+class TestQgsKernelDensityEstimation(unittest.TestCase):
+
+    def setUp(self):
+        self.tempDir = tempfile.mkdtemp()
+
+    def tearDown(self):
+        shutil.rmtree(self.tempDir, True)
+
+    def createPoints(self):
+        """
+        Creates points spread over several output tiles, with kernels which do not overlap
+        """
+        layer = QgsVectorLayer('Point?crs=epsg:3857', 'points', 'memory')
+        layer.dataProvider().addAttributes([QgsField('radius', QVariant.Double), QgsField('weight', QVariant.Double)])
+        layer.updateFields()
+        features = []
+        for i in range(15):
+            for j in range(15):
+                f = QgsFeature(layer.fields())
+                f.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(i * 20 + 0.37 * (j % 3), j * 20 + 0.61 * (i % 4))))
+                f.setAttributes([4.0 + (i + j) % 3, 1.0 + (i * j) % 5])
+                features.append(f)
+        self.assertTrue(layer.dataProvider().addFeatures(features))
+        return layer
+
+    def runKde(self, layer, method, radius_field='', weight_field='', shape=QgsKernelDensityEstimation.KernelQuartic):
+        params = QgsKernelDensityEstimation.Parameters()
+        params.source = layer
+        params.radius = 6.3
+        params.radiusField = radius_field
+        params.weightField = weight_field
+        params.pixelSize = 1.0
+        params.shape = shape
+        params.decayRatio = 0.0
+        params.outputValues = QgsKernelDensityEstimation.OutputRaw
+        output = os.path.join(self.tempDir, 'kde_{}_{}_{}.tif'.format(method, radius_field, shape))
+        kde = QgsKernelDensityEstimation(params, output, 'GTiff')
+        kde.setMethod(method)
+        self.assertEqual(kde.method(), method)
+        self.assertEqual(kde.run(), QgsKernelDensityEstimation.Success)
+        ds = gdal.Open(output)
+        return ds.RasterXSize, ds.RasterYSize, ds.GetGeoTransform(), ds.GetRasterBand(1).ReadRaster()
+
+    def testMethodsGiveSameSurface(self):
+        """
+        Test that the tiled and streamed methods give the same surface as the point by point method
+        """
+        layer = self.createPoints()
+        for radius_field, weight_field, shape in [('', '', QgsKernelDensityEstimation.KernelQuartic),
+                                                  ('radius', 'weight', QgsKernelDensityEstimation.KernelTriangular)]:
+            expected = self.runKde(layer, QgsKernelDensityEstimation.PointByPoint, radius_field, weight_field, shape)
+            # more than one tile in each direction
+            self.assertGreater(expected[0], 256)
+            self.assertGreater(expected[1], 256)
+            for method in [QgsKernelDensityEstimation.Tiled, QgsKernelDensityEstimation.Streamed]:
+                result = self.runKde(layer, method, radius_field, weight_field, shape)
+                self.assertEqual(result[:3], expected[:3])
+                self.assertEqual(result[3], expected[3], 'method {} differs from PointByPoint'.format(method))
+
+
+if __name__ == '__main__':
+    unittest.main()